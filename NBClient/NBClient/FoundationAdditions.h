@@ -70,4 +70,7 @@
 
 + (nonnull NSError *)nb_genericError;
 
+// Whether it's from cancelling a task, not a failure to report.
+- (BOOL)nb_isCancellation;
+
 @end
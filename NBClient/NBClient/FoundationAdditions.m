@@ -262,4 +262,9 @@ static NSString *QueryPairJoiner = @"=";
                  NSLocalizedFailureReasonErrorKey: @"message.unknown-error".nb_localizedString }];
 }
 
+- (BOOL)nb_isCancellation
+{
+    return [self.domain isEqualToString:NSURLErrorDomain] && self.code == NSURLErrorCancelled;
+}
+
 @end
@@ -14,6 +14,7 @@
 
     #import "NBAuthenticator.h"
     #import "NBClient.h"
+    #import "NBClient+Composites.h"
     #import "NBClient+Contacts.h"
     #import "NBClient+Donations.h"
     #import "NBClient+Lists.h"
@@ -21,6 +22,22 @@
     #import "NBClient+Sites.h"
     #import "NBClient+Surveys.h"
     #import "NBClient+Tags.h"
+    #import "NBClientCompositePipeline.h"
+    #import "NBClientImportJob.h"
+    #import "NBClientMembershipSet.h"
+    #import "NBClientPageSizer.h"
+    #import "NBClientPeopleSnapshot.h"
+    #import "NBClientPersonSaveCoalescer.h"
+    #import "NBClientReferenceData.h"
+    #import "NBClientRefreshScheduler.h"
+    #import "NBClientSessionProvider.h"
+    #import "NBClientStreamedBody.h"
+    #import "NBClientStringInternPool.h"
+    #import "NBClientSurveyTally.h"
+    #import "NBClientSyncJob.h"
+    #import "NBClientTagCatalog.h"
+    #import "NBClientTaskGroup.h"
+    #import "NBClientTracer.h"
     #import "NBDefines.h"
     #import "FoundationAdditions.h"
     #import "NBPaginationInfo.h"
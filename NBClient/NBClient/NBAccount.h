@@ -13,6 +13,8 @@
 #import "NBClient.h"
 
 @class NBAuthenticator;
+@class NBClientReferenceData;
+@class NBClientRefreshScheduler;
 
 @protocol NBAccountDelegate;
 
@@ -25,6 +27,10 @@
 
 @property (nonatomic, readonly, null_resettable) NBClient *client;
 @property (nonatomic, readonly, nonnull) NBAuthenticator *authenticator;
+// Snapshotted per account, so only once the account has an identifier.
+@property (nonatomic, readonly, nullable) NBClientReferenceData *referenceData;
+// Keeps the account's key collections warm during background fetches. Same.
+@property (nonatomic, readonly, nullable) NBClientRefreshScheduler *refreshScheduler;
 
 @property (nonatomic, copy, readonly, nonnull) NSDictionary *clientInfo;
 // Will load from the conventional plist with name equal to NBInfoFileName. Useful if your app is only for one nation.
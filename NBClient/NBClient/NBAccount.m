@@ -12,6 +12,9 @@
 #import "NBAuthenticator.h"
 #import "NBClient.h"
 #import "NBClient+People.h"
+#import "NBClientReferenceData.h"
+#import "NBClientRefreshScheduler.h"
+#import "NBClientSessionProvider.h"
 
 #if DEBUG
 static NBLogLevel LogLevel = NBLogLevelDebug;
@@ -109,6 +112,8 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                                           customURLSession:nil customURLSessionConfiguration:nil];
     }
     self.client.delegate = self;
+    // Accounts share one session and connection pool.
+    self.client.sessionProvider = [NBClientSessionProvider sharedProvider];
     return _client;
 }
 
@@ -120,9 +125,32 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     self.authenticator = [[NBAuthenticator alloc] initWithBaseURL:self.baseURL
                                                  clientIdentifier:self.clientInfo[NBInfoClientIdentifierKey]];
     self.authenticator.shouldPersistCredential = NO;
+    // Apply any identifying info set before the authenticator was needed, ie. when restoring.
+    [self updateCredentialIdentifier];
     return _authenticator;
 }
 
+- (NBClientReferenceData *)referenceData
+{
+    if (_referenceData || self.identifier == NSNotFound) {
+        return _referenceData;
+    }
+    NSString *identifier = [NSString stringWithFormat:@"%@-%lu", self.clientInfo[NBInfoNationSlugKey], (unsigned long)self.identifier];
+    self.referenceData = [[NBClientReferenceData alloc] initWithClient:self.client identifier:identifier];
+    return _referenceData;
+}
+
+- (NBClientRefreshScheduler *)refreshScheduler
+{
+    if (_refreshScheduler || self.identifier == NSNotFound) {
+        return _refreshScheduler;
+    }
+    NSString *identifier = [NSString stringWithFormat:@"%@-%lu", self.clientInfo[NBInfoNationSlugKey], (unsigned long)self.identifier];
+    self.refreshScheduler = [[NBClientRefreshScheduler alloc] initWithClient:self.client identifier:identifier];
+    self.refreshScheduler.referenceData = self.referenceData;
+    return _refreshScheduler;
+}
+
 - (NSDictionary *)defaultClientInfo
 {
     if (_defaultClientInfo) {
@@ -144,6 +172,13 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     _shouldUseTestToken = shouldUseTestToken;
     // Did.
     self.client = nil;
+    self.referenceData = nil;
+    self.refreshScheduler = nil;
+}
+
+- (BOOL)isMaterialized
+{
+    return _client || _authenticator;
 }
 
 - (NSURL *)baseURL
@@ -232,6 +267,22 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
      completionHandler:authenticationCompletionHandler];
 }
 
+- (BOOL)prepareClientWithSavedCredential
+{
+    if (self.isActive) {
+        return YES;
+    }
+    NBAuthenticationCredential *credential = self.authenticator.credential;
+    if (!credential && [self updateCredentialIdentifier]) {
+        credential = [NBAuthenticationCredential fetchCredentialWithIdentifier:self.authenticator.credentialIdentifier];
+    }
+    if (!credential) {
+        return NO;
+    }
+    self.client.apiKey = credential.accessToken;
+    return YES;
+}
+
 - (BOOL)requestCleanUpWithError:(NSError *__autoreleasing *)error
 {
     BOOL didDelete = [self.authenticator discardCredential];
@@ -243,6 +294,10 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                      NSLocalizedFailureReasonErrorKey: @"message.unknown-error".nb_localizedString }];
     } else {
         self.client.apiKey = nil;
+        [_referenceData discardSnapshot];
+        self.referenceData = nil;
+        [_refreshScheduler removeAllData];
+        self.refreshScheduler = nil;
     }
     return didDelete;
 }
@@ -277,10 +332,9 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 - (void)fetchAvatarWithCompletionHandler:(NBGenericCompletionHandler)completionHandler
 {
     NSURL *avatarURL = [NSURL URLWithString:self.person[@"profile_image_url_ssl"]];
-    NSURLSessionDownloadTask *avatarTask =
-    [self.client.urlSession
-     downloadTaskWithURL:avatarURL completionHandler:^(NSURL *location, NSURLResponse *response, NSError *error) {
-         self.avatarImageData = [NSData dataWithContentsOfURL:location];
+    [self.client
+     startDataTaskWithURL:avatarURL completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+         self.avatarImageData = data;
          if (!self.avatarImageData) {
              NBLogWarning(@"Invalid avatar URL %@", avatarURL);
          }
@@ -290,7 +344,6 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
              });
          }
      }];
-    [avatarTask resume];
 }
 
 - (NSString *)credentialIdentifier {
@@ -301,10 +354,12 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 {
     BOOL didUpdate = NO;
     if (self.name && self.identifier != NSNotFound) {
+        didUpdate = YES;
+        // Don't create the authenticator just for this. It will update itself when needed.
+        if (!_authenticator) { return didUpdate; }
         self.authenticator.credentialIdentifier =
         [self.authenticator.defaultCredentialIdentifier stringByAppendingString:
          [NSString stringWithFormat:@"-%@-%lu", self.name, (unsigned long)self.identifier]];
-        didUpdate = YES;
     }
     return didUpdate;
 }
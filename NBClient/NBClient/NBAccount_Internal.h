@@ -13,6 +13,8 @@
 
 @property (nonatomic, readwrite, null_resettable) NBClient *client;
 @property (nonatomic, readwrite, nonnull) NBAuthenticator *authenticator;
+@property (nonatomic, readwrite, nullable) NBClientReferenceData *referenceData;
+@property (nonatomic, readwrite, nullable) NBClientRefreshScheduler *refreshScheduler;
 
 @property (nonatomic, copy, readwrite, nonnull) NSDictionary *clientInfo;
 @property (nonatomic, copy, readwrite, nonnull) NSDictionary *defaultClientInfo;
@@ -21,11 +23,17 @@
 
 @property (nonatomic, copy, readonly, nullable) NSString *credentialIdentifier;
 
+// Restored accounts are lightweight until their client or authenticator is first needed.
+@property (nonatomic, readonly, getter = isMaterialized) BOOL materialized;
+
 - (nonnull NSURL *)baseURL;
 
 - (void)fetchPersonWithCompletionHandler:(nullable NBGenericCompletionHandler)completionHandler;
 - (void)fetchAvatarWithCompletionHandler:(nullable NBGenericCompletionHandler)completionHandler;
 
 - (BOOL)updateCredentialIdentifier;
+// Gives the client the saved credential without activating, ie. to search an
+// account that isn't selected. NO if the account isn't signed in.
+- (BOOL)prepareClientWithSavedCredential;
 
 @end
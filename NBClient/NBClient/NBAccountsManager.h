@@ -12,6 +12,20 @@
 
 #import "NBAccount.h"
 
+@class NBClientTaskGroup;
+@class NBPaginationInfo;
+
+// Each person found by a search across accounts is labeled with its nation.
+extern NSString * __nonnull const NBAccountsManagerSearchNationSlugKey;
+extern NSUInteger const NBAccountsManagerSearchDefaultMaximumNumberOfConcurrentSearches;
+
+// Called as each account's search finishes, with its labeled results, the
+// pagination info for fetching more from that account, and all results so far.
+typedef void (^NBAccountsManagerSearchResultsHandler)(NBAccount * __nonnull account, NSArray * __nullable items, NBPaginationInfo * __nullable paginationInfo, NSArray * __nonnull mergedItems, NSError * __nullable error);
+// If any account's search failed, the error has code
+// `NBClientErrorCodePartialResults` and errors by nation slug.
+typedef void (^NBAccountsManagerSearchCompletionHandler)(NSArray * __nonnull mergedItems, NSError * __nullable error);
+
 // The account manager builds on top of the account model, and unlike the lower
 // level classes, it relies on delegation to integrate with other classes, ie. the
 // app delegate. It provides a simpler interface than manually managing one or more
@@ -24,4 +38,20 @@
 - (nonnull instancetype)initWithClientInfo:(nullable NSDictionary *)clientInfoOrNil
                                   delegate:(nonnull id<NBAccountsManagerDelegate>)delegate;
 
+#pragma mark - Search
+
+// GET /people/search, for every signed-in account, selected or not
+// Searches all signed-in nations at once, up to the given number at a time,
+// instead of one after another, so the total wait is that of the slowest
+// nation. Results are merged as each nation's arrive, in order of arrival,
+// or, given a comparator, in sorted order. Only the page size of the
+// pagination info is used; each account starts at its first page. Cancel the
+// returned group to cancel all searches, including those not yet started.
+- (nonnull NBClientTaskGroup *)searchPeopleInAllAccountsByParameters:(nonnull NSDictionary *)parameters
+                                                  withPaginationInfo:(nullable NBPaginationInfo *)paginationInfo
+                                   maximumNumberOfConcurrentSearches:(NSUInteger)maximumNumberOfConcurrentSearches
+                                                     mergeComparator:(nullable NSComparator)mergeComparator
+                                                      resultsHandler:(nullable NBAccountsManagerSearchResultsHandler)resultsHandler
+                                                   completionHandler:(nonnull NBAccountsManagerSearchCompletionHandler)completionHandler;
+
 @end
@@ -11,6 +11,10 @@
 
 #import "FoundationAdditions.h"
 #import "NBAccount_Internal.h"
+#import "NBClient+Composites.h"
+#import "NBClient+People.h"
+#import "NBClientTaskGroup.h"
+#import "NBPaginationInfo.h"
 
 NSString * const NBAccountInfosDefaultsKey = @"NBAccountInfos";
 NSString * const NBAccountInfoIdentifierKey = @"User ID";
@@ -18,6 +22,12 @@ NSString * const NBAccountInfoNameKey = @"User Name";
 NSString * const NBAccountInfoNationSlugKey = @"Nation Slug";
 NSString * const NBAccountInfoSelectedKey = @"Selected";
 
+NSString * const NBAccountsManagerSearchNationSlugKey = @"nation_slug";
+NSUInteger const NBAccountsManagerSearchDefaultMaximumNumberOfConcurrentSearches = 4;
+
+static NSTimeInterval PersistenceCoalescingInterval = 0.5f;
+static void *PersistenceQueueKey = &PersistenceQueueKey;
+
 #if DEBUG
 static NBLogLevel LogLevel = NBLogLevelDebug;
 #else
@@ -65,6 +75,112 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     [NBAccount updateLoggingToLevel:logLevel];
 }
 
+#pragma mark - Search
+
+- (NBClientTaskGroup *)searchPeopleInAllAccountsByParameters:(NSDictionary *)parameters
+                                          withPaginationInfo:(NBPaginationInfo *)paginationInfo
+                           maximumNumberOfConcurrentSearches:(NSUInteger)maximumNumberOfConcurrentSearches
+                                             mergeComparator:(NSComparator)mergeComparator
+                                              resultsHandler:(NBAccountsManagerSearchResultsHandler)resultsHandler
+                                           completionHandler:(NBAccountsManagerSearchCompletionHandler)completionHandler
+{
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    maximumNumberOfConcurrentSearches = MAX(maximumNumberOfConcurrentSearches, (NSUInteger)1);
+    NSMutableArray *pendingAccounts = [NSMutableArray array];
+    // Restored accounts stay lightweight until selected, so materialize any
+    // that are signed in but inactive.
+    for (NBAccount *account in self.accounts) {
+        if ([account prepareClientWithSavedCredential]) {
+            [pendingAccounts addObject:account];
+        } else {
+            NBLogInfo(@"Skipping search of signed-out account for nation %@", account.nationSlug);
+        }
+    }
+    // Completion handlers are called on the main queue, so no locking is needed.
+    __block NSArray *mergedItems = @[];
+    NSUInteger numberOfAccounts = pendingAccounts.count;
+    __block NSUInteger remainingCount = numberOfAccounts;
+    NSMutableDictionary *accountErrors = [NSMutableDictionary dictionary];
+    void (^finishSearch)(void) = ^{
+        NSError *error;
+        if (accountErrors.count) {
+            error = [NSError
+                     errorWithDomain:NBErrorDomain code:NBClientErrorCodePartialResults
+                     userInfo:@{ NSLocalizedDescriptionKey: @"message.partial-results-error".nb_localizedString,
+                                 NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                    @"message.partial-results-error.format".nb_localizedString,
+                                                                    [accountErrors.allKeys componentsJoinedByString:@", "]],
+                                 NBClientErrorPartErrorsKey: [NSDictionary dictionaryWithDictionary:accountErrors] }];
+        }
+        NBLogInfo(@"Searched %lu account(s), found %lu people", (unsigned long)numberOfAccounts, (unsigned long)mergedItems.count);
+        completionHandler(mergedItems, error);
+    };
+    if (!remainingCount) {
+        dispatch_async(dispatch_get_main_queue(), finishSearch);
+        return taskGroup;
+    }
+    __block void (^searchNextAccount)(void);
+    searchNextAccount = ^{
+        if (!pendingAccounts.count) {
+            return;
+        }
+        NBAccount *account = pendingAccounts.firstObject;
+        [pendingAccounts removeObjectAtIndex:0];
+        NSString *nationSlug = account.nationSlug;
+        // Not shared, since each client updates its own.
+        NBPaginationInfo *pageInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:account.client.shouldUseLegacyPagination];
+        if (paginationInfo) {
+            pageInfo.numberOfItemsPerPage = paginationInfo.numberOfItemsPerPage;
+        }
+        NBClientResourceListCompletionHandler accountHandler = ^(NSArray *items, NBPaginationInfo *resultInfo, NSError *error) {
+            NSMutableArray *labeledItems;
+            if (error) {
+                accountErrors[nationSlug] = error;
+                if (error.nb_isCancellation) {
+                    // Skip the rest.
+                    NSError *cancelledError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+                    for (NBAccount *pendingAccount in pendingAccounts) {
+                        accountErrors[pendingAccount.nationSlug] = cancelledError;
+                    }
+                    remainingCount -= pendingAccounts.count;
+                    [pendingAccounts removeAllObjects];
+                }
+            } else if ([items isKindOfClass:[NSArray class]]) {
+                labeledItems = [NSMutableArray arrayWithCapacity:items.count];
+                for (NSDictionary *item in items) {
+                    NSMutableDictionary *labeledItem = item.mutableCopy;
+                    labeledItem[NBAccountsManagerSearchNationSlugKey] = nationSlug;
+                    [labeledItems addObject:labeledItem];
+                }
+                if (mergeComparator) {
+                    [labeledItems sortWithOptions:NSSortStable usingComparator:mergeComparator];
+                    mergedItems = [self.class mergedItems:mergedItems withSortedItems:labeledItems comparator:mergeComparator];
+                } else {
+                    mergedItems = [mergedItems arrayByAddingObjectsFromArray:labeledItems];
+                }
+            }
+            if (resultsHandler) {
+                resultsHandler(account, labeledItems, resultInfo, mergedItems, error);
+            }
+            remainingCount -= 1;
+            if (remainingCount) {
+                searchNextAccount();
+                return;
+            }
+            searchNextAccount = nil;
+            finishSearch();
+        };
+        NBClient *client = account.client;
+        [client performRequestsInTaskGroup:taskGroup usingBlock:^{
+            [client fetchPeopleByParameters:parameters withPaginationInfo:pageInfo completionHandler:accountHandler];
+        }];
+    };
+    for (NSUInteger i = 0; i < maximumNumberOfConcurrentSearches; i++) {
+        searchNextAccount();
+    }
+    return taskGroup;
+}
+
 #pragma mark - NBAccountsDataSource
 
 - (NSArray *)accounts
@@ -173,9 +289,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
             [self.delegate accountsManager:self didFailToSwitchToAccount:account withError:error];
             shouldBail = YES;
         } else {
+            // Compare what the credential identifier is made from, so restored
+            // accounts don't need their authenticators created.
             for (NBAccount *existingAccount in self.accounts) {
-                if (existingAccount != account &&
-                    existingAccount.credentialIdentifier == account.credentialIdentifier) {
+                if (existingAccount != account && existingAccount.identifier == account.identifier &&
+                    [existingAccount.nationSlug isEqualToString:account.nationSlug]) {
                     shouldBail = YES;
                     break;
                 }
@@ -223,6 +341,23 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                                         delegate:self];
 }
 
++ (NSArray *)mergedItems:(NSArray *)items withSortedItems:(NSArray *)otherItems comparator:(NSComparator)comparator
+{
+    NSMutableArray *mergedItems = [NSMutableArray arrayWithCapacity:items.count + otherItems.count];
+    NSUInteger index = 0, otherIndex = 0;
+    while (index < items.count && otherIndex < otherItems.count) {
+        // Ties keep earlier arrivals first.
+        if (comparator(otherItems[otherIndex], items[index]) == NSOrderedAscending) {
+            [mergedItems addObject:otherItems[otherIndex++]];
+        } else {
+            [mergedItems addObject:items[index++]];
+        }
+    }
+    [mergedItems addObjectsFromArray:[items subarrayWithRange:NSMakeRange(index, items.count - index)]];
+    [mergedItems addObjectsFromArray:[otherItems subarrayWithRange:NSMakeRange(otherIndex, otherItems.count - otherIndex)]];
+    return [NSArray arrayWithArray:mergedItems];
+}
+
 #pragma mark Account Persistence
 
 - (void)setUpAccountPersistence
@@ -237,6 +372,8 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     }
     if (!self.shouldPersistAccounts) { return; }
     // Continue.
+    self.persistenceQueue = dispatch_queue_create("com.nationbuilder.accounts-persistence", DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(self.persistenceQueue, PersistenceQueueKey, (__bridge void *)self.persistenceQueue, NULL);
     self.persistedAccountsIdentifier = (self.persistedAccountsIdentifier
                                         ?: [NSString stringWithFormat:@"%@-%@",
                                             NBAccountInfosDefaultsKey, NSStringFromClass(self.delegate.class)]);
@@ -247,7 +384,9 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
      object:[UIApplication sharedApplication] queue:[NSOperationQueue mainQueue]
      usingBlock:^(NSNotification *note) {
          NSAssert(weakSelf, @"Account manager dereferenced before application received termination signal.");
+         // Don't wait for coalescing, since we may not get another chance.
          [weakSelf persistAccounts];
+         [weakSelf flushPersistedAccounts];
      }];
 }
 
@@ -255,13 +394,18 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 {
     if (!self.shouldPersistAccounts) { return; }
     [[NSNotificationCenter defaultCenter] removeObserver:self.applicationDidEnterBackgroundObserver];
+    [self flushPersistedAccounts];
 }
 
 - (void)loadPersistedAccounts
 {
     if (!self.shouldPersistAccounts) { return; }
+    // Make sure any pending writes land before reading.
+    [self flushPersistedAccounts];
     NSArray *accountInfos = [[NSUserDefaults standardUserDefaults] arrayForKey:self.persistedAccountsIdentifier];
     if (accountInfos) {
+        // Only restore lightweight accounts. Their clients, authenticators, and
+        // credentials get created when they're selected or otherwise used.
         NBAccount *selectedAccount;
         for (NSDictionary *accountInfo in accountInfos) {
             NBAccount *account = [self createAccountWithNationSlug:accountInfo[NBAccountInfoNationSlugKey]];
@@ -286,7 +430,6 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 - (void)persistAccounts
 {
     if (!self.shouldPersistAccounts) { return; }
-    NSArray *existingAccountInfos = [[NSUserDefaults standardUserDefaults] arrayForKey:self.persistedAccountsIdentifier];
     NSMutableArray *accountInfos = [NSMutableArray array];
     for (NBAccount *account in self.accounts) {
         if (!account.name) { continue; }
@@ -295,13 +438,60 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                                    NBAccountInfoNationSlugKey: account.nationSlug,
                                    NBAccountInfoSelectedKey: @(account == self.selectedAccount) }];
     }
-    [[NSUserDefaults standardUserDefaults] setObject:accountInfos forKey:self.persistedAccountsIdentifier];
+    // Coalesce: only the latest snapshot gets written, off the main queue.
+    BOOL needsScheduling;
+    @synchronized (self) {
+        needsScheduling = !self.pendingAccountInfos;
+        self.pendingAccountInfos = accountInfos;
+    }
+    if (!needsScheduling) { return; }
+    __weak __typeof(self)weakSelf = self;
+    NSString *identifier = self.persistedAccountsIdentifier;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(PersistenceCoalescingInterval * NSEC_PER_SEC)),
+                   self.persistenceQueue, ^{
+        [NBAccountsManager writeAccountInfos:[weakSelf dequeuePendingAccountInfos] forIdentifier:identifier];
+    });
+}
+
+- (void)flushPersistedAccounts
+{
+    if (!self.shouldPersistAccounts) { return; }
+    NSArray *accountInfos = [self dequeuePendingAccountInfos];
+    NSString *identifier = self.persistedAccountsIdentifier;
+    if (dispatch_get_specific(PersistenceQueueKey) == (__bridge void *)self.persistenceQueue) {
+        // The coalesced write can hold the last reference, so we can get
+        // deallocated on the queue, where syncing onto it would deadlock.
+        [NBAccountsManager writeAccountInfos:accountInfos forIdentifier:identifier];
+        return;
+    }
+    // Also waits for any in-progress write.
+    dispatch_sync(self.persistenceQueue, ^{
+        [NBAccountsManager writeAccountInfos:accountInfos forIdentifier:identifier];
+    });
+}
+
+- (NSArray *)dequeuePendingAccountInfos
+{
+    NSArray *accountInfos;
+    @synchronized (self) {
+        accountInfos = self.pendingAccountInfos;
+        self.pendingAccountInfos = nil;
+    }
+    return accountInfos;
+}
+
++ (void)writeAccountInfos:(NSArray *)accountInfos forIdentifier:(NSString *)identifier
+{
+    if (!accountInfos) { return; }
+    NSUserDefaults *defaults = [NSUserDefaults standardUserDefaults];
+    NSArray *existingAccountInfos = [defaults arrayForKey:identifier];
+    [defaults setObject:accountInfos forKey:identifier];
     BOOL immediately = accountInfos.count != existingAccountInfos.count;
     if (immediately) {
-        [[NSUserDefaults standardUserDefaults] synchronize];
+        [defaults synchronize];
     }
     NBLogInfo(@"Persisted %lu persisted account(s) for identifier \"%@\" immediately (%d)",
-              (unsigned long)accountInfos.count, self.persistedAccountsIdentifier, immediately);
+              (unsigned long)accountInfos.count, identifier, immediately);
 }
 
 @end
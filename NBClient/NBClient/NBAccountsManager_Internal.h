@@ -23,15 +23,24 @@
 @property (nonatomic, nullable) id applicationDidBecomeActiveObserver;
 @property (nonatomic, nullable) id applicationDidEnterBackgroundObserver;
 @property (nonatomic, copy, nonnull) NSString *persistedAccountsIdentifier;
+@property (nonatomic, nullable) dispatch_queue_t persistenceQueue;
+@property (nonatomic, copy, nullable) NSArray *pendingAccountInfos;
 
 - (void)activateAccount:(nonnull NBAccount *)account;
 - (void)deactivateAccount:(nonnull NBAccount *)account;
 - (nonnull NSDictionary *)clientInfoForAccountWithNationSlug:(nonnull NSString *)nationSlug;
 - (nonnull NBAccount *)createAccountWithNationSlug:(nonnull NSString *)nationSlug;
+// Merges in linear time. Both must be sorted.
++ (nonnull NSArray *)mergedItems:(nonnull NSArray *)items
+                 withSortedItems:(nonnull NSArray *)otherItems
+                      comparator:(nonnull NSComparator)comparator;
 
 - (void)setUpAccountPersistence;
 - (void)tearDownAccountPersistence;
 - (void)loadPersistedAccounts;
-- (void)persistAccounts;
+- (void)persistAccounts; // Coalesced and written in the background.
+- (void)flushPersistedAccounts;
+- (nullable NSArray *)dequeuePendingAccountInfos;
++ (void)writeAccountInfos:(nullable NSArray *)accountInfos forIdentifier:(nonnull NSString *)identifier;
 
 @end
@@ -0,0 +1,97 @@
+//
+//  NBClient+Composites.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClient.h"
+
+@class NBClientTaskGroup;
+
+// Composites combine several endpoint requests into one result. Independent
+// parts are requested together instead of one after another, so the total
+// latency is that of the slowest part, not the sum of all parts.
+
+extern NSUInteger const NBClientErrorCodePartialResults;
+extern NSString * __nonnull const NBClientErrorPartErrorsKey; // Dictionary of part keys to errors.
+
+extern NSString * __nonnull const NBClientPersonProfilePersonKey;
+extern NSString * __nonnull const NBClientPersonProfileTaggingsKey;
+extern NSString * __nonnull const NBClientPersonProfileCapitalsKey;
+extern NSString * __nonnull const NBClientPersonProfileContactsKey;
+
+// Keys for person write composites. Only the person parameters are required.
+extern NSString * __nonnull const NBClientPersonCompositePersonKey; // Dictionary, as for `-createPersonWithParameters:`.
+extern NSString * __nonnull const NBClientPersonCompositeTaggingInfoKey; // Dictionary, as for `-createPersonTaggingsByIdentifier:`.
+extern NSString * __nonnull const NBClientPersonCompositeListIdentifiersKey; // Array of list identifiers.
+extern NSString * __nonnull const NBClientPersonCompositeNoteInfoKey; // Dictionary, as for `-createPersonPrivateNoteByIdentifier:`.
+// Results only: list identifiers the person was successfully added to.
+extern NSString * __nonnull const NBClientPersonCompositeListingsKey;
+// Error user info only: `YES` if the created person was deleted after a failure.
+extern NSString * __nonnull const NBClientErrorRolledBackKey;
+// Error user info only: the error deleting the created person, if rolling back failed.
+extern NSString * __nonnull const NBClientErrorRollbackErrorKey;
+
+// Metrics, in seconds since the composite started.
+extern NSString * __nonnull const NBClientCompositeLatencyKey; // The critical path, ie. the slowest part.
+extern NSString * __nonnull const NBClientCompositePartLatenciesKey; // Dictionary of part keys to latencies.
+
+extern NSTimeInterval const NBClientCompositeDefaultPartTimeout;
+extern NSUInteger const NBClientCompositeDefaultMaximumNumberOfConcurrentPages;
+
+// Called as each part finishes, so results can be shown progressively.
+typedef void (^NBClientCompositePartHandler)(NSString * __nonnull partKey, id __nullable result, NSError * __nullable error);
+// The results include every part that succeeded, along with the metrics. If any
+// part failed, the error has code `NBClientErrorCodePartialResults`.
+typedef void (^NBClientCompositeCompletionHandler)(NSDictionary * __nullable results, NSError * __nullable error);
+// Requests one page, ie. by calling `-fetchPeopleWithPaginationInfo:completionHandler:`.
+typedef NSURLSessionDataTask * __nullable (^NBClientPageFetcher)(NBPaginationInfo * __nonnull paginationInfo, NBClientResourceListCompletionHandler __nonnull completionHandler);
+
+@interface NBClient (Composites)
+
+#pragma mark - Fetch
+
+// GET /people/:id
+// GET /people/:id/taggings
+// GET /people/:id/capitals
+// GET /people/:id/contacts
+// Parts that don't finish within the part timeout fail with a timed-out error.
+// Cancel the returned group to cancel all parts.
+- (nonnull NBClientTaskGroup *)fetchPersonProfileByIdentifier:(NSUInteger)identifier
+                                                  partTimeout:(NSTimeInterval)partTimeout
+                                                  partHandler:(nullable NBClientCompositePartHandler)partHandler
+                                            completionHandler:(nonnull NBClientCompositeCompletionHandler)completionHandler;
+
+#pragma mark - Write
+
+// POST /people
+// Then, together, once the person's identifier is known:
+// PUT /people/:id/taggings
+// POST /lists/:id/people
+// POST /people/:person_id/notes
+// If any step fails, the whole composite is reported as partial, or, if
+// `shouldRollBack` is set, the person is deleted (undoing the other steps) and
+// the error says so. The person's own parameters are not timed out.
+- (nonnull NBClientTaskGroup *)createPersonWithCompositeInfo:(nonnull NSDictionary *)compositeInfo
+                                                  partTimeout:(NSTimeInterval)partTimeout
+                                               shouldRollBack:(BOOL)shouldRollBack
+                                            completionHandler:(nonnull NBClientCompositeCompletionHandler)completionHandler;
+
+#pragma mark - Pages
+
+// Fetches every page from the given one onwards, and calls back once with all
+// the items in page order and the last page's pagination info. With legacy
+// pagination, the total number of pages is known after the first page, so the
+// rest are requested together, up to the given number at a time (and within
+// any session provider limits), then reassembled in order. Token pagination
+// can only follow its next links, so those pages are requested one after
+// another. The first failing page cancels the rest. Cancel the returned group
+// to cancel all pages. Called inside `-performRequestsInTaskGroup:usingBlock:`,
+// every page also joins that group.
+- (nonnull NBClientTaskGroup *)fetchAllPagesWithPaginationInfo:(nonnull NBPaginationInfo *)paginationInfo
+                                maximumNumberOfConcurrentPages:(NSUInteger)maximumNumberOfConcurrentPages
+                                                   pageFetcher:(nonnull NBClientPageFetcher)pageFetcher
+                                             completionHandler:(nonnull NBClientResourceListCompletionHandler)completionHandler;
+
+@end
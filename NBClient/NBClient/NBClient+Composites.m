@@ -0,0 +1,334 @@
+//
+//  NBClient+Composites.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClient+Composites.h"
+
+#import "FoundationAdditions.h"
+#import "NBClient+Contacts.h"
+#import "NBClient+Lists.h"
+#import "NBClient+People.h"
+#import "NBClientTaskGroup.h"
+#import "NBClient_Internal.h"
+#import "NBPaginationInfo.h"
+
+NSUInteger const NBClientErrorCodePartialResults = 11;
+NSString * const NBClientErrorPartErrorsKey = @"part_errors";
+
+NSString * const NBClientPersonProfilePersonKey = @"person";
+NSString * const NBClientPersonProfileTaggingsKey = @"taggings";
+NSString * const NBClientPersonProfileCapitalsKey = @"capitals";
+NSString * const NBClientPersonProfileContactsKey = @"contacts";
+
+NSString * const NBClientPersonCompositePersonKey = @"person";
+NSString * const NBClientPersonCompositeTaggingInfoKey = @"tagging_info";
+NSString * const NBClientPersonCompositeListIdentifiersKey = @"list_ids";
+NSString * const NBClientPersonCompositeNoteInfoKey = @"note_info";
+NSString * const NBClientPersonCompositeListingsKey = @"listings";
+NSString * const NBClientErrorRolledBackKey = @"rolled_back";
+NSString * const NBClientErrorRollbackErrorKey = @"rollback_error";
+
+static NSString *PersonCompositeTaggingsPartKey = @"taggings";
+static NSString *PersonCompositeNotePartKey = @"note";
+static NSString *PersonCompositeListingPartKeyPrefix = @"listing:";
+
+NSString * const NBClientCompositeLatencyKey = @"latency";
+NSString * const NBClientCompositePartLatenciesKey = @"part_latencies";
+
+NSTimeInterval const NBClientCompositeDefaultPartTimeout = 10.0f;
+NSUInteger const NBClientCompositeDefaultMaximumNumberOfConcurrentPages = 4;
+
+// Starts the part's request, which calls back when done.
+typedef NSURLSessionDataTask * __nullable (^NBClientCompositePart)(void (^ __nonnull partCompletionHandler)(id __nullable result, NSError * __nullable error));
+
+@implementation NBClient (Composites)
+
+#pragma mark - Fetch
+
+- (NBClientTaskGroup *)fetchPersonProfileByIdentifier:(NSUInteger)identifier
+                                          partTimeout:(NSTimeInterval)partTimeout
+                                          partHandler:(NBClientCompositePartHandler)partHandler
+                                    completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    NSDictionary *parts =
+    @{ NBClientPersonProfilePersonKey: ^(void (^done)(id, NSError *)) {
+           return [self fetchPersonByIdentifier:identifier withCompletionHandler:^(NSDictionary *item, NSError *error) {
+               done(item, error);
+           }];
+       },
+       NBClientPersonProfileTaggingsKey: ^(void (^done)(id, NSError *)) {
+           return [self fetchPersonTaggingsByIdentifier:identifier withCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+               done(items, error);
+           }];
+       },
+       NBClientPersonProfileCapitalsKey: ^(void (^done)(id, NSError *)) {
+           return [self fetchPersonCapitalsByIdentifier:identifier withPaginationInfo:nil completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+               done(items, error);
+           }];
+       },
+       NBClientPersonProfileContactsKey: ^(void (^done)(id, NSError *)) {
+           return [self fetchPersonContactsByIdentifier:identifier withPaginationInfo:nil completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+               done(items, error);
+           }];
+       } };
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    [self performCompositeParts:parts inTaskGroup:taskGroup partTimeout:partTimeout
+                    partHandler:partHandler completionHandler:completionHandler];
+    return taskGroup;
+}
+
+#pragma mark - Write
+
+- (NBClientTaskGroup *)createPersonWithCompositeInfo:(NSDictionary *)compositeInfo
+                                         partTimeout:(NSTimeInterval)partTimeout
+                                      shouldRollBack:(BOOL)shouldRollBack
+                                   completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    NSAssert(compositeInfo[NBClientPersonCompositePersonKey], @"Person parameters are required.");
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    void (^createHandler)(NSDictionary *, NSError *) = ^(NSDictionary *person, NSError *error) {
+        if (error || !person[@"id"]) {
+            // Nothing to roll back.
+            completionHandler(nil, error);
+            return;
+        }
+        NSUInteger identifier = [person[@"id"] unsignedIntegerValue];
+        // Step 2: Decorate the new person concurrently.
+        NSMutableDictionary *parts = [NSMutableDictionary dictionary];
+        NSDictionary *taggingInfo = compositeInfo[NBClientPersonCompositeTaggingInfoKey];
+        if (taggingInfo) {
+            parts[PersonCompositeTaggingsPartKey] = ^(void (^done)(id, NSError *)) {
+                return [self createPersonTaggingsByIdentifier:identifier withTaggingInfo:taggingInfo completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+                    done(items, error);
+                }];
+            };
+        }
+        for (NSNumber *listIdentifier in compositeInfo[NBClientPersonCompositeListIdentifiersKey]) {
+            NSString *partKey = [PersonCompositeListingPartKeyPrefix stringByAppendingString:listIdentifier.stringValue];
+            parts[partKey] = ^(void (^done)(id, NSError *)) {
+                return [self createPeopleListingsByIdentifier:listIdentifier.unsignedIntegerValue withPeopleIdentifiers:@[ person[@"id"] ] completionHandler:^(NSDictionary *item, NSError *error) {
+                    done(error ? nil : listIdentifier, error);
+                }];
+            };
+        }
+        NSDictionary *noteInfo = compositeInfo[NBClientPersonCompositeNoteInfoKey];
+        if (noteInfo) {
+            parts[PersonCompositeNotePartKey] = ^(void (^done)(id, NSError *)) {
+                return [self createPersonPrivateNoteByIdentifier:identifier withNoteInfo:noteInfo completionHandler:^(NSDictionary *item, NSError *error) {
+                    done(item, error);
+                }];
+            };
+        }
+        [self performCompositeParts:parts inTaskGroup:taskGroup partTimeout:partTimeout partHandler:nil completionHandler:^(NSDictionary *partResults, NSError *error) {
+            // Step 3: Merge, then optionally roll back.
+            NSMutableDictionary *results = [NSMutableDictionary dictionary];
+            NSMutableArray *listings = [NSMutableArray array];
+            [partResults enumerateKeysAndObjectsUsingBlock:^(NSString *key, id result, BOOL *stop) {
+                if ([key hasPrefix:PersonCompositeListingPartKeyPrefix]) {
+                    [listings addObject:result];
+                } else {
+                    results[key] = result;
+                }
+            }];
+            results[NBClientPersonCompositePersonKey] = person;
+            results[NBClientPersonCompositeListingsKey] = [NSArray arrayWithArray:listings];
+            results[NBClientCompositeLatencyKey] = @(CFAbsoluteTimeGetCurrent() - startTime);
+            if (!error || !shouldRollBack) {
+                completionHandler([NSDictionary dictionaryWithDictionary:results], error);
+                return;
+            }
+            [self deletePersonByIdentifier:identifier withCompletionHandler:^(NSDictionary *item, NSError *deleteError) {
+                NSMutableDictionary *userInfo = error.userInfo.mutableCopy;
+                userInfo[NBClientErrorRolledBackKey] = @(!deleteError);
+                if (deleteError) {
+                    userInfo[NBClientErrorRollbackErrorKey] = deleteError;
+                }
+                completionHandler(deleteError ? [NSDictionary dictionaryWithDictionary:results] : nil,
+                                  [NSError errorWithDomain:error.domain code:error.code userInfo:userInfo]);
+            }];
+        }];
+    };
+    // Step 1: Create the person.
+    [self performRequestsInTaskGroup:taskGroup usingBlock:^{
+        [self createPersonWithParameters:compositeInfo[NBClientPersonCompositePersonKey] completionHandler:createHandler];
+    }];
+    return taskGroup;
+}
+
+#pragma mark - Pages
+
+- (NBClientTaskGroup *)fetchAllPagesWithPaginationInfo:(NBPaginationInfo *)paginationInfo
+                        maximumNumberOfConcurrentPages:(NSUInteger)maximumNumberOfConcurrentPages
+                                           pageFetcher:(NBClientPageFetcher)pageFetcher
+                                     completionHandler:(NBClientResourceListCompletionHandler)completionHandler
+{
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    // Later pages are requested outside the caller's block, so they're added to its group too.
+    NBClientTaskGroup *callerTaskGroup = self.currentTaskGroup;
+    maximumNumberOfConcurrentPages = MAX(maximumNumberOfConcurrentPages, (NSUInteger)1);
+    // Completion handlers are called on the main queue, so no locking is needed.
+    NSMutableArray *allItems = [NSMutableArray array];
+    void (^fetchPage)(NBPaginationInfo *, NBClientResourceListCompletionHandler) = ^(NBPaginationInfo *pageInfo, NBClientResourceListCompletionHandler handler) {
+        [self performRequestsInTaskGroup:taskGroup usingBlock:^{
+            NSURLSessionDataTask *task = pageFetcher(pageInfo, handler);
+            if (task) {
+                [callerTaskGroup addTask:task];
+            }
+        }];
+    };
+    // Token pagination: follow the next links.
+    __block NBClientResourceListCompletionHandler nextPageHandler;
+    nextPageHandler = ^(NSArray *items, NBPaginationInfo *nextInfo, NSError *error) {
+        if (error) {
+            nextPageHandler = nil;
+            completionHandler(nil, nil, error);
+            return;
+        }
+        [allItems addObjectsFromArray:items];
+        if (!nextInfo || nextInfo.isLegacy || nextInfo.isLastPage) {
+            nextPageHandler = nil;
+            completionHandler([NSArray arrayWithArray:allItems], nextInfo, nil);
+            return;
+        }
+        nextInfo.currentDirection = NBPaginationDirectionNext;
+        fetchPage(nextInfo, nextPageHandler);
+    };
+    // Legacy pagination: fan out the remaining page numbers.
+    void (^fetchRemainingPages)(NBPaginationInfo *) = ^(NBPaginationInfo *firstInfo) {
+        NSUInteger firstPageNumber = firstInfo.currentPageNumber + 1;
+        NSUInteger lastPageNumber = firstInfo.numberOfTotalPages;
+        NSMutableDictionary *itemsByPageNumber = [NSMutableDictionary dictionary];
+        __block NSUInteger nextPageNumber = firstPageNumber;
+        __block NSUInteger remainingPageCount = lastPageNumber - firstPageNumber + 1;
+        __block NBPaginationInfo *lastInfo = firstInfo;
+        __block BOOL didFail = NO;
+        __block void (^fetchNextPage)(void);
+        fetchNextPage = ^{
+            if (nextPageNumber > lastPageNumber) {
+                return;
+            }
+            NSUInteger pageNumber = nextPageNumber;
+            nextPageNumber += 1;
+            NBPaginationInfo *pageInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+            pageInfo.currentPageNumber = pageNumber;
+            pageInfo.numberOfItemsPerPage = firstInfo.numberOfItemsPerPage;
+            fetchPage(pageInfo, ^(NSArray *items, NBPaginationInfo *resultInfo, NSError *error) {
+                if (didFail) {
+                    return;
+                }
+                if (error) {
+                    didFail = YES;
+                    fetchNextPage = nil;
+                    [taskGroup cancel];
+                    completionHandler(nil, nil, error);
+                    return;
+                }
+                itemsByPageNumber[@(pageNumber)] = items ?: @[];
+                if (pageNumber == lastPageNumber && resultInfo) {
+                    lastInfo = resultInfo;
+                }
+                remainingPageCount -= 1;
+                if (remainingPageCount) {
+                    fetchNextPage();
+                    return;
+                }
+                fetchNextPage = nil;
+                for (NSUInteger number = firstPageNumber; number <= lastPageNumber; number++) {
+                    [allItems addObjectsFromArray:itemsByPageNumber[@(number)]];
+                }
+                completionHandler([NSArray arrayWithArray:allItems], lastInfo, nil);
+            });
+        };
+        for (NSUInteger i = 0; i < maximumNumberOfConcurrentPages; i++) {
+            fetchNextPage();
+        }
+    };
+    NBClientResourceListCompletionHandler firstPageHandler = ^(NSArray *items, NBPaginationInfo *firstInfo, NSError *error) {
+        if (!error && firstInfo.isLegacy && firstInfo.currentPageNumber < firstInfo.numberOfTotalPages) {
+            [allItems addObjectsFromArray:items];
+            nextPageHandler = nil;
+            fetchRemainingPages(firstInfo);
+            return;
+        }
+        nextPageHandler(items, firstInfo, error);
+    };
+    fetchPage(paginationInfo, firstPageHandler);
+    return taskGroup;
+}
+
+#pragma mark - Private
+
+- (void)performCompositeParts:(NSDictionary *)parts
+                  inTaskGroup:(NBClientTaskGroup *)taskGroup
+                  partTimeout:(NSTimeInterval)partTimeout
+                  partHandler:(NBClientCompositePartHandler)partHandler
+            completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    // Completion handlers are called on the main queue, so no locking is needed.
+    NSMutableDictionary *results = [NSMutableDictionary dictionary];
+    NSMutableDictionary *partErrors = [NSMutableDictionary dictionary];
+    NSMutableDictionary *partLatencies = [NSMutableDictionary dictionary];
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    __block NSUInteger remainingPartCount = parts.count;
+    void (^finishComposite)(void) = ^{
+        NSTimeInterval latency = CFAbsoluteTimeGetCurrent() - startTime;
+        results[NBClientCompositeLatencyKey] = @(latency);
+        results[NBClientCompositePartLatenciesKey] = [NSDictionary dictionaryWithDictionary:partLatencies];
+        NSError *error;
+        if (partErrors.count) {
+            error = [NSError
+                     errorWithDomain:NBErrorDomain code:NBClientErrorCodePartialResults
+                     userInfo:@{ NSLocalizedDescriptionKey: @"message.partial-results-error".nb_localizedString,
+                                 NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                    @"message.partial-results-error.format".nb_localizedString,
+                                                                    [partErrors.allKeys componentsJoinedByString:@", "]],
+                                 NBClientErrorPartErrorsKey: [NSDictionary dictionaryWithDictionary:partErrors] }];
+        }
+        completionHandler([NSDictionary dictionaryWithDictionary:results], error);
+    };
+    if (!parts.count) {
+        dispatch_async(dispatch_get_main_queue(), finishComposite);
+        return;
+    }
+    [parts enumerateKeysAndObjectsUsingBlock:^(NSString *partKey, NBClientCompositePart part, BOOL *stop) {
+        __block BOOL isPartFinished = NO;
+        void (^finishPart)(id, NSError *) = ^(id result, NSError *error) {
+            if (isPartFinished) {
+                return; // Already timed out.
+            }
+            isPartFinished = YES;
+            partLatencies[partKey] = @(CFAbsoluteTimeGetCurrent() - startTime);
+            if (error) {
+                partErrors[partKey] = error;
+            } else if (result) {
+                results[partKey] = result;
+            }
+            if (partHandler) {
+                partHandler(partKey, result, error);
+            }
+            remainingPartCount -= 1;
+            if (!remainingPartCount) {
+                finishComposite();
+            }
+        };
+        __block NSURLSessionDataTask *task;
+        [self performRequestsInTaskGroup:taskGroup usingBlock:^{
+            task = part(finishPart);
+        }];
+        if (partTimeout > 0) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(partTimeout * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+                if (isPartFinished) {
+                    return;
+                }
+                finishPart(nil, [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil]);
+                [task cancel];
+            });
+        }
+    }];
+}
+
+@end
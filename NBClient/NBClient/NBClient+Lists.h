@@ -28,11 +28,13 @@
                                             completionHandler:(nonnull NBClientResourceListCompletionHandler)completionHandler;
 
 // POST /lists/:id/people
+// Large numbers of people are streamed. See `bodyStreamingThreshold`.
 - (nullable NSURLSessionDataTask *)createPeopleListingsByIdentifier:(NSUInteger)listIdentifier
                                               withPeopleIdentifiers:(nonnull NSArray *)peopleIdentifiers
                                                   completionHandler:(nonnull NBClientResourceItemCompletionHandler)completionHandler;
 
 // DELETE /lists/:id/people
+// Large numbers of people are streamed. See `bodyStreamingThreshold`.
 - (nullable NSURLSessionDataTask *)deletePeopleListingsByIdentifier:(NSUInteger)listIdentifier
                                               withPeopleIdentifiers:(nonnull NSArray *)peopleIdentifiers
                                                   completionHandler:(nonnull NBClientResourceItemCompletionHandler)completionHandler;
@@ -32,8 +32,12 @@
                                      withPeopleIdentifiers:(NSArray *)peopleIdentifiers
                                          completionHandler:(NBClientResourceItemCompletionHandler)completionHandler
 {
-    return [self createByResourceSubPath:[NSString stringWithFormat:@"/lists/%lu/people", (unsigned long)listIdentifier]
-                          withParameters:@{ @"people_ids": peopleIdentifiers } resultsKey:nil completionHandler:completionHandler];
+    __block NSURLSessionDataTask *task;
+    [self performBulkRequestsUsingBlock:^{
+        task = [self createByResourceSubPath:[NSString stringWithFormat:@"/lists/%lu/people", (unsigned long)listIdentifier]
+                              withParameters:@{ @"people_ids": peopleIdentifiers } resultsKey:nil completionHandler:completionHandler];
+    }];
+    return task;
 }
 
 // TODO: Deprecate to use NBClientEmptyCompletionHandler.
@@ -41,8 +45,12 @@
                                      withPeopleIdentifiers:(NSArray *)peopleIdentifiers
                                          completionHandler:(NBClientResourceItemCompletionHandler)completionHandler
 {
-    return [self deleteByResourceSubPath:[NSString stringWithFormat:@"/lists/%lu/people", (unsigned long)listIdentifier]
-                          withParameters:@{ @"people_ids": peopleIdentifiers } resultsKey:nil completionHandler:completionHandler];
+    __block NSURLSessionDataTask *task;
+    [self performBulkRequestsUsingBlock:^{
+        task = [self deleteByResourceSubPath:[NSString stringWithFormat:@"/lists/%lu/people", (unsigned long)listIdentifier]
+                              withParameters:@{ @"people_ids": peopleIdentifiers } resultsKey:nil completionHandler:completionHandler];
+    }];
+    return task;
 }
 
 @end
@@ -7,6 +7,11 @@
 
 #import "NBClient.h"
 
+// Posted by a client once tags are applied to a person, ie. so a tag catalog
+// can learn new tags. The user info has the tag names under `NBClientTagNamesKey`.
+extern NSString * __nonnull const NBClientDidCreateTaggingsNotification;
+extern NSString * __nonnull const NBClientTagNamesKey;
+
 @interface NBClient (People)
 
 /**
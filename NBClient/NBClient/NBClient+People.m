@@ -11,6 +11,15 @@
 #import "NBPaginationInfo.h"
 #import "NBClient_Internal.h" // Only needed for a couple endpoints.
 
+NSString * const NBClientDidCreateTaggingsNotification = @"NBClientDidCreateTaggingsNotification";
+NSString * const NBClientTagNamesKey = @"tag_names";
+
+@interface NBClient (PeoplePrivate)
+
+- (void)postDidCreateTaggingsNotificationWithTaggingInfo:(NSDictionary *)taggingInfo;
+
+@end
+
 @implementation NBClient (People)
 
 #pragma mark - Fetch
@@ -84,7 +93,15 @@
                                         completionHandler:(NBClientResourceItemCompletionHandler)completionHandler
 {
     return [self saveByResourceSubPath:[NSString stringWithFormat:@"/people/%lu/taggings", (unsigned long)personIdentifier]
-                        withParameters:@{ @"tagging": taggingInfo } resultsKey:@"tagging" completionHandler:completionHandler];
+                        withParameters:@{ @"tagging": taggingInfo } resultsKey:@"tagging"
+                     completionHandler:^(NSDictionary *item, NSError *error) {
+                         if (item && !error) {
+                             [self postDidCreateTaggingsNotificationWithTaggingInfo:taggingInfo];
+                         }
+                         if (completionHandler) {
+                             completionHandler(item, error);
+                         }
+                     }];
 }
 
 - (NSURLSessionDataTask *)createPersonTaggingsByIdentifier:(NSUInteger)personIdentifier
@@ -92,7 +109,15 @@
                                          completionHandler:(NBClientResourceListCompletionHandler)completionHandler
 {
     return [self saveByResourceSubPath:[NSString stringWithFormat:@"/people/%lu/taggings", (unsigned long)personIdentifier]
-                        withParameters:@{ @"tagging": taggingInfo } resultsKey:@"taggings" completionHandler:completionHandler];
+                        withParameters:@{ @"tagging": taggingInfo } resultsKey:@"taggings"
+                     completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+                         if (!error && [items isKindOfClass:[NSArray class]]) {
+                             [self postDidCreateTaggingsNotificationWithTaggingInfo:taggingInfo];
+                         }
+                         if (completionHandler) {
+                             completionHandler(items, paginationInfo, error);
+                         }
+                     }];
 }
 
 // TODO: Deprecate to use NBClientEmptyCompletionHandler.
@@ -171,4 +196,17 @@
                           withParameters:nil resultsKey:nil completionHandler:completionHandler];
 }
 
+#pragma mark - Private
+
+- (void)postDidCreateTaggingsNotificationWithTaggingInfo:(NSDictionary *)taggingInfo
+{
+    id tagNameOrList = taggingInfo[NBClientTaggingTagNameOrListKey];
+    NSArray *tagNames = [tagNameOrList isKindOfClass:[NSArray class]] ? tagNameOrList : (tagNameOrList ? @[ tagNameOrList ] : @[]);
+    if (!tagNames.count) {
+        return;
+    }
+    [[NSNotificationCenter defaultCenter] postNotificationName:NBClientDidCreateTaggingsNotification object:self
+                                                      userInfo:@{ NBClientTagNamesKey: tagNames }];
+}
+
 @end
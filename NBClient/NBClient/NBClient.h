@@ -10,6 +10,10 @@
 #import "NBDefines.h"
 
 @class NBAuthenticator;
+@class NBClientPageSizer;
+@class NBClientSessionProvider;
+@class NBClientStringInternPool;
+@class NBClientTaskGroup;
 @class NBPaginationInfo;
 
 @protocol NBClientDelegate;
@@ -77,6 +81,10 @@ extern NSString * __nonnull const NBClientSurveyQuestionResponseIdentifierKey;
 @property (nonatomic, copy, readonly, nonnull) NSString *nationSlug;
 @property (nonatomic, readonly, nonnull) NSURLSession *urlSession;
 @property (nonatomic, readonly, nonnull) NSURLSessionConfiguration *sessionConfiguration;
+// Optional. Set this before making requests to share the provider's session
+// (and its connection pool and task limits) with other clients. Ignored if a
+// custom `urlSession` was passed in.
+@property (nonatomic, nullable) NBClientSessionProvider *sessionProvider;
 
 @property (nonatomic, readonly, nullable) NBAuthenticator *authenticator;
 
@@ -91,6 +99,25 @@ extern NSString * __nonnull const NBClientSurveyQuestionResponseIdentifierKey;
 @property (nonatomic) BOOL shouldUseLegacyPagination;
 // For a shorter query string, set this to `NO` if you're not a 'legacy' app.
 @property (nonatomic) BOOL shouldUseTokenPagination;
+// Bulk endpoints' request bodies, ie. for list edits, with at least this many
+// items are encoded as a stream, off the calling thread. Defaults to 1000. Set
+// to 0 to never stream.
+@property (nonatomic) NSUInteger bodyStreamingThreshold;
+// Gzip streamed bodies. Only for servers that accept gzip-encoded requests.
+// Defaults to `NO`.
+@property (nonatomic) BOOL shouldCompressStreamedBodies;
+// Records of list responses share one instance of each key and of each
+// repeated value, ie. state codes and tag names, through the intern pool. It
+// costs a pass over the parsed response, so it's worth it for large lists that
+// are kept, ie. synced people. Defaults to `NO`.
+@property (nonatomic) BOOL shouldInternStrings;
+// Created on first use. Can be shared between clients of the same nation, and
+// reports the bytes saved.
+@property (nonatomic, null_resettable) NBClientStringInternPool *stringInternPool;
+// If set, it sizes the pages of list requests from how their endpoints have
+// performed, overriding the pagination info's number of items per page, and
+// each page is recorded with it. Can be shared between clients. Defaults to nil.
+@property (nonatomic, nullable) NBClientPageSizer *pageSizer;
 
 #pragma mark - Initializers
 
@@ -111,6 +138,21 @@ extern NSString * __nonnull const NBClientSurveyQuestionResponseIdentifierKey;
                           customURLSession:(nullable NSURLSession *)urlSession
              customURLSessionConfiguration:(nullable NSURLSessionConfiguration *)sessionConfiguration;
 
+// Use this to start tasks the delegate chose not to start automatically, so
+// any session provider limits still apply.
+- (void)startDataTask:(nonnull NSURLSessionDataTask *)task;
+
+// For resources outside the API, ie. profile images, so they go through the
+// same session and session provider limits. The task joins the current task
+// group, and is started.
+- (nonnull NSURLSessionDataTask *)startDataTaskWithURL:(nonnull NSURL *)url
+                                     completionHandler:(nonnull void (^)(NSData * __nullable data, NSURLResponse * __nullable response, NSError * __nullable error))completionHandler;
+
+// Requests made in the block join the group, ie. so a data source can cancel
+// all its requests at once. Not thread-safe, like the rest of the client.
+- (void)performRequestsInTaskGroup:(nonnull NBClientTaskGroup *)taskGroup
+                        usingBlock:(nonnull dispatch_block_t)block;
+
 #pragma mark - Generic Endpoints
 
 // These are generic endpoint methods since NBClient doesn't attempt to provide
@@ -147,9 +189,10 @@ extern NSString * __nonnull const NBClientSurveyQuestionResponseIdentifierKey;
 // Implement this protocol to customize the general response and request
 // handling for a client, ie. do something before each request gets sent or
 // after each response gets received. Refer to the individual methods for more
-// details. If you don't pass a custom `urlSession`, this delegate will also be
-// the delegate for the default session and can conform to additional sub-
-// protocols: `NSURLSessionTaskDelegate`, `NSURLSessionDataDelegate`, etc.
+// details. If you don't pass a custom `urlSession`, the client forwards the
+// default session's delegate messages to this delegate, so it can conform to
+// additional sub-protocols: `NSURLSessionTaskDelegate`, `NSURLSessionDataDelegate`,
+// etc. Streamed bodies are still resent if it doesn't provide new body streams.
 @protocol NBClientDelegate <NSURLSessionDelegate>
 
 @optional
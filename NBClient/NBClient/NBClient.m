@@ -7,8 +7,16 @@
 
 #import "NBClient_Internal.h"
 
+#import <objc/runtime.h>
+
 #import "NBAuthenticator.h"
 #import "FoundationAdditions.h"
+#import "NBClientPageSizer.h"
+#import "NBClientSessionProvider.h"
+#import "NBClientStreamedBody.h"
+#import "NBClientStringInternPool.h"
+#import "NBClientTaskGroup.h"
+#import "NBClientTracer.h"
 #import "NBPaginationInfo.h"
 
 # pragma mark - External Constants
@@ -54,6 +62,9 @@ NSString * const NBClientSurveyQuestionResponseIdentifierKey = @"response";
 
 #pragma mark - Internal Constants
 
+static NSUInteger DefaultBodyStreamingThreshold = 1000;
+static void *TaskResumeTimeKey = &TaskResumeTimeKey;
+
 #if DEBUG
 static NBLogLevel LogLevel = NBLogLevelDebug;
 #else
@@ -108,11 +119,16 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     self.shouldIncludeKeyAsHeader = NO;
     self.shouldUseLegacyPagination = NO;
     self.shouldUseTokenPagination = YES;
+    self.bodyStreamingThreshold = DefaultBodyStreamingThreshold;
 }
 
 - (void)dealloc
 {
-    [self.urlSession invalidateAndCancel];
+    if (self.isUsingSessionProvider) {
+        [self.sessionProvider cancelTasksForClient:self];
+    } else {
+        [self.urlSession invalidateAndCancel];
+    }
 }
 
 #pragma mark - NBLogging
@@ -142,15 +158,22 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     if (_urlSession) {
         return _urlSession;
     }
-    id <NSURLSessionDelegate> delegate = self.delegate ? (id)self.delegate : self;
+    if (self.isUsingSessionProvider) {
+        // Not retained, since the provider releases its session when idle.
+        return self.sessionProvider.urlSession;
+    }
+    // The client forwards what it doesn't handle itself to its delegate.
     self.urlSession = [NSURLSession sessionWithConfiguration:self.sessionConfiguration
-                                                    delegate:delegate
+                                                    delegate:self
                                                delegateQueue:[NSOperationQueue mainQueue]];
     return _urlSession;
 }
 
 - (NSURLSessionConfiguration *)sessionConfiguration
 {
+    if (self.isUsingSessionProvider) {
+        return self.sessionProvider.sessionConfiguration;
+    }
     static NSURLCache *sharedCache;
     BOOL shouldUseDefaultCache = !_sessionConfiguration || !_sessionConfiguration.URLCache;
     if (shouldUseDefaultCache) {
@@ -172,6 +195,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     return _sessionConfiguration;
 }
 
+- (BOOL)isUsingSessionProvider
+{
+    return self.sessionProvider && !_urlSession;
+}
+
 - (void)setAuthenticator:(NBAuthenticator *)authenticator
 {
     _authenticator = authenticator;
@@ -210,6 +238,33 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     [self updateBaseURLComponents];
 }
 
+- (NBClientStringInternPool *)stringInternPool
+{
+    if (_stringInternPool) {
+        return _stringInternPool;
+    }
+    self.stringInternPool = [[NBClientStringInternPool alloc] init];
+    return _stringInternPool;
+}
+
+#pragma mark - Task Groups
+
+- (void)performRequestsInTaskGroup:(NBClientTaskGroup *)taskGroup usingBlock:(dispatch_block_t)block
+{
+    NBClientTaskGroup *previousTaskGroup = self.currentTaskGroup;
+    self.currentTaskGroup = taskGroup;
+    block();
+    self.currentTaskGroup = previousTaskGroup;
+}
+
+- (void)performBulkRequestsUsingBlock:(dispatch_block_t)block
+{
+    BOOL wasMakingBulkRequests = self.isMakingBulkRequests;
+    self.makingBulkRequests = YES;
+    block();
+    self.makingBulkRequests = wasMakingBulkRequests;
+}
+
 #pragma mark - Generic Endpoints
 
 - (NSURLSessionDataTask *)fetchByResourceSubPath:(NSString *)path
@@ -298,7 +353,13 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     if (self.shouldIncludeKeyAsHeader) {
         [request setValue:[NSString stringWithFormat:@"Bearer %@", self.apiKey] forHTTPHeaderField:@"Authorization"];
     }
-    if (parameters) {
+    NBClientStreamedBody *streamedBody = [self streamedBodyForParameters:parameters];
+    if (streamedBody) {
+        // Fails before sending, rather than once the body is half sent.
+        if (![streamedBody applyToRequest:request error:error]) {
+            return request;
+        }
+    } else if (parameters) {
         [request setHTTPBody:[NSJSONSerialization dataWithJSONObject:parameters options:0 error:error]];
     }
     if (self.delegate && [self.delegate respondsToSelector:@selector(client:willCreateDataTaskForRequest:)]) {
@@ -314,11 +375,19 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                                          paginationInfo:(NBPaginationInfo *)paginationInfo
                                       completionHandler:(id)completionHandler
 {
+    NBClientTracer *tracer = [NBClientTracer sharedTracer];
+    NBClientTraceSpan *span;
+    if (tracer.isEnabled) {
+        span = [tracer beginRequestSpanWithArguments:@{ @"method": method, @"path": components.path ?: @"" }];
+        [span beginStageWithName:NBClientTraceURLStageName];
+    }
+
     // Step 1: Finalize URL components.
     NSMutableDictionary *mutableParameters;
     if (paginationInfo) {
         // Add pagination query parameters.
         paginationInfo.legacy = self.shouldUseLegacyPagination;
+        [self.pageSizer updatePaginationInfo:paginationInfo forPath:components.path];
         mutableParameters = paginationInfo.queryParameters.mutableCopy;
         if (!paginationInfo.legacy && self.shouldUseTokenPagination) {
             // Only add the flag if opting in, necessary for older apps.
@@ -339,9 +408,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     }
 
     // Step 2: Create request.
+    [span beginStageWithName:NBClientTraceBodyStageName];
     NSError *jsonError;
     NSMutableURLRequest *request = [self baseRequestWithURL:components.URL parameters:parameters error:&jsonError];
     if (jsonError) {
+        [span end];
         dispatch_async(dispatch_get_main_queue(), ^{
             // Requires interface deprecation to enable.
             // if (!resultsKey) {
@@ -359,15 +430,33 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     }
     request.HTTPMethod = method;
     if ([request.HTTPMethod isEqualToString:@"GET"]) {
-        request.cachePolicy = NSURLRequestReloadRevalidatingCacheData;
+        // A provider's session cache is shared by all its clients, and only
+        // partitioned by the access token when it's in the URL.
+        BOOL shouldIgnoreLocalCache = self.isUsingSessionProvider && self.shouldIncludeKeyAsHeader;
+        request.cachePolicy = (shouldIgnoreLocalCache
+                               ? NSURLRequestReloadIgnoringLocalCacheData : NSURLRequestReloadRevalidatingCacheData);
     }
     NBLogInfo(@"REQUEST: %@", request.nb_debugDescription);
+    if (span) {
+        [tracer setSpan:span forRequest:request];
+    }
 
     // Step 3: Create task with handler.
+    NBClientPageSizer *pageSizer = paginationInfo ? self.pageSizer : nil;
+    NSString *path = components.path;
+    // Tasks resumed outside the client, ie. by its delegate, are timed from here.
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    __weak NSURLSessionDataTask *weakTask;
+    __block NSUInteger numberOfBytes = 0;
+    __block NSTimeInterval duration = 0;
     void (^taskCompletionHandler)(NSData *, NSURLResponse *, NSError *) =
     [self dataTaskCompletionHandlerForResultsKey:resultsKey originalRequest:request completionHandler:^(id results, NSDictionary *jsonObject, NSError *error) {
+        if (pageSizer && !error && [results isKindOfClass:[NSArray class]]) {
+            [pageSizer recordPageForPath:path numberOfItems:[results count] numberOfBytes:numberOfBytes duration:duration];
+        }
         if (completionHandler) {
             if ([results isKindOfClass:[NSArray class]] || paginationInfo) {
+                [span beginStageWithName:NBClientTracePaginationStageName];
                 NBPaginationInfo *responsePaginationInfo;
                 if ([NBPaginationInfo dictionaryContainsPaginationInfo:jsonObject]) {
                     responsePaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:jsonObject legacy:paginationInfo.legacy];
@@ -377,12 +466,16 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                     }
                     [responsePaginationInfo updateCurrentPageNumber];
                 }
+                [span beginStageWithName:NBClientTraceCompletionStageName];
                 ((NBClientResourceListCompletionHandler)completionHandler)(results, responsePaginationInfo, error);
             } else if ([results isKindOfClass:[NSDictionary class]]) {
+                [span beginStageWithName:NBClientTraceCompletionStageName];
                 ((NBClientResourceItemCompletionHandler)completionHandler)(results, error);
             } else if (results) {
+                [span beginStageWithName:NBClientTraceCompletionStageName];
                 ((NBClientResourceCompletionHandler)completionHandler)(results, error);
             } else if (!results) {
+                [span beginStageWithName:NBClientTraceCompletionStageName];
                 ((NBClientResourceItemCompletionHandler)completionHandler)(results, error);
                 // Requires interface deprecation to replace above.
                 // ((NBClientEmptyCompletionHandler)completionHandler)(results);
@@ -390,8 +483,30 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                 NBLogError(@"Client cannot infer block type, completion not called! %@", completionHandler);
             }
         }
+        [span end];
     }];
-    NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request completionHandler:taskCompletionHandler];
+    if (pageSizer) {
+        void (^handler)(NSData *, NSURLResponse *, NSError *) = taskCompletionHandler;
+        taskCompletionHandler = ^(NSData *data, NSURLResponse *response, NSError *error) {
+            numberOfBytes = data.length;
+            CFAbsoluteTime resumeTime = weakTask ? [NBClient resumeTimeForTask:weakTask] : 0;
+            duration = CFAbsoluteTimeGetCurrent() - (resumeTime ?: startTime);
+            handler(data, response, error);
+        };
+    }
+    NSURLSessionDataTask *task;
+    if (self.isUsingSessionProvider) {
+        task = [self.sessionProvider dataTaskWithRequest:request client:self completionHandler:taskCompletionHandler];
+    } else {
+        task = [self.urlSession dataTaskWithRequest:request completionHandler:taskCompletionHandler];
+    }
+    weakTask = task;
+
+    [self.currentTaskGroup addTask:task];
+    if (span) {
+        [span beginStageWithName:NBClientTraceQueueStageName];
+        [tracer setSpan:span forTask:task];
+    }
 
     // Step 4: Optionally start task.
     BOOL shouldStart = YES;
@@ -399,18 +514,68 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         shouldStart = [self.delegate client:self shouldAutomaticallyStartDataTask:task];
     }
     if (shouldStart) {
+        [self startDataTask:task];
+    }
+    return task;
+}
+
+- (void)startDataTask:(NSURLSessionDataTask *)task
+{
+    if (self.isUsingSessionProvider) {
+        [self.sessionProvider startTask:task];
+    } else {
         [task resume];
+        [NBClient taskDidResume:task];
     }
+}
+
++ (void)taskDidResume:(NSURLSessionTask *)task
+{
+    objc_setAssociatedObject(task, TaskResumeTimeKey, @(CFAbsoluteTimeGetCurrent()), OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    [[NBClientTracer sharedTracer] taskDidResume:task];
+}
+
++ (CFAbsoluteTime)resumeTimeForTask:(NSURLSessionTask *)task
+{
+    return [objc_getAssociatedObject(task, TaskResumeTimeKey) doubleValue];
+}
+
+- (NSURLSessionDataTask *)startDataTaskWithURL:(NSURL *)url
+                              completionHandler:(void (^)(NSData *, NSURLResponse *, NSError *))completionHandler
+{
+    NSURLRequest *request = [NSURLRequest requestWithURL:url];
+    NSURLSessionDataTask *task;
+    if (self.isUsingSessionProvider) {
+        task = [self.sessionProvider dataTaskWithRequest:request client:self completionHandler:completionHandler];
+    } else {
+        task = [self.urlSession dataTaskWithRequest:request completionHandler:completionHandler];
+    }
+    [self.currentTaskGroup addTask:task];
+    [self startDataTask:task];
     return task;
 }
 
+- (NBClientStreamedBody *)streamedBodyForParameters:(NSDictionary *)parameters
+{
+    if (!self.isMakingBulkRequests || !self.bodyStreamingThreshold || parameters.count != 1) {
+        return nil;
+    }
+    NSString *key = parameters.allKeys.firstObject;
+    NSArray *items = parameters[key];
+    if (![items isKindOfClass:[NSArray class]] || items.count < self.bodyStreamingThreshold) {
+        return nil;
+    }
+    NBLogInfo(@"Streaming body with %lu item(s) for \"%@\"", (unsigned long)items.count, key);
+    return [[NBClientStreamedBody alloc] initWithKey:key items:items shouldCompress:self.shouldCompressStreamedBodies];
+}
+
 #pragma mark Handlers
 
 - (void (^)(NSData *, NSURLResponse *, NSError *))dataTaskCompletionHandlerForResultsKey:(NSString *)resultsKey
                                                                          originalRequest:(NSURLRequest *)request
                                                                        completionHandler:(void (^)(id, NSDictionary *, NSError *))completionHandler
 {
-    return ^(NSData *data, NSURLResponse *response, NSError *error) {
+    void (^handler)(NSData *, NSURLResponse *, NSError *) = ^(NSData *data, NSURLResponse *response, NSError *error) {
         NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
         // Bail if delegate wants to handle the whole thing.
         if (self.delegate && [self.delegate respondsToSelector:@selector(client:shouldHandleResponse:forRequest:)]) {
@@ -464,6 +629,13 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                 }
             }
         }
+        // Intern list responses.
+        if (self.shouldInternStrings && resultsKey && [jsonObject[resultsKey] isKindOfClass:[NSArray class]]) {
+            NSUInteger savedBytes;
+            jsonObject = [self.stringInternPool internObject:jsonObject savedBytes:&savedBytes];
+            [[[NBClientTracer sharedTracer] spanForRequest:request] addArguments:@{ @"interned_bytes": @(savedBytes) }];
+            NBLogInfo(@"Interning saved %lu byte(s) for %@", (unsigned long)savedBytes, request.URL.path);
+        }
         // Get and check for results.
         if (self.delegate && [self.delegate respondsToSelector:@selector(client:didParseJSON:fromResponse:forRequest:)]) {
             [self.delegate client:self didParseJSON:jsonObject fromResponse:httpResponse forRequest:request];
@@ -484,6 +656,16 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
             completionHandler(results, jsonObject, error);
         }
     };
+    return ^(NSData *data, NSURLResponse *response, NSError *error) {
+        NBClientTraceSpan *span = [[NBClientTracer sharedTracer] spanForRequest:request];
+        if (span) {
+            [span addArguments:@{ @"status_code": @(((NSHTTPURLResponse *)response).statusCode), @"bytes": @(data.length) }];
+            [span beginStageWithName:NBClientTraceParseStageName];
+        }
+        handler(data, response, error);
+        // Also ends a request the delegate chose to handle.
+        [span end];
+    };
 }
 
 #pragma mark Helpers
@@ -536,4 +718,45 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
               response, body);
 }
 
+#pragma mark - NSURLSessionTaskDelegate
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+ needNewBodyStream:(void (^)(NSInputStream *))completionHandler
+{
+    if ([self.delegate respondsToSelector:_cmd]) {
+        [self.delegate URLSession:session task:task needNewBodyStream:completionHandler];
+        return;
+    }
+    // Ie. on an authentication challenge or a redirect.
+    completionHandler([NBClientStreamedBody inputStreamForResendingRequest:task.originalRequest]);
+}
+
+#pragma mark - NSObject
+
+- (BOOL)respondsToSelector:(SEL)selector
+{
+    if ([super respondsToSelector:selector]) {
+        return YES;
+    }
+    return [self.class isSessionDelegateSelector:selector] && [self.delegate respondsToSelector:selector];
+}
+
+- (id)forwardingTargetForSelector:(SEL)selector
+{
+    if ([self.class isSessionDelegateSelector:selector] && [self.delegate respondsToSelector:selector]) {
+        return self.delegate;
+    }
+    return [super forwardingTargetForSelector:selector];
+}
+
++ (BOOL)isSessionDelegateSelector:(SEL)selector
+{
+    for (Protocol *protocol in @[ @protocol(NSURLSessionDelegate), @protocol(NSURLSessionTaskDelegate), @protocol(NSURLSessionDataDelegate) ]) {
+        if (protocol_getMethodDescription(protocol, selector, NO, YES).name) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
 @end
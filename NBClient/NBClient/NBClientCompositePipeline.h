@@ -0,0 +1,53 @@
+//
+//  NBClientCompositePipeline.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient+Composites.h"
+
+@class NBClientCompositePipeline;
+@class NBClientTaskGroup;
+
+// Starts a composite, ie. `-createPersonWithCompositeInfo:...`, and returns its group.
+typedef NBClientTaskGroup * __nonnull (^NBClientCompositeStarter)(NBClientCompositeCompletionHandler __nonnull completionHandler);
+
+// The pipeline runs a batch of composites, ie. a sign-in sheet of walk-ins,
+// a bounded number at a time, so a large batch doesn't flood the client, while
+// reporting progress and throughput. Like the client, it should be used from
+// the main queue.
+@interface NBClientCompositePipeline : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+
+// Defaults to 2. Each composite can run several requests at once.
+@property (nonatomic) NSUInteger maximumNumberOfRunningComposites;
+// For person composites. Defaults to `YES`.
+@property (nonatomic) BOOL shouldRollBack;
+
+@property (nonatomic, readonly) NSUInteger numberOfPendingComposites;
+@property (nonatomic, readonly) NSUInteger numberOfRunningComposites;
+@property (nonatomic, readonly) NSUInteger numberOfSucceededComposites;
+@property (nonatomic, readonly) NSUInteger numberOfFailedComposites;
+// Finished composites per second, since the first one started.
+@property (nonatomic, readonly) double throughput;
+
+// Called after each composite finishes.
+@property (nonatomic, copy, nullable) void (^progressHandler)(NBClientCompositePipeline * __nonnull pipeline);
+
+// Designated initializer.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client;
+
+- (void)addComposite:(nonnull NBClientCompositeStarter)composite
+   completionHandler:(nullable NBClientCompositeCompletionHandler)completionHandler;
+- (void)addPersonWithCompositeInfo:(nonnull NSDictionary *)compositeInfo
+                 completionHandler:(nullable NBClientCompositeCompletionHandler)completionHandler;
+
+// Cancels running composites and drops pending ones. Their completion
+// handlers get a cancelled error.
+- (void)cancel;
+
+@end
@@ -0,0 +1,178 @@
+//
+//  NBClientCompositePipeline.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientCompositePipeline.h"
+
+#import "FoundationAdditions.h"
+#import "NBClientTaskGroup.h"
+
+static NSUInteger DefaultMaximumNumberOfRunningComposites = 2;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientCompositePipeline ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+
+@property (nonatomic, readwrite) NSUInteger numberOfSucceededComposites;
+@property (nonatomic, readwrite) NSUInteger numberOfFailedComposites;
+
+// Arrays of starter and completion handler pairs.
+@property (nonatomic) NSMutableArray *pendingComposites;
+@property (nonatomic) NSMutableArray *runningTaskGroups;
+@property (nonatomic) CFAbsoluteTime startTime;
+
+- (void)startPendingComposites;
+- (NSError *)missingClientError;
+
+@end
+
+@implementation NBClientCompositePipeline
+
+- (instancetype)initWithClient:(NBClient *)client
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.maximumNumberOfRunningComposites = DefaultMaximumNumberOfRunningComposites;
+        self.shouldRollBack = YES;
+        self.pendingComposites = [NSMutableArray array];
+        self.runningTaskGroups = [NSMutableArray array];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setMaximumNumberOfRunningComposites:(NSUInteger)maximumNumberOfRunningComposites
+{
+    _maximumNumberOfRunningComposites = MAX(maximumNumberOfRunningComposites, 1);
+    [self startPendingComposites];
+}
+
+- (NSUInteger)numberOfPendingComposites
+{
+    return self.pendingComposites.count;
+}
+
+- (NSUInteger)numberOfRunningComposites
+{
+    return self.runningTaskGroups.count;
+}
+
+- (double)throughput
+{
+    if (!self.startTime) {
+        return 0.0f;
+    }
+    NSTimeInterval duration = CFAbsoluteTimeGetCurrent() - self.startTime;
+    return duration > 0 ? (self.numberOfSucceededComposites + self.numberOfFailedComposites) / duration : 0.0f;
+}
+
+#pragma mark - Public
+
+- (void)addComposite:(NBClientCompositeStarter)composite
+   completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    [self.pendingComposites addObject:@[ [composite copy], [completionHandler copy] ?: [NSNull null] ]];
+    [self startPendingComposites];
+}
+
+- (void)addPersonWithCompositeInfo:(NSDictionary *)compositeInfo
+                 completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    __weak __typeof(self)weakSelf = self;
+    [self addComposite:^NBClientTaskGroup *(NBClientCompositeCompletionHandler compositeCompletionHandler) {
+        __strong __typeof(weakSelf)strongSelf = weakSelf;
+        NBClient *client = strongSelf.client;
+        if (!client) {
+            compositeCompletionHandler(nil, [strongSelf missingClientError]);
+            return [[NBClientTaskGroup alloc] init];
+        }
+        return [client createPersonWithCompositeInfo:compositeInfo
+                                         partTimeout:NBClientCompositeDefaultPartTimeout
+                                      shouldRollBack:strongSelf.shouldRollBack
+                                   completionHandler:compositeCompletionHandler];
+    } completionHandler:completionHandler];
+}
+
+- (void)cancel
+{
+    NSArray *pendingComposites = self.pendingComposites.copy;
+    [self.pendingComposites removeAllObjects];
+    for (NBClientTaskGroup *taskGroup in self.runningTaskGroups.copy) {
+        [taskGroup cancel];
+    }
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    for (NSArray *pair in pendingComposites) {
+        if (pair.lastObject != [NSNull null]) {
+            ((NBClientCompositeCompletionHandler)pair.lastObject)(nil, error);
+        }
+    }
+}
+
+#pragma mark - Private
+
+- (void)startPendingComposites
+{
+    while (self.pendingComposites.count && self.runningTaskGroups.count < self.maximumNumberOfRunningComposites) {
+        NSArray *pair = self.pendingComposites.firstObject;
+        [self.pendingComposites removeObjectAtIndex:0];
+        if (!self.startTime) {
+            self.startTime = CFAbsoluteTimeGetCurrent();
+        }
+        NBClientCompositeStarter composite = pair.firstObject;
+        NBClientCompositeCompletionHandler completionHandler = pair.lastObject != [NSNull null] ? pair.lastObject : nil;
+        __block NBClientTaskGroup *taskGroup;
+        __block BOOL didFinish = NO;
+        __weak __typeof(self)weakSelf = self;
+        taskGroup = composite(^(NSDictionary *results, NSError *error) {
+            didFinish = YES;
+            __strong __typeof(weakSelf)strongSelf = weakSelf;
+            if (strongSelf) {
+                if (error) {
+                    strongSelf.numberOfFailedComposites += 1;
+                } else {
+                    strongSelf.numberOfSucceededComposites += 1;
+                }
+                if (taskGroup) {
+                    [strongSelf.runningTaskGroups removeObject:taskGroup];
+                }
+            }
+            if (completionHandler) {
+                completionHandler(results, error);
+            }
+            if (strongSelf.progressHandler) {
+                strongSelf.progressHandler(strongSelf);
+            }
+            NBLogInfo(@"Composite finished, %.2f per second", strongSelf.throughput);
+            [strongSelf startPendingComposites];
+        });
+        if (taskGroup && !didFinish) {
+            [self.runningTaskGroups addObject:taskGroup];
+        }
+    }
+}
+
+- (NSError *)missingClientError
+{
+    return [NSError errorWithDomain:NBErrorDomain code:NBErrorCodeInvalidArgument
+                           userInfo:@{ NSLocalizedDescriptionKey: @"message.missing-client".nb_localizedString }];
+}
+
+@end
@@ -0,0 +1,96 @@
+//
+//  NBClientImportJob.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+@class NBClientImportJob;
+
+typedef NS_ENUM(NSUInteger, NBClientImportOutcome) {
+    NBClientImportOutcomePending,
+    NBClientImportOutcomeCreated,
+    NBClientImportOutcomeUpdated, // Matched an existing person.
+    NBClientImportOutcomeMerged, // Into an earlier row of the batch with the same email or phone.
+    NBClientImportOutcomeFailed,
+};
+
+// Keys of row results.
+extern NSString * __nonnull const NBClientImportRowIndexKey;
+extern NSString * __nonnull const NBClientImportOutcomeKey; // NBClientImportOutcome.
+extern NSString * __nonnull const NBClientImportPersonIdentifierKey; // Once created, updated or merged.
+extern NSString * __nonnull const NBClientImportPrimaryRowIndexKey; // Of the row a row was merged into.
+extern NSString * __nonnull const NBClientImportErrorKey; // If failed. Not checkpointed.
+
+extern NSUInteger const NBClientImportDefaultMaximumNumberOfConcurrentRows;
+
+typedef void (^NBClientImportRowHandler)(NSDictionary * __nonnull rowResult);
+// Failed rows are in the error, which has code `NBClientErrorCodePartialResults`
+// and errors by row index.
+typedef void (^NBClientImportCompletionHandler)(NSArray * __nonnull rowResults, NSError * __nullable error);
+
+// An import job brings a batch of people, ie. the rows of a sign-up sheet or
+// CSV file, into the nation without duplicating anyone. Emails are trimmed and
+// lowercased, and phone and mobile numbers compared by their digits, though
+// rows keep them as given. Rows that share an email, or a number as long as at
+// most one of them has an email, are then merged into the first of them, whose
+// empty fields the later rows fill in, before any request is made. Rows with
+// different emails are never merged, even when they share a household phone.
+// Each remaining row is matched by email or phone (`GET /people/match`), then
+// updated if it matched or created if not, through a composite pipeline, a
+// bounded number of rows at a time.
+//
+// Progress is checkpointed every few rows, so a job started again with the
+// same identifier and rows skips the rows already imported. A row imported
+// just before a crash may be imported again, which then only updates it,
+// since it matches. Rows with neither an email nor a phone can't be matched,
+// so they're checkpointed as soon as they're created, but one in flight
+// during a crash is still created again. The checkpoint is removed once every
+// row is imported.
+// Like the client, it should be used from the main queue.
+@interface NBClientImportJob : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+@property (nonatomic, copy, readonly, nonnull) NSString *identifier;
+// Of person parameters, as for `-createPersonWithParameters:`.
+@property (nonatomic, copy, readonly, nonnull) NSArray *rows;
+
+// Defaults to a directory in Application Support.
+@property (nonatomic, copy, nonnull) NSURL *checkpointDirectoryURL;
+@property (nonatomic, readonly, nonnull) NSURL *checkpointURL;
+// Defaults to 4.
+@property (nonatomic) NSUInteger maximumNumberOfConcurrentRows;
+// Rows between checkpoints. Defaults to 25.
+@property (nonatomic) NSUInteger checkpointInterval;
+@property (nonatomic, copy, nullable) NBClientImportRowHandler rowHandler;
+
+// One per row, in order, pending until imported.
+@property (nonatomic, copy, readonly, nonnull) NSArray *rowResults;
+@property (nonatomic, readonly) NSUInteger numberOfImportedRows;
+// Rows finished per second in the current or last run, merged ones included.
+@property (nonatomic, readonly) double throughput;
+@property (nonatomic, readonly, getter = isRunning) BOOL running;
+
+// Designated initializer. Loads any checkpoint.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client
+                            identifier:(nonnull NSString *)identifier
+                                  rows:(nonnull NSArray *)rows;
+
++ (nullable NSString *)normalizedEmail:(nullable NSString *)email;
+// Digits only, without the country code of US numbers.
++ (nullable NSString *)normalizedPhoneNumber:(nullable NSString *)phoneNumber;
+
+// Rows merged into each other, each group in order and by its first row.
+- (nonnull NSArray *)duplicateRowIndexGroups;
+
+- (void)startWithCompletionHandler:(nonnull NBClientImportCompletionHandler)completionHandler;
+// Keeps the checkpoint. Unfinished rows fail with a cancelled error.
+- (void)cancel;
+// Removes the checkpoint, so the next start imports every row.
+- (void)reset;
+
+@end
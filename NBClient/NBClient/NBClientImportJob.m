@@ -0,0 +1,546 @@
+//
+//  NBClientImportJob.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientImportJob.h"
+
+#import "FoundationAdditions.h"
+#import "NBClient+Composites.h"
+#import "NBClient+People.h"
+#import "NBClientCompositePipeline.h"
+#import "NBClientTaskGroup.h"
+
+NSString * const NBClientImportRowIndexKey = @"row";
+NSString * const NBClientImportOutcomeKey = @"outcome";
+NSString * const NBClientImportPersonIdentifierKey = @"person_id";
+NSString * const NBClientImportPrimaryRowIndexKey = @"primary_row";
+NSString * const NBClientImportErrorKey = @"error";
+
+NSUInteger const NBClientImportDefaultMaximumNumberOfConcurrentRows = 4;
+
+static NSString *CheckpointDirectoryName = @"com.nationbuilder.import";
+static NSString *CheckpointNumberOfRowsKey = @"rows";
+static NSString *CheckpointRowResultsKey = @"row_results";
+static NSUInteger DefaultCheckpointInterval = 25;
+// Person fields used to find duplicates and matches, in order of preference.
+static NSString *EmailKey = @"email";
+static NSString *PhoneKey = @"phone";
+static NSString *MobileKey = @"mobile";
+static NSString *NoMatchesErrorCode = @"no_matches";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientImportJob ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+@property (nonatomic, copy, readwrite) NSString *identifier;
+@property (nonatomic, copy, readwrite) NSArray *rows;
+
+@property (nonatomic, readwrite) NSUInteger numberOfImportedRows;
+@property (nonatomic, readwrite, getter = isRunning) BOOL running;
+
+@property (nonatomic) NSMutableArray *mutableRowResults;
+@property (nonatomic, copy) NSArray *rowIndexGroups;
+@property (nonatomic) NBClientCompositePipeline *pipeline;
+@property (nonatomic, copy) NBClientImportCompletionHandler completionHandler;
+@property (nonatomic, getter = isCancelled) BOOL cancelled;
+@property (nonatomic) NSMutableDictionary *rowErrors;
+@property (nonatomic) NSUInteger numberOfPendingGroups;
+@property (nonatomic) NSUInteger numberOfRowsSinceCheckpoint;
+@property (nonatomic) NSUInteger numberOfFinishedRows; // In the current or last run.
+@property (nonatomic) CFAbsoluteTime startTime;
+@property (nonatomic) CFAbsoluteTime endTime;
+
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+
++ (NSArray *)duplicateKeysForParameters:(NSDictionary *)parameters;
++ (NSDictionary *)matchParametersForParameters:(NSDictionary *)parameters;
+
+- (NSDictionary *)mergedParametersForRowIndexes:(NSArray *)rowIndexes;
+- (void)importPersonWithParameters:(NSDictionary *)parameters
+                       inTaskGroup:(NBClientTaskGroup *)taskGroup
+                 completionHandler:(NBClientCompositeCompletionHandler)completionHandler;
+- (void)finishRowIndexes:(NSArray *)rowIndexes withResults:(NSDictionary *)results error:(NSError *)error;
+- (void)finish;
+- (void)resetRowResults;
+- (void)saveCheckpoint;
+- (void)loadCheckpoint;
+
+@end
+
+@implementation NBClientImportJob
+
+- (instancetype)initWithClient:(NBClient *)client identifier:(NSString *)identifier rows:(NSArray *)rows
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.identifier = identifier;
+        NSMutableArray *normalizedRows = [NSMutableArray arrayWithCapacity:rows.count];
+        for (NSDictionary *row in rows) {
+            NSMutableDictionary *normalizedRow = row.mutableCopy;
+            NSString *email = [self.class normalizedEmail:row[EmailKey]];
+            if (email) {
+                normalizedRow[EmailKey] = email;
+            } else {
+                [normalizedRow removeObjectForKey:EmailKey];
+            }
+            [normalizedRows addObject:[NSDictionary dictionaryWithDictionary:normalizedRow]];
+        }
+        self.rows = normalizedRows;
+        self.maximumNumberOfConcurrentRows = NBClientImportDefaultMaximumNumberOfConcurrentRows;
+        self.checkpointInterval = DefaultCheckpointInterval;
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.import-job", DISPATCH_QUEUE_SERIAL);
+        NSURL *applicationSupportURL = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory
+                                                                               inDomains:NSUserDomainMask].firstObject;
+        self.checkpointDirectoryURL = [applicationSupportURL URLByAppendingPathComponent:CheckpointDirectoryName isDirectory:YES];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setCheckpointDirectoryURL:(NSURL *)checkpointDirectoryURL
+{
+    // Guard.
+    NSAssert(!self.isRunning, @"Checkpoint directory can't change while running.");
+    // Set.
+    _checkpointDirectoryURL = checkpointDirectoryURL.copy;
+    // Did.
+    [self loadCheckpoint];
+}
+
+- (NSURL *)checkpointURL
+{
+    return [self.checkpointDirectoryURL URLByAppendingPathComponent:
+            [self.identifier stringByAppendingPathExtension:@"plist"]];
+}
+
+- (NSArray *)rowResults
+{
+    return [NSArray arrayWithArray:self.mutableRowResults];
+}
+
+- (double)throughput
+{
+    if (!self.startTime) {
+        return 0.0f;
+    }
+    NSTimeInterval duration = (self.endTime ?: CFAbsoluteTimeGetCurrent()) - self.startTime;
+    return duration > 0 ? self.numberOfFinishedRows / duration : 0.0f;
+}
+
+- (NSArray *)rowIndexGroups
+{
+    if (_rowIndexGroups) {
+        return _rowIndexGroups;
+    }
+    // Union rows that share a key, with the earliest row as the root. Different
+    // emails are different people, even with one household phone, so groups
+    // are only joined by phone while at most one of them has an email.
+    NSUInteger numberOfRows = self.rows.count;
+    NSMutableArray *parents = [NSMutableArray arrayWithCapacity:numberOfRows];
+    NSMutableDictionary *emailsByRootIndex = [NSMutableDictionary dictionary];
+    NSUInteger (^root)(NSUInteger) = ^NSUInteger(NSUInteger index) {
+        while ([parents[index] unsignedIntegerValue] != index) {
+            // Halve the path as we go.
+            parents[index] = parents[[parents[index] unsignedIntegerValue]];
+            index = [parents[index] unsignedIntegerValue];
+        }
+        return index;
+    };
+    void (^unite)(NSUInteger, NSUInteger) = ^(NSUInteger index, NSUInteger otherIndex) {
+        NSUInteger rootIndex = root(index);
+        NSUInteger otherRootIndex = root(otherIndex);
+        if (rootIndex == otherRootIndex) {
+            return;
+        }
+        NSString *email = emailsByRootIndex[@(rootIndex)];
+        NSString *otherEmail = emailsByRootIndex[@(otherRootIndex)];
+        if (email && otherEmail && ![email isEqualToString:otherEmail]) {
+            return;
+        }
+        NSUInteger newRootIndex = MIN(rootIndex, otherRootIndex);
+        parents[MAX(rootIndex, otherRootIndex)] = @(newRootIndex);
+        [emailsByRootIndex removeObjectForKey:@(MAX(rootIndex, otherRootIndex))];
+        if (email ?: otherEmail) {
+            emailsByRootIndex[@(newRootIndex)] = email ?: otherEmail;
+        }
+    };
+    NSMutableDictionary *rowIndexesByKey = [NSMutableDictionary dictionary];
+    for (NSUInteger index = 0; index < numberOfRows; index++) {
+        [parents addObject:@(index)];
+        NSString *email = [self.class normalizedEmail:self.rows[index][EmailKey]];
+        if (email) {
+            emailsByRootIndex[@(index)] = email;
+        }
+        for (NSString *key in [self.class duplicateKeysForParameters:self.rows[index]]) {
+            NSMutableArray *otherIndexes = rowIndexesByKey[key];
+            if (!otherIndexes) {
+                otherIndexes = [NSMutableArray array];
+                rowIndexesByKey[key] = otherIndexes;
+            }
+            // A phone can be shared by groups that couldn't be joined.
+            for (NSNumber *otherIndex in otherIndexes) {
+                unite(index, otherIndex.unsignedIntegerValue);
+            }
+            [otherIndexes addObject:@(index)];
+        }
+    }
+    NSMutableArray *groups = [NSMutableArray array];
+    NSMutableDictionary *groupsByRootIndex = [NSMutableDictionary dictionary];
+    for (NSUInteger index = 0; index < numberOfRows; index++) {
+        NSNumber *rootIndex = @(root(index));
+        NSMutableArray *group = groupsByRootIndex[rootIndex];
+        if (!group) {
+            group = [NSMutableArray array];
+            groupsByRootIndex[rootIndex] = group;
+            [groups addObject:group];
+        }
+        [group addObject:@(index)];
+    }
+    self.rowIndexGroups = groups;
+    return _rowIndexGroups;
+}
+
+#pragma mark - Public
+
++ (NSString *)normalizedEmail:(NSString *)email
+{
+    if (![email isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    email = [email stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]].lowercaseString;
+    return email.length ? email : nil;
+}
+
++ (NSString *)normalizedPhoneNumber:(NSString *)phoneNumber
+{
+    if (![phoneNumber isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    NSString *digits = [[phoneNumber componentsSeparatedByCharactersInSet:
+                         [NSCharacterSet decimalDigitCharacterSet].invertedSet] componentsJoinedByString:@""];
+    if (digits.length == 11 && [digits hasPrefix:@"1"]) {
+        digits = [digits substringFromIndex:1];
+    }
+    return digits.length ? digits : nil;
+}
+
+- (NSArray *)duplicateRowIndexGroups
+{
+    return [self.rowIndexGroups filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(NSArray *rowIndexes, NSDictionary *bindings) {
+        return rowIndexes.count > 1;
+    }]];
+}
+
+- (void)startWithCompletionHandler:(NBClientImportCompletionHandler)completionHandler
+{
+    NSAssert(!self.isRunning, @"Import job is already running.");
+    self.running = YES;
+    self.cancelled = NO;
+    self.completionHandler = completionHandler;
+    self.rowErrors = [NSMutableDictionary dictionary];
+    self.numberOfFinishedRows = 0;
+    self.numberOfRowsSinceCheckpoint = 0;
+    self.startTime = CFAbsoluteTimeGetCurrent();
+    self.endTime = 0;
+    self.pipeline = [[NBClientCompositePipeline alloc] initWithClient:self.client];
+    self.pipeline.maximumNumberOfRunningComposites = self.maximumNumberOfConcurrentRows;
+    NSMutableArray *pendingGroups = [NSMutableArray array];
+    for (NSArray *rowIndexes in self.rowIndexGroups) {
+        NSUInteger rowIndex = [rowIndexes.firstObject unsignedIntegerValue];
+        NBClientImportOutcome outcome = [self.mutableRowResults[rowIndex][NBClientImportOutcomeKey] unsignedIntegerValue];
+        // Retry rows that failed before.
+        if (outcome == NBClientImportOutcomePending || outcome == NBClientImportOutcomeFailed) {
+            [pendingGroups addObject:rowIndexes];
+        }
+    }
+    self.numberOfPendingGroups = pendingGroups.count;
+    NBLogInfo(@"Starting import job \"%@\" with %lu of %lu row(s), %lu duplicate group(s)", self.identifier,
+              (unsigned long)pendingGroups.count, (unsigned long)self.rows.count, (unsigned long)self.duplicateRowIndexGroups.count);
+    if (!pendingGroups.count) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self finish];
+        });
+        return;
+    }
+    __weak __typeof(self)weakSelf = self;
+    for (NSArray *rowIndexes in pendingGroups) {
+        NSDictionary *parameters = [self mergedParametersForRowIndexes:rowIndexes];
+        [self.pipeline addComposite:^NBClientTaskGroup *(NBClientCompositeCompletionHandler compositeCompletionHandler) {
+            NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+            [weakSelf importPersonWithParameters:parameters inTaskGroup:taskGroup completionHandler:compositeCompletionHandler];
+            return taskGroup;
+        } completionHandler:^(NSDictionary *results, NSError *error) {
+            [weakSelf finishRowIndexes:rowIndexes withResults:results error:error];
+        }];
+    }
+}
+
+- (void)cancel
+{
+    if (!self.isRunning) {
+        return;
+    }
+    self.cancelled = YES;
+    [self.pipeline cancel];
+}
+
+- (void)reset
+{
+    NSAssert(!self.isRunning, @"Import job can't reset while running.");
+    NSURL *checkpointURL = self.checkpointURL;
+    dispatch_sync(self.persistenceQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:checkpointURL error:nil];
+    });
+    [self resetRowResults];
+}
+
+#pragma mark - Private
+
++ (NSArray *)duplicateKeysForParameters:(NSDictionary *)parameters
+{
+    NSMutableArray *keys = [NSMutableArray array];
+    NSString *email = [self normalizedEmail:parameters[EmailKey]];
+    if (email) {
+        [keys addObject:[@"email:" stringByAppendingString:email]];
+    }
+    // A number can be one row's phone and another's mobile.
+    for (NSString *key in @[ PhoneKey, MobileKey ]) {
+        NSString *phoneNumber = [self normalizedPhoneNumber:parameters[key]];
+        if (phoneNumber) {
+            [keys addObject:[@"phone:" stringByAppendingString:phoneNumber]];
+        }
+    }
+    return keys;
+}
+
++ (NSDictionary *)matchParametersForParameters:(NSDictionary *)parameters
+{
+    for (NSString *key in @[ EmailKey, PhoneKey, MobileKey ]) {
+        if ([parameters[key] isKindOfClass:[NSString class]] && [parameters[key] length]) {
+            return @{ key: parameters[key] };
+        }
+    }
+    return nil;
+}
+
+- (NSDictionary *)mergedParametersForRowIndexes:(NSArray *)rowIndexes
+{
+    // The first row wins, and later rows fill in what it's missing.
+    NSMutableDictionary *parameters = [NSMutableDictionary dictionary];
+    for (NSNumber *rowIndex in rowIndexes) {
+        [self.rows[rowIndex.unsignedIntegerValue] enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+            if (!parameters[key] && [value nb_nilIfNull]) {
+                parameters[key] = value;
+            }
+        }];
+    }
+    return [NSDictionary dictionaryWithDictionary:parameters];
+}
+
+- (void)importPersonWithParameters:(NSDictionary *)parameters
+                       inTaskGroup:(NBClientTaskGroup *)taskGroup
+                 completionHandler:(NBClientCompositeCompletionHandler)completionHandler
+{
+    NBClient *client = self.client;
+    __weak __typeof(self)weakSelf = self;
+    NBClientResourceItemCompletionHandler (^personHandler)(NBClientImportOutcome) = ^(NBClientImportOutcome outcome) {
+        return ^(NSDictionary *item, NSError *error) {
+            if (error) {
+                return completionHandler(nil, error);
+            }
+            completionHandler(@{ NBClientImportOutcomeKey: @(outcome),
+                                 NBClientImportPersonIdentifierKey: item[@"id"] ?: [NSNull null] }, nil);
+        };
+    };
+    // Steps after the first need to check, since the group only cancels running tasks.
+    BOOL (^didCancel)(void) = ^BOOL{
+        if (!weakSelf.isCancelled) {
+            return NO;
+        }
+        completionHandler(nil, [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]);
+        return YES;
+    };
+    void (^createPerson)(void) = ^{
+        [client performRequestsInTaskGroup:taskGroup usingBlock:^{
+            [client createPersonWithParameters:parameters completionHandler:personHandler(NBClientImportOutcomeCreated)];
+        }];
+    };
+    NSDictionary *matchParameters = [self.class matchParametersForParameters:parameters];
+    if (!matchParameters) {
+        createPerson();
+        return;
+    }
+    [client performRequestsInTaskGroup:taskGroup usingBlock:^{
+        [client fetchPersonByParameters:matchParameters withCompletionHandler:^(NSDictionary *item, NSError *error) {
+            if (didCancel()) {
+                return;
+            }
+            if (error) {
+                if ([error.userInfo[NBClientErrorCodeKey] isEqual:NoMatchesErrorCode]) {
+                    return createPerson();
+                }
+                // Including multiple matches, which can't be resolved here.
+                return completionHandler(nil, error);
+            }
+            [client performRequestsInTaskGroup:taskGroup usingBlock:^{
+                [client savePersonByIdentifier:[item[@"id"] unsignedIntegerValue] withParameters:parameters
+                             completionHandler:personHandler(NBClientImportOutcomeUpdated)];
+            }];
+        }];
+    }];
+}
+
+- (void)finishRowIndexes:(NSArray *)rowIndexes withResults:(NSDictionary *)results error:(NSError *)error
+{
+    NSNumber *primaryRowIndex = rowIndexes.firstObject;
+    id personIdentifier = [results[NBClientImportPersonIdentifierKey] nb_nilIfNull];
+    for (NSNumber *rowIndex in rowIndexes) {
+        NSMutableDictionary *rowResult = [NSMutableDictionary dictionaryWithObject:rowIndex forKey:NBClientImportRowIndexKey];
+        if (error) {
+            rowResult[NBClientImportOutcomeKey] = @(NBClientImportOutcomeFailed);
+            rowResult[NBClientImportErrorKey] = error;
+            self.rowErrors[rowIndex.stringValue] = error;
+        } else {
+            rowResult[NBClientImportOutcomeKey] = ([rowIndex isEqual:primaryRowIndex]
+                                                   ? results[NBClientImportOutcomeKey] : @(NBClientImportOutcomeMerged));
+            if (personIdentifier) {
+                rowResult[NBClientImportPersonIdentifierKey] = personIdentifier;
+            }
+            self.numberOfImportedRows += 1;
+        }
+        if (![rowIndex isEqual:primaryRowIndex]) {
+            rowResult[NBClientImportPrimaryRowIndexKey] = primaryRowIndex;
+        }
+        self.mutableRowResults[rowIndex.unsignedIntegerValue] = [NSDictionary dictionaryWithDictionary:rowResult];
+        self.numberOfFinishedRows += 1;
+        if (self.rowHandler) {
+            self.rowHandler(self.mutableRowResults[rowIndex.unsignedIntegerValue]);
+        }
+    }
+    self.numberOfRowsSinceCheckpoint += rowIndexes.count;
+    self.numberOfPendingGroups -= 1;
+    // Nothing can match a row without an email or phone on resume, so it's
+    // checkpointed right away rather than created again.
+    BOOL isUnmatchable = !error && ![self.class matchParametersForParameters:[self mergedParametersForRowIndexes:rowIndexes]];
+    if (!self.numberOfPendingGroups) {
+        [self finish];
+    } else if (isUnmatchable || self.numberOfRowsSinceCheckpoint >= self.checkpointInterval) {
+        [self saveCheckpoint];
+    }
+}
+
+- (void)finish
+{
+    self.endTime = CFAbsoluteTimeGetCurrent();
+    [self saveCheckpoint];
+    NBClientImportCompletionHandler completionHandler = self.completionHandler;
+    self.completionHandler = nil;
+    self.pipeline = nil;
+    self.running = NO;
+    NSError *error;
+    if (self.rowErrors.count) {
+        NSArray *rowIndexes = [self.rowErrors.allKeys sortedArrayUsingSelector:@selector(localizedStandardCompare:)];
+        error = [NSError
+                 errorWithDomain:NBErrorDomain code:NBClientErrorCodePartialResults
+                 userInfo:@{ NSLocalizedDescriptionKey: @"message.partial-results-error".nb_localizedString,
+                             NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                @"message.partial-results-error.format".nb_localizedString,
+                                                                [rowIndexes componentsJoinedByString:@", "]],
+                             NBClientErrorPartErrorsKey: [NSDictionary dictionaryWithDictionary:self.rowErrors] }];
+    }
+    NBLogInfo(@"Finished import job \"%@\", %lu of %lu row(s) imported, %.2f per second, %lu failed", self.identifier,
+              (unsigned long)self.numberOfImportedRows, (unsigned long)self.rows.count, self.throughput, (unsigned long)self.rowErrors.count);
+    if (completionHandler) {
+        completionHandler(self.rowResults, error);
+    }
+}
+
+- (void)resetRowResults
+{
+    self.mutableRowResults = [NSMutableArray arrayWithCapacity:self.rows.count];
+    for (NSUInteger index = 0; index < self.rows.count; index++) {
+        [self.mutableRowResults addObject:@{ NBClientImportRowIndexKey: @(index),
+                                             NBClientImportOutcomeKey: @(NBClientImportOutcomePending) }];
+    }
+    self.numberOfImportedRows = 0;
+}
+
+- (void)saveCheckpoint
+{
+    self.numberOfRowsSinceCheckpoint = 0;
+    BOOL isDone = self.numberOfImportedRows == self.rows.count;
+    NSMutableArray *rowResults = [NSMutableArray array];
+    for (NSDictionary *rowResult in self.mutableRowResults) {
+        NBClientImportOutcome outcome = [rowResult[NBClientImportOutcomeKey] unsignedIntegerValue];
+        if (outcome != NBClientImportOutcomePending && outcome != NBClientImportOutcomeFailed) {
+            [rowResults addObject:rowResult];
+        }
+    }
+    NSDictionary *checkpoint = @{ CheckpointNumberOfRowsKey: @(self.rows.count),
+                                  CheckpointRowResultsKey: rowResults };
+    NSURL *directoryURL = self.checkpointDirectoryURL;
+    NSURL *checkpointURL = self.checkpointURL;
+    dispatch_async(self.persistenceQueue, ^{
+        NSError *error;
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        if (isDone) {
+            [fileManager removeItemAtURL:checkpointURL error:nil];
+            return;
+        }
+        NSData *data = [NSPropertyListSerialization dataWithPropertyList:checkpoint format:NSPropertyListBinaryFormat_v1_0
+                                                                 options:0 error:&error];
+        if (data && [fileManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:&error]) {
+            [data writeToURL:checkpointURL options:NSDataWritingAtomic error:&error];
+        }
+        if (error) {
+            NBLogError(@"Failed to save import checkpoint to %@: %@", checkpointURL, error);
+        }
+    });
+}
+
+- (void)loadCheckpoint
+{
+    [self resetRowResults];
+    NSData *data = [NSData dataWithContentsOfURL:self.checkpointURL];
+    if (!data) {
+        return;
+    }
+    NSError *error;
+    NSDictionary *checkpoint = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable
+                                                                          format:NULL error:&error];
+    if (error || ![checkpoint isKindOfClass:[NSDictionary class]]) {
+        NBLogWarning(@"Ignoring unreadable import checkpoint at %@: %@", self.checkpointURL, error);
+        return;
+    }
+    if ([checkpoint[CheckpointNumberOfRowsKey] unsignedIntegerValue] != self.rows.count) {
+        NBLogWarning(@"Ignoring import checkpoint at %@ for a different number of rows", self.checkpointURL);
+        return;
+    }
+    for (NSDictionary *rowResult in checkpoint[CheckpointRowResultsKey]) {
+        NSUInteger rowIndex = [rowResult[NBClientImportRowIndexKey] unsignedIntegerValue];
+        if (rowIndex < self.rows.count) {
+            self.mutableRowResults[rowIndex] = rowResult;
+            self.numberOfImportedRows += 1;
+        }
+    }
+    NBLogInfo(@"Resuming import job \"%@\" with %lu row(s) imported", self.identifier, (unsigned long)self.numberOfImportedRows);
+}
+
+@end
@@ -0,0 +1,74 @@
+//
+//  NBClientMembershipSet.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+@class NBClientMembershipSet;
+@class NBClientTaskGroup;
+
+typedef void (^NBClientMembershipSetCompletionHandler)(NBClientMembershipSet * __nullable membershipSet, NSError * __nullable error);
+
+// A membership set holds person identifiers, ie. the members of a list or the
+// people with a tag, so questions like "on list A, tagged B, not tagged C" can
+// be answered without keeping every person around. It's a compressed bitmap:
+// identifiers are grouped by their upper 16 bits into containers, each of
+// which is a sorted array of the lower 16 bits while sparse (up to 4096), and
+// a 8KB bitmap when dense. Intersecting, uniting and subtracting sets works a
+// container at a time, and counting is cached per container, so queries over
+// lists of 100k people take milliseconds and a few hundred KB at most.
+//
+// Identifiers must fit in 32 bits. Not thread-safe, but copies are cheap to
+// hand to another queue.
+@interface NBClientMembershipSet : NSObject <NSCopying>
+
+@property (nonatomic, readonly) NSUInteger count;
+// Of the containers, for comparing against the people they stand for.
+@property (nonatomic, readonly) NSUInteger numberOfBytes;
+
+// Numbers, ie. the `id` of each person.
+- (nonnull instancetype)initWithIdentifiers:(nonnull NSArray *)identifiers;
+
+- (BOOL)containsIdentifier:(NSUInteger)identifier;
+- (void)addIdentifier:(NSUInteger)identifier;
+
+// AND
+- (nonnull NBClientMembershipSet *)setByIntersectingSet:(nonnull NBClientMembershipSet *)otherSet;
+// OR
+- (nonnull NBClientMembershipSet *)setByUnitingSet:(nonnull NBClientMembershipSet *)otherSet;
+// AND NOT
+- (nonnull NBClientMembershipSet *)setBySubtractingSet:(nonnull NBClientMembershipSet *)otherSet;
+
+// In ascending order.
+- (void)enumerateIdentifiersUsingBlock:(nonnull void (^)(NSUInteger identifier, BOOL * __nonnull stop))block;
+// Numbers, in ascending order, ie. for a page of people to hydrate. The range
+// is clamped to the count.
+- (nonnull NSArray *)identifiersInRange:(NSRange)range;
+
+@end
+
+@interface NBClient (MembershipSets)
+
+// GET /lists/:id/people
+// Fetches every page, keeping only each person's identifier, so a large list
+// costs its bitmap, not its people. Cancel the returned group to cancel all pages.
+- (nonnull NBClientTaskGroup *)fetchListMembershipSetByIdentifier:(NSUInteger)listIdentifier
+                                                completionHandler:(nonnull NBClientMembershipSetCompletionHandler)completionHandler;
+// GET /tags/:tag/people
+- (nonnull NBClientTaskGroup *)fetchTagMembershipSetByName:(nonnull NSString *)tagName
+                                         completionHandler:(nonnull NBClientMembershipSetCompletionHandler)completionHandler;
+
+// GET /people/:id
+// Fetches the people in the given range of the set, a bounded number at a time,
+// and calls back once with them in identifier order. People deleted since the
+// set was fetched are skipped. The first other failure cancels the rest.
+- (nonnull NBClientTaskGroup *)fetchPeopleInMembershipSet:(nonnull NBClientMembershipSet *)membershipSet
+                                                    range:(NSRange)range
+                                        completionHandler:(nonnull NBClientResourceListCompletionHandler)completionHandler;
+
+@end
@@ -0,0 +1,724 @@
+//
+//  NBClientMembershipSet.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientMembershipSet.h"
+
+#import "NBClient+Composites.h"
+#import "NBClient+Lists.h"
+#import "NBClient+People.h"
+#import "NBClient+Tags.h"
+#import "NBClientTaskGroup.h"
+#import "NBPaginationInfo.h"
+
+// Past this, a bitmap is smaller than an array.
+static uint32_t const ArrayContainerMaximumCardinality = 4096;
+static uint32_t const ArrayContainerMinimumCapacity = 4;
+#define BitmapContainerNumberOfWords (65536 / 64)
+
+static NSUInteger MembershipPageSize = 100;
+static NSUInteger MaximumNumberOfConcurrentPages = 4;
+static NSUInteger MaximumNumberOfConcurrentPersonFetches = 4;
+
+typedef NS_ENUM(uint8_t, NBMembershipContainerType) {
+    NBMembershipContainerTypeArray,
+    NBMembershipContainerTypeBitmap,
+};
+
+typedef NS_ENUM(NSUInteger, NBMembershipOperation) {
+    NBMembershipOperationIntersection,
+    NBMembershipOperationUnion,
+    NBMembershipOperationDifference,
+};
+
+// The identifiers sharing upper 16 bits, by their lower 16 bits.
+typedef struct {
+    uint16_t key;
+    NBMembershipContainerType type;
+    uint32_t cardinality;
+    uint32_t capacity; // Of an array's values.
+    uint16_t *values; // Sorted, for arrays.
+    uint64_t *words; // For bitmaps.
+} NBMembershipContainer;
+
+#pragma mark - Containers
+
+static NBMembershipContainer ArrayContainerMake(uint16_t key, uint32_t capacity)
+{
+    NBMembershipContainer container = { .key = key, .type = NBMembershipContainerTypeArray };
+    container.capacity = MAX(capacity, ArrayContainerMinimumCapacity);
+    container.values = malloc(container.capacity * sizeof(uint16_t));
+    return container;
+}
+
+static NBMembershipContainer BitmapContainerMake(uint16_t key)
+{
+    NBMembershipContainer container = { .key = key, .type = NBMembershipContainerTypeBitmap };
+    container.words = calloc(BitmapContainerNumberOfWords, sizeof(uint64_t));
+    return container;
+}
+
+static void ContainerFree(NBMembershipContainer *container)
+{
+    free(container->values);
+    free(container->words);
+    container->values = NULL;
+    container->words = NULL;
+}
+
+static NBMembershipContainer ContainerCopy(const NBMembershipContainer *container)
+{
+    NBMembershipContainer copy = *container;
+    if (container->type == NBMembershipContainerTypeArray) {
+        copy.capacity = MAX(container->cardinality, ArrayContainerMinimumCapacity);
+        copy.values = malloc(copy.capacity * sizeof(uint16_t));
+        memcpy(copy.values, container->values, container->cardinality * sizeof(uint16_t));
+    } else {
+        copy.words = malloc(BitmapContainerNumberOfWords * sizeof(uint64_t));
+        memcpy(copy.words, container->words, BitmapContainerNumberOfWords * sizeof(uint64_t));
+    }
+    return copy;
+}
+
+static size_t ContainerSize(const NBMembershipContainer *container)
+{
+    return (container->type == NBMembershipContainerTypeArray
+            ? container->capacity * sizeof(uint16_t) : BitmapContainerNumberOfWords * sizeof(uint64_t));
+}
+
+static BOOL BitmapContains(const uint64_t *words, uint16_t low)
+{
+    return (words[low >> 6] >> (low & 63)) & 1;
+}
+
+// The index of the value, or else -(insertion index + 1).
+static NSInteger ArraySearch(const uint16_t *values, uint32_t count, uint16_t low)
+{
+    NSInteger lower = 0;
+    NSInteger upper = (NSInteger)count - 1;
+    while (lower <= upper) {
+        NSInteger middle = (lower + upper) >> 1;
+        if (values[middle] < low) {
+            lower = middle + 1;
+        } else if (values[middle] > low) {
+            upper = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+    return -(lower + 1);
+}
+
+static BOOL ContainerContains(const NBMembershipContainer *container, uint16_t low)
+{
+    return (container->type == NBMembershipContainerTypeBitmap
+            ? BitmapContains(container->words, low) : ArraySearch(container->values, container->cardinality, low) >= 0);
+}
+
+static void ContainerConvertToBitmap(NBMembershipContainer *container)
+{
+    uint64_t *words = calloc(BitmapContainerNumberOfWords, sizeof(uint64_t));
+    for (uint32_t index = 0; index < container->cardinality; index++) {
+        uint16_t low = container->values[index];
+        words[low >> 6] |= 1ULL << (low & 63);
+    }
+    free(container->values);
+    container->values = NULL;
+    container->capacity = 0;
+    container->words = words;
+    container->type = NBMembershipContainerTypeBitmap;
+}
+
+// Sparse bitmaps become arrays, so each set has one representation.
+static void ContainerNormalize(NBMembershipContainer *container)
+{
+    if (container->type != NBMembershipContainerTypeBitmap || container->cardinality > ArrayContainerMaximumCardinality) {
+        return;
+    }
+    uint32_t capacity = MAX(container->cardinality, ArrayContainerMinimumCapacity);
+    uint16_t *values = malloc(capacity * sizeof(uint16_t));
+    uint32_t count = 0;
+    for (uint32_t wordIndex = 0; wordIndex < BitmapContainerNumberOfWords; wordIndex++) {
+        uint64_t word = container->words[wordIndex];
+        while (word) {
+            values[count++] = (uint16_t)((wordIndex << 6) + (uint32_t)__builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    free(container->words);
+    container->words = NULL;
+    container->values = values;
+    container->capacity = capacity;
+    container->type = NBMembershipContainerTypeArray;
+}
+
+static void ArrayContainerAppend(NBMembershipContainer *container, uint16_t low)
+{
+    container->values[container->cardinality++] = low;
+}
+
+static void ContainerAdd(NBMembershipContainer *container, uint16_t low)
+{
+    if (container->type == NBMembershipContainerTypeBitmap) {
+        uint64_t bit = 1ULL << (low & 63);
+        if (!(container->words[low >> 6] & bit)) {
+            container->words[low >> 6] |= bit;
+            container->cardinality += 1;
+        }
+        return;
+    }
+    NSInteger index = ArraySearch(container->values, container->cardinality, low);
+    if (index >= 0) {
+        return;
+    }
+    index = -index - 1;
+    if (container->cardinality == ArrayContainerMaximumCardinality) {
+        ContainerConvertToBitmap(container);
+        ContainerAdd(container, low);
+        return;
+    }
+    if (container->cardinality == container->capacity) {
+        container->capacity = MIN(container->capacity * 2, ArrayContainerMaximumCardinality);
+        container->values = realloc(container->values, container->capacity * sizeof(uint16_t));
+    }
+    memmove(&container->values[index + 1], &container->values[index], (container->cardinality - (uint32_t)index) * sizeof(uint16_t));
+    container->values[index] = low;
+    container->cardinality += 1;
+}
+
+static uint32_t BitmapCardinality(const uint64_t *words)
+{
+    uint32_t cardinality = 0;
+    for (uint32_t index = 0; index < BitmapContainerNumberOfWords; index++) {
+        cardinality += (uint32_t)__builtin_popcountll(words[index]);
+    }
+    return cardinality;
+}
+
+static NBMembershipContainer ContainerIntersect(const NBMembershipContainer *container, const NBMembershipContainer *otherContainer)
+{
+    if (container->type == NBMembershipContainerTypeBitmap && otherContainer->type == NBMembershipContainerTypeBitmap) {
+        NBMembershipContainer result = BitmapContainerMake(container->key);
+        for (uint32_t index = 0; index < BitmapContainerNumberOfWords; index++) {
+            result.words[index] = container->words[index] & otherContainer->words[index];
+        }
+        result.cardinality = BitmapCardinality(result.words);
+        ContainerNormalize(&result);
+        return result;
+    }
+    // At least one is an array, and the result is no bigger.
+    const NBMembershipContainer *array = (container->type == NBMembershipContainerTypeArray ? container : otherContainer);
+    const NBMembershipContainer *other = (array == container ? otherContainer : container);
+    NBMembershipContainer result = ArrayContainerMake(container->key, MIN(array->cardinality, other->cardinality));
+    if (other->type == NBMembershipContainerTypeBitmap) {
+        for (uint32_t index = 0; index < array->cardinality; index++) {
+            if (BitmapContains(other->words, array->values[index])) {
+                ArrayContainerAppend(&result, array->values[index]);
+            }
+        }
+        return result;
+    }
+    uint32_t index = 0, otherIndex = 0;
+    while (index < array->cardinality && otherIndex < other->cardinality) {
+        uint16_t value = array->values[index], otherValue = other->values[otherIndex];
+        if (value < otherValue) {
+            index += 1;
+        } else if (value > otherValue) {
+            otherIndex += 1;
+        } else {
+            ArrayContainerAppend(&result, value);
+            index += 1;
+            otherIndex += 1;
+        }
+    }
+    return result;
+}
+
+static NBMembershipContainer ContainerUnite(const NBMembershipContainer *container, const NBMembershipContainer *otherContainer)
+{
+    if (container->type == NBMembershipContainerTypeBitmap && otherContainer->type == NBMembershipContainerTypeBitmap) {
+        NBMembershipContainer result = BitmapContainerMake(container->key);
+        for (uint32_t index = 0; index < BitmapContainerNumberOfWords; index++) {
+            result.words[index] = container->words[index] | otherContainer->words[index];
+        }
+        result.cardinality = BitmapCardinality(result.words);
+        return result;
+    }
+    if (container->type == NBMembershipContainerTypeBitmap || otherContainer->type == NBMembershipContainerTypeBitmap) {
+        const NBMembershipContainer *bitmap = (container->type == NBMembershipContainerTypeBitmap ? container : otherContainer);
+        const NBMembershipContainer *array = (bitmap == container ? otherContainer : container);
+        NBMembershipContainer result = ContainerCopy(bitmap);
+        for (uint32_t index = 0; index < array->cardinality; index++) {
+            ContainerAdd(&result, array->values[index]);
+        }
+        return result;
+    }
+    uint32_t capacity = container->cardinality + otherContainer->cardinality;
+    if (capacity > ArrayContainerMaximumCardinality) {
+        NBMembershipContainer result = ContainerCopy(container);
+        ContainerConvertToBitmap(&result);
+        for (uint32_t index = 0; index < otherContainer->cardinality; index++) {
+            ContainerAdd(&result, otherContainer->values[index]);
+        }
+        ContainerNormalize(&result);
+        return result;
+    }
+    NBMembershipContainer result = ArrayContainerMake(container->key, capacity);
+    uint32_t index = 0, otherIndex = 0;
+    while (index < container->cardinality || otherIndex < otherContainer->cardinality) {
+        if (otherIndex == otherContainer->cardinality ||
+            (index < container->cardinality && container->values[index] < otherContainer->values[otherIndex]))
+        {
+            ArrayContainerAppend(&result, container->values[index++]);
+        } else if (index == container->cardinality || otherContainer->values[otherIndex] < container->values[index]) {
+            ArrayContainerAppend(&result, otherContainer->values[otherIndex++]);
+        } else {
+            ArrayContainerAppend(&result, container->values[index]);
+            index += 1;
+            otherIndex += 1;
+        }
+    }
+    return result;
+}
+
+static NBMembershipContainer ContainerSubtract(const NBMembershipContainer *container, const NBMembershipContainer *otherContainer)
+{
+    if (container->type == NBMembershipContainerTypeArray) {
+        NBMembershipContainer result = ArrayContainerMake(container->key, container->cardinality);
+        for (uint32_t index = 0; index < container->cardinality; index++) {
+            if (!ContainerContains(otherContainer, container->values[index])) {
+                ArrayContainerAppend(&result, container->values[index]);
+            }
+        }
+        return result;
+    }
+    NBMembershipContainer result = ContainerCopy(container);
+    if (otherContainer->type == NBMembershipContainerTypeBitmap) {
+        for (uint32_t index = 0; index < BitmapContainerNumberOfWords; index++) {
+            result.words[index] &= ~otherContainer->words[index];
+        }
+        result.cardinality = BitmapCardinality(result.words);
+    } else {
+        for (uint32_t index = 0; index < otherContainer->cardinality; index++) {
+            uint16_t low = otherContainer->values[index];
+            uint64_t bit = 1ULL << (low & 63);
+            if (result.words[low >> 6] & bit) {
+                result.words[low >> 6] &= ~bit;
+                result.cardinality -= 1;
+            }
+        }
+    }
+    ContainerNormalize(&result);
+    return result;
+}
+
+// Calls the block with each identifier from the given rank within the
+// container, until it stops.
+static BOOL ContainerEnumerate(const NBMembershipContainer *container, uint32_t startRank,
+                               void (^block)(NSUInteger identifier, BOOL *stop))
+{
+    NSUInteger high = (NSUInteger)container->key << 16;
+    BOOL stop = NO;
+    if (container->type == NBMembershipContainerTypeArray) {
+        for (uint32_t index = startRank; index < container->cardinality && !stop; index++) {
+            block(high | container->values[index], &stop);
+        }
+        return stop;
+    }
+    uint32_t rank = 0;
+    for (uint32_t wordIndex = 0; wordIndex < BitmapContainerNumberOfWords && !stop; wordIndex++) {
+        uint64_t word = container->words[wordIndex];
+        uint32_t wordCardinality = (uint32_t)__builtin_popcountll(word);
+        if (rank + wordCardinality <= startRank) {
+            rank += wordCardinality;
+            continue;
+        }
+        while (word && !stop) {
+            if (rank >= startRank) {
+                block(high | ((wordIndex << 6) + (uint32_t)__builtin_ctzll(word)), &stop);
+            }
+            rank += 1;
+            word &= word - 1;
+        }
+    }
+    return stop;
+}
+
+@interface NBClientMembershipSet ()
+
+- (NSInteger)indexOfContainerWithKey:(uint16_t)key;
+- (void)appendContainer:(NBMembershipContainer)container;
+- (NBClientMembershipSet *)setByCombiningWithSet:(NBClientMembershipSet *)otherSet operation:(NBMembershipOperation)operation;
+
+@end
+
+@implementation NBClientMembershipSet
+{
+    // Sorted by key.
+    NBMembershipContainer *_containers;
+    NSUInteger _numberOfContainers;
+    NSUInteger _containersCapacity;
+}
+
+- (instancetype)initWithIdentifiers:(NSArray *)identifiers
+{
+    self = [self init];
+    if (self) {
+        for (NSNumber *identifier in identifiers) {
+            [self addIdentifier:identifier.unsignedIntegerValue];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        ContainerFree(&_containers[index]);
+    }
+    free(_containers);
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    NBClientMembershipSet *copy = [[self.class allocWithZone:zone] init];
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        [copy appendContainer:ContainerCopy(&_containers[index])];
+    }
+    return copy;
+}
+
+#pragma mark - NSObject
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self) {
+        return YES;
+    }
+    if (![object isKindOfClass:[NBClientMembershipSet class]]) {
+        return NO;
+    }
+    NBClientMembershipSet *otherSet = object;
+    if (otherSet->_numberOfContainers != _numberOfContainers) {
+        return NO;
+    }
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        const NBMembershipContainer *container = &_containers[index];
+        const NBMembershipContainer *otherContainer = &otherSet->_containers[index];
+        if (container->key != otherContainer->key || container->type != otherContainer->type ||
+            container->cardinality != otherContainer->cardinality)
+        {
+            return NO;
+        }
+        BOOL isEqual = (container->type == NBMembershipContainerTypeArray
+                        ? !memcmp(container->values, otherContainer->values, container->cardinality * sizeof(uint16_t))
+                        : !memcmp(container->words, otherContainer->words, BitmapContainerNumberOfWords * sizeof(uint64_t)));
+        if (!isEqual) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (NSUInteger)hash
+{
+    return self.count ^ _numberOfContainers;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p, %lu identifier(s) in %lu container(s), %lu byte(s)>",
+            NSStringFromClass(self.class), self, (unsigned long)self.count,
+            (unsigned long)_numberOfContainers, (unsigned long)self.numberOfBytes];
+}
+
+#pragma mark - Accessors
+
+- (NSUInteger)count
+{
+    NSUInteger count = 0;
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        count += _containers[index].cardinality;
+    }
+    return count;
+}
+
+- (NSUInteger)numberOfBytes
+{
+    NSUInteger numberOfBytes = _containersCapacity * sizeof(NBMembershipContainer);
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        numberOfBytes += ContainerSize(&_containers[index]);
+    }
+    return numberOfBytes;
+}
+
+#pragma mark - Public
+
+- (BOOL)containsIdentifier:(NSUInteger)identifier
+{
+    if (identifier > UINT32_MAX) {
+        return NO;
+    }
+    NSInteger index = [self indexOfContainerWithKey:(uint16_t)(identifier >> 16)];
+    return index >= 0 && ContainerContains(&_containers[index], (uint16_t)(identifier & 0xFFFF));
+}
+
+- (void)addIdentifier:(NSUInteger)identifier
+{
+    NSAssert(identifier <= UINT32_MAX, @"Identifier should fit in 32 bits.");
+    if (identifier > UINT32_MAX) {
+        return;
+    }
+    uint16_t key = (uint16_t)(identifier >> 16);
+    NSInteger index = [self indexOfContainerWithKey:key];
+    if (index < 0) {
+        // Insert a container in key order.
+        index = -index - 1;
+        [self appendContainer:ArrayContainerMake(key, ArrayContainerMinimumCapacity)];
+        NBMembershipContainer container = _containers[_numberOfContainers - 1];
+        memmove(&_containers[index + 1], &_containers[index], (_numberOfContainers - 1 - (NSUInteger)index) * sizeof(NBMembershipContainer));
+        _containers[index] = container;
+    }
+    ContainerAdd(&_containers[index], (uint16_t)(identifier & 0xFFFF));
+}
+
+- (NBClientMembershipSet *)setByIntersectingSet:(NBClientMembershipSet *)otherSet
+{
+    return [self setByCombiningWithSet:otherSet operation:NBMembershipOperationIntersection];
+}
+
+- (NBClientMembershipSet *)setByUnitingSet:(NBClientMembershipSet *)otherSet
+{
+    return [self setByCombiningWithSet:otherSet operation:NBMembershipOperationUnion];
+}
+
+- (NBClientMembershipSet *)setBySubtractingSet:(NBClientMembershipSet *)otherSet
+{
+    return [self setByCombiningWithSet:otherSet operation:NBMembershipOperationDifference];
+}
+
+- (void)enumerateIdentifiersUsingBlock:(void (^)(NSUInteger, BOOL *))block
+{
+    for (NSUInteger index = 0; index < _numberOfContainers; index++) {
+        if (ContainerEnumerate(&_containers[index], 0, block)) {
+            return;
+        }
+    }
+}
+
+- (NSArray *)identifiersInRange:(NSRange)range
+{
+    NSMutableArray *identifiers = [NSMutableArray array];
+    NSUInteger skipCount = range.location;
+    __block NSUInteger remainingCount = range.length;
+    for (NSUInteger index = 0; index < _numberOfContainers && remainingCount; index++) {
+        const NBMembershipContainer *container = &_containers[index];
+        // Whole containers are skipped by their cardinality.
+        if (skipCount >= container->cardinality) {
+            skipCount -= container->cardinality;
+            continue;
+        }
+        ContainerEnumerate(container, (uint32_t)skipCount, ^(NSUInteger identifier, BOOL *stop) {
+            [identifiers addObject:@(identifier)];
+            remainingCount -= 1;
+            *stop = !remainingCount;
+        });
+        skipCount = 0;
+    }
+    return [NSArray arrayWithArray:identifiers];
+}
+
+#pragma mark - Private
+
+- (NSInteger)indexOfContainerWithKey:(uint16_t)key
+{
+    NSInteger lower = 0;
+    NSInteger upper = (NSInteger)_numberOfContainers - 1;
+    while (lower <= upper) {
+        NSInteger middle = (lower + upper) >> 1;
+        uint16_t middleKey = _containers[middle].key;
+        if (middleKey < key) {
+            lower = middle + 1;
+        } else if (middleKey > key) {
+            upper = middle - 1;
+        } else {
+            return middle;
+        }
+    }
+    return -(lower + 1);
+}
+
+- (void)appendContainer:(NBMembershipContainer)container
+{
+    if (_numberOfContainers == _containersCapacity) {
+        _containersCapacity = MAX(_containersCapacity * 2, (NSUInteger)4);
+        _containers = realloc(_containers, _containersCapacity * sizeof(NBMembershipContainer));
+    }
+    _containers[_numberOfContainers++] = container;
+}
+
+- (NBClientMembershipSet *)setByCombiningWithSet:(NBClientMembershipSet *)otherSet operation:(NBMembershipOperation)operation
+{
+    NBClientMembershipSet *result = [[NBClientMembershipSet alloc] init];
+    NSUInteger index = 0, otherIndex = 0;
+    // Walk both sets' containers in key order, like a merge.
+    while (index < _numberOfContainers || otherIndex < otherSet->_numberOfContainers) {
+        const NBMembershipContainer *container = index < _numberOfContainers ? &_containers[index] : NULL;
+        const NBMembershipContainer *otherContainer = (otherIndex < otherSet->_numberOfContainers
+                                                       ? &otherSet->_containers[otherIndex] : NULL);
+        if (operation == NBMembershipOperationIntersection && (!container || !otherContainer)) {
+            break;
+        }
+        NBMembershipContainer resultContainer = { 0 };
+        if (container && (!otherContainer || container->key < otherContainer->key)) {
+            index += 1;
+            if (operation == NBMembershipOperationIntersection) {
+                continue;
+            }
+            resultContainer = ContainerCopy(container);
+        } else if (otherContainer && (!container || otherContainer->key < container->key)) {
+            otherIndex += 1;
+            if (operation != NBMembershipOperationUnion) {
+                continue;
+            }
+            resultContainer = ContainerCopy(otherContainer);
+        } else {
+            index += 1;
+            otherIndex += 1;
+            switch (operation) {
+                case NBMembershipOperationIntersection:
+                    resultContainer = ContainerIntersect(container, otherContainer);
+                    break;
+                case NBMembershipOperationUnion:
+                    resultContainer = ContainerUnite(container, otherContainer);
+                    break;
+                case NBMembershipOperationDifference:
+                    resultContainer = ContainerSubtract(container, otherContainer);
+                    break;
+            }
+        }
+        if (!resultContainer.cardinality) {
+            ContainerFree(&resultContainer);
+            continue;
+        }
+        [result appendContainer:resultContainer];
+    }
+    return result;
+}
+
+@end
+
+@interface NBClient (MembershipSetsPrivate)
+
+- (NBClientTaskGroup *)fetchMembershipSetWithPageFetcher:(NBClientPageFetcher)pageFetcher
+                                       completionHandler:(NBClientMembershipSetCompletionHandler)completionHandler;
+
+@end
+
+@implementation NBClient (MembershipSets)
+
+- (NBClientTaskGroup *)fetchListMembershipSetByIdentifier:(NSUInteger)listIdentifier
+                                        completionHandler:(NBClientMembershipSetCompletionHandler)completionHandler
+{
+    return [self fetchMembershipSetWithPageFetcher:^NSURLSessionDataTask *(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler pageCompletionHandler) {
+        return [self fetchListPeopleByIdentifier:listIdentifier withPaginationInfo:paginationInfo completionHandler:pageCompletionHandler];
+    } completionHandler:completionHandler];
+}
+
+- (NBClientTaskGroup *)fetchTagMembershipSetByName:(NSString *)tagName
+                                 completionHandler:(NBClientMembershipSetCompletionHandler)completionHandler
+{
+    return [self fetchMembershipSetWithPageFetcher:^NSURLSessionDataTask *(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler pageCompletionHandler) {
+        return [self fetchTagPeopleByName:tagName withPaginationInfo:paginationInfo completionHandler:pageCompletionHandler];
+    } completionHandler:completionHandler];
+}
+
+- (NBClientTaskGroup *)fetchPeopleInMembershipSet:(NBClientMembershipSet *)membershipSet
+                                            range:(NSRange)range
+                                completionHandler:(NBClientResourceListCompletionHandler)completionHandler
+{
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    NSArray *identifiers = [membershipSet identifiersInRange:range];
+    if (!identifiers.count) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(@[], nil, nil);
+        });
+        return taskGroup;
+    }
+    // Completion handlers are called on the main queue, so no locking is needed.
+    NSMutableArray *people = [NSMutableArray arrayWithCapacity:identifiers.count];
+    for (NSUInteger index = 0; index < identifiers.count; index++) {
+        [people addObject:[NSNull null]];
+    }
+    __block NSUInteger nextIndex = 0;
+    __block NSUInteger remainingCount = identifiers.count;
+    __block BOOL didFail = NO;
+    __block void (^fetchNextPerson)(void);
+    fetchNextPerson = ^{
+        if (nextIndex >= identifiers.count) {
+            return;
+        }
+        NSUInteger index = nextIndex;
+        nextIndex += 1;
+        [self performRequestsInTaskGroup:taskGroup usingBlock:^{
+            [self fetchPersonByIdentifier:[identifiers[index] unsignedIntegerValue] withCompletionHandler:^(NSDictionary *item, NSError *error) {
+                if (didFail) {
+                    return;
+                }
+                if (error && [error.userInfo[NBClientErrorHTTPStatusCodeKey] integerValue] != 404) {
+                    didFail = YES;
+                    fetchNextPerson = nil;
+                    [taskGroup cancel];
+                    completionHandler(nil, nil, error);
+                    return;
+                }
+                if (item) {
+                    people[index] = item;
+                }
+                remainingCount -= 1;
+                if (remainingCount) {
+                    fetchNextPerson();
+                    return;
+                }
+                fetchNextPerson = nil;
+                [people removeObjectIdenticalTo:[NSNull null]];
+                completionHandler([NSArray arrayWithArray:people], nil, nil);
+            }];
+        }];
+    };
+    for (NSUInteger index = 0; index < MaximumNumberOfConcurrentPersonFetches; index++) {
+        fetchNextPerson();
+    }
+    return taskGroup;
+}
+
+#pragma mark - Private
+
+- (NBClientTaskGroup *)fetchMembershipSetWithPageFetcher:(NBClientPageFetcher)pageFetcher
+                                       completionHandler:(NBClientMembershipSetCompletionHandler)completionHandler
+{
+    NBClientMembershipSet *membershipSet = [[NBClientMembershipSet alloc] init];
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:self.shouldUseLegacyPagination];
+    paginationInfo.numberOfItemsPerPage = MembershipPageSize;
+    return [self fetchAllPagesWithPaginationInfo:paginationInfo maximumNumberOfConcurrentPages:MaximumNumberOfConcurrentPages pageFetcher:^NSURLSessionDataTask *(NBPaginationInfo *pageInfo, NBClientResourceListCompletionHandler pageCompletionHandler) {
+        return pageFetcher(pageInfo, ^(NSArray *items, NBPaginationInfo *resultInfo, NSError *error) {
+            // Keep only the identifiers, so pages don't pile up.
+            for (NSDictionary *item in items) {
+                id identifier = item[@"id"];
+                if ([identifier isKindOfClass:[NSNumber class]]) {
+                    [membershipSet addIdentifier:[identifier unsignedIntegerValue]];
+                }
+            }
+            pageCompletionHandler(@[], resultInfo, error);
+        });
+    } completionHandler:^(NSArray *items, NBPaginationInfo *lastPaginationInfo, NSError *error) {
+        completionHandler(error ? nil : membershipSet, error);
+    }];
+}
+
+@end
@@ -0,0 +1,60 @@
+//
+//  NBClientPageSizer.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+@class NBPaginationInfo;
+
+// Keys of an endpoint's estimates.
+extern NSString * __nonnull const NBClientPageSizerRoundTripTimeKey; // Seconds.
+extern NSString * __nonnull const NBClientPageSizerBytesPerSecondKey;
+extern NSString * __nonnull const NBClientPageSizerBytesPerItemKey;
+
+// The page sizer picks the number of items per page from how each endpoint
+// has performed, instead of a fixed guess. It models a page's duration as a
+// round trip plus its bytes over the transfer rate, fit to the last pages of
+// the endpoint. First pages get as many items as fit in the first page target
+// duration, so something shows up quickly. Each later page grows by the growth
+// factor, up to the size where the round trip is at most the maximum latency
+// overhead of the page's duration, and never beyond the maximum, which is the
+// API's. Until an endpoint has pages, it starts at the minimum. Thread-safe.
+@interface NBClientPageSizer : NSObject <NBLogging>
+
+// Defaults to 10 and 100.
+@property (nonatomic) NSUInteger minimumNumberOfItemsPerPage;
+@property (nonatomic) NSUInteger maximumNumberOfItemsPerPage;
+// Defaults to 0.5 seconds.
+@property (nonatomic) NSTimeInterval firstPageTargetDuration;
+// Defaults to 0.1.
+@property (nonatomic) double maximumLatencyOverhead;
+// Defaults to 2.
+@property (nonatomic) double growthFactor;
+// Of pages kept per endpoint. Defaults to 16.
+@property (nonatomic) NSUInteger maximumNumberOfSamples;
+
+// Durations are from the request's creation to its response.
+- (void)recordPageForPath:(nonnull NSString *)path
+            numberOfItems:(NSUInteger)numberOfItems
+            numberOfBytes:(NSUInteger)numberOfBytes
+                 duration:(NSTimeInterval)duration;
+
+- (NSUInteger)numberOfItemsForFirstPageForPath:(nonnull NSString *)path;
+- (NSUInteger)numberOfItemsForPageForPath:(nonnull NSString *)path
+               afterPageWithNumberOfItems:(NSUInteger)previousNumberOfItems;
+
+// Sizes a request's pagination info, as the client does. Legacy pages after
+// the first are left alone, since their page numbers assume a fixed size.
+- (void)updatePaginationInfo:(nonnull NBPaginationInfo *)paginationInfo forPath:(nonnull NSString *)path;
+
+// Returns nil until the endpoint has pages.
+- (nullable NSDictionary *)estimatesForPath:(nonnull NSString *)path;
+
+- (void)removeAllSamples;
+
+@end
@@ -0,0 +1,208 @@
+//
+//  NBClientPageSizer.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientPageSizer.h"
+
+#import "NBPaginationInfo.h"
+
+NSString * const NBClientPageSizerRoundTripTimeKey = @"round_trip_time";
+NSString * const NBClientPageSizerBytesPerSecondKey = @"bytes_per_second";
+NSString * const NBClientPageSizerBytesPerItemKey = @"bytes_per_item";
+
+static NSUInteger DefaultMinimumNumberOfItemsPerPage = 10;
+static NSUInteger DefaultMaximumNumberOfItemsPerPage = 100;
+static NSTimeInterval DefaultFirstPageTargetDuration = 0.5f;
+static double DefaultMaximumLatencyOverhead = 0.1;
+static double DefaultGrowthFactor = 2.0;
+static NSUInteger DefaultMaximumNumberOfSamples = 16;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientPageSizer ()
+
+// Paths to arrays of samples, each of items, bytes, and duration.
+@property (nonatomic) NSMutableDictionary *samplesByPath;
+
+- (NSUInteger)clampedNumberOfItems:(double)numberOfItems;
+
+@end
+
+@implementation NBClientPageSizer
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.minimumNumberOfItemsPerPage = DefaultMinimumNumberOfItemsPerPage;
+        self.maximumNumberOfItemsPerPage = DefaultMaximumNumberOfItemsPerPage;
+        self.firstPageTargetDuration = DefaultFirstPageTargetDuration;
+        self.maximumLatencyOverhead = DefaultMaximumLatencyOverhead;
+        self.growthFactor = DefaultGrowthFactor;
+        self.maximumNumberOfSamples = DefaultMaximumNumberOfSamples;
+        self.samplesByPath = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Public
+
+- (void)recordPageForPath:(NSString *)path
+            numberOfItems:(NSUInteger)numberOfItems
+            numberOfBytes:(NSUInteger)numberOfBytes
+                 duration:(NSTimeInterval)duration
+{
+    @synchronized(self) {
+        NSMutableArray *samples = self.samplesByPath[path];
+        if (!samples) {
+            samples = [NSMutableArray array];
+            self.samplesByPath[path] = samples;
+        }
+        [samples addObject:@[ @(numberOfItems), @(numberOfBytes), @(duration) ]];
+        if (samples.count > self.maximumNumberOfSamples) {
+            [samples removeObjectsInRange:NSMakeRange(0, samples.count - self.maximumNumberOfSamples)];
+        }
+    }
+    NBLogDebug(@"Recorded page of %lu item(s), %lu byte(s) in %.3fs for %@",
+               (unsigned long)numberOfItems, (unsigned long)numberOfBytes, duration, path);
+}
+
+- (NSUInteger)numberOfItemsForFirstPageForPath:(NSString *)path
+{
+    NSDictionary *estimates = [self estimatesForPath:path];
+    if (!estimates) {
+        return [self clampedNumberOfItems:self.minimumNumberOfItemsPerPage];
+    }
+    NSTimeInterval transferDuration = self.firstPageTargetDuration - [estimates[NBClientPageSizerRoundTripTimeKey] doubleValue];
+    double numberOfItems = (MAX(transferDuration, 0.0) * [estimates[NBClientPageSizerBytesPerSecondKey] doubleValue]
+                            / [estimates[NBClientPageSizerBytesPerItemKey] doubleValue]);
+    return [self clampedNumberOfItems:numberOfItems];
+}
+
+- (NSUInteger)numberOfItemsForPageForPath:(NSString *)path afterPageWithNumberOfItems:(NSUInteger)previousNumberOfItems
+{
+    double grownNumberOfItems = MAX(previousNumberOfItems, (NSUInteger)1) * MAX(self.growthFactor, 1.0);
+    NSDictionary *estimates = [self estimatesForPath:path];
+    if (!estimates) {
+        return [self clampedNumberOfItems:grownNumberOfItems];
+    }
+    // The page's transfer should take long enough that its round trip is at
+    // most the overhead: rtt / (rtt + transfer) <= overhead.
+    double overhead = MIN(MAX(self.maximumLatencyOverhead, 0.01), 1.0);
+    NSTimeInterval transferDuration = [estimates[NBClientPageSizerRoundTripTimeKey] doubleValue] * (1.0 - overhead) / overhead;
+    double targetNumberOfItems = (transferDuration * [estimates[NBClientPageSizerBytesPerSecondKey] doubleValue]
+                                  / [estimates[NBClientPageSizerBytesPerItemKey] doubleValue]);
+    // Grow toward the target, without shrinking.
+    return [self clampedNumberOfItems:MIN(grownNumberOfItems, MAX(targetNumberOfItems, (double)previousNumberOfItems))];
+}
+
+- (void)updatePaginationInfo:(NBPaginationInfo *)paginationInfo forPath:(NSString *)path
+{
+    BOOL isFirstPage;
+    if (paginationInfo.isLegacy) {
+        isFirstPage = paginationInfo.currentPageNumber <= 1;
+    } else {
+        isFirstPage = !(paginationInfo.currentDirection == NBPaginationDirectionNext
+                        ? paginationInfo.nextPageURLString : paginationInfo.previousPageURLString);
+    }
+    NSUInteger numberOfItems;
+    if (isFirstPage) {
+        numberOfItems = [self numberOfItemsForFirstPageForPath:path];
+    } else if (!paginationInfo.isLegacy) {
+        numberOfItems = [self numberOfItemsForPageForPath:path afterPageWithNumberOfItems:paginationInfo.numberOfItemsPerPage];
+    } else {
+        return;
+    }
+    if (numberOfItems != paginationInfo.numberOfItemsPerPage) {
+        NBLogInfo(@"Sizing %@ page to %lu item(s)", path, (unsigned long)numberOfItems);
+    }
+    paginationInfo.numberOfItemsPerPage = numberOfItems;
+    paginationInfo.overridesLinkLimit = !paginationInfo.isLegacy;
+}
+
+- (NSDictionary *)estimatesForPath:(NSString *)path
+{
+    NSArray *samples;
+    @synchronized(self) {
+        samples = [self.samplesByPath[path] copy];
+    }
+    NSUInteger numberOfItems = 0;
+    double totalBytes = 0.0;
+    double totalDuration = 0.0;
+    for (NSArray *sample in samples) {
+        numberOfItems += [sample[0] unsignedIntegerValue];
+        totalBytes += [sample[1] doubleValue];
+        totalDuration += [sample[2] doubleValue];
+    }
+    if (!numberOfItems || !totalBytes) {
+        return nil;
+    }
+    // Least squares fit of duration to bytes.
+    double meanBytes = totalBytes / samples.count;
+    double meanDuration = totalDuration / samples.count;
+    double bytesVariance = 0.0;
+    double covariance = 0.0;
+    for (NSArray *sample in samples) {
+        double bytesDeviation = [sample[1] doubleValue] - meanBytes;
+        bytesVariance += bytesDeviation * bytesDeviation;
+        covariance += bytesDeviation * ([sample[2] doubleValue] - meanDuration);
+    }
+    double secondsPerByte = bytesVariance > 0.0 ? covariance / bytesVariance : 0.0;
+    NSTimeInterval roundTripTime = meanDuration - secondsPerByte * meanBytes;
+    double bytesPerSecond;
+    if (secondsPerByte > 0.0 && roundTripTime >= 0.0) {
+        bytesPerSecond = 1.0 / secondsPerByte;
+    } else {
+        // Pages too alike, or too noisy, to tell apart. Assume the worst of both.
+        roundTripTime = DBL_MAX;
+        bytesPerSecond = 0.0;
+        for (NSArray *sample in samples) {
+            NSTimeInterval duration = [sample[2] doubleValue];
+            roundTripTime = MIN(roundTripTime, duration);
+            if (duration > 0.0) {
+                bytesPerSecond = MAX(bytesPerSecond, [sample[1] doubleValue] / duration);
+            }
+        }
+        if (!bytesPerSecond) {
+            return nil;
+        }
+    }
+    return @{ NBClientPageSizerRoundTripTimeKey: @(roundTripTime),
+              NBClientPageSizerBytesPerSecondKey: @(bytesPerSecond),
+              NBClientPageSizerBytesPerItemKey: @(totalBytes / numberOfItems) };
+}
+
+- (void)removeAllSamples
+{
+    @synchronized(self) {
+        [self.samplesByPath removeAllObjects];
+    }
+}
+
+#pragma mark - Private
+
+- (NSUInteger)clampedNumberOfItems:(double)numberOfItems
+{
+    NSUInteger minimum = MAX(self.minimumNumberOfItemsPerPage, (NSUInteger)1);
+    NSUInteger maximum = MAX(self.maximumNumberOfItemsPerPage, minimum);
+    if (numberOfItems >= maximum) {
+        return maximum;
+    }
+    return MAX((NSUInteger)floor(numberOfItems), minimum);
+}
+
+@end
@@ -0,0 +1,59 @@
+//
+//  NBClientPeopleSnapshot.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+extern NSUInteger const NBClientPeopleSnapshotVersion;
+
+// Cursor keys.
+extern NSString * __nonnull const NBClientPeopleSnapshotPaginationInfoKey; // Dictionary, of the last page.
+extern NSString * __nonnull const NBClientPeopleSnapshotLegacyKey;
+extern NSString * __nonnull const NBClientPeopleSnapshotPageCursorsKey; // Dictionary of page numbers, as strings, to dictionaries.
+
+// A people snapshot is the last pages of people a screen rendered, saved in a
+// compact binary file so the next cold launch can show them before any request
+// or JSON parsing. The file has a header, a table of fixed-width records, one
+// per person, and a table of the UTF-8 strings they point into, deduplicated,
+// followed by the pagination cursor. The file is memory-mapped, so opening it
+// only reads the header, and records are decoded as they're accessed.
+//
+// Only the person's identifier and the string values of the snapshot's keys,
+// or arrays of strings like `tags`, are kept; it's meant for rendering, not as
+// a source of truth. Files of another version or with bad offsets fail to open.
+@interface NBClientPeopleSnapshot : NSObject <NBLogging>
+
+// The string keys of each record, besides `id`.
+@property (nonatomic, copy, readonly, nonnull) NSArray *keys;
+@property (nonatomic, readonly) NSUInteger numberOfItems;
+@property (nonatomic, copy, readonly, nonnull) NSDictionary *cursor;
+
+// Ie. the names, contact info, profile image URL and tags.
++ (nonnull NSArray *)defaultKeys;
+
++ (nullable NSData *)dataWithItems:(nonnull NSArray *)items
+                              keys:(nonnull NSArray *)keys
+                            cursor:(nullable NSDictionary *)cursor
+                             error:(NSError * __nullable * __nullable)error;
+// Writes atomically, creating the directory if needed.
++ (BOOL)writeItems:(nonnull NSArray *)items
+              keys:(nonnull NSArray *)keys
+            cursor:(nullable NSDictionary *)cursor
+             toURL:(nonnull NSURL *)fileURL
+             error:(NSError * __nullable * __nullable)error;
+
+// Designated initializer. Validates the header and tables, but decodes nothing.
+- (nullable instancetype)initWithData:(nonnull NSData *)data error:(NSError * __nullable * __nullable)error;
+// Memory-maps the file.
+- (nullable instancetype)initWithContentsOfURL:(nonnull NSURL *)fileURL error:(NSError * __nullable * __nullable)error;
+
+- (nonnull NSDictionary *)itemAtIndex:(NSUInteger)index;
+- (nonnull NSArray *)itemsInRange:(NSRange)range;
+- (nonnull NSArray *)items;
+
+@end
@@ -0,0 +1,324 @@
+//
+//  NBClientPeopleSnapshot.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientPeopleSnapshot.h"
+
+NSUInteger const NBClientPeopleSnapshotVersion = 1;
+
+NSString * const NBClientPeopleSnapshotPaginationInfoKey = @"pagination_info";
+NSString * const NBClientPeopleSnapshotLegacyKey = @"legacy";
+NSString * const NBClientPeopleSnapshotPageCursorsKey = @"page_cursors";
+
+static uint32_t const Magic = 0x4E425053; // NBPS
+static uint32_t const MissingStringOffset = UINT32_MAX;
+static uint32_t const ListFlag = 1u << 31;
+static NSString *ListSeparator = @"\x1f";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+// All fields are little-endian. The header is followed by the key table, then
+// the records, the string table and the cursor, a binary plist.
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numberOfRecords;
+    uint32_t numberOfKeys;
+    uint32_t keysOffset;
+    uint32_t recordsOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsLength;
+    uint32_t cursorOffset;
+    uint32_t cursorLength;
+} NBPeopleSnapshotHeader;
+
+// Into the string table.
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} NBPeopleSnapshotStringRef;
+
+// Records are an identifier followed by a string reference per key.
+static size_t RecordSize(uint32_t numberOfKeys)
+{
+    return sizeof(uint64_t) + numberOfKeys * sizeof(NBPeopleSnapshotStringRef);
+}
+
+static NSError *CorruptFileError(NSString *reason)
+{
+    return [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError
+                           userInfo:@{ NSLocalizedFailureReasonErrorKey: reason }];
+}
+
+static NBPeopleSnapshotStringRef AddString(NSString *string, BOOL isList,
+                                           NSMutableData *strings, NSMutableDictionary *stringRefs)
+{
+    NBPeopleSnapshotStringRef stringRef = { CFSwapInt32HostToLittle(MissingStringOffset), 0 };
+    if (!string) {
+        return stringRef;
+    }
+    NSValue *existingRef = stringRefs[string];
+    if (existingRef) {
+        [existingRef getValue:&stringRef];
+    } else {
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+        stringRef.offset = CFSwapInt32HostToLittle((uint32_t)strings.length);
+        stringRef.length = CFSwapInt32HostToLittle((uint32_t)data.length);
+        [strings appendData:data];
+        stringRefs[string] = [NSValue valueWithBytes:&stringRef objCType:@encode(NBPeopleSnapshotStringRef)];
+    }
+    if (isList) {
+        stringRef.length = CFSwapInt32HostToLittle(CFSwapInt32LittleToHost(stringRef.length) | ListFlag);
+    }
+    return stringRef;
+}
+
+@interface NBClientPeopleSnapshot ()
+
+@property (nonatomic, copy, readwrite) NSArray *keys;
+@property (nonatomic, readwrite) NSUInteger numberOfItems;
+@property (nonatomic, copy, readwrite) NSDictionary *cursor;
+
+@property (nonatomic) NSData *data;
+@property (nonatomic) NBPeopleSnapshotHeader header;
+
+// Returns nil if missing or out of bounds.
+- (id)stringWithRef:(NBPeopleSnapshotStringRef)stringRef;
+
+@end
+
+@implementation NBClientPeopleSnapshot
+
+- (instancetype)initWithData:(NSData *)data error:(NSError *__autoreleasing *)error
+{
+    self = [super init];
+    if (!self) {
+        return nil;
+    }
+    self.data = data;
+    NSError *validationError;
+    NBPeopleSnapshotHeader header = { 0 };
+    if (data.length < sizeof(header)) {
+        validationError = CorruptFileError(@"Snapshot is too short.");
+    } else {
+        [data getBytes:&header length:sizeof(header)];
+        uint32_t *fields = (uint32_t *)&header;
+        for (NSUInteger index = 0; index < sizeof(header) / sizeof(uint32_t); index++) {
+            fields[index] = CFSwapInt32LittleToHost(fields[index]);
+        }
+        self.header = header;
+        uint64_t length = data.length;
+        if (header.magic != Magic) {
+            validationError = CorruptFileError(@"Not a people snapshot.");
+        } else if (header.version != NBClientPeopleSnapshotVersion) {
+            validationError = CorruptFileError([NSString stringWithFormat:@"Snapshot is version %u.", header.version]);
+        } else if ((uint64_t)header.keysOffset + (uint64_t)header.numberOfKeys * sizeof(NBPeopleSnapshotStringRef) > length ||
+                   (uint64_t)header.recordsOffset + (uint64_t)header.numberOfRecords * RecordSize(header.numberOfKeys) > length ||
+                   (uint64_t)header.stringsOffset + header.stringsLength > length ||
+                   (uint64_t)header.cursorOffset + header.cursorLength > length)
+        {
+            validationError = CorruptFileError(@"Snapshot tables are out of bounds.");
+        }
+    }
+    if (!validationError) {
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:header.numberOfKeys];
+        for (NSUInteger index = 0; index < header.numberOfKeys; index++) {
+            NBPeopleSnapshotStringRef stringRef;
+            [data getBytes:&stringRef range:NSMakeRange(header.keysOffset + index * sizeof(stringRef), sizeof(stringRef))];
+            NSString *key = [self stringWithRef:stringRef];
+            if (![key isKindOfClass:[NSString class]]) {
+                validationError = CorruptFileError(@"Snapshot has a bad key.");
+                break;
+            }
+            [keys addObject:key];
+        }
+        self.keys = keys;
+    }
+    if (!validationError) {
+        NSDictionary *cursor = @{};
+        if (header.cursorLength) {
+            cursor = [NSPropertyListSerialization
+                      propertyListWithData:[data subdataWithRange:NSMakeRange(header.cursorOffset, header.cursorLength)]
+                      options:NSPropertyListImmutable format:NULL error:nil];
+        }
+        if (![cursor isKindOfClass:[NSDictionary class]]) {
+            validationError = CorruptFileError(@"Snapshot has a bad cursor.");
+        }
+        self.cursor = cursor;
+    }
+    if (validationError) {
+        NBLogWarning(@"Invalid people snapshot: %@", validationError.localizedFailureReason);
+        if (error) {
+            *error = validationError;
+        }
+        return nil;
+    }
+    self.numberOfItems = header.numberOfRecords;
+    return self;
+}
+
+- (instancetype)initWithContentsOfURL:(NSURL *)fileURL error:(NSError *__autoreleasing *)error
+{
+    NSData *data = [NSData dataWithContentsOfURL:fileURL options:NSDataReadingMappedAlways error:error];
+    if (!data) {
+        return nil;
+    }
+    return [self initWithData:data error:error];
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Public
+
++ (NSArray *)defaultKeys
+{
+    return @[ @"first_name", @"last_name", @"email", @"phone", @"mobile", @"profile_image_url_ssl", @"tags" ];
+}
+
++ (NSData *)dataWithItems:(NSArray *)items keys:(NSArray *)keys cursor:(NSDictionary *)cursor error:(NSError *__autoreleasing *)error
+{
+    NSData *cursorData = [NSPropertyListSerialization dataWithPropertyList:(cursor ?: @{}) format:NSPropertyListBinaryFormat_v1_0
+                                                                   options:0 error:error];
+    if (!cursorData) {
+        return nil;
+    }
+    NSMutableData *strings = [NSMutableData data];
+    NSMutableDictionary *stringRefs = [NSMutableDictionary dictionary];
+    NSMutableData *keyTable = [NSMutableData dataWithCapacity:keys.count * sizeof(NBPeopleSnapshotStringRef)];
+    for (NSString *key in keys) {
+        NBPeopleSnapshotStringRef stringRef = AddString(key, NO, strings, stringRefs);
+        [keyTable appendBytes:&stringRef length:sizeof(stringRef)];
+    }
+    size_t recordSize = RecordSize((uint32_t)keys.count);
+    NSMutableData *records = [NSMutableData dataWithCapacity:items.count * recordSize];
+    for (NSDictionary *item in items) {
+        NSNumber *identifier = [item[@"id"] isKindOfClass:[NSNumber class]] ? item[@"id"] : nil;
+        uint64_t recordIdentifier = CFSwapInt64HostToLittle(identifier.unsignedLongLongValue);
+        [records appendBytes:&recordIdentifier length:sizeof(recordIdentifier)];
+        for (NSString *key in keys) {
+            id value = item[key];
+            NBPeopleSnapshotStringRef stringRef;
+            if ([value isKindOfClass:[NSString class]]) {
+                stringRef = AddString(value, NO, strings, stringRefs);
+            } else if ([value isKindOfClass:[NSArray class]] &&
+                       [[value filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"self isKindOfClass: %@", [NSString class]]]
+                        count] == [value count])
+            {
+                stringRef = AddString([value componentsJoinedByString:ListSeparator], YES, strings, stringRefs);
+            } else {
+                stringRef = AddString(nil, NO, strings, stringRefs);
+            }
+            [records appendBytes:&stringRef length:sizeof(stringRef)];
+        }
+    }
+    NBPeopleSnapshotHeader header;
+    header.magic = Magic;
+    header.version = (uint32_t)NBClientPeopleSnapshotVersion;
+    header.numberOfRecords = (uint32_t)items.count;
+    header.numberOfKeys = (uint32_t)keys.count;
+    header.keysOffset = sizeof(header);
+    header.recordsOffset = header.keysOffset + (uint32_t)keyTable.length;
+    header.stringsOffset = header.recordsOffset + (uint32_t)records.length;
+    header.stringsLength = (uint32_t)strings.length;
+    header.cursorOffset = header.stringsOffset + header.stringsLength;
+    header.cursorLength = (uint32_t)cursorData.length;
+    if ((uint64_t)sizeof(header) + keyTable.length + records.length + strings.length + cursorData.length > UINT32_MAX ||
+        (uint64_t)strings.length >= ListFlag)
+    {
+        if (error) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileWriteOutOfSpaceError userInfo:nil];
+        }
+        return nil;
+    }
+    uint32_t *fields = (uint32_t *)&header;
+    for (NSUInteger index = 0; index < sizeof(header) / sizeof(uint32_t); index++) {
+        fields[index] = CFSwapInt32HostToLittle(fields[index]);
+    }
+    NSMutableData *data = [NSMutableData dataWithBytes:&header length:sizeof(header)];
+    [data appendData:keyTable];
+    [data appendData:records];
+    [data appendData:strings];
+    [data appendData:cursorData];
+    return [NSData dataWithData:data];
+}
+
++ (BOOL)writeItems:(NSArray *)items keys:(NSArray *)keys cursor:(NSDictionary *)cursor toURL:(NSURL *)fileURL error:(NSError *__autoreleasing *)error
+{
+    NSData *data = [self dataWithItems:items keys:keys cursor:cursor error:error];
+    if (!data ||
+        ![[NSFileManager defaultManager] createDirectoryAtURL:fileURL.URLByDeletingLastPathComponent
+                                  withIntermediateDirectories:YES attributes:nil error:error] ||
+        ![data writeToURL:fileURL options:NSDataWritingAtomic error:error])
+    {
+        return NO;
+    }
+    NBLogInfo(@"Wrote snapshot of %lu people, %lu byte(s), to %@", (unsigned long)items.count, (unsigned long)data.length, fileURL);
+    return YES;
+}
+
+- (NSDictionary *)itemAtIndex:(NSUInteger)index
+{
+    NSAssert(index < self.numberOfItems, @"Index is out of bounds.");
+    NBPeopleSnapshotHeader header = self.header;
+    size_t recordSize = RecordSize(header.numberOfKeys);
+    const uint8_t *record = (const uint8_t *)self.data.bytes + header.recordsOffset + index * recordSize;
+    NSMutableDictionary *item = [NSMutableDictionary dictionaryWithCapacity:self.keys.count + 1];
+    uint64_t identifier;
+    memcpy(&identifier, record, sizeof(identifier));
+    item[@"id"] = @(CFSwapInt64LittleToHost(identifier));
+    [self.keys enumerateObjectsUsingBlock:^(NSString *key, NSUInteger keyIndex, BOOL *stop) {
+        NBPeopleSnapshotStringRef stringRef;
+        memcpy(&stringRef, record + sizeof(uint64_t) + keyIndex * sizeof(stringRef), sizeof(stringRef));
+        item[key] = [self stringWithRef:stringRef];
+    }];
+    return [NSDictionary dictionaryWithDictionary:item];
+}
+
+- (NSArray *)itemsInRange:(NSRange)range
+{
+    NSAssert(NSMaxRange(range) <= self.numberOfItems, @"Range is out of bounds.");
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:range.length];
+    for (NSUInteger index = range.location; index < NSMaxRange(range); index++) {
+        [items addObject:[self itemAtIndex:index]];
+    }
+    return [NSArray arrayWithArray:items];
+}
+
+- (NSArray *)items
+{
+    return [self itemsInRange:NSMakeRange(0, self.numberOfItems)];
+}
+
+#pragma mark - Private
+
+- (id)stringWithRef:(NBPeopleSnapshotStringRef)stringRef
+{
+    uint32_t offset = CFSwapInt32LittleToHost(stringRef.offset);
+    uint32_t length = CFSwapInt32LittleToHost(stringRef.length);
+    BOOL isList = (length & ListFlag) != 0;
+    length &= ~ListFlag;
+    NBPeopleSnapshotHeader header = self.header;
+    if (offset == MissingStringOffset || (uint64_t)offset + length > header.stringsLength) {
+        return nil;
+    }
+    NSString *string = [[NSString alloc] initWithBytes:(const uint8_t *)self.data.bytes + header.stringsOffset + offset
+                                                length:length encoding:NSUTF8StringEncoding];
+    if (isList) {
+        return string.length ? [string componentsSeparatedByString:ListSeparator] : @[];
+    }
+    return string;
+}
+
+@end
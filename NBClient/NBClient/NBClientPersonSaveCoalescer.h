@@ -0,0 +1,53 @@
+//
+//  NBClientPersonSaveCoalescer.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+extern NSTimeInterval const NBClientPersonSaveDefaultCoalescingInterval;
+
+// The coalescer merges quick successive saves of the same person, ie. from
+// autosave during data entry, into one request. Each save restarts the
+// person's coalescing interval, and once it passes, only the merged changes
+// that differ from the person as last saved are sent. Saving again while a
+// save is in flight cancels it and folds its changes into the next one. Every
+// caller's completion handler is called with the outcome of the request that
+// carried its changes, or with no item and no error if none were left to
+// send. Like the client, it should be used from the main queue.
+@interface NBClientPersonSaveCoalescer : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+
+// Defaults to `NBClientPersonSaveDefaultCoalescingInterval`, half a second.
+@property (nonatomic) NSTimeInterval coalescingInterval;
+// Optional. Requests are made in this group.
+@property (nonatomic, nullable) NBClientTaskGroup *taskGroup;
+
+@property (nonatomic, readonly) NSUInteger numberOfRequestedSaves;
+@property (nonatomic, readonly) NSUInteger numberOfSentSaves;
+
+// Designated initializer.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client;
+
+// PUT /people/:id
+// Pass the person as last fetched or saved, if known, so unchanged values
+// aren't sent.
+- (void)savePersonByIdentifier:(NSUInteger)identifier
+                   withChanges:(nonnull NSDictionary *)changes
+                originalPerson:(nullable NSDictionary *)person
+             completionHandler:(nullable NBClientResourceItemCompletionHandler)completionHandler;
+
+// Sends all pending saves now, ie. before leaving an edit screen. Pending saves
+// are otherwise still sent after their interval, even if the coalescer has
+// been released by then.
+- (void)flush;
+// Pending and in-flight saves are dropped, and their completion handlers get
+// a cancelled error.
+- (void)cancelSavesForPersonByIdentifier:(NSUInteger)identifier;
+
+@end
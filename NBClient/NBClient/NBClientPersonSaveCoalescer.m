@@ -0,0 +1,219 @@
+//
+//  NBClientPersonSaveCoalescer.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientPersonSaveCoalescer.h"
+
+#import "NBClient+People.h"
+
+NSTimeInterval const NBClientPersonSaveDefaultCoalescingInterval = 0.5f;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+// Per-person state.
+@interface NBClientPersonSave : NSObject
+
+@property (nonatomic, copy) NSDictionary *person;
+
+@property (nonatomic) NSMutableDictionary *pendingChanges;
+@property (nonatomic) NSMutableArray *pendingCompletionHandlers;
+@property (nonatomic) NSUInteger pendingGeneration;
+
+@property (nonatomic) NSURLSessionDataTask *sentTask;
+@property (nonatomic, copy) NSDictionary *sentChanges;
+@property (nonatomic, copy) NSArray *sentCompletionHandlers;
+@property (nonatomic) NSUInteger sentGeneration;
+
+@end
+
+@implementation NBClientPersonSave
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.pendingChanges = [NSMutableDictionary dictionary];
+        self.pendingCompletionHandlers = [NSMutableArray array];
+    }
+    return self;
+}
+
+@end
+
+@interface NBClientPersonSaveCoalescer ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+
+@property (nonatomic, readwrite) NSUInteger numberOfRequestedSaves;
+@property (nonatomic, readwrite) NSUInteger numberOfSentSaves;
+
+@property (nonatomic) NSMutableDictionary *savesByIdentifier;
+
+- (void)sendSave:(NBClientPersonSave *)save forIdentifier:(NSUInteger)identifier;
+
+@end
+
+@implementation NBClientPersonSaveCoalescer
+
+- (instancetype)initWithClient:(NBClient *)client
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.coalescingInterval = NBClientPersonSaveDefaultCoalescingInterval;
+        self.savesByIdentifier = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Public
+
+- (void)savePersonByIdentifier:(NSUInteger)identifier
+                   withChanges:(NSDictionary *)changes
+                originalPerson:(NSDictionary *)person
+             completionHandler:(NBClientResourceItemCompletionHandler)completionHandler
+{
+    self.numberOfRequestedSaves += 1;
+    NBClientPersonSave *save = self.savesByIdentifier[@(identifier)];
+    if (!save) {
+        save = [[NBClientPersonSave alloc] init];
+        self.savesByIdentifier[@(identifier)] = save;
+    }
+    if (person && !save.sentTask) {
+        save.person = person;
+    }
+    if (save.sentTask) {
+        // Supersede the in-flight save, keeping its changes and callers.
+        NBLogInfo(@"Superseding in-flight save of person %lu", (unsigned long)identifier);
+        NSMutableDictionary *pendingChanges = save.sentChanges.mutableCopy;
+        [pendingChanges addEntriesFromDictionary:save.pendingChanges];
+        save.pendingChanges = pendingChanges;
+        [save.pendingCompletionHandlers insertObjects:save.sentCompletionHandlers
+                                            atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, save.sentCompletionHandlers.count)]];
+        save.sentGeneration += 1;
+        [save.sentTask cancel];
+        save.sentTask = nil;
+        save.sentChanges = nil;
+        save.sentCompletionHandlers = nil;
+    }
+    [save.pendingChanges addEntriesFromDictionary:changes];
+    if (completionHandler) {
+        [save.pendingCompletionHandlers addObject:completionHandler];
+    }
+    // Restart the interval.
+    save.pendingGeneration += 1;
+    NSUInteger pendingGeneration = save.pendingGeneration;
+    // Retain self until then, so edits aren't dropped if the owner goes away.
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.coalescingInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        if (self.savesByIdentifier[@(identifier)] != save || save.pendingGeneration != pendingGeneration) {
+            return;
+        }
+        [self sendSave:save forIdentifier:identifier];
+    });
+}
+
+- (void)flush
+{
+    [self.savesByIdentifier.copy enumerateKeysAndObjectsUsingBlock:^(NSNumber *identifier, NBClientPersonSave *save, BOOL *stop) {
+        if (save.pendingChanges.count || save.pendingCompletionHandlers.count) {
+            [self sendSave:save forIdentifier:identifier.unsignedIntegerValue];
+        }
+    }];
+}
+
+- (void)cancelSavesForPersonByIdentifier:(NSUInteger)identifier
+{
+    NBClientPersonSave *save = self.savesByIdentifier[@(identifier)];
+    if (!save) {
+        return;
+    }
+    [self.savesByIdentifier removeObjectForKey:@(identifier)];
+    save.sentGeneration += 1;
+    [save.sentTask cancel];
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    for (NBClientResourceItemCompletionHandler completionHandler in
+         [save.sentCompletionHandlers ?: @[] arrayByAddingObjectsFromArray:save.pendingCompletionHandlers])
+    {
+        completionHandler(nil, error);
+    }
+}
+
+#pragma mark - Private
+
+- (void)sendSave:(NBClientPersonSave *)save forIdentifier:(NSUInteger)identifier
+{
+    save.pendingGeneration += 1;
+    // Only send what differs from the person as last saved.
+    NSMutableDictionary *changes = [NSMutableDictionary dictionary];
+    [save.pendingChanges enumerateKeysAndObjectsUsingBlock:^(NSString *key, id value, BOOL *stop) {
+        if (![value isEqual:save.person[key]]) {
+            changes[key] = value;
+        }
+    }];
+    NSArray *completionHandlers = [NSArray arrayWithArray:save.pendingCompletionHandlers];
+    [save.pendingChanges removeAllObjects];
+    [save.pendingCompletionHandlers removeAllObjects];
+    if (!changes.count) {
+        NBLogInfo(@"No changes left to save for person %lu", (unsigned long)identifier);
+        if (!save.sentTask) {
+            [self.savesByIdentifier removeObjectForKey:@(identifier)];
+        }
+        for (NBClientResourceItemCompletionHandler completionHandler in completionHandlers) {
+            completionHandler(nil, nil);
+        }
+        return;
+    }
+    NBLogInfo(@"Saving %lu change(s) for %lu caller(s) of person %lu",
+              (unsigned long)changes.count, (unsigned long)completionHandlers.count, (unsigned long)identifier);
+    save.sentGeneration += 1;
+    NSUInteger sentGeneration = save.sentGeneration;
+    save.sentChanges = changes;
+    save.sentCompletionHandlers = completionHandlers;
+    self.numberOfSentSaves += 1;
+    __weak __typeof(self)weakSelf = self;
+    NBClientResourceItemCompletionHandler taskCompletionHandler = ^(NSDictionary *item, NSError *error) {
+        if (save.sentGeneration != sentGeneration) {
+            return; // Superseded or cancelled.
+        }
+        save.sentTask = nil;
+        save.sentChanges = nil;
+        save.sentCompletionHandlers = nil;
+        if (item) {
+            save.person = item;
+        }
+        __strong __typeof(weakSelf)strongSelf = weakSelf;
+        if (strongSelf && !save.pendingChanges.count && !save.pendingCompletionHandlers.count &&
+            strongSelf.savesByIdentifier[@(identifier)] == save)
+        {
+            [strongSelf.savesByIdentifier removeObjectForKey:@(identifier)];
+        }
+        for (NBClientResourceItemCompletionHandler completionHandler in completionHandlers) {
+            completionHandler(item, error);
+        }
+    };
+    NBClient *client = self.client;
+    dispatch_block_t request = ^{
+        save.sentTask = [client savePersonByIdentifier:identifier withParameters:changes completionHandler:taskCompletionHandler];
+    };
+    if (self.taskGroup) {
+        [client performRequestsInTaskGroup:self.taskGroup usingBlock:request];
+    } else {
+        request();
+    }
+}
+
+@end
@@ -0,0 +1,82 @@
+//
+//  NBClientReferenceData.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+extern NSUInteger const NBClientReferenceDataSnapshotVersion;
+extern NSTimeInterval const NBClientReferenceDataDefaultRefreshInterval;
+
+// Keys for the default fetchers.
+extern NSString * __nonnull const NBClientReferenceDataContactTypesKey; // Array.
+extern NSString * __nonnull const NBClientReferenceDataContactMethodsKey; // Array.
+extern NSString * __nonnull const NBClientReferenceDataContactStatusesKey; // Array.
+extern NSString * __nonnull const NBClientReferenceDataSitesKey; // Array.
+extern NSString * __nonnull const NBClientReferenceDataSurveysKey; // Dictionary of site slugs to arrays.
+
+// Posted only when a refresh actually changes the data. The object is the
+// reference data.
+extern NSString * __nonnull const NBClientReferenceDataDidChangeNotification;
+extern NSString * __nonnull const NBClientReferenceDataChangedKeysKey; // Array.
+
+// Fetches one part of the reference data, ie. all contact types. The result
+// must be JSON-compatible.
+typedef void (^NBClientReferenceDataFetcher)(NBClient * __nonnull client, NBClientResourceCompletionHandler __nonnull completionHandler);
+
+// Reference data is the nation settings that rarely change but that screens,
+// ie. logging a contact, can't do without: contact types, methods and
+// statuses, sites and their surveys. The last snapshot is persisted per
+// account and loaded on creation, so it can be shown right away at launch,
+// while it's refreshed in the background once it's older than the refresh
+// interval, or when the data is reported changed. Observers are notified only
+// when a refresh yields different data. Snapshots from other versions of this
+// class are discarded. Like the client, it should be used from the main queue.
+@interface NBClientReferenceData : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+// Ie. the nation slug and account identifier.
+@property (nonatomic, copy, readonly, nonnull) NSString *identifier;
+
+// Defaults to a file for the identifier in the caches directory.
+@property (nonatomic, copy, nonnull) NSURL *fileURL;
+// Defaults to fetchers for each of the keys above. Part of the snapshot.
+@property (nonatomic, copy, nonnull) NSDictionary *fetchersByKey;
+
+@property (nonatomic, copy, readonly, nonnull) NSDictionary *snapshot;
+@property (nonatomic, readonly, nullable) NSDate *snapshotDate;
+
+// Defaults to `NBClientReferenceDataDefaultRefreshInterval`, one day.
+@property (nonatomic) NSTimeInterval refreshInterval;
+// Refresh whenever the snapshot gets stale or the data is reported changed.
+// Defaults to `NO`.
+@property (nonatomic) BOOL automaticallyRefreshes;
+@property (nonatomic, readonly, getter = isRefreshing) BOOL refreshing;
+@property (nonatomic, readonly) BOOL needsRefresh;
+
+// Designated initializer. Loads any persisted snapshot.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client
+                            identifier:(nonnull NSString *)identifier;
+
+- (nullable NSArray *)contactTypes;
+- (nullable NSArray *)contactMethods;
+- (nullable NSArray *)contactStatuses;
+- (nullable NSArray *)sites;
+- (nullable NSArray *)surveysBySiteSlug:(nonnull NSString *)siteSlug;
+
+// Parts that fail keep their last data, and the error is for the first of them.
+// Concurrent calls share one refresh.
+- (void)refreshWithCompletionHandler:(nullable NBClientEmptyCompletionHandler)completionHandler;
+// Only refreshes if the snapshot is stale or needs a refresh.
+- (void)refreshIfNeededWithCompletionHandler:(nullable NBClientEmptyCompletionHandler)completionHandler;
+// Call this when the server reports a change, ie. via a push notification or a
+// validation error about an unknown contact type.
+- (void)setNeedsRefresh;
+// Ie. on sign out.
+- (void)discardSnapshot;
+
+@end
@@ -0,0 +1,395 @@
+//
+//  NBClientReferenceData.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientReferenceData.h"
+
+#import "NBClient+Composites.h"
+#import "NBClient+Contacts.h"
+#import "NBClient+Sites.h"
+#import "NBClient+Surveys.h"
+#import "NBPaginationInfo.h"
+
+NSUInteger const NBClientReferenceDataSnapshotVersion = 1;
+NSTimeInterval const NBClientReferenceDataDefaultRefreshInterval = 24 * 60 * 60;
+
+NSString * const NBClientReferenceDataContactTypesKey = @"contact_types";
+NSString * const NBClientReferenceDataContactMethodsKey = @"contact_methods";
+NSString * const NBClientReferenceDataContactStatusesKey = @"contact_statuses";
+NSString * const NBClientReferenceDataSitesKey = @"sites";
+NSString * const NBClientReferenceDataSurveysKey = @"surveys";
+
+NSString * const NBClientReferenceDataDidChangeNotification = @"NBClientReferenceDataDidChangeNotification";
+NSString * const NBClientReferenceDataChangedKeysKey = @"changed_keys";
+
+static NSString *SnapshotDirectoryName = @"com.nationbuilder.reference-data";
+static NSString *VersionKey = @"version";
+static NSString *DateKey = @"date";
+static NSString *DataKey = @"data";
+
+static NSUInteger PageSize = 100;
+static NSTimeInterval RetryInterval = 60.0f;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientReferenceData ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+@property (nonatomic, copy, readwrite) NSString *identifier;
+@property (nonatomic, copy, readwrite) NSDictionary *snapshot;
+@property (nonatomic, readwrite) NSDate *snapshotDate;
+@property (nonatomic, readwrite, getter = isRefreshing) BOOL refreshing;
+@property (nonatomic, readwrite) BOOL needsRefresh;
+
+@property (nonatomic) NSMutableArray *completionHandlers;
+@property (nonatomic) NSUInteger scheduleGeneration;
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+
++ (NSDictionary *)defaultFetchersByKey;
++ (void)fetchAllPagesWithClient:(NBClient *)client
+                    pageFetcher:(NBClientPageFetcher)pageFetcher
+              completionHandler:(NBClientResourceCompletionHandler)completionHandler;
+
+- (void)finishRefreshWithResults:(NSDictionary *)results error:(NSError *)error;
+- (void)scheduleRefreshWithMinimumDelay:(NSTimeInterval)minimumDelay;
+- (void)load;
+- (void)persist;
+
+@end
+
+@implementation NBClientReferenceData
+
+- (instancetype)initWithClient:(NBClient *)client identifier:(NSString *)identifier
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.identifier = identifier;
+        self.fetchersByKey = [self.class defaultFetchersByKey];
+        self.refreshInterval = NBClientReferenceDataDefaultRefreshInterval;
+        self.completionHandlers = [NSMutableArray array];
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.reference-data", DISPATCH_QUEUE_SERIAL);
+        NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        self.fileURL = [[cachesURL URLByAppendingPathComponent:SnapshotDirectoryName isDirectory:YES]
+                        URLByAppendingPathComponent:[identifier stringByAppendingPathExtension:@"json"]];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setFileURL:(NSURL *)fileURL
+{
+    // Set.
+    _fileURL = fileURL.copy;
+    // Did.
+    [self load];
+}
+
+- (void)setAutomaticallyRefreshes:(BOOL)automaticallyRefreshes
+{
+    // Guard.
+    if (automaticallyRefreshes == _automaticallyRefreshes) { return; }
+    // Set.
+    _automaticallyRefreshes = automaticallyRefreshes;
+    // Did.
+    self.scheduleGeneration += 1;
+    if (automaticallyRefreshes) {
+        [self scheduleRefreshWithMinimumDelay:0.0f];
+    }
+}
+
+- (void)setRefreshInterval:(NSTimeInterval)refreshInterval
+{
+    // Set.
+    _refreshInterval = refreshInterval;
+    // Did.
+    if (self.automaticallyRefreshes) {
+        self.scheduleGeneration += 1;
+        [self scheduleRefreshWithMinimumDelay:0.0f];
+    }
+}
+
+- (NSArray *)contactTypes
+{
+    return self.snapshot[NBClientReferenceDataContactTypesKey];
+}
+
+- (NSArray *)contactMethods
+{
+    return self.snapshot[NBClientReferenceDataContactMethodsKey];
+}
+
+- (NSArray *)contactStatuses
+{
+    return self.snapshot[NBClientReferenceDataContactStatusesKey];
+}
+
+- (NSArray *)sites
+{
+    return self.snapshot[NBClientReferenceDataSitesKey];
+}
+
+- (NSArray *)surveysBySiteSlug:(NSString *)siteSlug
+{
+    return self.snapshot[NBClientReferenceDataSurveysKey][siteSlug];
+}
+
+#pragma mark - Public
+
+- (void)refreshWithCompletionHandler:(NBClientEmptyCompletionHandler)completionHandler
+{
+    if (completionHandler) {
+        [self.completionHandlers addObject:[completionHandler copy]];
+    }
+    if (self.isRefreshing) {
+        return;
+    }
+    NBClient *client = self.client;
+    if (!client) {
+        [self finishRefreshWithResults:@{} error:nil];
+        return;
+    }
+    self.refreshing = YES;
+    self.needsRefresh = NO;
+    // Parts are fetched together, so the refresh takes as long as the slowest.
+    NSMutableDictionary *results = [NSMutableDictionary dictionary];
+    __block NSUInteger numberOfPendingParts = self.fetchersByKey.count;
+    __block NSError *firstError;
+    if (!numberOfPendingParts) {
+        [self finishRefreshWithResults:results error:nil];
+        return;
+    }
+    [self.fetchersByKey enumerateKeysAndObjectsUsingBlock:^(NSString *key, NBClientReferenceDataFetcher fetcher, BOOL *stop) {
+        fetcher(client, ^(id result, NSError *error) {
+            if (error || !result) {
+                NBLogWarning(@"Failed to refresh reference data \"%@\": %@", key, error);
+                firstError = firstError ?: error;
+            } else {
+                results[key] = result;
+            }
+            numberOfPendingParts -= 1;
+            if (!numberOfPendingParts) {
+                [self finishRefreshWithResults:results error:firstError];
+            }
+        });
+    }];
+}
+
+- (void)refreshIfNeededWithCompletionHandler:(NBClientEmptyCompletionHandler)completionHandler
+{
+    BOOL isStale = !self.snapshotDate || -self.snapshotDate.timeIntervalSinceNow >= self.refreshInterval;
+    if (isStale || self.needsRefresh || self.isRefreshing) {
+        [self refreshWithCompletionHandler:completionHandler];
+    } else if (completionHandler) {
+        completionHandler(nil);
+    }
+}
+
+- (void)setNeedsRefresh
+{
+    self.needsRefresh = YES;
+    if (self.automaticallyRefreshes) {
+        self.scheduleGeneration += 1;
+        [self scheduleRefreshWithMinimumDelay:0.0f];
+    }
+}
+
+- (void)discardSnapshot
+{
+    self.snapshot = @{};
+    self.snapshotDate = nil;
+    NSURL *fileURL = self.fileURL;
+    dispatch_async(self.persistenceQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+    });
+}
+
+#pragma mark - Private
+
++ (NSDictionary *)defaultFetchersByKey
+{
+    NBClientReferenceDataFetcher contactTypesFetcher = ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        [self fetchAllPagesWithClient:client pageFetcher:^(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler pageHandler) {
+            return [client fetchContactTypesWithPaginationInfo:paginationInfo completionHandler:pageHandler];
+        } completionHandler:completionHandler];
+    };
+    NBClientReferenceDataFetcher contactMethodsFetcher = ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        [client fetchContactMethodsWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+            completionHandler(items, error);
+        }];
+    };
+    NBClientReferenceDataFetcher contactStatusesFetcher = ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        [client fetchContactStatusesWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+            completionHandler(items, error);
+        }];
+    };
+    NBClientReferenceDataFetcher sitesFetcher = ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        [self fetchAllPagesWithClient:client pageFetcher:^(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler pageHandler) {
+            return [client fetchSitesWithPaginationInfo:paginationInfo completionHandler:pageHandler];
+        } completionHandler:completionHandler];
+    };
+    // Fetches its own list of sites, since parts are fetched together.
+    NBClientReferenceDataFetcher surveysFetcher = ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        sitesFetcher(client, ^(NSArray *sites, NSError *error) {
+            NSArray *siteSlugs = [[sites valueForKey:@"slug"] filteredArrayUsingPredicate:
+                                  [NSPredicate predicateWithFormat:@"self isKindOfClass: %@", [NSString class]]];
+            if (error || !siteSlugs.count) {
+                completionHandler(error ? nil : @{}, error);
+                return;
+            }
+            NSMutableDictionary *surveysBySiteSlug = [NSMutableDictionary dictionary];
+            __block NSUInteger numberOfPendingSites = siteSlugs.count;
+            __block NSError *firstError;
+            for (NSString *siteSlug in siteSlugs) {
+                [self fetchAllPagesWithClient:client pageFetcher:^(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler pageHandler) {
+                    return [client fetchSurveysBySiteSlug:siteSlug withPaginationInfo:paginationInfo completionHandler:pageHandler];
+                } completionHandler:^(NSArray *surveys, NSError *error) {
+                    firstError = firstError ?: error;
+                    surveysBySiteSlug[siteSlug] = surveys;
+                    numberOfPendingSites -= 1;
+                    if (!numberOfPendingSites) {
+                        completionHandler(firstError ? nil : surveysBySiteSlug, firstError);
+                    }
+                }];
+            }
+        });
+    };
+    return @{ NBClientReferenceDataContactTypesKey: contactTypesFetcher,
+              NBClientReferenceDataContactMethodsKey: contactMethodsFetcher,
+              NBClientReferenceDataContactStatusesKey: contactStatusesFetcher,
+              NBClientReferenceDataSitesKey: sitesFetcher,
+              NBClientReferenceDataSurveysKey: surveysFetcher };
+}
+
++ (void)fetchAllPagesWithClient:(NBClient *)client
+                    pageFetcher:(NBClientPageFetcher)pageFetcher
+              completionHandler:(NBClientResourceCompletionHandler)completionHandler
+{
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:client.shouldUseLegacyPagination];
+    paginationInfo.numberOfItemsPerPage = PageSize;
+    [client
+     fetchAllPagesWithPaginationInfo:paginationInfo
+     maximumNumberOfConcurrentPages:NBClientCompositeDefaultMaximumNumberOfConcurrentPages
+     pageFetcher:pageFetcher
+     completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+         completionHandler(error ? nil : items, error);
+     }];
+}
+
+- (void)finishRefreshWithResults:(NSDictionary *)results error:(NSError *)error
+{
+    NSMutableArray *changedKeys = [NSMutableArray array];
+    NSMutableDictionary *snapshot = self.snapshot.mutableCopy;
+    [results enumerateKeysAndObjectsUsingBlock:^(NSString *key, id result, BOOL *stop) {
+        if (![result isEqual:snapshot[key]]) {
+            snapshot[key] = result;
+            [changedKeys addObject:key];
+        }
+    }];
+    BOOL didRefresh = self.isRefreshing;
+    self.refreshing = NO;
+    if (didRefresh && !error) {
+        self.snapshotDate = [NSDate date];
+    }
+    if (changedKeys.count) {
+        self.snapshot = snapshot;
+    }
+    if (didRefresh && (changedKeys.count || !error)) {
+        [self persist];
+    }
+    NBLogInfo(@"Refreshed reference data %@, changed: %@", self.identifier, changedKeys);
+    if (changedKeys.count) {
+        [[NSNotificationCenter defaultCenter] postNotificationName:NBClientReferenceDataDidChangeNotification object:self
+                                                          userInfo:@{ NBClientReferenceDataChangedKeysKey: [changedKeys copy] }];
+    }
+    NSArray *completionHandlers = self.completionHandlers.copy;
+    [self.completionHandlers removeAllObjects];
+    for (NBClientEmptyCompletionHandler completionHandler in completionHandlers) {
+        completionHandler(error);
+    }
+    if (didRefresh && self.automaticallyRefreshes) {
+        self.scheduleGeneration += 1;
+        // Don't retry failures right away.
+        [self scheduleRefreshWithMinimumDelay:(error ? RetryInterval : 0.0f)];
+    }
+}
+
+- (void)scheduleRefreshWithMinimumDelay:(NSTimeInterval)minimumDelay
+{
+    NSTimeInterval delay = 0.0f;
+    if (self.snapshotDate && !self.needsRefresh) {
+        delay = MAX(0.0f, self.refreshInterval + self.snapshotDate.timeIntervalSinceNow);
+    }
+    delay = MAX(delay, minimumDelay);
+    NSUInteger scheduleGeneration = self.scheduleGeneration;
+    __weak __typeof(self)weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        __strong __typeof(weakSelf)strongSelf = weakSelf;
+        if (!strongSelf || strongSelf.scheduleGeneration != scheduleGeneration || strongSelf.isRefreshing) {
+            return;
+        }
+        [strongSelf refreshIfNeededWithCompletionHandler:nil];
+    });
+}
+
+- (void)load
+{
+    self.snapshot = @{};
+    self.snapshotDate = nil;
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    NSDictionary *file = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    if (![file isKindOfClass:[NSDictionary class]] ||
+        [file[VersionKey] unsignedIntegerValue] != NBClientReferenceDataSnapshotVersion ||
+        ![file[DataKey] isKindOfClass:[NSDictionary class]])
+    {
+        NBLogInfo(@"Discarding outdated reference data at %@", self.fileURL);
+        return;
+    }
+    self.snapshot = file[DataKey];
+    self.snapshotDate = [NSDate dateWithTimeIntervalSince1970:[file[DateKey] doubleValue]];
+    NBLogInfo(@"Loaded reference data from %@", self.fileURL);
+}
+
+- (void)persist
+{
+    NSDictionary *file = @{ VersionKey: @(NBClientReferenceDataSnapshotVersion),
+                            DateKey: @(self.snapshotDate.timeIntervalSince1970),
+                            DataKey: self.snapshot };
+    NSURL *fileURL = self.fileURL;
+    dispatch_async(self.persistenceQueue, ^{
+        if (![NSJSONSerialization isValidJSONObject:file]) {
+            NBLogError(@"Not persisting invalid reference data to %@", fileURL);
+            return;
+        }
+        NSError *error;
+        NSData *data = [NSJSONSerialization dataWithJSONObject:file options:0 error:&error];
+        if (data) {
+            [[NSFileManager defaultManager] createDirectoryAtURL:fileURL.URLByDeletingLastPathComponent
+                                     withIntermediateDirectories:YES attributes:nil error:nil];
+            [data writeToURL:fileURL options:NSDataWritingAtomic error:&error];
+        }
+        if (error) {
+            NBLogWarning(@"Failed to persist reference data to %@: %@", fileURL, error);
+        }
+    });
+}
+
+@end
@@ -0,0 +1,100 @@
+//
+//  NBClientRefreshScheduler.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <UIKit/UIKit.h>
+
+#import "NBClient.h"
+
+@class NBClientReferenceData;
+@class NBClientTagCatalog;
+
+// Keys of the built-in collections.
+extern NSString * __nonnull const NBClientRefreshPeopleKey; // The first page of people.
+extern NSString * __nonnull const NBClientRefreshListKeyFormat; // The first page of a watched list's people, ie. 'lists/12'.
+extern NSString * __nonnull const NBClientRefreshTagsKey;
+extern NSString * __nonnull const NBClientRefreshReferenceDataKey;
+
+// Keys of refresh records.
+extern NSString * __nonnull const NBClientRefreshRecordCollectionKey;
+extern NSString * __nonnull const NBClientRefreshRecordDateKey; // Seconds since 1970.
+extern NSString * __nonnull const NBClientRefreshRecordDurationKey;
+extern NSString * __nonnull const NBClientRefreshRecordBytesKey;
+extern NSString * __nonnull const NBClientRefreshRecordErrorKey; // Description, if it failed.
+
+typedef void (^NBClientRefreshCompletionHandler)(NSUInteger numberOfBytes, NSError * __nullable error);
+// Refreshes one collection into local storage, and reports about how many
+// bytes it downloaded.
+typedef void (^NBClientRefresher)(NBClientRefreshCompletionHandler __nonnull completionHandler);
+
+// What one background refresh may spend.
+@interface NBClientRefreshBudget : NSObject <NSCopying>
+
+// Defaults to 25 seconds, within the 30 seconds of a background fetch.
+@property (nonatomic) NSTimeInterval timeLimit;
+// Defaults to 1 MB. 0 is unlimited.
+@property (nonatomic) NSUInteger byteLimit;
+// Defaults to 0.2. Nothing is refreshed below it, unless the device is charging.
+@property (nonatomic) float minimumBatteryLevel;
+
+@end
+
+// The refresh scheduler keeps an account's key collections warm during
+// background execution, ie. a background fetch, so a launch can render from
+// fresh local data instead of refetching from scratch: the first page of
+// people and of each watched list, which it stores itself, and the tag catalog
+// and reference data, which store themselves. Collections are refreshed one at
+// a time, most recently used first, and only once they're older than the
+// minimum refresh interval, until the budget's time or bytes run out. Each
+// refresh is recorded. Like the client, it should be used from the main queue.
+@interface NBClientRefreshScheduler : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+// Ie. the nation slug and account identifier.
+@property (nonatomic, copy, readonly, nonnull) NSString *identifier;
+
+// Defaults to a directory for the identifier in the caches directory.
+@property (nonatomic, copy, nonnull) NSURL *directoryURL;
+@property (nonatomic, copy, nonnull) NBClientRefreshBudget *budget;
+// Defaults to 15 minutes.
+@property (nonatomic) NSTimeInterval minimumRefreshInterval;
+// Of stored pages. Match the views that show them. Defaults to 25.
+@property (nonatomic) NSUInteger numberOfItemsPerPage;
+
+@property (nonatomic, weak, nullable) NBClientReferenceData *referenceData;
+@property (nonatomic, weak, nullable) NBClientTagCatalog *tagCatalog;
+@property (nonatomic, copy, nonnull) NSArray *watchedListIdentifiers;
+
+// The built-in collections that apply, then any custom ones.
+@property (nonatomic, copy, readonly, nonnull) NSArray *collectionKeys;
+// Oldest first, up to the last 100.
+@property (nonatomic, copy, readonly, nonnull) NSArray *records;
+@property (nonatomic, readonly, getter = isRefreshing) BOOL refreshing;
+
+// Designated initializer. Loads any persisted records.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client
+                            identifier:(nonnull NSString *)identifier;
+
++ (nonnull NSString *)collectionKeyForListIdentifier:(NSUInteger)listIdentifier;
+
+// For collections stored elsewhere, ie. by the app. Replaces any built-in
+// refresher for the key. Pass nil to remove.
+- (void)setRefresher:(nullable NBClientRefresher)refresher forCollectionKey:(nonnull NSString *)collectionKey;
+
+// Call this whenever a collection is shown, so it's refreshed sooner.
+- (void)collectionWasUsed:(nonnull NSString *)collectionKey;
+// Stored pages only, ie. of people.
+- (nullable NSArray *)cachedItemsForCollectionKey:(nonnull NSString *)collectionKey;
+- (nullable NSDate *)lastRefreshDateForCollectionKey:(nonnull NSString *)collectionKey;
+
+// Ie. from `-application:performFetchWithCompletionHandler:`. Has new data if
+// any collection was refreshed.
+- (void)performRefreshWithCompletionHandler:(nullable void (^)(UIBackgroundFetchResult result))completionHandler;
+
+// Ie. on sign out.
+- (void)removeAllData;
+
+@end
@@ -0,0 +1,524 @@
+//
+//  NBClientRefreshScheduler.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientRefreshScheduler.h"
+
+#import "NBClient+Composites.h"
+#import "NBClient+Lists.h"
+#import "NBClient+People.h"
+#import "NBClientReferenceData.h"
+#import "NBClientTagCatalog.h"
+#import "NBClientTaskGroup.h"
+#import "NBPaginationInfo.h"
+
+NSString * const NBClientRefreshPeopleKey = @"people";
+NSString * const NBClientRefreshListKeyFormat = @"lists/%lu";
+NSString * const NBClientRefreshTagsKey = @"tags";
+NSString * const NBClientRefreshReferenceDataKey = @"reference_data";
+
+NSString * const NBClientRefreshRecordCollectionKey = @"collection";
+NSString * const NBClientRefreshRecordDateKey = @"date";
+NSString * const NBClientRefreshRecordDurationKey = @"duration";
+NSString * const NBClientRefreshRecordBytesKey = @"bytes";
+NSString * const NBClientRefreshRecordErrorKey = @"error";
+
+static NSString *DirectoryName = @"com.nationbuilder.refresh";
+static NSString *CollectionsDirectoryName = @"collections"; // Apart from the state file, whatever the keys.
+static NSString *StateFileName = @"state.json";
+static NSString *LastUseDatesKey = @"last_use_dates";
+static NSString *RecordsKey = @"records";
+static NSString *DateKey = @"date";
+static NSString *ItemsKey = @"items";
+
+static NSTimeInterval DefaultTimeLimit = 25.0f;
+static NSUInteger DefaultByteLimit = 1024 * 1024;
+static float DefaultMinimumBatteryLevel = 0.2f;
+static NSTimeInterval DefaultMinimumRefreshInterval = 15 * 60;
+static NSUInteger DefaultNumberOfItemsPerPage = 25;
+static NSUInteger MaximumNumberOfRecords = 100;
+// Tags are synced by the catalog, which doesn't count bytes.
+static NSUInteger EstimatedNumberOfBytesPerTag = 64;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@implementation NBClientRefreshBudget
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.timeLimit = DefaultTimeLimit;
+        self.byteLimit = DefaultByteLimit;
+        self.minimumBatteryLevel = DefaultMinimumBatteryLevel;
+    }
+    return self;
+}
+
+#pragma mark - NSCopying
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    NBClientRefreshBudget *budget = [[self.class allocWithZone:zone] init];
+    budget.timeLimit = self.timeLimit;
+    budget.byteLimit = self.byteLimit;
+    budget.minimumBatteryLevel = self.minimumBatteryLevel;
+    return budget;
+}
+
+@end
+
+@interface NBClientRefreshScheduler ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+@property (nonatomic, copy, readwrite) NSString *identifier;
+@property (nonatomic, readwrite, getter = isRefreshing) BOOL refreshing;
+
+@property (nonatomic) NSMutableArray *customCollectionKeys;
+@property (nonatomic) NSMutableDictionary *customRefreshers;
+@property (nonatomic) NSMutableDictionary *lastUseDates; // Of seconds since 1970.
+@property (nonatomic) NSMutableArray *mutableRecords;
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+
+- (NSDictionary *)refreshersByKey;
+- (NBClientRefresher)pageRefresherForCollectionKey:(NSString *)collectionKey pageFetcher:(NBClientPageFetcher)pageFetcher;
+- (NSArray *)prioritizedStaleCollectionKeys;
+- (NSUInteger)lastNumberOfBytesForCollectionKey:(NSString *)collectionKey;
+- (void)addRecordForCollectionKey:(NSString *)collectionKey
+                        startTime:(CFAbsoluteTime)startTime
+                    numberOfBytes:(NSUInteger)numberOfBytes
+                            error:(NSError *)error;
+- (BOOL)hasEnoughBattery;
+
+- (NSURL *)fileURLForCollectionKey:(NSString *)collectionKey;
+- (void)storeItems:(NSArray *)items forCollectionKey:(NSString *)collectionKey;
+- (void)load;
+- (void)persist;
+- (void)writeJSONObject:(id)object toURL:(NSURL *)fileURL;
+
+@end
+
+@implementation NBClientRefreshScheduler
+
+- (instancetype)initWithClient:(NBClient *)client identifier:(NSString *)identifier
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.identifier = identifier;
+        self.budget = [[NBClientRefreshBudget alloc] init];
+        self.minimumRefreshInterval = DefaultMinimumRefreshInterval;
+        self.numberOfItemsPerPage = DefaultNumberOfItemsPerPage;
+        self.watchedListIdentifiers = @[];
+        self.customCollectionKeys = [NSMutableArray array];
+        self.customRefreshers = [NSMutableDictionary dictionary];
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.refresh", DISPATCH_QUEUE_SERIAL);
+        NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        self.directoryURL = [[cachesURL URLByAppendingPathComponent:DirectoryName isDirectory:YES]
+                             URLByAppendingPathComponent:identifier isDirectory:YES];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setDirectoryURL:(NSURL *)directoryURL
+{
+    // Set.
+    _directoryURL = directoryURL.copy;
+    // Did.
+    [self load];
+}
+
+- (NSArray *)collectionKeys
+{
+    NSMutableArray *collectionKeys = [NSMutableArray arrayWithObject:NBClientRefreshPeopleKey];
+    for (NSNumber *listIdentifier in self.watchedListIdentifiers) {
+        [collectionKeys addObject:[self.class collectionKeyForListIdentifier:listIdentifier.unsignedIntegerValue]];
+    }
+    if (self.tagCatalog) {
+        [collectionKeys addObject:NBClientRefreshTagsKey];
+    }
+    if (self.referenceData) {
+        [collectionKeys addObject:NBClientRefreshReferenceDataKey];
+    }
+    for (NSString *collectionKey in self.customCollectionKeys) {
+        if (![collectionKeys containsObject:collectionKey]) {
+            [collectionKeys addObject:collectionKey];
+        }
+    }
+    return [NSArray arrayWithArray:collectionKeys];
+}
+
+- (NSArray *)records
+{
+    return [NSArray arrayWithArray:self.mutableRecords];
+}
+
+#pragma mark - Public
+
++ (NSString *)collectionKeyForListIdentifier:(NSUInteger)listIdentifier
+{
+    return [NSString stringWithFormat:NBClientRefreshListKeyFormat, (unsigned long)listIdentifier];
+}
+
+- (void)setRefresher:(NBClientRefresher)refresher forCollectionKey:(NSString *)collectionKey
+{
+    if (refresher) {
+        if (!self.customRefreshers[collectionKey]) {
+            [self.customCollectionKeys addObject:collectionKey];
+        }
+        self.customRefreshers[collectionKey] = [refresher copy];
+    } else {
+        [self.customCollectionKeys removeObject:collectionKey];
+        [self.customRefreshers removeObjectForKey:collectionKey];
+    }
+}
+
+- (void)collectionWasUsed:(NSString *)collectionKey
+{
+    self.lastUseDates[collectionKey] = @([NSDate date].timeIntervalSince1970);
+    [self persist];
+}
+
+- (NSArray *)cachedItemsForCollectionKey:(NSString *)collectionKey
+{
+    NSData *data = [NSData dataWithContentsOfURL:[self fileURLForCollectionKey:collectionKey]];
+    if (!data) {
+        return nil;
+    }
+    NSDictionary *file = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    if (![file isKindOfClass:[NSDictionary class]] || ![file[ItemsKey] isKindOfClass:[NSArray class]]) {
+        return nil;
+    }
+    return file[ItemsKey];
+}
+
+- (NSDate *)lastRefreshDateForCollectionKey:(NSString *)collectionKey
+{
+    for (NSDictionary *record in self.mutableRecords.reverseObjectEnumerator) {
+        if ([record[NBClientRefreshRecordCollectionKey] isEqualToString:collectionKey] && !record[NBClientRefreshRecordErrorKey]) {
+            return [NSDate dateWithTimeIntervalSince1970:[record[NBClientRefreshRecordDateKey] doubleValue]];
+        }
+    }
+    return nil;
+}
+
+- (void)performRefreshWithCompletionHandler:(void (^)(UIBackgroundFetchResult))completionHandler
+{
+    if (self.isRefreshing || !self.client || ![self hasEnoughBattery]) {
+        NBLogInfo(@"Skipping refresh for %@", self.identifier);
+        if (completionHandler) {
+            completionHandler(UIBackgroundFetchResultNoData);
+        }
+        return;
+    }
+    self.refreshing = YES;
+    NBClient *client = self.client;
+    // Everything the refreshers request, ie. every page of a tag sync, so it can be cancelled.
+    NBClientTaskGroup *taskGroup = [[NBClientTaskGroup alloc] init];
+    NBClientRefreshBudget *budget = self.budget;
+    NSDictionary *refreshersByKey = [self refreshersByKey];
+    NSMutableArray *pendingKeys = [self prioritizedStaleCollectionKeys].mutableCopy;
+    // Refresh handlers are called on the main queue, so no locking is needed.
+    __block NSUInteger numberOfBytes = 0;
+    __block NSUInteger numberOfRefreshes = 0;
+    __block NSUInteger numberOfFailures = 0;
+    __block NSString *currentKey;
+    __block CFAbsoluteTime currentStartTime;
+    __block BOOL didFinish = NO;
+    __block void (^refreshNextCollection)(void);
+    void (^finishRefresh)(void) = ^{
+        didFinish = YES;
+        refreshNextCollection = nil;
+        self.refreshing = NO;
+        [self persist];
+        NBLogInfo(@"Refreshed %lu collection(s) of %@ with %lu byte(s), %lu failed",
+                  (unsigned long)numberOfRefreshes, self.identifier, (unsigned long)numberOfBytes, (unsigned long)numberOfFailures);
+        if (!completionHandler) {
+            return;
+        }
+        UIBackgroundFetchResult result = (numberOfRefreshes ? UIBackgroundFetchResultNewData :
+                                          (numberOfFailures ? UIBackgroundFetchResultFailed : UIBackgroundFetchResultNoData));
+        // After every queued write, since the app may be suspended right after.
+        dispatch_async(self.persistenceQueue, ^{
+            dispatch_async(dispatch_get_main_queue(), ^{
+                completionHandler(result);
+            });
+        });
+    };
+    refreshNextCollection = ^{
+        currentKey = nil;
+        while (!currentKey && pendingKeys.count) {
+            NSString *collectionKey = pendingKeys.firstObject;
+            [pendingKeys removeObjectAtIndex:0];
+            // Going by the last refresh, since a collection's size is only known after.
+            if (budget.byteLimit && numberOfBytes + [self lastNumberOfBytesForCollectionKey:collectionKey] > budget.byteLimit) {
+                NBLogInfo(@"Skipping %@, over the byte budget", collectionKey);
+                continue;
+            }
+            currentKey = collectionKey;
+        }
+        if (!currentKey) {
+            finishRefresh();
+            return;
+        }
+        NSString *collectionKey = currentKey;
+        currentStartTime = CFAbsoluteTimeGetCurrent();
+        NBClientRefresher refresher = refreshersByKey[collectionKey];
+        [client performRequestsInTaskGroup:taskGroup usingBlock:^{
+            refresher(^(NSUInteger collectionNumberOfBytes, NSError *error) {
+                if (didFinish) {
+                    return; // Out of time.
+                }
+                numberOfBytes += collectionNumberOfBytes;
+                if (error) {
+                    numberOfFailures += 1;
+                } else {
+                    numberOfRefreshes += 1;
+                }
+                [self addRecordForCollectionKey:collectionKey startTime:currentStartTime numberOfBytes:collectionNumberOfBytes error:error];
+                refreshNextCollection();
+            });
+        }];
+    };
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(budget.timeLimit * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        if (didFinish) {
+            return;
+        }
+        NBLogWarning(@"Refresh of %@ ran out of time during %@", self.identifier, currentKey);
+        if (currentKey) {
+            numberOfFailures += 1;
+            NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+            [self addRecordForCollectionKey:currentKey startTime:currentStartTime numberOfBytes:0 error:error];
+        }
+        finishRefresh();
+        // Its requests would otherwise keep using the network, and finish into a suspended app.
+        [taskGroup cancel];
+    });
+    refreshNextCollection();
+}
+
+- (void)removeAllData
+{
+    [self.lastUseDates removeAllObjects];
+    [self.mutableRecords removeAllObjects];
+    NSURL *directoryURL = self.directoryURL;
+    dispatch_async(self.persistenceQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:directoryURL error:nil];
+    });
+}
+
+#pragma mark - Private
+
+- (NSDictionary *)refreshersByKey
+{
+    NBClient *client = self.client;
+    __weak __typeof(client)weakClient = client;
+    NSMutableDictionary *refreshersByKey = [NSMutableDictionary dictionary];
+    refreshersByKey[NBClientRefreshPeopleKey] =
+    [self pageRefresherForCollectionKey:NBClientRefreshPeopleKey pageFetcher:^(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler completionHandler) {
+        return [weakClient fetchPeopleWithPaginationInfo:paginationInfo completionHandler:completionHandler];
+    }];
+    for (NSNumber *listIdentifier in self.watchedListIdentifiers) {
+        NSString *collectionKey = [self.class collectionKeyForListIdentifier:listIdentifier.unsignedIntegerValue];
+        refreshersByKey[collectionKey] =
+        [self pageRefresherForCollectionKey:collectionKey pageFetcher:^(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler completionHandler) {
+            return [weakClient fetchListPeopleByIdentifier:listIdentifier.unsignedIntegerValue
+                                        withPaginationInfo:paginationInfo completionHandler:completionHandler];
+        }];
+    }
+    NBClientTagCatalog *tagCatalog = self.tagCatalog;
+    if (tagCatalog) {
+        NBClientRefresher tagsRefresher = ^(NBClientRefreshCompletionHandler completionHandler) {
+            [tagCatalog syncWithCompletionHandler:^(NSError *error) {
+                completionHandler(tagCatalog.numberOfTags * EstimatedNumberOfBytesPerTag, error);
+            }];
+        };
+        refreshersByKey[NBClientRefreshTagsKey] = tagsRefresher;
+    }
+    NBClientReferenceData *referenceData = self.referenceData;
+    if (referenceData) {
+        NBClientRefresher referenceDataRefresher = ^(NBClientRefreshCompletionHandler completionHandler) {
+            NSDate *snapshotDate = referenceData.snapshotDate;
+            // It has its own, longer refresh interval.
+            [referenceData refreshIfNeededWithCompletionHandler:^(NSError *error) {
+                NSUInteger numberOfBytes = 0;
+                if (![referenceData.snapshotDate isEqualToDate:snapshotDate]) {
+                    numberOfBytes = [NSJSONSerialization dataWithJSONObject:referenceData.snapshot options:0 error:nil].length;
+                }
+                completionHandler(numberOfBytes, error);
+            }];
+        };
+        refreshersByKey[NBClientRefreshReferenceDataKey] = referenceDataRefresher;
+    }
+    [refreshersByKey addEntriesFromDictionary:self.customRefreshers];
+    return [NSDictionary dictionaryWithDictionary:refreshersByKey];
+}
+
+- (NBClientRefresher)pageRefresherForCollectionKey:(NSString *)collectionKey pageFetcher:(NBClientPageFetcher)pageFetcher
+{
+    BOOL isLegacy = self.client.shouldUseLegacyPagination;
+    NSUInteger numberOfItemsPerPage = self.numberOfItemsPerPage;
+    __weak __typeof(self)weakSelf = self;
+    return ^(NBClientRefreshCompletionHandler completionHandler) {
+        NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:isLegacy];
+        paginationInfo.numberOfItemsPerPage = numberOfItemsPerPage;
+        __block NSURLSessionDataTask *task;
+        task = pageFetcher(paginationInfo, ^(NSArray *items, NBPaginationInfo *responsePaginationInfo, NSError *error) {
+            NSUInteger numberOfBytes = (NSUInteger)MAX(task.countOfBytesReceived, (int64_t)0);
+            task = nil;
+            if (!error && [items isKindOfClass:[NSArray class]]) {
+                [weakSelf storeItems:items forCollectionKey:collectionKey];
+            }
+            completionHandler(numberOfBytes, error);
+        });
+    };
+}
+
+- (NSArray *)prioritizedStaleCollectionKeys
+{
+    NSMutableArray *collectionKeys = [NSMutableArray array];
+    for (NSString *collectionKey in self.collectionKeys) {
+        NSDate *lastRefreshDate = [self lastRefreshDateForCollectionKey:collectionKey];
+        if (!lastRefreshDate || -lastRefreshDate.timeIntervalSinceNow >= self.minimumRefreshInterval) {
+            [collectionKeys addObject:collectionKey];
+        }
+    }
+    // Most recently used first. Unused ones keep their order, last.
+    NSDictionary *lastUseDates = self.lastUseDates;
+    return [collectionKeys sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(NSString *key, NSString *otherKey) {
+        return [(lastUseDates[otherKey] ?: @0) compare:(lastUseDates[key] ?: @0)];
+    }];
+}
+
+- (NSUInteger)lastNumberOfBytesForCollectionKey:(NSString *)collectionKey
+{
+    for (NSDictionary *record in self.mutableRecords.reverseObjectEnumerator) {
+        if ([record[NBClientRefreshRecordCollectionKey] isEqualToString:collectionKey] && !record[NBClientRefreshRecordErrorKey]) {
+            return [record[NBClientRefreshRecordBytesKey] unsignedIntegerValue];
+        }
+    }
+    return 0;
+}
+
+- (void)addRecordForCollectionKey:(NSString *)collectionKey
+                        startTime:(CFAbsoluteTime)startTime
+                    numberOfBytes:(NSUInteger)numberOfBytes
+                            error:(NSError *)error
+{
+    NSMutableDictionary *record = [@{ NBClientRefreshRecordCollectionKey: collectionKey,
+                                      NBClientRefreshRecordDateKey: @([NSDate date].timeIntervalSince1970),
+                                      NBClientRefreshRecordDurationKey: @(CFAbsoluteTimeGetCurrent() - startTime),
+                                      NBClientRefreshRecordBytesKey: @(numberOfBytes) } mutableCopy];
+    if (error) {
+        record[NBClientRefreshRecordErrorKey] = error.localizedDescription ?: @"";
+        NBLogWarning(@"Failed to refresh %@: %@", collectionKey, error);
+    } else {
+        NBLogInfo(@"Refreshed %@ with %lu byte(s)", collectionKey, (unsigned long)numberOfBytes);
+    }
+    [self.mutableRecords addObject:[NSDictionary dictionaryWithDictionary:record]];
+    if (self.mutableRecords.count > MaximumNumberOfRecords) {
+        [self.mutableRecords removeObjectsInRange:NSMakeRange(0, self.mutableRecords.count - MaximumNumberOfRecords)];
+    }
+}
+
+- (BOOL)hasEnoughBattery
+{
+    NSProcessInfo *processInfo = [NSProcessInfo processInfo];
+    if ([processInfo respondsToSelector:@selector(isLowPowerModeEnabled)] && processInfo.isLowPowerModeEnabled) {
+        return NO;
+    }
+    UIDevice *device = [UIDevice currentDevice];
+    BOOL wasMonitoringBattery = device.isBatteryMonitoringEnabled;
+    device.batteryMonitoringEnabled = YES;
+    float batteryLevel = device.batteryLevel;
+    UIDeviceBatteryState batteryState = device.batteryState;
+    device.batteryMonitoringEnabled = wasMonitoringBattery;
+    // Unknown, ie. in the simulator.
+    if (batteryLevel < 0.0f || batteryState == UIDeviceBatteryStateCharging || batteryState == UIDeviceBatteryStateFull) {
+        return YES;
+    }
+    return batteryLevel >= self.budget.minimumBatteryLevel;
+}
+
+#pragma mark Persistence
+
+- (NSURL *)fileURLForCollectionKey:(NSString *)collectionKey
+{
+    // Escaped, so distinct keys never share a file, ie. 'lists/12' and 'lists-12'.
+    NSString *fileName = [collectionKey stringByAddingPercentEncodingWithAllowedCharacters:
+                          [NSCharacterSet alphanumericCharacterSet]];
+    return [[self.directoryURL URLByAppendingPathComponent:CollectionsDirectoryName isDirectory:YES]
+            URLByAppendingPathComponent:[fileName stringByAppendingPathExtension:@"json"]];
+}
+
+- (void)storeItems:(NSArray *)items forCollectionKey:(NSString *)collectionKey
+{
+    [self writeJSONObject:@{ DateKey: @([NSDate date].timeIntervalSince1970), ItemsKey: items }
+                    toURL:[self fileURLForCollectionKey:collectionKey]];
+}
+
+- (void)load
+{
+    self.lastUseDates = [NSMutableDictionary dictionary];
+    self.mutableRecords = [NSMutableArray array];
+    NSData *data = [NSData dataWithContentsOfURL:[self.directoryURL URLByAppendingPathComponent:StateFileName]];
+    if (!data) {
+        return;
+    }
+    NSDictionary *state = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    if (![state isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+    if ([state[LastUseDatesKey] isKindOfClass:[NSDictionary class]]) {
+        [self.lastUseDates addEntriesFromDictionary:state[LastUseDatesKey]];
+    }
+    if ([state[RecordsKey] isKindOfClass:[NSArray class]]) {
+        [self.mutableRecords addObjectsFromArray:state[RecordsKey]];
+    }
+    NBLogInfo(@"Loaded %lu refresh record(s) from %@", (unsigned long)self.mutableRecords.count, self.directoryURL);
+}
+
+- (void)persist
+{
+    [self writeJSONObject:@{ LastUseDatesKey: [NSDictionary dictionaryWithDictionary:self.lastUseDates],
+                             RecordsKey: self.records }
+                    toURL:[self.directoryURL URLByAppendingPathComponent:StateFileName]];
+}
+
+- (void)writeJSONObject:(id)object toURL:(NSURL *)fileURL
+{
+    dispatch_async(self.persistenceQueue, ^{
+        if (![NSJSONSerialization isValidJSONObject:object]) {
+            NBLogError(@"Not persisting invalid JSON to %@", fileURL);
+            return;
+        }
+        NSError *error;
+        NSData *data = [NSJSONSerialization dataWithJSONObject:object options:0 error:&error];
+        if (data) {
+            [[NSFileManager defaultManager] createDirectoryAtURL:fileURL.URLByDeletingLastPathComponent
+                                     withIntermediateDirectories:YES attributes:nil error:nil];
+            [data writeToURL:fileURL options:NSDataWritingAtomic error:&error];
+        }
+        if (error) {
+            NBLogWarning(@"Failed to persist to %@: %@", fileURL, error);
+        }
+    });
+}
+
+@end
@@ -0,0 +1,52 @@
+//
+//  NBClientSessionProvider.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+@class NBClient;
+
+// The session provider lets multiple clients, ie. one per nation for an
+// accounts manager, share a single URL session and therefore its connection
+// pool, cache, and delegate queue. Authentication stays per-client since each
+// request carries its own client's access token. Cached responses are
+// partitioned by that token: responses to requests that only carry the token
+// as a header are not cached. The provider also applies a global limit on
+// running tasks across all its clients, and releases its session when idle.
+// Like the client, it should be used from the main queue.
+@interface NBClientSessionProvider : NSObject <NSURLSessionDataDelegate, NBLogging>
+
+@property (nonatomic, readonly, nonnull) NSURLSessionConfiguration *sessionConfiguration;
+// Created on demand, so don't hold onto it.
+@property (nonatomic, readonly, nonnull) NSURLSession *urlSession;
+
+// Defaults to 6. Tasks started beyond this limit wait for running ones to finish.
+@property (nonatomic) NSUInteger maximumNumberOfRunningTasks;
+// Defaults to 60 seconds. Set to 0 to keep the session indefinitely.
+@property (nonatomic) NSTimeInterval idleSessionTimeoutInterval;
+
+@property (nonatomic, readonly) NSUInteger numberOfRunningTasks;
+@property (nonatomic, readonly) NSUInteger numberOfPendingTasks;
+
+// The provider the accounts layer uses for its clients.
++ (nonnull instancetype)sharedProvider;
+
+// Designated initializer.
+- (nonnull instancetype)initWithSessionConfiguration:(nullable NSURLSessionConfiguration *)sessionConfiguration;
+
+- (nonnull NSURLSessionDataTask *)dataTaskWithRequest:(nonnull NSURLRequest *)request
+                                               client:(nonnull NBClient *)client
+                                    completionHandler:(nonnull void (^)(NSData * __nullable data, NSURLResponse * __nullable response, NSError * __nullable error))completionHandler;
+
+// Resumes the task now, or once the number of running tasks is under the limit.
+// Deferred tasks start in order of priority.
+- (void)startTask:(nonnull NSURLSessionTask *)task;
+
+- (void)cancelTasksForClient:(nonnull NBClient *)client;
+
+@end
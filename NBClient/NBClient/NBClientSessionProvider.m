@@ -0,0 +1,307 @@
+//
+//  NBClientSessionProvider.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientSessionProvider.h"
+
+#import "NBClient_Internal.h"
+#import "NBClientStreamedBody.h"
+
+static NSUInteger DefaultMaximumNumberOfRunningTasks = 6;
+static NSUInteger DefaultMaximumConnectionsPerHost = 4;
+static NSTimeInterval DefaultIdleSessionTimeoutInterval = 60.0f;
+
+static NSString *AccessTokenQueryItemName = @"access_token";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientSessionProvider ()
+
+@property (nonatomic, readwrite) NSURLSessionConfiguration *sessionConfiguration;
+@property (nonatomic, nullable) NSURLSession *currentSession;
+
+// Values are non-retained client pointers, only used for identity, and are
+// removed before their client is deallocated. See `-clientForTask:`.
+@property (nonatomic) NSMapTable *clientsByTask;
+@property (nonatomic) NSMutableArray *runningTasks;
+@property (nonatomic) NSMutableArray *pendingTasks;
+
+@property (nonatomic) NSUInteger idleGeneration;
+
+- (NBClient *)clientForTask:(NSURLSessionTask *)task;
+- (void)finishTask:(NSURLSessionTask *)task;
+- (void)startPendingTasks;
+- (void)scheduleIdleSessionInvalidation;
+
+@end
+
+@implementation NBClientSessionProvider
+
++ (instancetype)sharedProvider
+{
+    static NBClientSessionProvider *sharedProvider;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedProvider = [[self alloc] initWithSessionConfiguration:nil];
+    });
+    return sharedProvider;
+}
+
+- (instancetype)initWithSessionConfiguration:(NSURLSessionConfiguration *)sessionConfiguration
+{
+    self = [super init];
+    if (self) {
+        if (!sessionConfiguration) {
+            const NSUInteger mb = 1024 * 1024;
+            sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
+            sessionConfiguration.HTTPMaximumConnectionsPerHost = DefaultMaximumConnectionsPerHost;
+            sessionConfiguration.URLCache = [[NSURLCache alloc] initWithMemoryCapacity:4 * mb
+                                                                          diskCapacity:20 * mb
+                                                                              diskPath:@"com.nationbuilder.sessions"];
+        }
+        self.sessionConfiguration = sessionConfiguration;
+        self.maximumNumberOfRunningTasks = DefaultMaximumNumberOfRunningTasks;
+        self.idleSessionTimeoutInterval = DefaultIdleSessionTimeoutInterval;
+        self.clientsByTask = [NSMapTable weakToStrongObjectsMapTable];
+        self.runningTasks = [NSMutableArray array];
+        self.pendingTasks = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_currentSession finishTasksAndInvalidate];
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (NSURLSession *)urlSession
+{
+    if (self.currentSession) {
+        return self.currentSession;
+    }
+    // The provider is the session delegate, and forwards to each task's client.
+    self.currentSession = [NSURLSession sessionWithConfiguration:self.sessionConfiguration
+                                                        delegate:self
+                                                   delegateQueue:[NSOperationQueue mainQueue]];
+    NBLogInfo(@"Created shared session %@", self.currentSession);
+    return self.currentSession;
+}
+
+- (void)setMaximumNumberOfRunningTasks:(NSUInteger)maximumNumberOfRunningTasks
+{
+    // Guard.
+    if (maximumNumberOfRunningTasks == 0) {
+        maximumNumberOfRunningTasks = 1;
+    }
+    // Set.
+    _maximumNumberOfRunningTasks = maximumNumberOfRunningTasks;
+    // Did.
+    [self startPendingTasks];
+}
+
+- (NSUInteger)numberOfRunningTasks
+{
+    return self.runningTasks.count;
+}
+
+- (NSUInteger)numberOfPendingTasks
+{
+    return self.pendingTasks.count;
+}
+
+#pragma mark - Public
+
+- (NSURLSessionDataTask *)dataTaskWithRequest:(NSURLRequest *)request
+                                       client:(NBClient *)client
+                            completionHandler:(void (^)(NSData *, NSURLResponse *, NSError *))completionHandler
+{
+    __weak __typeof(self)weakSelf = self;
+    __block __weak NSURLSessionDataTask *weakTask;
+    NSURLSessionDataTask *task = [self.urlSession dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        [weakSelf finishTask:weakTask];
+        completionHandler(data, response, error);
+    }];
+    weakTask = task;
+    [self.clientsByTask setObject:[NSValue valueWithNonretainedObject:client] forKey:task];
+    self.idleGeneration += 1;
+    return task;
+}
+
+- (void)startTask:(NSURLSessionTask *)task
+{
+    if ([self.runningTasks containsObject:task] || [self.pendingTasks containsObject:task]) {
+        return;
+    }
+    self.idleGeneration += 1;
+    if (self.runningTasks.count < self.maximumNumberOfRunningTasks) {
+        [self.runningTasks addObject:task];
+        [task resume];
+        [NBClient taskDidResume:task];
+    } else {
+        NBLogInfo(@"Deferring task %lu, %lu running", (unsigned long)task.taskIdentifier, (unsigned long)self.runningTasks.count);
+        [self.pendingTasks addObject:task];
+    }
+}
+
+- (void)cancelTasksForClient:(NBClient *)client
+{
+    NSMutableArray *tasks = [NSMutableArray array];
+    for (NSURLSessionTask *task in self.clientsByTask) {
+        if ([[self.clientsByTask objectForKey:task] nonretainedObjectValue] == client) {
+            [tasks addObject:task];
+        }
+    }
+    for (NSURLSessionTask *task in tasks) {
+        [self.clientsByTask removeObjectForKey:task];
+        [self.pendingTasks removeObject:task];
+        [task cancel];
+    }
+}
+
+#pragma mark - Private
+
+- (NBClient *)clientForTask:(NSURLSessionTask *)task
+{
+    return [[self.clientsByTask objectForKey:task] nonretainedObjectValue];
+}
+
+- (void)finishTask:(NSURLSessionTask *)task
+{
+    if (task) {
+        [self.clientsByTask removeObjectForKey:task];
+        [self.runningTasks removeObject:task];
+        [self.pendingTasks removeObject:task];
+    }
+    [self startPendingTasks];
+    if (!self.runningTasks.count && !self.pendingTasks.count) {
+        [self scheduleIdleSessionInvalidation];
+    }
+}
+
+- (void)startPendingTasks
+{
+    while (self.pendingTasks.count && self.runningTasks.count < self.maximumNumberOfRunningTasks) {
+        // Highest priority first, then oldest.
+        NSURLSessionTask *task = self.pendingTasks.firstObject;
+        for (NSURLSessionTask *pendingTask in self.pendingTasks) {
+            if (pendingTask.priority > task.priority) {
+                task = pendingTask;
+            }
+        }
+        [self.pendingTasks removeObject:task];
+        if (task.state != NSURLSessionTaskStateSuspended) {
+            continue;
+        }
+        [self.runningTasks addObject:task];
+        [task resume];
+        [NBClient taskDidResume:task];
+    }
+}
+
+- (void)scheduleIdleSessionInvalidation
+{
+    if (self.idleSessionTimeoutInterval <= 0) {
+        return;
+    }
+    NSUInteger idleGeneration = self.idleGeneration;
+    __weak __typeof(self)weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.idleSessionTimeoutInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        __strong __typeof(weakSelf)strongSelf = weakSelf;
+        if (!strongSelf || strongSelf.idleGeneration != idleGeneration ||
+            strongSelf.runningTasks.count || strongSelf.pendingTasks.count)
+        {
+            return;
+        }
+        NBLogInfo(@"Releasing idle shared session %@", strongSelf.currentSession);
+        [strongSelf.currentSession finishTasksAndInvalidate];
+        strongSelf.currentSession = nil;
+    });
+}
+
+#pragma mark - NSURLSessionDelegate
+
+- (void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error
+{
+    if (session == self.currentSession) {
+        self.currentSession = nil;
+    }
+    if (error) {
+        NBLogWarning(@"Shared session became invalid: %@", error);
+    }
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+didReceiveChallenge:(NSURLAuthenticationChallenge *)challenge
+ completionHandler:(void (^)(NSURLSessionAuthChallengeDisposition, NSURLCredential *))completionHandler
+{
+    id delegate = [self clientForTask:task].delegate;
+    if ([delegate respondsToSelector:_cmd]) {
+        [delegate URLSession:session task:task didReceiveChallenge:challenge completionHandler:completionHandler];
+        return;
+    }
+    completionHandler(NSURLSessionAuthChallengePerformDefaultHandling, nil);
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+willPerformHTTPRedirection:(NSHTTPURLResponse *)response newRequest:(NSURLRequest *)request
+ completionHandler:(void (^)(NSURLRequest *))completionHandler
+{
+    id delegate = [self clientForTask:task].delegate;
+    if ([delegate respondsToSelector:_cmd]) {
+        [delegate URLSession:session task:task willPerformHTTPRedirection:response newRequest:request completionHandler:completionHandler];
+        return;
+    }
+    completionHandler(request);
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+ needNewBodyStream:(void (^)(NSInputStream *))completionHandler
+{
+    id delegate = [self clientForTask:task].delegate;
+    if ([delegate respondsToSelector:_cmd]) {
+        [delegate URLSession:session task:task needNewBodyStream:completionHandler];
+        return;
+    }
+    completionHandler([NBClientStreamedBody inputStreamForResendingRequest:task.originalRequest]);
+}
+
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask
+ willCacheResponse:(NSCachedURLResponse *)proposedResponse
+ completionHandler:(void (^)(NSCachedURLResponse *))completionHandler
+{
+    // Partition by access token: only cache responses whose URL carries one.
+    NSURLComponents *components = [NSURLComponents componentsWithURL:dataTask.originalRequest.URL resolvingAgainstBaseURL:NO];
+    NSPredicate *predicate = [NSPredicate predicateWithFormat:@"name == %@ AND value.length > 0", AccessTokenQueryItemName];
+    if (![components.queryItems filteredArrayUsingPredicate:predicate].count) {
+        completionHandler(nil);
+        return;
+    }
+    id delegate = [self clientForTask:dataTask].delegate;
+    if ([delegate respondsToSelector:_cmd]) {
+        [delegate URLSession:session dataTask:dataTask willCacheResponse:proposedResponse completionHandler:completionHandler];
+        return;
+    }
+    completionHandler(proposedResponse);
+}
+
+@end
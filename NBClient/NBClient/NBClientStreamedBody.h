@@ -0,0 +1,43 @@
+//
+//  NBClientStreamedBody.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+extern NSUInteger const NBClientErrorCodeBodyEncoding;
+
+// A streamed body encodes a large JSON request body of the form
+// `{ "key": [item, ...] }`, ie. tens of thousands of person identifiers for a
+// bulk list edit, a chunk at a time as the request reads it. The request reads
+// one end of a bound stream pair, while a writer thread shared by all bodies
+// encodes into the other, so neither the whole JSON nor its compressed form is
+// ever held in memory, and the calling thread isn't blocked encoding it.
+@interface NBClientStreamedBody : NSObject <NBLogging>
+
+@property (nonatomic, copy, readonly, nonnull) NSString *key;
+@property (nonatomic, copy, readonly, nonnull) NSArray *items; // Numbers are fastest.
+// Gzip the body. Only for servers that accept gzip-encoded requests.
+@property (nonatomic, readonly) BOOL shouldCompress;
+
+// Designated initializer.
+- (nonnull instancetype)initWithKey:(nonnull NSString *)key
+                              items:(nonnull NSArray *)items
+                     shouldCompress:(BOOL)shouldCompress;
+
+// Each stream is a new encoding, so a request can be resent. Items are checked
+// and compression is started up front, since a bound stream can't fail a read:
+// nil with the error if either fails.
+- (nullable NSInputStream *)inputStreamWithError:(NSError * __nullable * __nullable)error;
+// For `URLSession:task:needNewBodyStream:`. Nil if the request's body isn't streamed.
++ (nullable NSInputStream *)inputStreamForResendingRequest:(nonnull NSURLRequest *)request;
+// Checks every item can be encoded as JSON, which is quicker than encoding.
+- (BOOL)validateItemsWithError:(NSError * __nullable * __nullable)error;
+// Sets the body stream and its headers.
+- (BOOL)applyToRequest:(nonnull NSMutableURLRequest *)request error:(NSError * __nullable * __nullable)error;
+
+@end
@@ -0,0 +1,417 @@
+//
+//  NBClientStreamedBody.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientStreamedBody.h"
+
+#import <zlib.h>
+
+#import "FoundationAdditions.h"
+
+NSUInteger const NBClientErrorCodeBodyEncoding = 13;
+
+// Bounds memory: the stream buffer, plus one chunk before and after compression.
+static CFIndex StreamBufferSize = 64 * 1024;
+static NSUInteger NumberOfItemsPerChunk = 2048;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+// Streams handed out, to their bodies, for resending.
+static NSMapTable *BodiesByInputStream;
+
+@interface NBClientStreamedBody ()
+
+@property (nonatomic, copy, readwrite) NSString *key;
+@property (nonatomic, copy, readwrite) NSArray *items;
+@property (nonatomic, readwrite) BOOL shouldCompress;
+
++ (BOOL)isIntegerItem:(id)item;
++ (NSError *)invalidItemErrorWithKey:(NSString *)key index:(NSUInteger)index;
+
+- (BOOL)appendItem:(id)item toData:(NSMutableData *)data;
+
+@end
+
+// Writes a body into the output end of a bound stream pair, a chunk at a time
+// whenever the request has read enough to make space. Writers are scheduled on
+// one shared thread, and never block it.
+@interface NBClientStreamedBodyWriter : NSObject <NSStreamDelegate>
+
+@property (nonatomic, readonly) NBClientStreamedBody *body;
+@property (nonatomic, readonly) NSOutputStream *outputStream;
+@property (nonatomic) NSMutableData *pendingData;
+@property (nonatomic) NSUInteger pendingOffset;
+@property (nonatomic) NSUInteger numberOfEncodedItems;
+@property (nonatomic) BOOL didEncodeFirstChunk;
+@property (nonatomic) BOOL didEncodeLastChunk;
+@property (nonatomic, getter = isFinished) BOOL finished;
+@property (nonatomic) CFAbsoluteTime startTime;
+
++ (NSThread *)writerThread;
++ (void)runWriterThread;
++ (NSMutableSet *)activeWriters;
+
+- (instancetype)initWithBody:(NBClientStreamedBody *)body outputStream:(NSOutputStream *)outputStream;
+
+- (BOOL)startCompressingWithError:(NSError **)error;
+- (void)start;
+- (void)writePendingData;
+- (BOOL)encodeNextChunk;
+- (void)finish;
+
+@end
+
+@implementation NBClientStreamedBodyWriter
+{
+    z_stream _zStream;
+    BOOL _isCompressing;
+}
+
+- (instancetype)initWithBody:(NBClientStreamedBody *)body outputStream:(NSOutputStream *)outputStream
+{
+    self = [super init];
+    if (self) {
+        _body = body;
+        _outputStream = outputStream;
+        self.pendingData = [NSMutableData dataWithCapacity:StreamBufferSize];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_isCompressing) {
+        deflateEnd(&_zStream);
+    }
+}
+
+#pragma mark - Public
+
++ (NSThread *)writerThread
+{
+    static NSThread *thread;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        thread = [[NSThread alloc] initWithTarget:self selector:@selector(runWriterThread) object:nil];
+        thread.name = @"com.nationbuilder.streamed-body";
+        thread.qualityOfService = NSQualityOfServiceUtility;
+        [thread start];
+    });
+    return thread;
+}
+
+- (BOOL)startCompressingWithError:(NSError *__autoreleasing *)error
+{
+    // 16 more window bits for a gzip wrapper.
+    int status = deflateInit2(&_zStream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    if (status != Z_OK) {
+        NBLogError(@"Failed to start compressing body for \"%@\", zlib status %d", self.body.key, status);
+        if (error) {
+            *error = [NSError errorWithDomain:NBErrorDomain code:NBClientErrorCodeBodyEncoding
+                                     userInfo:@{ NSLocalizedDescriptionKey: @"message.body-compression-error".nb_localizedString,
+                                                 NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                                    @"message.body-compression-error.format".nb_localizedString,
+                                                                                    status] }];
+        }
+        return NO;
+    }
+    _isCompressing = YES;
+    return YES;
+}
+
+- (void)start
+{
+    NSAssert([NSThread currentThread] == [self.class writerThread], @"Writers only run on the writer thread.");
+    // Streams don't retain their delegates.
+    [[self.class activeWriters] addObject:self];
+    self.startTime = CFAbsoluteTimeGetCurrent();
+    self.outputStream.delegate = self;
+    [self.outputStream scheduleInRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    [self.outputStream open];
+}
+
+#pragma mark - NSStreamDelegate
+
+- (void)stream:(NSStream *)stream handleEvent:(NSStreamEvent)eventCode
+{
+    switch (eventCode) {
+        case NSStreamEventHasSpaceAvailable:
+            [self writePendingData];
+            break;
+        case NSStreamEventErrorOccurred:
+        case NSStreamEventEndEncountered:
+            // Ie. the request stopped reading.
+            NBLogInfo(@"Stopped streaming body for \"%@\" after %lu item(s): %@",
+                      self.body.key, (unsigned long)self.numberOfEncodedItems, stream.streamError);
+            [self finish];
+            break;
+        default:
+            break;
+    }
+}
+
+#pragma mark - Private
+
++ (void)runWriterThread
+{
+    @autoreleasepool {
+        NSRunLoop *runLoop = [NSRunLoop currentRunLoop];
+        // Keeps the run loop running while no stream is scheduled.
+        [runLoop addPort:[NSMachPort port] forMode:NSDefaultRunLoopMode];
+        while (YES) {
+            @autoreleasepool {
+                [runLoop runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+            }
+        }
+    }
+}
+
++ (NSMutableSet *)activeWriters
+{
+    static NSMutableSet *activeWriters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        activeWriters = [NSMutableSet set];
+    });
+    return activeWriters;
+}
+
+- (void)writePendingData
+{
+    while (!self.isFinished && self.outputStream.hasSpaceAvailable) {
+        if (self.pendingOffset == self.pendingData.length) {
+            if (self.didEncodeLastChunk) {
+                NBLogInfo(@"Encoded body for \"%@\" with %lu item(s) in %.3fs", self.body.key,
+                          (unsigned long)self.numberOfEncodedItems, CFAbsoluteTimeGetCurrent() - self.startTime);
+                return [self finish];
+            }
+            if (![self encodeNextChunk]) {
+                // Items are validated up front, so this is a bug. Ending early
+                // leaves invalid JSON or gzip, which the server rejects.
+                NBLogError(@"Failed to encode body for \"%@\" at item %lu", self.body.key, (unsigned long)self.numberOfEncodedItems);
+                return [self finish];
+            }
+            continue;
+        }
+        const uint8_t *bytes = (const uint8_t *)self.pendingData.bytes + self.pendingOffset;
+        NSInteger length = [self.outputStream write:bytes maxLength:self.pendingData.length - self.pendingOffset];
+        if (length <= 0) {
+            return [self finish];
+        }
+        self.pendingOffset += (NSUInteger)length;
+    }
+}
+
+- (BOOL)encodeNextChunk
+{
+    @autoreleasepool {
+        NBClientStreamedBody *body = self.body;
+        NSMutableData *chunk = [NSMutableData dataWithCapacity:StreamBufferSize];
+        if (!self.didEncodeFirstChunk) {
+            NSData *keyData = [NSJSONSerialization dataWithJSONObject:@[ body.key ] options:0 error:nil];
+            [chunk appendBytes:"{" length:1];
+            [chunk appendBytes:(const char *)keyData.bytes + 1 length:keyData.length - 2]; // Without brackets.
+            [chunk appendBytes:":[" length:2];
+            self.didEncodeFirstChunk = YES;
+        }
+        NSUInteger count = body.items.count;
+        NSUInteger index = self.numberOfEncodedItems;
+        NSUInteger endIndex = MIN(index + NumberOfItemsPerChunk, count);
+        for (; index < endIndex; index++) {
+            if (index) {
+                [chunk appendBytes:"," length:1];
+            }
+            if (![body appendItem:body.items[index] toData:chunk]) {
+                return NO;
+            }
+        }
+        self.numberOfEncodedItems = index;
+        BOOL isLastChunk = index == count;
+        if (isLastChunk) {
+            [chunk appendBytes:"]}" length:2];
+            self.didEncodeLastChunk = YES;
+        }
+        self.pendingData.length = 0;
+        self.pendingOffset = 0;
+        if (!_isCompressing) {
+            [self.pendingData appendData:chunk];
+            return YES;
+        }
+        uint8_t buffer[16 * 1024];
+        _zStream.next_in = (Bytef *)chunk.bytes;
+        _zStream.avail_in = (uInt)chunk.length;
+        int status;
+        do {
+            _zStream.next_out = buffer;
+            _zStream.avail_out = sizeof(buffer);
+            status = deflate(&_zStream, isLastChunk ? Z_FINISH : Z_NO_FLUSH);
+            if (status == Z_STREAM_ERROR) {
+                return NO;
+            }
+            [self.pendingData appendBytes:buffer length:sizeof(buffer) - _zStream.avail_out];
+        } while (_zStream.avail_out == 0 || (isLastChunk && status != Z_STREAM_END));
+        if (isLastChunk) {
+            NBLogInfo(@"Compressed body for \"%@\" to %lu bytes", body.key, (unsigned long)_zStream.total_out);
+        }
+        return YES;
+    }
+}
+
+- (void)finish
+{
+    if (self.isFinished) {
+        return;
+    }
+    self.finished = YES;
+    [self.outputStream close];
+    [self.outputStream removeFromRunLoop:[NSRunLoop currentRunLoop] forMode:NSDefaultRunLoopMode];
+    self.outputStream.delegate = nil;
+    [[self.class activeWriters] removeObject:self];
+}
+
+@end
+
+@implementation NBClientStreamedBody
+
+- (instancetype)initWithKey:(NSString *)key items:(NSArray *)items shouldCompress:(BOOL)shouldCompress
+{
+    self = [super init];
+    if (self) {
+        self.key = key;
+        self.items = items;
+        self.shouldCompress = shouldCompress;
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Public
+
+- (NSInputStream *)inputStreamWithError:(NSError *__autoreleasing *)error
+{
+    if (![self validateItemsWithError:error]) {
+        return nil;
+    }
+    CFReadStreamRef readStream;
+    CFWriteStreamRef writeStream;
+    CFStreamCreateBoundPair(kCFAllocatorDefault, &readStream, &writeStream, StreamBufferSize);
+    NSInputStream *inputStream = CFBridgingRelease(readStream);
+    NSOutputStream *outputStream = CFBridgingRelease(writeStream);
+    NBClientStreamedBodyWriter *writer = [[NBClientStreamedBodyWriter alloc] initWithBody:self outputStream:outputStream];
+    if (self.shouldCompress && ![writer startCompressingWithError:error]) {
+        return nil;
+    }
+    // Only the first buffer is encoded before the request starts reading.
+    [writer performSelector:@selector(start) onThread:[NBClientStreamedBodyWriter writerThread] withObject:nil waitUntilDone:NO];
+    @synchronized(self.class) {
+        if (!BodiesByInputStream) {
+            BodiesByInputStream = [NSMapTable weakToStrongObjectsMapTable];
+        }
+        [BodiesByInputStream setObject:self forKey:inputStream];
+    }
+    return inputStream;
+}
+
++ (NSInputStream *)inputStreamForResendingRequest:(NSURLRequest *)request
+{
+    NSInputStream *inputStream = request.HTTPBodyStream;
+    if (!inputStream) {
+        return nil;
+    }
+    NBClientStreamedBody *body;
+    @synchronized(self) {
+        body = [BodiesByInputStream objectForKey:inputStream];
+    }
+    if (!body) {
+        return nil;
+    }
+    NBLogInfo(@"Restarting streamed body for %@", request.URL.path);
+    NSError *error;
+    NSInputStream *newInputStream = [body inputStreamWithError:&error];
+    if (!newInputStream) {
+        NBLogError(@"Failed to restart streamed body for %@: %@", request.URL.path, error);
+    }
+    return newInputStream;
+}
+
+- (BOOL)validateItemsWithError:(NSError *__autoreleasing *)error
+{
+    NSUInteger index = 0;
+    for (id item in self.items) {
+        if (![self.class isIntegerItem:item] && ![NSJSONSerialization isValidJSONObject:@[ item ]]) {
+            if (error) {
+                *error = [self.class invalidItemErrorWithKey:self.key index:index];
+            }
+            return NO;
+        }
+        index += 1;
+    }
+    return YES;
+}
+
+- (BOOL)applyToRequest:(NSMutableURLRequest *)request error:(NSError *__autoreleasing *)error
+{
+    NSInputStream *inputStream = [self inputStreamWithError:error];
+    if (!inputStream) {
+        return NO;
+    }
+    request.HTTPBody = nil;
+    request.HTTPBodyStream = inputStream;
+    if (self.shouldCompress) {
+        [request setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+    }
+    return YES;
+}
+
+#pragma mark - Private
+
++ (BOOL)isIntegerItem:(id)item
+{
+    // Booleans are numbers too, but aren't CFNumbers.
+    return (CFGetTypeID((__bridge CFTypeRef)item) == CFNumberGetTypeID() &&
+            !CFNumberIsFloatType((__bridge CFNumberRef)item));
+}
+
++ (NSError *)invalidItemErrorWithKey:(NSString *)key index:(NSUInteger)index
+{
+    return [NSError errorWithDomain:NBErrorDomain code:NBErrorCodeInvalidArgument
+                           userInfo:@{ NSLocalizedDescriptionKey: @"message.invalid-body-item".nb_localizedString,
+                                       NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                          @"message.invalid-body-item.format".nb_localizedString,
+                                                                          (unsigned long)index, key] }];
+}
+
+- (BOOL)appendItem:(id)item toData:(NSMutableData *)data
+{
+    if ([self.class isIntegerItem:item]) {
+        char buffer[24];
+        int length = snprintf(buffer, sizeof(buffer), "%lld", [item longLongValue]);
+        [data appendBytes:buffer length:(NSUInteger)length];
+        return YES;
+    }
+    // Anything else gets proper JSON encoding.
+    NSData *itemData;
+    if ([NSJSONSerialization isValidJSONObject:@[ item ]]) {
+        itemData = [NSJSONSerialization dataWithJSONObject:@[ item ] options:0 error:nil];
+    }
+    if (itemData.length < 2) {
+        return NO;
+    }
+    [data appendBytes:(const char *)itemData.bytes + 1 length:itemData.length - 2];
+    return YES;
+}
+
+@end
@@ -0,0 +1,36 @@
+//
+//  NBClientStringInternPool.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+// The intern pool deduplicates strings in parsed JSON, so records of a large
+// list share one instance of each key and of each repeated value, ie. state
+// codes, party, support levels and tag names, instead of each record having
+// its own copies. Values are interned per key until that key has more than
+// `maximumNumberOfValuesPerKey` distinct values, ie. names and emails, after
+// which its values are left alone, so the pool stays small. Thread-safe.
+@interface NBClientStringInternPool : NSObject <NBLogging>
+
+// Defaults to 256.
+@property (nonatomic) NSUInteger maximumNumberOfValuesPerKey;
+// Defaults to 64. Longer values are never interned.
+@property (nonatomic) NSUInteger maximumValueLength;
+
+@property (nonatomic, readonly) NSUInteger numberOfStrings;
+// Totals across all objects interned since the last reset.
+@property (nonatomic, readonly) NSUInteger numberOfDeduplicatedStrings;
+@property (nonatomic, readonly) NSUInteger numberOfSavedBytes;
+
+// Returns a copy of the JSON object with its dictionary keys and short string
+// values interned, and the bytes that no longer need to be kept, if any.
+- (nonnull id)internObject:(nonnull id)object savedBytes:(nullable NSUInteger *)savedBytes;
+
+- (void)removeAllStrings;
+
+@end
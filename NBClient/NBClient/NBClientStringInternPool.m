@@ -0,0 +1,147 @@
+//
+//  NBClientStringInternPool.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientStringInternPool.h"
+
+#import <malloc/malloc.h>
+
+static NSUInteger DefaultMaximumNumberOfValuesPerKey = 256;
+static NSUInteger DefaultMaximumValueLength = 64;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientStringInternPool ()
+
+@property (nonatomic, readwrite) NSUInteger numberOfStrings;
+@property (nonatomic, readwrite) NSUInteger numberOfDeduplicatedStrings;
+@property (nonatomic, readwrite) NSUInteger numberOfSavedBytes;
+
+@property (nonatomic) NSMutableSet *keys;
+// Sets of values, or null for keys with too many distinct values.
+@property (nonatomic) NSMutableDictionary *valuesByKey;
+
+- (id)internObject:(id)object forKey:(NSString *)key savedBytes:(NSUInteger *)savedBytes;
+- (NSString *)internString:(NSString *)string inSet:(NSMutableSet *)strings savedBytes:(NSUInteger *)savedBytes;
+
+@end
+
+@implementation NBClientStringInternPool
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.maximumNumberOfValuesPerKey = DefaultMaximumNumberOfValuesPerKey;
+        self.maximumValueLength = DefaultMaximumValueLength;
+        self.keys = [NSMutableSet set];
+        self.valuesByKey = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Public
+
+- (id)internObject:(id)object savedBytes:(NSUInteger *)savedBytes
+{
+    NSUInteger bytes = 0;
+    id internedObject;
+    @synchronized(self) {
+        internedObject = [self internObject:object forKey:nil savedBytes:&bytes];
+        self.numberOfSavedBytes += bytes;
+    }
+    NBLogDebug(@"Interned object, saving %lu byte(s), pool has %lu string(s)",
+               (unsigned long)bytes, (unsigned long)self.numberOfStrings);
+    if (savedBytes) {
+        *savedBytes = bytes;
+    }
+    return internedObject;
+}
+
+- (void)removeAllStrings
+{
+    @synchronized(self) {
+        [self.keys removeAllObjects];
+        [self.valuesByKey removeAllObjects];
+        self.numberOfStrings = 0;
+        self.numberOfDeduplicatedStrings = 0;
+        self.numberOfSavedBytes = 0;
+    }
+}
+
+#pragma mark - Private
+
+- (id)internObject:(id)object forKey:(NSString *)key savedBytes:(NSUInteger *)savedBytes
+{
+    if ([object isKindOfClass:[NSDictionary class]]) {
+        NSDictionary *dictionary = object;
+        NSMutableArray *keys = [[NSMutableArray alloc] initWithCapacity:dictionary.count];
+        NSMutableArray *values = [[NSMutableArray alloc] initWithCapacity:dictionary.count];
+        for (NSString *aKey in dictionary) {
+            NSString *internedKey = [self internString:aKey inSet:self.keys savedBytes:savedBytes];
+            [keys addObject:internedKey];
+            [values addObject:[self internObject:dictionary[aKey] forKey:internedKey savedBytes:savedBytes]];
+        }
+        return [NSDictionary dictionaryWithObjects:values forKeys:keys];
+    }
+    if ([object isKindOfClass:[NSArray class]]) {
+        NSArray *array = object;
+        NSMutableArray *items = [[NSMutableArray alloc] initWithCapacity:array.count];
+        for (id item in array) {
+            // Items of a list value, ie. tags, count as values of its key.
+            [items addObject:[self internObject:item forKey:key savedBytes:savedBytes]];
+        }
+        return [items copy];
+    }
+    if (![object isKindOfClass:[NSString class]] || !key || [object length] > self.maximumValueLength) {
+        return object;
+    }
+    id values = self.valuesByKey[key];
+    if (values == [NSNull null]) {
+        return object;
+    }
+    if (!values) {
+        values = [NSMutableSet set];
+        self.valuesByKey[key] = values;
+    }
+    if (![values member:object] && [values count] >= self.maximumNumberOfValuesPerKey) {
+        // Too many distinct values to be worth it, ie. names and emails.
+        NBLogDebug(@"Stopped interning values for \"%@\"", key);
+        self.numberOfStrings -= [values count];
+        self.valuesByKey[key] = [NSNull null];
+        return object;
+    }
+    return [self internString:object inSet:values savedBytes:savedBytes];
+}
+
+- (NSString *)internString:(NSString *)string inSet:(NSMutableSet *)strings savedBytes:(NSUInteger *)savedBytes
+{
+    NSString *internedString = [strings member:string];
+    if (!internedString) {
+        [strings addObject:string];
+        self.numberOfStrings += 1;
+        return string;
+    }
+    if (internedString != string) {
+        // Zero for tagged pointers, which were never allocated.
+        *savedBytes += malloc_size((__bridge const void *)string);
+        self.numberOfDeduplicatedStrings += 1;
+    }
+    return internedString;
+}
+
+@end
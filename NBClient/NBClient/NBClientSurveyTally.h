@@ -0,0 +1,66 @@
+//
+//  NBClientSurveyTally.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+extern NSUInteger const NBClientSurveyTallyVersion;
+
+// Called with each page's newly counted responses, as the page arrives.
+typedef void (^NBClientSurveyTallyUpdateHandler)(NSArray * __nonnull responses);
+
+// A survey tally keeps per-question answer counts for one survey, ie. for a
+// phone bank dashboard, and updates them as response pages arrive instead of
+// recounting every response. Each refresh only asks for responses created
+// since the last complete refresh (`start_time`), so refreshing a large survey
+// usually costs a single small page. Responses are counted once by identifier,
+// which makes overlapping pages and interrupted refreshes safe to fetch again.
+// Responses changed or deleted after being counted aren't reflected until a
+// reset. The tally is persisted per account and loaded on creation. Like the
+// client, it should be used from the main queue.
+@interface NBClientSurveyTally : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+// Ie. the nation slug and account identifier.
+@property (nonatomic, copy, readonly, nonnull) NSString *identifier;
+@property (nonatomic, readonly) NSUInteger surveyIdentifier;
+
+// Defaults to a file for the identifier and survey in the caches directory.
+@property (nonatomic, copy, nonnull) NSURL *fileURL;
+@property (nonatomic, copy, nullable) NBClientSurveyTallyUpdateHandler updateHandler;
+
+// Question identifiers to dictionaries of responses to counts, all keyed by
+// their string values. Questions allowing several answers count each.
+@property (nonatomic, copy, readonly, nonnull) NSDictionary *counts;
+@property (nonatomic, readonly) NSUInteger numberOfResponses;
+// Of the newest counted response.
+@property (nonatomic, readonly) NSUInteger lastResponseIdentifier;
+// Ie. the creation time of the newest response as of the last complete refresh.
+@property (nonatomic, copy, readonly, nullable) NSString *startTime;
+@property (nonatomic, readonly, getter = isRefreshing) BOOL refreshing;
+
+// Designated initializer. Loads any persisted tally.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client
+                            identifier:(nonnull NSString *)identifier
+                      surveyIdentifier:(NSUInteger)surveyIdentifier;
+
+- (nullable NSDictionary *)countsForQuestionIdentifier:(NSUInteger)questionIdentifier;
+
+// Counts responses not yet counted, ie. from pages fetched elsewhere or just
+// created. Returns the newly counted ones.
+- (nonnull NSArray *)addResponses:(nonnull NSArray *)responses;
+
+// Fetches every page of new responses, counting each as it arrives. Progress is
+// kept if a page fails. Concurrent calls share one refresh.
+- (void)refreshWithCompletionHandler:(nullable NBClientEmptyCompletionHandler)completionHandler;
+// Keeps the responses counted so far. The completion handlers get a cancelled error.
+- (void)cancel;
+// Removes all counts, so the next refresh fetches every response.
+- (void)reset;
+
+@end
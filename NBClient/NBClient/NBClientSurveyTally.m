@@ -0,0 +1,375 @@
+//
+//  NBClientSurveyTally.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientSurveyTally.h"
+
+#import "FoundationAdditions.h"
+#import "NBClient+Surveys.h"
+#import "NBPaginationInfo.h"
+
+NSUInteger const NBClientSurveyTallyVersion = 1;
+
+static NSString *TallyDirectoryName = @"com.nationbuilder.survey-tallies";
+static NSString *VersionKey = @"version";
+static NSString *SurveyIdentifierKey = @"survey_id";
+static NSString *CountsKey = @"counts";
+static NSString *NumberOfResponsesKey = @"responses";
+static NSString *ResponseIdentifierRangesKey = @"response_id_ranges";
+static NSString *LastResponseIdentifierKey = @"last_response_id";
+static NSString *LastResponseCreationTimeKey = @"last_response_created_at";
+static NSString *StartTimeKey = @"start_time";
+
+static NSString *ResponseCreationTimeKey = @"created_at";
+
+static NSUInteger PageSize = 100;
+// Counted responses are persisted every few pages, and when a refresh ends.
+static NSUInteger NumberOfPagesPerPersist = 10;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientSurveyTally ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+@property (nonatomic, copy, readwrite) NSString *identifier;
+@property (nonatomic, readwrite) NSUInteger surveyIdentifier;
+@property (nonatomic, readwrite) NSUInteger numberOfResponses;
+@property (nonatomic, readwrite) NSUInteger lastResponseIdentifier;
+@property (nonatomic, copy, readwrite) NSString *startTime;
+@property (nonatomic, readwrite, getter = isRefreshing) BOOL refreshing;
+
+@property (nonatomic) NSMutableDictionary *mutableCounts;
+@property (nonatomic) NSMutableIndexSet *responseIdentifiers;
+@property (nonatomic, copy) NSString *lastResponseCreationTime;
+
+@property (nonatomic) NSMutableArray *completionHandlers;
+@property (nonatomic, weak) NSURLSessionDataTask *currentTask;
+@property (nonatomic, getter = isCancelled) BOOL cancelled;
+@property (nonatomic) NSUInteger numberOfPagesSincePersist;
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+
+- (void)fetchPageWithPaginationInfo:(NBPaginationInfo *)paginationInfo parameters:(NSDictionary *)parameters;
+- (void)handlePageItems:(NSArray *)items
+         paginationInfo:(NBPaginationInfo *)paginationInfo
+             parameters:(NSDictionary *)parameters
+                  error:(NSError *)error;
+- (void)finishRefreshWithError:(NSError *)error;
+- (NSError *)missingClientError;
+- (void)load;
+- (void)persist;
+
+@end
+
+@implementation NBClientSurveyTally
+
+- (instancetype)initWithClient:(NBClient *)client identifier:(NSString *)identifier surveyIdentifier:(NSUInteger)surveyIdentifier
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.identifier = identifier;
+        self.surveyIdentifier = surveyIdentifier;
+        self.completionHandlers = [NSMutableArray array];
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.survey-tally", DISPATCH_QUEUE_SERIAL);
+        NSString *fileName = [NSString stringWithFormat:@"%@-%lu.json", identifier, (unsigned long)surveyIdentifier];
+        NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        self.fileURL = [[cachesURL URLByAppendingPathComponent:TallyDirectoryName isDirectory:YES]
+                        URLByAppendingPathComponent:fileName];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setFileURL:(NSURL *)fileURL
+{
+    // Guard.
+    NSAssert(!self.isRefreshing, @"File can't change while refreshing.");
+    // Set.
+    _fileURL = fileURL.copy;
+    // Did.
+    [self load];
+}
+
+- (NSDictionary *)counts
+{
+    NSMutableDictionary *counts = [NSMutableDictionary dictionary];
+    [self.mutableCounts enumerateKeysAndObjectsUsingBlock:^(NSString *questionKey, NSDictionary *questionCounts, BOOL *stop) {
+        counts[questionKey] = [questionCounts copy];
+    }];
+    return [NSDictionary dictionaryWithDictionary:counts];
+}
+
+#pragma mark - Public
+
+- (NSDictionary *)countsForQuestionIdentifier:(NSUInteger)questionIdentifier
+{
+    return [self.mutableCounts[[NSString stringWithFormat:@"%lu", (unsigned long)questionIdentifier]] copy];
+}
+
+- (NSArray *)addResponses:(NSArray *)responses
+{
+    NSMutableArray *newResponses = [NSMutableArray array];
+    for (NSDictionary *response in responses) {
+        id responseIdentifier = [response[@"id"] nb_nilIfNull];
+        if (![responseIdentifier isKindOfClass:[NSNumber class]] ||
+            [self.responseIdentifiers containsIndex:[responseIdentifier unsignedIntegerValue]])
+        {
+            continue;
+        }
+        NSUInteger identifier = [responseIdentifier unsignedIntegerValue];
+        [self.responseIdentifiers addIndex:identifier];
+        NSArray *questionResponses = [response[NBClientSurveyResponsesKey] nb_nilIfNull];
+        for (NSDictionary *questionResponse in ([questionResponses isKindOfClass:[NSArray class]] ? questionResponses : nil)) {
+            id questionIdentifier = [questionResponse[NBClientSurveyQuestionIdentifierKey] nb_nilIfNull];
+            id answer = [questionResponse[NBClientSurveyQuestionResponseIdentifierKey] nb_nilIfNull];
+            if (!questionIdentifier || !answer) {
+                continue;
+            }
+            NSString *questionKey = [questionIdentifier description];
+            NSString *answerKey = [answer description];
+            NSMutableDictionary *questionCounts = self.mutableCounts[questionKey];
+            if (!questionCounts) {
+                questionCounts = [NSMutableDictionary dictionary];
+                self.mutableCounts[questionKey] = questionCounts;
+            }
+            questionCounts[answerKey] = @([questionCounts[answerKey] unsignedIntegerValue] + 1);
+        }
+        if (identifier > self.lastResponseIdentifier) {
+            self.lastResponseIdentifier = identifier;
+            NSString *creationTime = [response[ResponseCreationTimeKey] nb_nilIfNull];
+            self.lastResponseCreationTime = [creationTime isKindOfClass:[NSString class]] ? creationTime : nil;
+        }
+        [newResponses addObject:response];
+    }
+    self.numberOfResponses += newResponses.count;
+    if (newResponses.count && !self.isRefreshing) {
+        [self persist];
+    }
+    if (newResponses.count && self.updateHandler) {
+        self.updateHandler([NSArray arrayWithArray:newResponses]);
+    }
+    return [NSArray arrayWithArray:newResponses];
+}
+
+- (void)refreshWithCompletionHandler:(NBClientEmptyCompletionHandler)completionHandler
+{
+    if (completionHandler) {
+        [self.completionHandlers addObject:[completionHandler copy]];
+    }
+    if (self.isRefreshing) {
+        return;
+    }
+    if (!self.client) {
+        return [self finishRefreshWithError:[self missingClientError]];
+    }
+    self.refreshing = YES;
+    self.cancelled = NO;
+    self.numberOfPagesSincePersist = 0;
+    NSDictionary *parameters = self.startTime ? @{ StartTimeKey: self.startTime } : nil;
+    NBLogInfo(@"Refreshing survey %lu tally of %lu response(s) from %@",
+              (unsigned long)self.surveyIdentifier, (unsigned long)self.numberOfResponses, self.startTime ?: @"the start");
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:self.client.shouldUseLegacyPagination];
+    paginationInfo.numberOfItemsPerPage = PageSize;
+    [self fetchPageWithPaginationInfo:paginationInfo parameters:parameters];
+}
+
+- (void)cancel
+{
+    if (!self.isRefreshing) {
+        return;
+    }
+    self.cancelled = YES;
+    [self.currentTask cancel];
+}
+
+- (void)reset
+{
+    NSAssert(!self.isRefreshing, @"Survey tally can't reset while refreshing.");
+    self.mutableCounts = [NSMutableDictionary dictionary];
+    self.responseIdentifiers = [NSMutableIndexSet indexSet];
+    self.numberOfResponses = 0;
+    self.lastResponseIdentifier = 0;
+    self.lastResponseCreationTime = nil;
+    self.startTime = nil;
+    NSURL *fileURL = self.fileURL;
+    dispatch_async(self.persistenceQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+    });
+}
+
+#pragma mark - Private
+
+- (void)fetchPageWithPaginationInfo:(NBPaginationInfo *)paginationInfo parameters:(NSDictionary *)parameters
+{
+    if (self.isCancelled) {
+        return [self finishRefreshWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    }
+    // The client can go away between pages, and would never call back.
+    NBClient *client = self.client;
+    if (!client) {
+        return [self finishRefreshWithError:[self missingClientError]];
+    }
+    __weak __typeof(self)weakSelf = self;
+    self.currentTask = [client
+                        fetchSurveyResponseByIdentifier:self.surveyIdentifier parameters:parameters
+                        withPaginationInfo:paginationInfo
+                        completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+                            [weakSelf handlePageItems:items paginationInfo:paginationInfo parameters:parameters error:error];
+                        }];
+}
+
+- (void)handlePageItems:(NSArray *)items
+         paginationInfo:(NBPaginationInfo *)paginationInfo
+             parameters:(NSDictionary *)parameters
+                  error:(NSError *)error
+{
+    if (!error && self.isCancelled) {
+        error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    }
+    if (error) {
+        return [self finishRefreshWithError:error];
+    }
+    NSArray *newResponses = [self addResponses:items ?: @[]];
+    NBLogDebug(@"Counted %lu of %lu response(s) for survey %lu",
+               (unsigned long)newResponses.count, (unsigned long)items.count, (unsigned long)self.surveyIdentifier);
+    if (newResponses.count) {
+        self.numberOfPagesSincePersist += 1;
+    }
+    BOOL isLastPage = (!paginationInfo ||
+                       (paginationInfo.isLegacy
+                        ? paginationInfo.currentPageNumber >= paginationInfo.numberOfTotalPages
+                        : !paginationInfo.nextPageURLString));
+    if (isLastPage) {
+        // Only now are all responses up to the newest one counted, whatever
+        // order the pages came in.
+        self.startTime = self.lastResponseCreationTime ?: self.startTime;
+        return [self finishRefreshWithError:nil];
+    }
+    if (self.numberOfPagesSincePersist >= NumberOfPagesPerPersist) {
+        [self persist];
+    }
+    NBPaginationInfo *nextPaginationInfo = paginationInfo;
+    if (paginationInfo.isLegacy) {
+        nextPaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:paginationInfo.dictionary legacy:YES];
+        nextPaginationInfo.currentPageNumber = paginationInfo.currentPageNumber + 1;
+    } else {
+        nextPaginationInfo.currentDirection = NBPaginationDirectionNext;
+    }
+    [self fetchPageWithPaginationInfo:nextPaginationInfo parameters:parameters];
+}
+
+- (void)finishRefreshWithError:(NSError *)error
+{
+    BOOL didRefresh = self.isRefreshing;
+    self.refreshing = NO;
+    self.currentTask = nil;
+    if (didRefresh && (!error || self.numberOfPagesSincePersist)) {
+        [self persist];
+    }
+    if (error) {
+        NBLogWarning(@"Failed to refresh survey %lu tally: %@", (unsigned long)self.surveyIdentifier, error);
+    } else {
+        NBLogInfo(@"Refreshed survey %lu tally, %lu response(s)",
+                  (unsigned long)self.surveyIdentifier, (unsigned long)self.numberOfResponses);
+    }
+    NSArray *completionHandlers = self.completionHandlers.copy;
+    [self.completionHandlers removeAllObjects];
+    for (NBClientEmptyCompletionHandler completionHandler in completionHandlers) {
+        completionHandler(error);
+    }
+}
+
+- (NSError *)missingClientError
+{
+    return [NSError errorWithDomain:NBErrorDomain code:NBErrorCodeInvalidArgument
+                           userInfo:@{ NSLocalizedDescriptionKey: @"message.missing-client".nb_localizedString }];
+}
+
+- (void)load
+{
+    self.mutableCounts = [NSMutableDictionary dictionary];
+    self.responseIdentifiers = [NSMutableIndexSet indexSet];
+    self.numberOfResponses = 0;
+    self.lastResponseIdentifier = 0;
+    self.lastResponseCreationTime = nil;
+    self.startTime = nil;
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    NSDictionary *file = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    if (![file isKindOfClass:[NSDictionary class]] ||
+        [file[VersionKey] unsignedIntegerValue] != NBClientSurveyTallyVersion ||
+        [file[SurveyIdentifierKey] unsignedIntegerValue] != self.surveyIdentifier ||
+        ![file[CountsKey] isKindOfClass:[NSDictionary class]] ||
+        ![file[ResponseIdentifierRangesKey] isKindOfClass:[NSArray class]])
+    {
+        NBLogInfo(@"Discarding outdated survey tally at %@", self.fileURL);
+        return;
+    }
+    [file[CountsKey] enumerateKeysAndObjectsUsingBlock:^(NSString *questionKey, NSDictionary *questionCounts, BOOL *stop) {
+        if ([questionCounts isKindOfClass:[NSDictionary class]]) {
+            self.mutableCounts[questionKey] = questionCounts.mutableCopy;
+        }
+    }];
+    for (NSArray *range in file[ResponseIdentifierRangesKey]) {
+        if ([range isKindOfClass:[NSArray class]] && range.count == 2) {
+            [self.responseIdentifiers addIndexesInRange:NSMakeRange([range[0] unsignedIntegerValue], [range[1] unsignedIntegerValue])];
+        }
+    }
+    self.numberOfResponses = [file[NumberOfResponsesKey] unsignedIntegerValue];
+    self.lastResponseIdentifier = [file[LastResponseIdentifierKey] unsignedIntegerValue];
+    self.lastResponseCreationTime = [file[LastResponseCreationTimeKey] nb_nilIfNull];
+    self.startTime = [file[StartTimeKey] nb_nilIfNull];
+    NBLogInfo(@"Loaded survey tally of %lu response(s) from %@", (unsigned long)self.numberOfResponses, self.fileURL);
+}
+
+- (void)persist
+{
+    self.numberOfPagesSincePersist = 0;
+    // Identifiers of one survey's responses are sparse, but mostly ascending,
+    // so ranges stay few.
+    NSMutableArray *ranges = [NSMutableArray array];
+    [self.responseIdentifiers enumerateRangesUsingBlock:^(NSRange range, BOOL *stop) {
+        [ranges addObject:@[ @(range.location), @(range.length) ]];
+    }];
+    NSMutableDictionary *file = [NSMutableDictionary dictionary];
+    file[VersionKey] = @(NBClientSurveyTallyVersion);
+    file[SurveyIdentifierKey] = @(self.surveyIdentifier);
+    file[CountsKey] = self.counts;
+    file[NumberOfResponsesKey] = @(self.numberOfResponses);
+    file[ResponseIdentifierRangesKey] = ranges;
+    file[LastResponseIdentifierKey] = @(self.lastResponseIdentifier);
+    file[LastResponseCreationTimeKey] = self.lastResponseCreationTime;
+    file[StartTimeKey] = self.startTime;
+    NSURL *fileURL = self.fileURL;
+    dispatch_async(self.persistenceQueue, ^{
+        NSError *error;
+        NSData *data = [NSJSONSerialization dataWithJSONObject:file options:0 error:&error];
+        if (data) {
+            [[NSFileManager defaultManager] createDirectoryAtURL:fileURL.URLByDeletingLastPathComponent
+                                     withIntermediateDirectories:YES attributes:nil error:nil];
+            [data writeToURL:fileURL options:NSDataWritingAtomic error:&error];
+        }
+        if (error) {
+            NBLogWarning(@"Failed to persist survey tally to %@: %@", fileURL, error);
+        }
+    });
+}
+
+@end
@@ -0,0 +1,78 @@
+//
+//  NBClientSyncJob.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient+Composites.h"
+
+@class NBPaginationInfo;
+
+extern NSUInteger const NBClientErrorCodeSyncDiscontinuity;
+
+// Checkpoint keys.
+extern NSString * __nonnull const NBClientSyncCheckpointPaginationInfoKey; // Dictionary, of the last synced page.
+extern NSString * __nonnull const NBClientSyncCheckpointLegacyKey;
+extern NSString * __nonnull const NBClientSyncCheckpointPageNumberKey; // Of the last synced page.
+extern NSString * __nonnull const NBClientSyncCheckpointNumberOfItemsSeenKey;
+extern NSString * __nonnull const NBClientSyncCheckpointNumberOfTotalItemsKey; // #legacy
+extern NSString * __nonnull const NBClientSyncCheckpointItemIdentifiersKey; // Of the last synced page.
+
+// Called with each page's new items, in order. Store them before returning:
+// the checkpoint is saved right after, and the page isn't fetched again once
+// it is. Store them by identifier, since a page handled just before a crash
+// is handled again.
+typedef void (^NBClientSyncPageHandler)(NSArray * __nonnull items, NSUInteger pageNumber);
+typedef void (^NBClientSyncCompletionHandler)(NSUInteger numberOfItemsSeen, NSError * __nullable error);
+
+// A sync job pulls every page of a resource, ie. all of `/people`, which can
+// take many minutes, and saves a checkpoint after each page so that a job
+// started again with the same identifier, ie. after the app is relaunched,
+// resumes where it left off instead of from the first page. The checkpoint is
+// written atomically after the page handler returns and before the next page
+// is requested, so a page is handled at least once: if the app dies in
+// between, the resumed job handles that page again.
+//
+// Resumed pages are checked for continuity against the checkpoint, which only
+// keeps the cursor, counts, and the last synced page's item identifiers, so it
+// stays small. Items from that page that shift onto the next, ie. because
+// records were added before it, are skipped. Items shifting further are
+// handled again. With legacy pagination, records removed before it shift
+// unseen items onto synced pages, so a shrinking total fails the job with
+// `NBClientErrorCodeSyncDiscontinuity`; reset it to sync from the start. Token
+// pagination cursors are stable, so gaps can't occur. Like the client, it
+// should be used from the main queue.
+@interface NBClientSyncJob : NSObject <NBLogging>
+
+@property (nonatomic, copy, readonly, nonnull) NSString *identifier;
+
+// Defaults to a directory in Application Support.
+@property (nonatomic, copy, nonnull) NSURL *checkpointDirectoryURL;
+@property (nonatomic, readonly, nonnull) NSURL *checkpointURL;
+@property (nonatomic, copy, readonly, nullable) NSDictionary *checkpoint;
+
+// Defaults to 'id'. Used to check continuity.
+@property (nonatomic, copy, nonnull) NSString *itemIdentifierKey;
+@property (nonatomic, copy, nullable) NBClientSyncPageHandler pageHandler;
+
+@property (nonatomic, readonly) NSUInteger numberOfItemsSeen;
+@property (nonatomic, readonly, getter = isRunning) BOOL running;
+
+// Designated initializer. The fetcher gets the first page's pagination info,
+// then each following page's.
+- (nonnull instancetype)initWithIdentifier:(nonnull NSString *)identifier
+                               pageFetcher:(nonnull NBClientPageFetcher)pageFetcher;
+
+// Resumes from the checkpoint if there is one. The checkpoint is removed once
+// the last page is synced.
+- (void)startWithPaginationInfo:(nullable NBPaginationInfo *)paginationInfo
+              completionHandler:(nonnull NBClientSyncCompletionHandler)completionHandler;
+// Keeps the checkpoint. The completion handler gets a cancelled error.
+- (void)cancel;
+// Removes the checkpoint, so the next start is from the first page.
+- (void)reset;
+
+@end
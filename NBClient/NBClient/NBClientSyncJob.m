@@ -0,0 +1,298 @@
+//
+//  NBClientSyncJob.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientSyncJob.h"
+
+#import "FoundationAdditions.h"
+#import "NBPaginationInfo.h"
+
+NSUInteger const NBClientErrorCodeSyncDiscontinuity = 12;
+
+NSString * const NBClientSyncCheckpointPaginationInfoKey = @"pagination_info";
+NSString * const NBClientSyncCheckpointLegacyKey = @"legacy";
+NSString * const NBClientSyncCheckpointPageNumberKey = @"page_number";
+NSString * const NBClientSyncCheckpointNumberOfItemsSeenKey = @"items_seen";
+NSString * const NBClientSyncCheckpointNumberOfTotalItemsKey = @"total_items";
+NSString * const NBClientSyncCheckpointItemIdentifiersKey = @"item_ids";
+
+static NSString *CheckpointDirectoryName = @"com.nationbuilder.sync";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientSyncJob ()
+
+@property (nonatomic, copy, readwrite) NSString *identifier;
+@property (nonatomic, copy, readwrite) NSDictionary *checkpoint;
+
+@property (nonatomic, readwrite) NSUInteger numberOfItemsSeen;
+@property (nonatomic, readwrite, getter = isRunning) BOOL running;
+
+@property (nonatomic, copy) NBClientPageFetcher pageFetcher;
+@property (nonatomic, copy) NBClientSyncCompletionHandler completionHandler;
+@property (nonatomic, weak) NSURLSessionDataTask *currentTask;
+@property (nonatomic, getter = isCancelled) BOOL cancelled;
+
+// Of the last synced page.
+@property (nonatomic) NSUInteger pageNumber;
+@property (nonatomic) NSUInteger numberOfTotalItems;
+@property (nonatomic) NSSet *itemIdentifiers;
+
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+
+- (void)fetchPageWithPaginationInfo:(NBPaginationInfo *)paginationInfo;
+- (void)handlePageItems:(NSArray *)items paginationInfo:(NBPaginationInfo *)paginationInfo error:(NSError *)error;
+- (void)saveCheckpoint:(NSDictionary *)checkpoint completionHandler:(void (^)(NSError *error))completionHandler;
+- (void)loadCheckpoint;
+- (void)finishWithError:(NSError *)error;
+
+@end
+
+@implementation NBClientSyncJob
+
+- (instancetype)initWithIdentifier:(NSString *)identifier pageFetcher:(NBClientPageFetcher)pageFetcher
+{
+    self = [super init];
+    if (self) {
+        self.identifier = identifier;
+        self.pageFetcher = pageFetcher;
+        self.itemIdentifierKey = @"id";
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.sync-job", DISPATCH_QUEUE_SERIAL);
+        NSURL *applicationSupportURL = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory
+                                                                               inDomains:NSUserDomainMask].firstObject;
+        self.checkpointDirectoryURL = [applicationSupportURL URLByAppendingPathComponent:CheckpointDirectoryName isDirectory:YES];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setCheckpointDirectoryURL:(NSURL *)checkpointDirectoryURL
+{
+    // Guard.
+    NSAssert(!self.isRunning, @"Checkpoint directory can't change while running.");
+    // Set.
+    _checkpointDirectoryURL = checkpointDirectoryURL.copy;
+    // Did.
+    [self loadCheckpoint];
+}
+
+- (NSURL *)checkpointURL
+{
+    return [self.checkpointDirectoryURL URLByAppendingPathComponent:
+            [self.identifier stringByAppendingPathExtension:@"plist"]];
+}
+
+#pragma mark - Public
+
+- (void)startWithPaginationInfo:(NBPaginationInfo *)paginationInfo
+              completionHandler:(NBClientSyncCompletionHandler)completionHandler
+{
+    NSAssert(!self.isRunning, @"Sync job is already running.");
+    self.running = YES;
+    self.cancelled = NO;
+    self.completionHandler = completionHandler;
+    NSDictionary *checkpoint = self.checkpoint;
+    if (checkpoint) {
+        BOOL isLegacy = [checkpoint[NBClientSyncCheckpointLegacyKey] boolValue];
+        self.pageNumber = [checkpoint[NBClientSyncCheckpointPageNumberKey] unsignedIntegerValue];
+        self.numberOfItemsSeen = [checkpoint[NBClientSyncCheckpointNumberOfItemsSeenKey] unsignedIntegerValue];
+        self.numberOfTotalItems = [checkpoint[NBClientSyncCheckpointNumberOfTotalItemsKey] unsignedIntegerValue];
+        self.itemIdentifiers = [NSSet setWithArray:checkpoint[NBClientSyncCheckpointItemIdentifiersKey]];
+        paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:checkpoint[NBClientSyncCheckpointPaginationInfoKey]
+                                                               legacy:isLegacy];
+        if (isLegacy) {
+            paginationInfo.currentPageNumber = self.pageNumber + 1;
+        } else {
+            paginationInfo.currentDirection = NBPaginationDirectionNext;
+        }
+        NBLogInfo(@"Resuming sync job \"%@\" after page %lu, %lu item(s) seen",
+                  self.identifier, (unsigned long)self.pageNumber, (unsigned long)self.numberOfItemsSeen);
+    } else {
+        self.pageNumber = 0;
+        self.numberOfItemsSeen = 0;
+        self.numberOfTotalItems = 0;
+        self.itemIdentifiers = nil;
+        paginationInfo = paginationInfo ?: [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+    }
+    [self fetchPageWithPaginationInfo:paginationInfo];
+}
+
+- (void)cancel
+{
+    if (!self.isRunning) {
+        return;
+    }
+    self.cancelled = YES;
+    [self.currentTask cancel];
+}
+
+- (void)reset
+{
+    NSAssert(!self.isRunning, @"Sync job can't reset while running.");
+    NSURL *checkpointURL = self.checkpointURL;
+    dispatch_sync(self.persistenceQueue, ^{
+        [[NSFileManager defaultManager] removeItemAtURL:checkpointURL error:nil];
+    });
+    self.checkpoint = nil;
+    self.numberOfItemsSeen = 0;
+}
+
+#pragma mark - Private
+
+- (void)fetchPageWithPaginationInfo:(NBPaginationInfo *)paginationInfo
+{
+    if (self.isCancelled) {
+        return [self finishWithError:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    }
+    __weak __typeof(self)weakSelf = self;
+    self.currentTask = self.pageFetcher(paginationInfo, ^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+        [weakSelf handlePageItems:items paginationInfo:paginationInfo error:error];
+    });
+}
+
+- (void)handlePageItems:(NSArray *)items paginationInfo:(NBPaginationInfo *)paginationInfo error:(NSError *)error
+{
+    if (!error && self.isCancelled) {
+        error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    }
+    if (error) {
+        return [self finishWithError:error];
+    }
+    NSUInteger pageNumber = self.pageNumber + 1;
+    // Check continuity.
+    if (paginationInfo.isLegacy && self.numberOfTotalItems && paginationInfo.numberOfTotalItems < self.numberOfTotalItems) {
+        NBLogWarning(@"Sync job \"%@\" total went from %lu to %lu at page %lu", self.identifier,
+                     (unsigned long)self.numberOfTotalItems, (unsigned long)paginationInfo.numberOfTotalItems, (unsigned long)pageNumber);
+        return [self finishWithError:
+                [NSError errorWithDomain:NBErrorDomain code:NBClientErrorCodeSyncDiscontinuity
+                                userInfo:@{ NSLocalizedDescriptionKey: @"message.sync-discontinuity-error".nb_localizedString,
+                                            NSLocalizedFailureReasonErrorKey: [NSString localizedStringWithFormat:
+                                                                               @"message.sync-discontinuity-error.format".nb_localizedString,
+                                                                               (unsigned long)pageNumber] }]];
+    }
+    NSMutableArray *newItems = [NSMutableArray array];
+    NSMutableSet *itemIdentifiers = [NSMutableSet setWithCapacity:items.count];
+    for (NSDictionary *item in items) {
+        id itemIdentifier = item[self.itemIdentifierKey];
+        if (itemIdentifier) {
+            [itemIdentifiers addObject:itemIdentifier];
+        }
+        // Records added before synced pages push items from the last one onto this one.
+        if (itemIdentifier && [self.itemIdentifiers containsObject:itemIdentifier]) {
+            continue;
+        }
+        [newItems addObject:item];
+    }
+    if (newItems.count < items.count) {
+        NBLogInfo(@"Sync job \"%@\" skipped %lu already seen item(s) at page %lu", self.identifier,
+                  (unsigned long)(items.count - newItems.count), (unsigned long)pageNumber);
+    }
+    if (self.pageHandler) {
+        self.pageHandler([NSArray arrayWithArray:newItems], pageNumber);
+    }
+    self.pageNumber = pageNumber;
+    self.numberOfItemsSeen += newItems.count;
+    self.numberOfTotalItems = paginationInfo.numberOfTotalItems;
+    self.itemIdentifiers = [NSSet setWithSet:itemIdentifiers];
+    BOOL isLastPage = (!paginationInfo ||
+                       (paginationInfo.isLegacy
+                        ? paginationInfo.currentPageNumber >= paginationInfo.numberOfTotalPages
+                        : !paginationInfo.nextPageURLString));
+    NSDictionary *checkpoint;
+    if (!isLastPage) {
+        checkpoint = @{ NBClientSyncCheckpointPaginationInfoKey: paginationInfo.dictionary,
+                        NBClientSyncCheckpointLegacyKey: @(paginationInfo.isLegacy),
+                        NBClientSyncCheckpointPageNumberKey: @(self.pageNumber),
+                        NBClientSyncCheckpointNumberOfItemsSeenKey: @(self.numberOfItemsSeen),
+                        NBClientSyncCheckpointNumberOfTotalItemsKey: @(self.numberOfTotalItems),
+                        NBClientSyncCheckpointItemIdentifiersKey: itemIdentifiers.allObjects };
+    }
+    [self saveCheckpoint:checkpoint completionHandler:^(NSError *error) {
+        if (error || isLastPage) {
+            return [self finishWithError:error];
+        }
+        NBPaginationInfo *nextPaginationInfo = paginationInfo;
+        if (paginationInfo.isLegacy) {
+            nextPaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:paginationInfo.dictionary legacy:YES];
+            nextPaginationInfo.currentPageNumber = pageNumber + 1;
+        } else {
+            nextPaginationInfo.currentDirection = NBPaginationDirectionNext;
+        }
+        [self fetchPageWithPaginationInfo:nextPaginationInfo];
+    }];
+}
+
+// Passing nil removes the checkpoint.
+- (void)saveCheckpoint:(NSDictionary *)checkpoint completionHandler:(void (^)(NSError *))completionHandler
+{
+    self.checkpoint = checkpoint;
+    NSURL *directoryURL = self.checkpointDirectoryURL;
+    NSURL *checkpointURL = self.checkpointURL;
+    dispatch_async(self.persistenceQueue, ^{
+        NSError *error;
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        if (!checkpoint) {
+            [fileManager removeItemAtURL:checkpointURL error:nil];
+        } else {
+            NSData *data = [NSPropertyListSerialization dataWithPropertyList:checkpoint format:NSPropertyListBinaryFormat_v1_0
+                                                                     options:0 error:&error];
+            if (data && [fileManager createDirectoryAtURL:directoryURL withIntermediateDirectories:YES attributes:nil error:&error]) {
+                [data writeToURL:checkpointURL options:NSDataWritingAtomic error:&error];
+            }
+            if (error) {
+                NBLogError(@"Failed to save sync checkpoint to %@: %@", checkpointURL, error);
+            }
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(error);
+        });
+    });
+}
+
+- (void)loadCheckpoint
+{
+    NSData *data = [NSData dataWithContentsOfURL:self.checkpointURL];
+    NSDictionary *checkpoint;
+    if (data) {
+        NSError *error;
+        checkpoint = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable
+                                                                format:NULL error:&error];
+        if (error || ![checkpoint isKindOfClass:[NSDictionary class]]) {
+            NBLogWarning(@"Ignoring unreadable sync checkpoint at %@: %@", self.checkpointURL, error);
+            checkpoint = nil;
+        }
+    }
+    self.checkpoint = checkpoint;
+    self.numberOfItemsSeen = [checkpoint[NBClientSyncCheckpointNumberOfItemsSeenKey] unsignedIntegerValue];
+}
+
+- (void)finishWithError:(NSError *)error
+{
+    NBClientSyncCompletionHandler completionHandler = self.completionHandler;
+    self.completionHandler = nil;
+    self.currentTask = nil;
+    self.running = NO;
+    if (!error) {
+        NBLogInfo(@"Finished sync job \"%@\", %lu item(s) seen", self.identifier, (unsigned long)self.numberOfItemsSeen);
+    }
+    if (completionHandler) {
+        completionHandler(self.numberOfItemsSeen, error);
+    }
+}
+
+@end
@@ -0,0 +1,45 @@
+//
+//  NBClientTagCatalog.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBClient.h"
+
+// The tag catalog keeps every tag of a client's nation locally, for instant
+// autocomplete while tagging. It syncs all tags in the background and keeps
+// their names sorted by a case and diacritic insensitive key, so matching a
+// prefix is a binary search followed by a short scan. Tags applied through the
+// client are added as they're created, and ranked higher the more they're
+// used. The catalog persists to the caches directory and loads on creation,
+// so it's ready before the first sync. Like the client, it should be used
+// from the main queue.
+@interface NBClientTagCatalog : NSObject <NBLogging>
+
+@property (nonatomic, weak, readonly, nullable) NBClient *client;
+
+// Defaults to a file for the client's nation in the caches directory.
+@property (nonatomic, copy, nonnull) NSURL *fileURL;
+
+@property (nonatomic, readonly) NSUInteger numberOfTags;
+@property (nonatomic, readonly, nullable) NSDate *lastSyncDate;
+@property (nonatomic, readonly, getter = isSyncing) BOOL syncing;
+
+// Designated initializer. Loads any persisted tags.
+- (nonnull instancetype)initWithClient:(nonnull NBClient *)client;
+
+// GET /tags
+// All pages. Names added locally in the meantime are kept.
+- (void)syncWithCompletionHandler:(nullable NBClientEmptyCompletionHandler)completionHandler;
+
+// Exact matches first, then the most used, then the shortest, then
+// alphabetically. Unused tags past the first `limit` matches aren't ranked.
+- (nonnull NSArray *)tagNamesWithPrefix:(nonnull NSString *)prefix limit:(NSUInteger)limit;
+
+// Counts as a use of each name.
+- (void)addTagNames:(nonnull NSArray *)tagNames;
+
+@end
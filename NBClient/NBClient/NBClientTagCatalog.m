@@ -0,0 +1,336 @@
+//
+//  NBClientTagCatalog.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientTagCatalog.h"
+
+#import "NBClient+Composites.h"
+#import "NBClient+People.h"
+#import "NBClient+Tags.h"
+#import "NBPaginationInfo.h"
+
+static NSString *CatalogDirectoryName = @"com.nationbuilder.tags";
+static NSString *NamesKey = @"names";
+static NSString *KeysKey = @"keys";
+static NSString *UseCountsKey = @"use_counts";
+static NSString *LastSyncDateKey = @"last_sync_date";
+
+static NSUInteger SyncPageSize = 100;
+static NSTimeInterval PersistenceCoalescingInterval = 1.0f;
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientTagCatalog ()
+
+@property (nonatomic, weak, readwrite) NBClient *client;
+@property (nonatomic, readwrite) NSDate *lastSyncDate;
+@property (nonatomic, readwrite, getter = isSyncing) BOOL syncing;
+
+// Parallel arrays, sorted by key.
+@property (nonatomic) NSMutableArray *names;
+@property (nonatomic) NSMutableArray *keys;
+@property (nonatomic) NSMutableDictionary *useCounts;
+@property (nonatomic) NSMutableSet *namesAddedDuringSync;
+
+@property (nonatomic) id taggingsObserver;
+@property (nonatomic) dispatch_queue_t persistenceQueue;
+@property (nonatomic) NSUInteger persistenceGeneration;
+
++ (NSString *)keyForTagName:(NSString *)name;
++ (NSComparator)keyComparator;
+
+- (NSUInteger)insertionIndexForKey:(NSString *)key;
+- (BOOL)insertTagName:(NSString *)name;
+- (void)load;
+- (void)schedulePersisting;
+
+@end
+
+@implementation NBClientTagCatalog
+
+- (instancetype)initWithClient:(NBClient *)client
+{
+    self = [super init];
+    if (self) {
+        self.client = client;
+        self.persistenceQueue = dispatch_queue_create("com.nationbuilder.tag-catalog", DISPATCH_QUEUE_SERIAL);
+        NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        self.fileURL = [[cachesURL URLByAppendingPathComponent:CatalogDirectoryName isDirectory:YES]
+                        URLByAppendingPathComponent:[client.nationSlug stringByAppendingPathExtension:@"plist"]];
+        __weak __typeof(self)weakSelf = self;
+        self.taggingsObserver =
+        [[NSNotificationCenter defaultCenter]
+         addObserverForName:NBClientDidCreateTaggingsNotification object:client queue:[NSOperationQueue mainQueue]
+         usingBlock:^(NSNotification *note) {
+             [weakSelf addTagNames:note.userInfo[NBClientTagNamesKey]];
+         }];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:_taggingsObserver];
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setFileURL:(NSURL *)fileURL
+{
+    // Set.
+    _fileURL = fileURL.copy;
+    // Did.
+    [self load];
+}
+
+- (NSUInteger)numberOfTags
+{
+    return self.names.count;
+}
+
+#pragma mark - Public
+
+- (void)syncWithCompletionHandler:(NBClientEmptyCompletionHandler)completionHandler
+{
+    NBClient *client = self.client;
+    if (!client || self.isSyncing) {
+        if (completionHandler) {
+            dispatch_async(dispatch_get_main_queue(), ^{ completionHandler(nil); });
+        }
+        return;
+    }
+    self.syncing = YES;
+    self.namesAddedDuringSync = [NSMutableSet set];
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:client.shouldUseLegacyPagination];
+    paginationInfo.numberOfItemsPerPage = SyncPageSize;
+    __weak __typeof(client)weakClient = client;
+    __weak __typeof(self)weakSelf = self;
+    [client
+     fetchAllPagesWithPaginationInfo:paginationInfo
+     maximumNumberOfConcurrentPages:NBClientCompositeDefaultMaximumNumberOfConcurrentPages
+     pageFetcher:^(NBPaginationInfo *pageInfo, NBClientResourceListCompletionHandler pageHandler) {
+         return [weakClient fetchTagsWithPaginationInfo:pageInfo completionHandler:pageHandler];
+     }
+     completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+         if (error) {
+             weakSelf.namesAddedDuringSync = nil;
+             weakSelf.syncing = NO;
+             if (completionHandler) {
+                 completionHandler(error);
+             }
+             return;
+         }
+         // Sort off the main queue, since there can be tens of thousands.
+         dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+             NSMutableDictionary *namesByKey = [NSMutableDictionary dictionaryWithCapacity:items.count];
+             for (NSDictionary *item in items) {
+                 NSString *name = item[@"name"];
+                 if ([name isKindOfClass:[NSString class]] && name.length) {
+                     namesByKey[[NBClientTagCatalog keyForTagName:name]] = name;
+                 }
+             }
+             NSMutableArray *keys = [namesByKey.allKeys sortedArrayUsingComparator:[NBClientTagCatalog keyComparator]].mutableCopy;
+             NSMutableArray *names = [namesByKey objectsForKeys:keys notFoundMarker:[NSNull null]].mutableCopy;
+             dispatch_async(dispatch_get_main_queue(), ^{
+                 __strong __typeof(weakSelf)strongSelf = weakSelf;
+                 if (!strongSelf) {
+                     return;
+                 }
+                 strongSelf.keys = keys;
+                 strongSelf.names = names;
+                 for (NSString *name in strongSelf.namesAddedDuringSync) {
+                     [strongSelf insertTagName:name];
+                 }
+                 strongSelf.namesAddedDuringSync = nil;
+                 strongSelf.lastSyncDate = [NSDate date];
+                 strongSelf.syncing = NO;
+                 NBLogInfo(@"Synced %lu tag(s) for %@", (unsigned long)names.count, weakClient.nationSlug);
+                 [strongSelf schedulePersisting];
+                 if (completionHandler) {
+                     completionHandler(nil);
+                 }
+             });
+         });
+     }];
+}
+
+- (NSArray *)tagNamesWithPrefix:(NSString *)prefix limit:(NSUInteger)limit
+{
+    NSString *prefixKey = [self.class keyForTagName:prefix];
+    if (!prefixKey.length || !limit) {
+        return @[];
+    }
+    NSArray *keys = self.keys;
+    NSDictionary *useCounts = self.useCounts;
+    NSComparator keyComparator = [self.class keyComparator];
+    NSComparisonResult (^compareRanks)(NSUInteger, NSUInteger) = ^NSComparisonResult(NSUInteger index, NSUInteger otherIndex) {
+        NSString *key = keys[index], *otherKey = keys[otherIndex];
+        BOOL isExact = [key isEqualToString:prefixKey], isOtherExact = [otherKey isEqualToString:prefixKey];
+        if (isExact != isOtherExact) {
+            return isExact ? NSOrderedAscending : NSOrderedDescending;
+        }
+        NSUInteger useCount = [useCounts[key] unsignedIntegerValue], otherUseCount = [useCounts[otherKey] unsignedIntegerValue];
+        if (useCount != otherUseCount) {
+            return useCount > otherUseCount ? NSOrderedAscending : NSOrderedDescending;
+        }
+        if (key.length != otherKey.length) {
+            return key.length < otherKey.length ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return keyComparator(key, otherKey);
+    };
+    // Used tags are few, so all matching ones are candidates. Otherwise only
+    // the first `limit` matches are, since the exact match sorts first.
+    NSMutableIndexSet *candidateIndexes = [NSMutableIndexSet indexSet];
+    for (NSString *key in useCounts) {
+        if ([key hasPrefix:prefixKey]) {
+            NSUInteger index = [self insertionIndexForKey:key];
+            if (index < keys.count && [keys[index] isEqualToString:key]) {
+                [candidateIndexes addIndex:index];
+            }
+        }
+    }
+    NSUInteger startIndex = [self insertionIndexForKey:prefixKey];
+    for (NSUInteger index = startIndex; index < keys.count && index - startIndex < limit && [keys[index] hasPrefix:prefixKey]; index++) {
+        [candidateIndexes addIndex:index];
+    }
+    NSMutableArray *rankedIndexes = [NSMutableArray arrayWithCapacity:candidateIndexes.count];
+    [candidateIndexes enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        [rankedIndexes addObject:@(index)];
+    }];
+    [rankedIndexes sortUsingComparator:^NSComparisonResult(NSNumber *index, NSNumber *otherIndex) {
+        return compareRanks(index.unsignedIntegerValue, otherIndex.unsignedIntegerValue);
+    }];
+    NSMutableArray *names = [NSMutableArray arrayWithCapacity:MIN(limit, rankedIndexes.count)];
+    for (NSNumber *index in rankedIndexes) {
+        if (names.count == limit) {
+            break;
+        }
+        [names addObject:self.names[index.unsignedIntegerValue]];
+    }
+    return [NSArray arrayWithArray:names];
+}
+
+- (void)addTagNames:(NSArray *)tagNames
+{
+    BOOL didChange = NO;
+    for (NSString *name in tagNames) {
+        if (![name isKindOfClass:[NSString class]] || !name.length) {
+            continue;
+        }
+        NSString *key = [self.class keyForTagName:name];
+        self.useCounts[key] = @([self.useCounts[key] unsignedIntegerValue] + 1);
+        [self insertTagName:name];
+        [self.namesAddedDuringSync addObject:name];
+        didChange = YES;
+    }
+    if (didChange) {
+        [self schedulePersisting];
+    }
+}
+
+#pragma mark - Private
+
++ (NSString *)keyForTagName:(NSString *)name
+{
+    return [name stringByFoldingWithOptions:(NSCaseInsensitiveSearch | NSDiacriticInsensitiveSearch) locale:nil];
+}
+
++ (NSComparator)keyComparator
+{
+    return ^NSComparisonResult(NSString *key, NSString *otherKey) {
+        return [key compare:otherKey options:NSLiteralSearch];
+    };
+}
+
+- (NSUInteger)insertionIndexForKey:(NSString *)key
+{
+    return [self.keys indexOfObject:key inSortedRange:NSMakeRange(0, self.keys.count)
+                            options:(NSBinarySearchingFirstEqual | NSBinarySearchingInsertionIndex)
+                    usingComparator:[self.class keyComparator]];
+}
+
+- (BOOL)insertTagName:(NSString *)name
+{
+    NSString *key = [self.class keyForTagName:name];
+    NSUInteger index = [self insertionIndexForKey:key];
+    if (index < self.keys.count && [self.keys[index] isEqualToString:key]) {
+        return NO;
+    }
+    [self.keys insertObject:key atIndex:index];
+    [self.names insertObject:name atIndex:index];
+    return YES;
+}
+
+- (void)load
+{
+    self.names = [NSMutableArray array];
+    self.keys = [NSMutableArray array];
+    self.useCounts = [NSMutableDictionary dictionary];
+    self.lastSyncDate = nil;
+    NSData *data = [NSData dataWithContentsOfURL:self.fileURL];
+    if (!data) {
+        return;
+    }
+    NSDictionary *catalog = [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable
+                                                                       format:NULL error:nil];
+    NSArray *names = catalog[NamesKey];
+    NSArray *keys = catalog[KeysKey];
+    if (![names isKindOfClass:[NSArray class]] || ![keys isKindOfClass:[NSArray class]] || names.count != keys.count) {
+        NBLogWarning(@"Ignoring invalid tag catalog at %@", self.fileURL);
+        return;
+    }
+    self.names = names.mutableCopy;
+    self.keys = keys.mutableCopy;
+    self.useCounts = [catalog[UseCountsKey] mutableCopy] ?: [NSMutableDictionary dictionary];
+    self.lastSyncDate = catalog[LastSyncDateKey];
+    NBLogInfo(@"Loaded %lu tag(s) from %@", (unsigned long)names.count, self.fileURL);
+}
+
+- (void)schedulePersisting
+{
+    // Coalesce: only the latest catalog gets written, off the main queue.
+    self.persistenceGeneration += 1;
+    NSUInteger persistenceGeneration = self.persistenceGeneration;
+    __weak __typeof(self)weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(PersistenceCoalescingInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        __strong __typeof(weakSelf)strongSelf = weakSelf;
+        if (!strongSelf || strongSelf.persistenceGeneration != persistenceGeneration) {
+            return;
+        }
+        NSMutableDictionary *catalog = [NSMutableDictionary dictionary];
+        catalog[NamesKey] = [NSArray arrayWithArray:strongSelf.names];
+        catalog[KeysKey] = [NSArray arrayWithArray:strongSelf.keys];
+        catalog[UseCountsKey] = [NSDictionary dictionaryWithDictionary:strongSelf.useCounts];
+        catalog[LastSyncDateKey] = strongSelf.lastSyncDate;
+        NSURL *fileURL = strongSelf.fileURL;
+        dispatch_async(strongSelf.persistenceQueue, ^{
+            NSError *error;
+            NSData *data = [NSPropertyListSerialization dataWithPropertyList:catalog format:NSPropertyListBinaryFormat_v1_0
+                                                                     options:0 error:&error];
+            if (data) {
+                [[NSFileManager defaultManager] createDirectoryAtURL:fileURL.URLByDeletingLastPathComponent
+                                         withIntermediateDirectories:YES attributes:nil error:nil];
+                [data writeToURL:fileURL options:NSDataWritingAtomic error:&error];
+            }
+            if (error) {
+                NBLogWarning(@"Failed to persist tag catalog to %@: %@", fileURL, error);
+            }
+        });
+    });
+}
+
+@end
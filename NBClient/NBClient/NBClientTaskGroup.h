@@ -0,0 +1,37 @@
+//
+//  NBClientTaskGroup.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+// A task group collects related tasks, ie. everything a view's data source has
+// in flight, so they can be cancelled, reprioritized, or awaited together.
+// Client requests join a group when made inside
+// `-[NBClient performRequestsInTaskGroup:usingBlock:]`, and any other task can
+// be added directly. Finished tasks leave the group on their own. Cancelling
+// doesn't retire the group; tasks added afterwards run as usual.
+@interface NBClientTaskGroup : NSObject <NBLogging>
+
+// Unfinished tasks only.
+@property (nonatomic, copy, readonly, nonnull) NSArray *tasks;
+// Applied to current and future tasks. Defaults to
+// `NSURLSessionTaskPriorityDefault`.
+@property (nonatomic) float priority;
+
+- (void)addTask:(nonnull NSURLSessionTask *)task;
+
+- (void)cancel;
+
+// Called once all current tasks finish, or right away if there are none.
+- (void)notifyOnQueue:(nullable dispatch_queue_t)queue
+    completionHandler:(nonnull dispatch_block_t)completionHandler;
+// Blocks, so don't call this from the main queue when tasks complete there.
+// Returns `NO` on timeout.
+- (BOOL)waitUntilFinishedWithTimeout:(NSTimeInterval)timeout;
+
+@end
@@ -0,0 +1,140 @@
+//
+//  NBClientTaskGroup.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientTaskGroup.h"
+
+static void *ObservationContext = &ObservationContext;
+static NSString *StateKeyPath = @"state";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientTaskGroup ()
+
+@property (nonatomic) NSMutableArray *mutableTasks;
+@property (nonatomic) dispatch_group_t dispatchGroup;
+
+- (void)finishTask:(NSURLSessionTask *)task;
+
+@end
+
+@implementation NBClientTaskGroup
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.mutableTasks = [NSMutableArray array];
+        self.dispatchGroup = dispatch_group_create();
+        _priority = NSURLSessionTaskPriorityDefault;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    for (NSURLSessionTask *task in _mutableTasks) {
+        [task removeObserver:self forKeyPath:StateKeyPath context:ObservationContext];
+        dispatch_group_leave(_dispatchGroup);
+    }
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (NSArray *)tasks
+{
+    @synchronized(self) {
+        return [NSArray arrayWithArray:self.mutableTasks];
+    }
+}
+
+- (void)setPriority:(float)priority
+{
+    // Set.
+    _priority = priority;
+    // Did.
+    for (NSURLSessionTask *task in self.tasks) {
+        task.priority = priority;
+    }
+}
+
+#pragma mark - Public
+
+- (void)addTask:(NSURLSessionTask *)task
+{
+    @synchronized(self) {
+        if (task.state == NSURLSessionTaskStateCompleted || [self.mutableTasks containsObject:task]) {
+            return;
+        }
+        [self.mutableTasks addObject:task];
+        dispatch_group_enter(self.dispatchGroup);
+    }
+    task.priority = self.priority;
+    [task addObserver:self forKeyPath:StateKeyPath options:0 context:ObservationContext];
+    // In case it finished before observing.
+    if (task.state == NSURLSessionTaskStateCompleted) {
+        [self finishTask:task];
+    }
+}
+
+- (void)cancel
+{
+    NSArray *tasks = self.tasks;
+    if (tasks.count) {
+        NBLogInfo(@"Cancelling %lu task(s) in group %@", (unsigned long)tasks.count, self);
+    }
+    for (NSURLSessionTask *task in tasks) {
+        [task cancel];
+    }
+}
+
+- (void)notifyOnQueue:(dispatch_queue_t)queue completionHandler:(dispatch_block_t)completionHandler
+{
+    dispatch_group_notify(self.dispatchGroup, queue ?: dispatch_get_main_queue(), completionHandler);
+}
+
+- (BOOL)waitUntilFinishedWithTimeout:(NSTimeInterval)timeout
+{
+    NSAssert(![NSThread isMainThread], @"Waiting on the main thread would deadlock main queue completion handlers.");
+    return dispatch_group_wait(self.dispatchGroup, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC))) == 0;
+}
+
+#pragma mark - Private
+
+- (void)finishTask:(NSURLSessionTask *)task
+{
+    @synchronized(self) {
+        if (![self.mutableTasks containsObject:task]) {
+            return;
+        }
+        [self.mutableTasks removeObject:task];
+    }
+    [task removeObserver:self forKeyPath:StateKeyPath context:ObservationContext];
+    dispatch_group_leave(self.dispatchGroup);
+}
+
+- (void)observeValueForKeyPath:(NSString *)keyPath ofObject:(id)object change:(NSDictionary *)change context:(void *)context
+{
+    if (context != ObservationContext) {
+        return [super observeValueForKeyPath:keyPath ofObject:object change:change context:context];
+    }
+    if ([object state] == NSURLSessionTaskStateCompleted) {
+        [self finishTask:object];
+    }
+}
+
+@end
@@ -0,0 +1,87 @@
+//
+//  NBClientTracer.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+#import "NBDefines.h"
+
+// Stages of a client request, in order.
+extern NSString * __nonnull const NBClientTraceRequestSpanName;
+extern NSString * __nonnull const NBClientTraceURLStageName; // Building the URL and query.
+extern NSString * __nonnull const NBClientTraceBodyStageName; // Serializing the body.
+extern NSString * __nonnull const NBClientTraceQueueStageName; // Until the task is resumed, ie. by a session provider.
+extern NSString * __nonnull const NBClientTraceNetworkStageName; // Until the response is on the main queue.
+extern NSString * __nonnull const NBClientTraceParseStageName; // JSON parsing.
+extern NSString * __nonnull const NBClientTracePaginationStageName;
+extern NSString * __nonnull const NBClientTraceCompletionStageName; // The caller's completion handler.
+
+@class NBClientTracer;
+
+// A span times one stage of work. Spans of the same request share its
+// identifier, and a request's stages are its child spans, so they nest even
+// though they run across async hops.
+@interface NBClientTraceSpan : NSObject
+
+@property (nonatomic, copy, readonly, nonnull) NSString *name;
+@property (nonatomic, readonly) NSUInteger requestIdentifier;
+@property (nonatomic, weak, readonly, nullable) NBClientTraceSpan *parent;
+@property (nonatomic, copy, readonly, nonnull) NSDictionary *arguments;
+// In seconds since the tracer started.
+@property (nonatomic, readonly) NSTimeInterval startTime;
+@property (nonatomic, readonly) NSTimeInterval endTime;
+@property (nonatomic, readonly) NSTimeInterval duration;
+@property (nonatomic, readonly, getter = isEnded) BOOL ended;
+
+- (void)addArguments:(nonnull NSDictionary *)arguments;
+- (nonnull NBClientTraceSpan *)beginChildSpanWithName:(nonnull NSString *)name;
+// Ends the current stage, if any, and begins the next as a child span.
+- (void)beginStageWithName:(nonnull NSString *)name;
+// Also ends the current stage.
+- (void)end;
+
+@end
+
+// The tracer collects spans of client requests, from building the URL to
+// calling the completion handler, and exports them as Chrome trace events, to
+// be loaded in chrome://tracing, to see where a slow screen's time went. It's
+// off by default, and then costs a nil check per stage. Only the most recent
+// spans are kept. Thread-safe.
+@interface NBClientTracer : NSObject <NBLogging>
+
+@property (nonatomic, getter = isEnabled) BOOL enabled;
+// Defaults to 10000. Older spans are dropped.
+@property (nonatomic) NSUInteger maximumNumberOfSpans;
+// Ended spans only, in order of ending.
+@property (nonatomic, copy, readonly, nonnull) NSArray *spans;
+// Spans begun on the main thread and not yet ended, in order of beginning, ie.
+// to know what the main thread was doing when it stalled. Requests and their
+// queue and network stages stay open across async waits, so they're included
+// but rarely to blame. Only the most recent 100 are kept.
+@property (nonatomic, copy, readonly, nonnull) NSArray *openMainThreadSpans;
+
++ (nonnull instancetype)sharedTracer;
+
+// Returns nil if not enabled. Starts a new request.
+- (nullable NBClientTraceSpan *)beginRequestSpanWithArguments:(nullable NSDictionary *)arguments;
+
+// For tasks whose stages are advanced by others, ie. a session provider. If
+// the task is deallocated before the span ends, ie. it never ran, the span is
+// ended then, with an `abandoned` argument.
+- (void)setSpan:(nullable NBClientTraceSpan *)span forTask:(nonnull NSURLSessionTask *)task;
+- (nullable NBClientTraceSpan *)spanForTask:(nonnull NSURLSessionTask *)task;
+- (void)setSpan:(nullable NBClientTraceSpan *)span forRequest:(nonnull NSURLRequest *)request;
+- (nullable NBClientTraceSpan *)spanForRequest:(nonnull NSURLRequest *)request;
+// Ends the queue stage and begins the network stage.
+- (void)taskDidResume:(nonnull NSURLSessionTask *)task;
+
+- (void)removeAllSpans;
+
+// Trace event format, with each request as a nestable async event.
+- (nonnull NSData *)chromeTraceData;
+- (BOOL)writeChromeTraceToURL:(nonnull NSURL *)url error:(NSError * __nullable * __nullable)error;
+
+@end
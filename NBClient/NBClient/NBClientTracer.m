@@ -0,0 +1,378 @@
+//
+//  NBClientTracer.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBClientTracer.h"
+
+#import <objc/runtime.h>
+#import <pthread.h>
+
+NSString * const NBClientTraceRequestSpanName = @"request";
+NSString * const NBClientTraceURLStageName = @"url";
+NSString * const NBClientTraceBodyStageName = @"body";
+NSString * const NBClientTraceQueueStageName = @"queue";
+NSString * const NBClientTraceNetworkStageName = @"network";
+NSString * const NBClientTraceParseStageName = @"parse";
+NSString * const NBClientTracePaginationStageName = @"pagination";
+NSString * const NBClientTraceCompletionStageName = @"completion";
+
+static NSUInteger DefaultMaximumNumberOfSpans = 10000;
+static NSUInteger MaximumNumberOfOpenMainThreadSpans = 100;
+static void *TaskSentinelKey = &TaskSentinelKey;
+static NSString *TraceCategory = @"nbclient";
+static NSString *DepthKey = @"depth";
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBClientTracer ()
+
+@property (nonatomic) CFAbsoluteTime epoch;
+@property (nonatomic) NSUInteger lastRequestIdentifier;
+@property (nonatomic) NSMutableArray *mutableSpans;
+@property (nonatomic) NSMutableArray *mutableOpenMainThreadSpans;
+@property (nonatomic) NSMapTable *spansByTask;
+@property (nonatomic) NSMapTable *spansByRequest;
+
+- (NSTimeInterval)currentTime;
+- (void)addOpenSpan:(NBClientTraceSpan *)span;
+- (void)addEndedSpan:(NBClientTraceSpan *)span;
+
+@end
+
+@interface NBClientTraceSpan ()
+
+@property (nonatomic, weak) NBClientTracer *tracer;
+@property (nonatomic, copy, readwrite) NSString *name;
+@property (nonatomic, readwrite) NSUInteger requestIdentifier;
+@property (nonatomic, weak, readwrite) NBClientTraceSpan *parent;
+@property (nonatomic) NSMutableDictionary *mutableArguments;
+@property (nonatomic, readwrite) NSTimeInterval startTime;
+@property (nonatomic, readwrite) NSTimeInterval endTime;
+@property (nonatomic, readwrite, getter = isEnded) BOOL ended;
+@property (nonatomic) mach_port_t threadIdentifier;
+@property (nonatomic) NBClientTraceSpan *currentStage;
+
+- (instancetype)initWithName:(NSString *)name
+           requestIdentifier:(NSUInteger)requestIdentifier
+                      parent:(NBClientTraceSpan *)parent
+                      tracer:(NBClientTracer *)tracer;
+
+@end
+
+// Associated with a task, to end its span when the task is deallocated.
+@interface NBClientTraceTaskSentinel : NSObject
+
+@property (nonatomic) NBClientTraceSpan *span;
+
+@end
+
+@implementation NBClientTraceTaskSentinel
+
+- (void)dealloc
+{
+    if (_span && !_span.isEnded) {
+        [_span addArguments:@{ @"abandoned": @YES }];
+        [_span end];
+    }
+}
+
+@end
+
+@implementation NBClientTraceSpan
+
+- (instancetype)initWithName:(NSString *)name
+           requestIdentifier:(NSUInteger)requestIdentifier
+                      parent:(NBClientTraceSpan *)parent
+                      tracer:(NBClientTracer *)tracer
+{
+    self = [super init];
+    if (self) {
+        self.name = name;
+        self.requestIdentifier = requestIdentifier;
+        self.parent = parent;
+        self.tracer = tracer;
+        self.mutableArguments = [NSMutableDictionary dictionary];
+        self.threadIdentifier = pthread_mach_thread_np(pthread_self());
+        self.startTime = [tracer currentTime];
+        if (pthread_main_np()) {
+            [tracer addOpenSpan:self];
+        }
+    }
+    return self;
+}
+
+#pragma mark - Accessors
+
+- (NSDictionary *)arguments
+{
+    @synchronized(self) {
+        return [NSDictionary dictionaryWithDictionary:self.mutableArguments];
+    }
+}
+
+- (NSTimeInterval)duration
+{
+    return self.isEnded ? self.endTime - self.startTime : 0.0f;
+}
+
+#pragma mark - Public
+
+- (void)addArguments:(NSDictionary *)arguments
+{
+    @synchronized(self) {
+        [self.mutableArguments addEntriesFromDictionary:arguments];
+    }
+}
+
+- (NBClientTraceSpan *)beginChildSpanWithName:(NSString *)name
+{
+    return [[NBClientTraceSpan alloc] initWithName:name requestIdentifier:self.requestIdentifier parent:self tracer:self.tracer];
+}
+
+- (void)beginStageWithName:(NSString *)name
+{
+    NBClientTraceSpan *stage = [self beginChildSpanWithName:name];
+    NBClientTraceSpan *previousStage;
+    @synchronized(self) {
+        previousStage = self.currentStage;
+        self.currentStage = stage;
+    }
+    [previousStage end];
+}
+
+- (void)end
+{
+    NBClientTraceSpan *stage;
+    @synchronized(self) {
+        if (self.isEnded) {
+            return;
+        }
+        stage = self.currentStage;
+        self.currentStage = nil;
+        self.ended = YES;
+    }
+    [stage end];
+    self.endTime = [self.tracer currentTime];
+    [self.tracer addEndedSpan:self];
+}
+
+@end
+
+@implementation NBClientTracer
+
++ (instancetype)sharedTracer
+{
+    static NBClientTracer *sharedTracer;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedTracer = [[self alloc] init];
+    });
+    return sharedTracer;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.epoch = CFAbsoluteTimeGetCurrent();
+        self.maximumNumberOfSpans = DefaultMaximumNumberOfSpans;
+        self.mutableSpans = [NSMutableArray array];
+        self.mutableOpenMainThreadSpans = [NSMutableArray array];
+        // By identity, since equal requests can be in flight at once.
+        NSPointerFunctionsOptions keyOptions = NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality;
+        self.spansByTask = [NSMapTable mapTableWithKeyOptions:keyOptions valueOptions:NSPointerFunctionsStrongMemory];
+        self.spansByRequest = [NSMapTable mapTableWithKeyOptions:keyOptions valueOptions:NSPointerFunctionsStrongMemory];
+    }
+    return self;
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (NSArray *)spans
+{
+    @synchronized(self) {
+        return [NSArray arrayWithArray:self.mutableSpans];
+    }
+}
+
+- (NSArray *)openMainThreadSpans
+{
+    @synchronized(self) {
+        return [NSArray arrayWithArray:self.mutableOpenMainThreadSpans];
+    }
+}
+
+#pragma mark - Public
+
+- (NBClientTraceSpan *)beginRequestSpanWithArguments:(NSDictionary *)arguments
+{
+    if (!self.isEnabled) {
+        return nil;
+    }
+    NSUInteger requestIdentifier;
+    @synchronized(self) {
+        self.lastRequestIdentifier += 1;
+        requestIdentifier = self.lastRequestIdentifier;
+    }
+    NBClientTraceSpan *span = [[NBClientTraceSpan alloc] initWithName:NBClientTraceRequestSpanName
+                                                    requestIdentifier:requestIdentifier parent:nil tracer:self];
+    [span addArguments:@{ @"request_id": @(requestIdentifier) }];
+    if (arguments) {
+        [span addArguments:arguments];
+    }
+    return span;
+}
+
+- (void)setSpan:(NBClientTraceSpan *)span forTask:(NSURLSessionTask *)task
+{
+    NBClientTraceTaskSentinel *sentinel;
+    @synchronized(self) {
+        // Replaced spans aren't abandoned.
+        ((NBClientTraceTaskSentinel *)objc_getAssociatedObject(task, TaskSentinelKey)).span = nil;
+        if (span) {
+            [self.spansByTask setObject:span forKey:task];
+            sentinel = [[NBClientTraceTaskSentinel alloc] init];
+            sentinel.span = span;
+        } else {
+            [self.spansByTask removeObjectForKey:task];
+        }
+        objc_setAssociatedObject(task, TaskSentinelKey, sentinel, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+    }
+}
+
+- (NBClientTraceSpan *)spanForTask:(NSURLSessionTask *)task
+{
+    @synchronized(self) {
+        return [self.spansByTask objectForKey:task];
+    }
+}
+
+- (void)setSpan:(NBClientTraceSpan *)span forRequest:(NSURLRequest *)request
+{
+    @synchronized(self) {
+        if (span) {
+            [self.spansByRequest setObject:span forKey:request];
+        } else {
+            [self.spansByRequest removeObjectForKey:request];
+        }
+    }
+}
+
+- (NBClientTraceSpan *)spanForRequest:(NSURLRequest *)request
+{
+    @synchronized(self) {
+        return [self.spansByRequest objectForKey:request];
+    }
+}
+
+- (void)taskDidResume:(NSURLSessionTask *)task
+{
+    [[self spanForTask:task] beginStageWithName:NBClientTraceNetworkStageName];
+}
+
+- (void)removeAllSpans
+{
+    @synchronized(self) {
+        [self.mutableSpans removeAllObjects];
+    }
+}
+
+- (NSData *)chromeTraceData
+{
+    NSMutableArray *events = [NSMutableArray array];
+    int processIdentifier = [NSProcessInfo processInfo].processIdentifier;
+    for (NBClientTraceSpan *span in self.spans) {
+        NSString *eventIdentifier = [NSString stringWithFormat:@"0x%lx", (unsigned long)span.requestIdentifier];
+        NSDictionary *event = @{ @"name": span.name, @"cat": TraceCategory, @"id": eventIdentifier,
+                                 @"pid": @(processIdentifier), @"tid": @(span.threadIdentifier) };
+        NSMutableDictionary *beginEvent = event.mutableCopy;
+        beginEvent[@"ph"] = @"b";
+        beginEvent[@"ts"] = @(span.startTime * 1e6);
+        beginEvent[@"args"] = span.arguments;
+        NSMutableDictionary *endEvent = event.mutableCopy;
+        endEvent[@"ph"] = @"e";
+        endEvent[@"ts"] = @(span.endTime * 1e6);
+        NSUInteger depth = 0;
+        for (NBClientTraceSpan *parent = span.parent; parent; parent = parent.parent) {
+            depth += 1;
+        }
+        beginEvent[DepthKey] = endEvent[DepthKey] = @(depth);
+        [events addObject:beginEvent];
+        [events addObject:endEvent];
+    }
+    // At the same time, ends come before begins, and parents begin before and
+    // end after their children.
+    [events sortUsingComparator:^NSComparisonResult(NSDictionary *event, NSDictionary *otherEvent) {
+        NSComparisonResult result = [event[@"ts"] compare:otherEvent[@"ts"]];
+        if (result != NSOrderedSame) {
+            return result;
+        }
+        if (![event[@"ph"] isEqualToString:otherEvent[@"ph"]]) {
+            return [event[@"ph"] isEqualToString:@"e"] ? NSOrderedAscending : NSOrderedDescending;
+        }
+        result = [event[DepthKey] compare:otherEvent[DepthKey]];
+        return [event[@"ph"] isEqualToString:@"e"] ? (NSComparisonResult)-result : result;
+    }];
+    [events makeObjectsPerformSelector:@selector(removeObjectForKey:) withObject:DepthKey];
+    NSDictionary *trace = @{ @"traceEvents": events, @"displayTimeUnit": @"ms" };
+    NSData *data;
+    if ([NSJSONSerialization isValidJSONObject:trace]) {
+        data = [NSJSONSerialization dataWithJSONObject:trace options:0 error:nil];
+    } else {
+        NBLogError(@"Trace has invalid span arguments.");
+    }
+    return data ?: [NSData data];
+}
+
+- (BOOL)writeChromeTraceToURL:(NSURL *)url error:(NSError *__autoreleasing *)error
+{
+    BOOL didWrite = [[self chromeTraceData] writeToURL:url options:NSDataWritingAtomic error:error];
+    if (didWrite) {
+        NBLogInfo(@"Wrote trace of %lu span(s) to %@", (unsigned long)self.spans.count, url);
+    }
+    return didWrite;
+}
+
+#pragma mark - Private
+
+- (NSTimeInterval)currentTime
+{
+    return CFAbsoluteTimeGetCurrent() - self.epoch;
+}
+
+- (void)addOpenSpan:(NBClientTraceSpan *)span
+{
+    @synchronized(self) {
+        [self.mutableOpenMainThreadSpans addObject:span];
+        if (self.mutableOpenMainThreadSpans.count > MaximumNumberOfOpenMainThreadSpans) {
+            [self.mutableOpenMainThreadSpans removeObjectAtIndex:0];
+        }
+    }
+}
+
+- (void)addEndedSpan:(NBClientTraceSpan *)span
+{
+    @synchronized(self) {
+        [self.mutableOpenMainThreadSpans removeObjectIdenticalTo:span];
+        [self.mutableSpans addObject:span];
+        if (self.mutableSpans.count > self.maximumNumberOfSpans) {
+            [self.mutableSpans removeObjectsInRange:NSMakeRange(0, self.mutableSpans.count - self.maximumNumberOfSpans)];
+        }
+    }
+}
+
+@end
@@ -7,7 +7,9 @@
 
 #import "NBClient.h"
 
-@interface NBClient () <NSURLSessionDelegate>
+@class NBClientStreamedBody;
+
+@interface NBClient () <NSURLSessionTaskDelegate>
 
 @property (nonatomic, copy, readwrite, nonnull) NSString *nationSlug;
 @property (nonatomic, readwrite, nonnull) NSURLSession *urlSession;
@@ -18,6 +20,9 @@
 @property (nonatomic, readwrite, nonnull) NSURL *baseURL;
 @property (nonatomic, null_resettable) NSURLComponents *baseURLComponents;
 @property (nonatomic, copy, nonnull) NSString *defaultErrorRecoverySuggestion;
+@property (nonatomic, readonly, getter = isUsingSessionProvider) BOOL usingSessionProvider;
+@property (nonatomic, nullable) NBClientTaskGroup *currentTaskGroup;
+@property (nonatomic, getter = isMakingBulkRequests) BOOL makingBulkRequests;
 
 - (void)commonInitWithNationSlug:(nonnull NSString *)nationSlug
                 customURLSession:(nullable NSURLSession *)urlSession
@@ -29,6 +34,18 @@
 - (nonnull NSMutableURLRequest *)baseRequestWithURL:(nonnull NSURL *)url
                                          parameters:(nullable NSDictionary *)parameters
                                               error:(NSError * __nullable * __nullable)error;
+// Only for bulk requests, with parameters that are a single list of at least
+// `bodyStreamingThreshold` items.
+- (nullable NBClientStreamedBody *)streamedBodyForParameters:(nullable NSDictionary *)parameters;
+// Bulk endpoints, ie. list edits, make their requests in the block so large
+// bodies can be streamed.
+- (void)performBulkRequestsUsingBlock:(nonnull dispatch_block_t)block;
++ (BOOL)isSessionDelegateSelector:(nonnull SEL)selector;
+// Call right after resuming a task, ie. from a session provider, so page sizing
+// times the request from there and not while it was queued.
++ (void)taskDidResume:(nonnull NSURLSessionTask *)task;
+// Zero if not resumed.
++ (CFAbsoluteTime)resumeTimeForTask:(nonnull NSURLSessionTask *)task;
 
 - (nonnull NSURLSessionDataTask *)baseDataTaskWithURLComponents:(nonnull NSURLComponents *)components
                                                      httpMethod:(nonnull NSString *)method
@@ -42,6 +42,9 @@ typedef NS_ENUM(NSUInteger, NBPaginationDirection) {
 @property (nonatomic, copy, nullable) NSString *nextPageURLString;
 @property (nonatomic, copy, nullable) NSString *previousPageURLString;
 @property (nonatomic) NBPaginationDirection currentDirection;
+// Set by a page sizer, so a token page link is requested with
+// `numberOfItemsPerPage` instead of the limit it came with.
+@property (nonatomic) BOOL overridesLinkLimit;
 
 @property (nonatomic, readonly) BOOL isLastPage;
 
@@ -129,6 +129,13 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         // Get parameters from generated URL strings, or get first page with initial parameters.
         if (components) {
             parameters = components.percentEncodedQuery.nb_queryStringParameters;
+            // Token pages can be resized, ie. by a page sizer.
+            id limit = parameters[NBClientPaginationLimitKey];
+            if (self.overridesLinkLimit && limit && (NSUInteger)[limit integerValue] != self.numberOfItemsPerPage) {
+                NSMutableDictionary *resizedParameters = parameters.mutableCopy;
+                resizedParameters[NBClientPaginationLimitKey] = @(self.numberOfItemsPerPage);
+                parameters = [NSDictionary dictionaryWithDictionary:resizedParameters];
+            }
         } else {
             [mutableParameters removeObjectsForKeys:@[ NBClientPaginationNextLinkKey, NBClientPaginationPreviousLinkKey ]];
             parameters = [NSDictionary dictionaryWithDictionary:mutableParameters];
@@ -12,6 +12,7 @@
 
     #import "NBAccountButton.h"
     #import "NBAccountsViewController.h"
+    #import "NBPerformanceMonitor.h"
     #import "UIKitAdditions.h"
 
 #endif /* _NBCLIENT_UI_ */
\ No newline at end of file
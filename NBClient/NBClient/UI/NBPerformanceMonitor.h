@@ -0,0 +1,77 @@
+//
+//  NBPerformanceMonitor.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <UIKit/UIKit.h>
+
+#import "NBDefines.h"
+
+// Report keys.
+extern NSString * __nonnull const NBPerformanceMonitorBuildKey;
+extern NSString * __nonnull const NBPerformanceMonitorFrameHistogramsKey;
+extern NSString * __nonnull const NBPerformanceMonitorStallsKey;
+extern NSString * __nonnull const NBPerformanceMonitorStallsByAttributionKey;
+
+// Stall keys.
+extern NSString * __nonnull const NBPerformanceMonitorStallAttributionKey; // The operation, or the client stage, or unattributed.
+extern NSString * __nonnull const NBPerformanceMonitorStallOperationsKey; // The operations open at the time, outermost first.
+extern NSString * __nonnull const NBPerformanceMonitorStallClientStageKey;
+extern NSString * __nonnull const NBPerformanceMonitorStallClientPathKey;
+extern NSString * __nonnull const NBPerformanceMonitorStallInteractionKey;
+extern NSString * __nonnull const NBPerformanceMonitorStallStartTimeKey; // In seconds since the monitor was enabled.
+extern NSString * __nonnull const NBPerformanceMonitorStallDurationKey; // In milliseconds.
+
+extern NSString * __nonnull const NBPerformanceMonitorUnattributed;
+
+// The performance monitor measures how smoothly a screen scrolls and when the
+// main thread stalls, and exports both as a report to compare across builds.
+//
+// During an interaction, ie. dragging and decelerating, each frame's duration
+// is counted into that interaction's histogram. Meanwhile, a watchdog on a
+// background queue pings the main queue; a ping left waiting past the stall
+// threshold is a stall. It's attributed to what the main thread was in the
+// middle of when caught: the innermost operation the app marked, ie. a data
+// source's fetch handler or a cell's refresh, or else the stage of an NBClient
+// request being traced, ie. parsing or the completion handler.
+//
+// It's off by default, and then operations cost a check. Enabling it also
+// enables the shared tracer, until it's disabled. Main-queue confined, besides
+// operations, which are ignored off the main thread.
+@interface NBPerformanceMonitor : NSObject <NBLogging>
+
+@property (nonatomic, getter = isEnabled) BOOL enabled;
+// Defaults to 0.1s.
+@property (nonatomic) NSTimeInterval stallThreshold;
+// Defaults to the bundle version.
+@property (nonatomic, copy, nonnull) NSString *buildIdentifier;
+@property (nonatomic, copy, readonly, nullable) NSString *interactionName;
+
++ (nonnull instancetype)sharedMonitor;
+
+// Frames are only counted during an interaction. Interactions don't nest.
+- (void)beginInteractionWithName:(nonnull NSString *)name;
+- (void)endInteraction;
+
+// Operations nest, and should be short and synchronous. Returns the token to
+// end it with, or 0 if ignored, which ending ignores too.
+- (NSUInteger)beginOperationWithName:(nonnull NSString *)name;
+- (void)endOperation:(NSUInteger)token;
+- (void)performOperationWithName:(nonnull NSString *)name usingBlock:(nonnull void (^)(void))block;
+
+// Interaction names to histograms, each with frame counts keyed by the upper
+// bound, in milliseconds, of their bucket, along with the number of frames, of
+// dropped frames, and the longest frame.
+- (nonnull NSDictionary *)frameHistograms;
+// In order of ending. Only the most recent 1000 are kept.
+- (nonnull NSArray *)stalls;
+// The build, device and system, the histograms and stalls, and the number and
+// total duration of stalls by attribution.
+- (nonnull NSDictionary *)report;
+- (BOOL)writeReportToURL:(nonnull NSURL *)url error:(NSError * __nullable * __nullable)error;
+
+- (void)reset;
+
+@end
@@ -0,0 +1,473 @@
+//
+//  NBPerformanceMonitor.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBPerformanceMonitor.h"
+
+#import <QuartzCore/QuartzCore.h>
+#import <sys/utsname.h>
+
+#import "NBClientTracer.h"
+
+NSString * const NBPerformanceMonitorBuildKey = @"build";
+NSString * const NBPerformanceMonitorFrameHistogramsKey = @"frame_histograms";
+NSString * const NBPerformanceMonitorStallsKey = @"stalls";
+NSString * const NBPerformanceMonitorStallsByAttributionKey = @"stalls_by_attribution";
+
+NSString * const NBPerformanceMonitorStallAttributionKey = @"attribution";
+NSString * const NBPerformanceMonitorStallOperationsKey = @"operations";
+NSString * const NBPerformanceMonitorStallClientStageKey = @"client_stage";
+NSString * const NBPerformanceMonitorStallClientPathKey = @"client_path";
+NSString * const NBPerformanceMonitorStallInteractionKey = @"interaction";
+NSString * const NBPerformanceMonitorStallStartTimeKey = @"start_time";
+NSString * const NBPerformanceMonitorStallDurationKey = @"duration";
+
+NSString * const NBPerformanceMonitorUnattributed = @"unattributed";
+
+static NSTimeInterval DefaultStallThreshold = 0.1f;
+static NSUInteger MaximumNumberOfStalls = 1000;
+// Of the stall threshold, so a stall is caught while it's still happening.
+static double WatchdogIntervalRatio = 0.25f;
+
+// Upper bounds, in milliseconds, with some slack for a 60fps frame's jitter.
+static double FrameBucketBounds[] = { 17.0f, 34.0f, 50.0f, 100.0f, 250.0f, INFINITY };
+#define NumberOfFrameBuckets (sizeof(FrameBucketBounds) / sizeof(FrameBucketBounds[0]))
+
+#if DEBUG
+static NBLogLevel LogLevel = NBLogLevelDebug;
+#else
+static NBLogLevel LogLevel = NBLogLevelWarning;
+#endif
+
+@interface NBPerformanceFrameHistogram : NSObject
+
+@property (nonatomic) NSUInteger numberOfFrames;
+@property (nonatomic) NSUInteger numberOfDroppedFrames;
+@property (nonatomic) NSTimeInterval longestFrameDuration;
+
+- (void)addFrameDuration:(NSTimeInterval)duration refreshInterval:(NSTimeInterval)refreshInterval;
+- (NSDictionary *)dictionaryRepresentation;
+
+@end
+
+@implementation NBPerformanceFrameHistogram
+{
+    NSUInteger _counts[NumberOfFrameBuckets];
+}
+
+- (void)addFrameDuration:(NSTimeInterval)duration refreshInterval:(NSTimeInterval)refreshInterval
+{
+    double milliseconds = duration * 1000;
+    for (NSUInteger index = 0; index < NumberOfFrameBuckets; index++) {
+        if (milliseconds <= FrameBucketBounds[index]) {
+            _counts[index] += 1;
+            break;
+        }
+    }
+    self.numberOfFrames += 1;
+    if (refreshInterval > 0) {
+        long numberOfRefreshes = lround(duration / refreshInterval);
+        self.numberOfDroppedFrames += (NSUInteger)MAX(0, numberOfRefreshes - 1);
+    }
+    self.longestFrameDuration = MAX(self.longestFrameDuration, duration);
+}
+
+- (NSDictionary *)dictionaryRepresentation
+{
+    NSMutableDictionary *buckets = [NSMutableDictionary dictionaryWithCapacity:NumberOfFrameBuckets];
+    for (NSUInteger index = 0; index < NumberOfFrameBuckets; index++) {
+        NSString *key = isinf(FrameBucketBounds[index]) ? @"inf" : [NSString stringWithFormat:@"%.0f", FrameBucketBounds[index]];
+        buckets[key] = @(_counts[index]);
+    }
+    return @{ @"buckets": buckets,
+              @"frames": @(self.numberOfFrames),
+              @"dropped_frames": @(self.numberOfDroppedFrames),
+              @"longest_frame": @(self.longestFrameDuration * 1000) };
+}
+
+@end
+
+@interface NBPerformanceMonitor ()
+
+@property (nonatomic, copy, readwrite) NSString *interactionName;
+
+@property (nonatomic) CFAbsoluteTime epoch;
+@property (nonatomic) BOOL wasTracerEnabled;
+
+@property (nonatomic) CADisplayLink *displayLink;
+@property (nonatomic) CFTimeInterval lastFrameTimestamp;
+@property (nonatomic) NSMutableDictionary *mutableFrameHistograms;
+
+@property (nonatomic) dispatch_queue_t watchdogQueue;
+@property (nonatomic) dispatch_source_t watchdogTimer;
+// Guarded by self, since the watchdog reads them.
+@property (nonatomic) NSMutableArray *operationNames;
+@property (nonatomic) NSMutableArray *operationTokens;
+@property (nonatomic) NSUInteger lastOperationToken;
+@property (nonatomic) NSUInteger pingNumber;
+@property (nonatomic) CFAbsoluteTime pingTime; // Zero if no ping is waiting.
+@property (nonatomic) NSDictionary *pendingStall;
+// A ring buffer, once full.
+@property (nonatomic) NSMutableArray *mutableStalls;
+@property (nonatomic) NSUInteger oldestStallIndex;
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink;
+
+- (void)startWatchdog;
+- (void)stopWatchdog;
+- (void)watchdogDidFireWithThreshold:(NSTimeInterval)threshold;
+- (void)mainQueueDidRespondToPingNumber:(NSUInteger)pingNumber threshold:(NSTimeInterval)threshold;
+- (void)applicationWillEnterForeground:(NSNotification *)notification;
+
+// Call while synchronized on self.
+- (NSDictionary *)currentAttribution;
+
+@end
+
+@implementation NBPerformanceMonitor
+
++ (instancetype)sharedMonitor
+{
+    static NBPerformanceMonitor *sharedMonitor;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        sharedMonitor = [[self alloc] init];
+    });
+    return sharedMonitor;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.stallThreshold = DefaultStallThreshold;
+        self.buildIdentifier = [NSBundle mainBundle].infoDictionary[(NSString *)kCFBundleVersionKey] ?: @"unknown";
+        self.mutableFrameHistograms = [NSMutableDictionary dictionary];
+        self.operationNames = [NSMutableArray array];
+        self.operationTokens = [NSMutableArray array];
+        self.mutableStalls = [NSMutableArray array];
+        self.watchdogQueue = dispatch_queue_create("com.nationbuilder.performance-monitor", DISPATCH_QUEUE_SERIAL);
+        // A suspended app isn't stalled.
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationWillEnterForeground:)
+                                                     name:UIApplicationWillEnterForegroundNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [self.displayLink invalidate];
+    [self stopWatchdog];
+}
+
+#pragma mark - NBLogging
+
++ (void)updateLoggingToLevel:(NBLogLevel)logLevel
+{
+    LogLevel = logLevel;
+}
+
+#pragma mark - Accessors
+
+- (void)setEnabled:(BOOL)enabled
+{
+    // Guard.
+    if (enabled == _enabled) { return; }
+    // Set.
+    _enabled = enabled;
+    // Did.
+    if (enabled) {
+        self.epoch = CFAbsoluteTimeGetCurrent();
+        self.wasTracerEnabled = [NBClientTracer sharedTracer].isEnabled;
+        [NBClientTracer sharedTracer].enabled = YES;
+        self.displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(displayLinkDidFire:)];
+        self.displayLink.paused = !self.interactionName;
+        // Common modes, to keep firing while tracking touches.
+        [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+        [self startWatchdog];
+    } else {
+        [self.displayLink invalidate];
+        self.displayLink = nil;
+        [self stopWatchdog];
+        [NBClientTracer sharedTracer].enabled = self.wasTracerEnabled;
+        @synchronized(self) {
+            [self.operationNames removeAllObjects];
+            [self.operationTokens removeAllObjects];
+        }
+    }
+}
+
+- (void)setStallThreshold:(NSTimeInterval)stallThreshold
+{
+    // Guard.
+    if (stallThreshold == _stallThreshold) { return; }
+    // Set.
+    _stallThreshold = stallThreshold;
+    // Did.
+    if (self.isEnabled) {
+        [self stopWatchdog];
+        [self startWatchdog];
+    }
+}
+
+#pragma mark - Public
+
+- (void)beginInteractionWithName:(NSString *)name
+{
+    @synchronized(self) {
+        self.interactionName = name;
+    }
+    self.lastFrameTimestamp = 0;
+    self.displayLink.paused = NO;
+}
+
+- (void)endInteraction
+{
+    @synchronized(self) {
+        self.interactionName = nil;
+    }
+    self.displayLink.paused = YES;
+}
+
+- (NSUInteger)beginOperationWithName:(NSString *)name
+{
+    if (![NSThread isMainThread] || !self.isEnabled) {
+        return 0;
+    }
+    NSUInteger token;
+    @synchronized(self) {
+        self.lastOperationToken += 1;
+        token = self.lastOperationToken;
+        [self.operationNames addObject:name];
+        [self.operationTokens addObject:@(token)];
+    }
+    return token;
+}
+
+- (void)endOperation:(NSUInteger)token
+{
+    if (!token || ![NSThread isMainThread]) {
+        return;
+    }
+    @synchronized(self) {
+        // Not found if disabling cleared it.
+        NSUInteger index = [self.operationTokens indexOfObject:@(token)];
+        if (index != NSNotFound) {
+            [self.operationNames removeObjectAtIndex:index];
+            [self.operationTokens removeObjectAtIndex:index];
+        }
+    }
+}
+
+- (void)performOperationWithName:(NSString *)name usingBlock:(void (^)(void))block
+{
+    NSUInteger token = [self beginOperationWithName:name];
+    block();
+    [self endOperation:token];
+}
+
+- (NSDictionary *)frameHistograms
+{
+    NSMutableDictionary *frameHistograms = [NSMutableDictionary dictionaryWithCapacity:self.mutableFrameHistograms.count];
+    [self.mutableFrameHistograms enumerateKeysAndObjectsUsingBlock:^(NSString *name, NBPerformanceFrameHistogram *histogram, BOOL *stop) {
+        frameHistograms[name] = [histogram dictionaryRepresentation];
+    }];
+    return frameHistograms;
+}
+
+- (NSArray *)stalls
+{
+    @synchronized(self) {
+        NSUInteger count = self.mutableStalls.count;
+        NSUInteger index = self.oldestStallIndex;
+        NSMutableArray *stalls = [NSMutableArray arrayWithCapacity:count];
+        [stalls addObjectsFromArray:[self.mutableStalls subarrayWithRange:NSMakeRange(index, count - index)]];
+        [stalls addObjectsFromArray:[self.mutableStalls subarrayWithRange:NSMakeRange(0, index)]];
+        return [NSArray arrayWithArray:stalls];
+    }
+}
+
+- (NSDictionary *)report
+{
+    NSArray *stalls = self.stalls;
+    NSMutableDictionary *stallsByAttribution = [NSMutableDictionary dictionary];
+    for (NSDictionary *stall in stalls) {
+        NSString *attribution = stall[NBPerformanceMonitorStallAttributionKey];
+        NSDictionary *summary = stallsByAttribution[attribution];
+        stallsByAttribution[attribution] =
+        @{ @"count": @([summary[@"count"] unsignedIntegerValue] + 1),
+           NBPerformanceMonitorStallDurationKey: @([summary[NBPerformanceMonitorStallDurationKey] doubleValue] +
+                                                   [stall[NBPerformanceMonitorStallDurationKey] doubleValue]) };
+    }
+    struct utsname systemInfo;
+    uname(&systemInfo);
+    UIDevice *device = [UIDevice currentDevice];
+    return @{ NBPerformanceMonitorBuildKey: self.buildIdentifier,
+              @"device": @(systemInfo.machine),
+              @"system": [NSString stringWithFormat:@"%@ %@", device.systemName, device.systemVersion],
+              @"date": @([NSDate date].timeIntervalSince1970),
+              @"stall_threshold": @(self.stallThreshold * 1000),
+              NBPerformanceMonitorFrameHistogramsKey: [self frameHistograms],
+              NBPerformanceMonitorStallsKey: stalls,
+              NBPerformanceMonitorStallsByAttributionKey: stallsByAttribution };
+}
+
+- (BOOL)writeReportToURL:(NSURL *)url error:(NSError *__autoreleasing *)error
+{
+    NSData *data = [NSJSONSerialization dataWithJSONObject:[self report] options:NSJSONWritingPrettyPrinted error:error];
+    BOOL didWrite = data && [data writeToURL:url options:NSDataWritingAtomic error:error];
+    if (didWrite) {
+        NBLogInfo(@"Wrote performance report of %lu stall(s) to %@", (unsigned long)self.stalls.count, url);
+    }
+    return didWrite;
+}
+
+- (void)reset
+{
+    [self.mutableFrameHistograms removeAllObjects];
+    self.lastFrameTimestamp = 0;
+    @synchronized(self) {
+        [self.mutableStalls removeAllObjects];
+        self.oldestStallIndex = 0;
+    }
+}
+
+#pragma mark - Private
+
+- (void)displayLinkDidFire:(CADisplayLink *)displayLink
+{
+    NSString *name = self.interactionName;
+    if (!name) {
+        return;
+    }
+    if (self.lastFrameTimestamp) {
+        NBPerformanceFrameHistogram *histogram = self.mutableFrameHistograms[name];
+        if (!histogram) {
+            histogram = [[NBPerformanceFrameHistogram alloc] init];
+            self.mutableFrameHistograms[name] = histogram;
+        }
+        [histogram addFrameDuration:(displayLink.timestamp - self.lastFrameTimestamp) refreshInterval:displayLink.duration];
+    }
+    self.lastFrameTimestamp = displayLink.timestamp;
+}
+
+- (void)startWatchdog
+{
+    NSTimeInterval threshold = self.stallThreshold;
+    uint64_t interval = (uint64_t)(threshold * WatchdogIntervalRatio * NSEC_PER_SEC);
+    self.watchdogTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.watchdogQueue);
+    dispatch_source_set_timer(self.watchdogTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+    __weak __typeof(self)weakSelf = self;
+    dispatch_source_set_event_handler(self.watchdogTimer, ^{
+        [weakSelf watchdogDidFireWithThreshold:threshold];
+    });
+    dispatch_resume(self.watchdogTimer);
+}
+
+- (void)stopWatchdog
+{
+    if (!self.watchdogTimer) {
+        return;
+    }
+    dispatch_source_cancel(self.watchdogTimer);
+    self.watchdogTimer = nil;
+    @synchronized(self) {
+        self.pingNumber += 1;
+        self.pingTime = 0;
+        self.pendingStall = nil;
+    }
+}
+
+- (void)watchdogDidFireWithThreshold:(NSTimeInterval)threshold
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    @synchronized(self) {
+        if (!self.pingTime) {
+            self.pingNumber += 1;
+            self.pingTime = now;
+            NSUInteger pingNumber = self.pingNumber;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [self mainQueueDidRespondToPingNumber:pingNumber threshold:threshold];
+            });
+        } else if (!self.pendingStall && now - self.pingTime > threshold) {
+            // Still stalled, so note what's on the main thread now.
+            self.pendingStall = [self currentAttribution];
+        }
+    }
+}
+
+- (void)mainQueueDidRespondToPingNumber:(NSUInteger)pingNumber threshold:(NSTimeInterval)threshold
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    NSDictionary *stall;
+    @synchronized(self) {
+        if (pingNumber != self.pingNumber || !self.pingTime) {
+            return;
+        }
+        NSTimeInterval duration = now - self.pingTime;
+        if (duration > threshold) {
+            // Without a pending stall, it ended before the watchdog could catch it.
+            NSMutableDictionary *mutableStall = (self.pendingStall ?: @{ NBPerformanceMonitorStallAttributionKey: NBPerformanceMonitorUnattributed }).mutableCopy;
+            mutableStall[NBPerformanceMonitorStallStartTimeKey] = @(self.pingTime - self.epoch);
+            mutableStall[NBPerformanceMonitorStallDurationKey] = @(duration * 1000);
+            stall = [mutableStall copy];
+            if (self.mutableStalls.count < MaximumNumberOfStalls) {
+                [self.mutableStalls addObject:stall];
+            } else {
+                self.mutableStalls[self.oldestStallIndex] = stall;
+                self.oldestStallIndex = (self.oldestStallIndex + 1) % MaximumNumberOfStalls;
+            }
+        }
+        self.pingTime = 0;
+        self.pendingStall = nil;
+    }
+    if (stall) {
+        NBLogInfo(@"Main thread stalled for %.0fms in %@", [stall[NBPerformanceMonitorStallDurationKey] doubleValue],
+                  stall[NBPerformanceMonitorStallAttributionKey]);
+    }
+}
+
+- (void)applicationWillEnterForeground:(NSNotification *)notification
+{
+    @synchronized(self) {
+        self.pingNumber += 1;
+        self.pingTime = 0;
+        self.pendingStall = nil;
+    }
+}
+
+- (NSDictionary *)currentAttribution
+{
+    NSMutableDictionary *attribution = [NSMutableDictionary dictionary];
+    NSArray *operationNames = [NSArray arrayWithArray:self.operationNames];
+    attribution[NBPerformanceMonitorStallOperationsKey] = operationNames;
+    attribution[NBPerformanceMonitorStallInteractionKey] = self.interactionName;
+    // The innermost stage actually running, not waiting.
+    static NSSet *WaitingSpanNames;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        WaitingSpanNames = [NSSet setWithArray:@[ NBClientTraceRequestSpanName, NBClientTraceQueueStageName,
+                                                  NBClientTraceNetworkStageName ]];
+    });
+    NBClientTraceSpan *stage;
+    for (NBClientTraceSpan *span in [[NBClientTracer sharedTracer].openMainThreadSpans reverseObjectEnumerator]) {
+        if (![WaitingSpanNames containsObject:span.name]) {
+            stage = span;
+            break;
+        }
+    }
+    if (stage) {
+        attribution[NBPerformanceMonitorStallClientStageKey] = stage.name;
+        attribution[NBPerformanceMonitorStallClientPathKey] = stage.parent.arguments[@"path"];
+    }
+    attribution[NBPerformanceMonitorStallAttributionKey] = (operationNames.lastObject ?:
+                                                            (stage ? [NSString stringWithFormat:@"nbclient.%@", stage.name]
+                                                             : NBPerformanceMonitorUnattributed));
+    return attribution;
+}
+
+@end
@@ -143,4 +143,14 @@
     XCTAssertFalse(@"abc123".nb_isNumeric, @"Strings that are partially numeric should not be numeric.");
 }
 
+- (void)testCheckingIfErrorIsCancellation
+{
+    XCTAssertTrue([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil].nb_isCancellation,
+                  @"Cancelled URL errors should be cancellations.");
+    XCTAssertFalse([NSError errorWithDomain:NBErrorDomain code:NSURLErrorCancelled userInfo:nil].nb_isCancellation,
+                   @"Errors with the same code in other domains should not be cancellations.");
+    XCTAssertFalse([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil].nb_isCancellation,
+                   @"Other URL errors should not be cancellations.");
+}
+
 @end
@@ -86,6 +86,23 @@
                   @"Credential identifier should contain new account name and identifier.");
 }
 
+- (void)testDeferredMaterialization
+{
+    // Given: a fresh account, ie. one restored from persistence.
+    XCTAssertFalse(self.account.isMaterialized, @"Account should start out lightweight.");
+    // When: setting identifying properties.
+    self.account.name = @"Foo Bar";
+    self.account.identifier = 123;
+    // Then: neither the client nor the authenticator are created yet.
+    XCTAssertFalse(self.account.isMaterialized, @"Identifying properties should not create the authenticator.");
+    // When: the authenticator is first needed.
+    NSString *credentialIdentifier = self.account.authenticator.credentialIdentifier;
+    // Then: it gets the deferred credential identifier.
+    XCTAssertTrue(self.account.isMaterialized, @"Account should now be fully created.");
+    XCTAssertTrue([credentialIdentifier hasSuffix:@"-Foo Bar-123"],
+                  @"Credential identifier should contain account name and identifier.");
+}
+
 - (void)testActivationAndPersonFetching
 {
     [self setUpAsyncWithHTTPStubbing:YES];
@@ -11,6 +11,8 @@
 
 #import "NBAccount_Internal.h"
 #import "NBAccountsManager_Internal.h"
+#import "NBClient+Composites.h"
+#import "NBClient+People.h"
 
 @interface NBAccountsManagerTests : NBTestCase
 
@@ -20,11 +22,18 @@
 @property (nonatomic) id accountsManagerMock;
 @property (nonatomic) id delegateMock;
 
+@property (nonatomic) NSUInteger numberOfSearches;
+@property (nonatomic) NSUInteger maximumNumberOfSearches;
+
 // NOTE: Sometimes creating real objects is necessary.
 - (NBAccount *)createAccount;
 
 - (id)createAccountMock;
 - (void)populateAccountsManagerWithAccountMocks:(NBAccountsManager *)accountsManager;
+- (id)createSearchableAccountMockWithNationSlug:(NSString *)nationSlug
+                                          items:(NSArray *)items
+                                          error:(NSError *)error
+                                          delay:(NSTimeInterval)delay;
 - (void)performAccountPersistenceWithAccountsManager:(NBAccountsManager *)accountsManager;
 
 - (void)assertAccountsManagerDeactivatedAccountAndIsSignedOut;
@@ -117,6 +126,37 @@
     }
 }
 
+- (id)createSearchableAccountMockWithNationSlug:(NSString *)nationSlug
+                                          items:(NSArray *)items
+                                          error:(NSError *)error
+                                          delay:(NSTimeInterval)delay
+{
+    id accountMock = [self createAccountMock];
+    // Signed in, but not necessarily active.
+    [OCMStub([accountMock prepareClientWithSavedCredential]) andReturnValue:@YES];
+    [OCMStub([accountMock nationSlug]) andReturn:nationSlug];
+    id clientMock = OCMClassMock([NBClient class]);
+    [OCMStub([clientMock performRequestsInTaskGroup:OCMOCK_ANY usingBlock:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        dispatch_block_t block;
+        [invocation getArgument:&block atIndex:3];
+        [invocation retainArguments];
+        block();
+    }];
+    [OCMStub([clientMock fetchPeopleByParameters:OCMOCK_ANY withPaginationInfo:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        NBClientResourceListCompletionHandler completionHandler;
+        [invocation getArgument:&completionHandler atIndex:4];
+        [invocation retainArguments];
+        self.numberOfSearches += 1;
+        self.maximumNumberOfSearches = MAX(self.maximumNumberOfSearches, self.numberOfSearches);
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            self.numberOfSearches -= 1;
+            completionHandler(error ? nil : items, nil, error);
+        });
+    }];
+    [OCMStub([accountMock client]) andReturn:clientMock];
+    return accountMock;
+}
+
 - (void)performAccountPersistenceWithAccountsManager:(NBAccountsManager *)accountsManager
 {
     [accountsManager setUpAccountPersistence];
@@ -207,6 +247,7 @@
     // Given: a duplicate account that has the same identifier.
     NBAccount *duplicate = self.accountMock;
     [OCMStub([duplicate identifier]) andReturnValue:@([(NBAccount *)accountsManager.selectedAccount identifier])];
+    [OCMStub([duplicate nationSlug]) andReturn:self.nationSlug];
     // When.
     NSUInteger originalCount = accountsManager.accounts.count;
     [self stubInfoFileBundleResourcePathForOperations:^{
@@ -249,8 +290,11 @@
     // Given: two accounts are active and the last one is selected.
     id accountMock = [self createAccountMock];
     id otherAccountMock = [self createAccountMock];
-    [OCMStub([(NBAccount *)accountMock credentialIdentifier]) andReturn:@"authenticator-tests.nationbuilder.com-someusername-123"];
-    [OCMStub([(NBAccount *)otherAccountMock credentialIdentifier]) andReturn:@"authenticator-tests.nationbuilder.com-someusername-321"];
+    // Given: the same user identifier, but on different nations.
+    [OCMStub([(NBAccount *)accountMock identifier]) andReturnValue:@123];
+    [OCMStub([(NBAccount *)otherAccountMock identifier]) andReturnValue:@123];
+    [OCMStub([(NBAccount *)accountMock nationSlug]) andReturn:self.nationSlug];
+    [OCMStub([(NBAccount *)otherAccountMock nationSlug]) andReturn:@"othernation"];
     [self stubInfoFileBundleResourcePathForOperations:^{
         [OCMStub([accountsManager createAccountWithNationSlug:self.nationSlug]) andReturn:accountMock];
         [accountsManager addAccountWithNationSlug:self.nationSlug error:nil];
@@ -350,4 +394,91 @@
                    @"Manager should have no accounts.");
 }
 
+- (void)testSearchingAllAccounts
+{
+    [self setUpAsync];
+    // Given: nations that respond at different speeds.
+    NBAccountsManager *accountsManager = self.accountsManager;
+    [accountsManager.mutableAccounts addObjectsFromArray:
+     @[ [self createSearchableAccountMockWithNationSlug:@"nation-a" items:@[ @{ @"id": @3 }, @{ @"id": @1 } ] error:nil delay:0.3f],
+        [self createSearchableAccountMockWithNationSlug:@"nation-b" items:@[ @{ @"id": @2 } ] error:nil delay:0.1f],
+        [self createSearchableAccountMockWithNationSlug:@"nation-c" items:@[ @{ @"id": @4 } ] error:nil delay:0.4f] ]];
+    NSMutableArray *resultNationSlugs = [NSMutableArray array];
+    // When:
+    [accountsManager
+     searchPeopleInAllAccountsByParameters:@{ @"first_name": @"Foo" } withPaginationInfo:nil
+     maximumNumberOfConcurrentSearches:2
+     mergeComparator:^NSComparisonResult(NSDictionary *item, NSDictionary *otherItem) {
+         return [item[@"id"] compare:otherItem[@"id"]];
+     }
+     resultsHandler:^(NBAccount *account, NSArray *items, NBPaginationInfo *paginationInfo, NSArray *mergedItems, NSError *error) {
+         XCTAssertNil(error);
+         [resultNationSlugs addObject:account.nationSlug];
+         XCTAssertEqualObjects([items valueForKey:NBAccountsManagerSearchNationSlugKey][0], account.nationSlug,
+                               @"Results should be labeled with their nation.");
+         NSArray *identifiers = [mergedItems valueForKey:@"id"];
+         XCTAssertEqualObjects(identifiers, [identifiers sortedArrayUsingSelector:@selector(compare:)],
+                               @"Results so far should stay sorted.");
+     }
+     completionHandler:^(NSArray *mergedItems, NSError *error) {
+         // Then:
+         XCTAssertNil(error);
+         XCTAssertEqualObjects([mergedItems valueForKey:@"id"], (@[ @1, @2, @3, @4 ]));
+         XCTAssertEqualObjects(resultNationSlugs, (@[ @"nation-b", @"nation-a", @"nation-c" ]),
+                               @"Results should stream in as each nation responds.");
+         XCTAssertEqual(self.maximumNumberOfSearches, 2);
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+- (void)testSearchingOnlySignedInAccounts
+{
+    [self setUpAsync];
+    // Given: a restored account, and one without a saved credential.
+    NBAccountsManager *accountsManager = self.accountsManager;
+    id restoredAccountMock = [self createSearchableAccountMockWithNationSlug:@"nation-a" items:@[ @{ @"id": @1 } ] error:nil delay:0.1f];
+    id signedOutAccountMock = [self createAccountMock];
+    [OCMStub([signedOutAccountMock prepareClientWithSavedCredential]) andReturnValue:@NO];
+    [accountsManager.mutableAccounts addObjectsFromArray:@[ restoredAccountMock, signedOutAccountMock ]];
+    // When:
+    [accountsManager
+     searchPeopleInAllAccountsByParameters:@{ @"first_name": @"Foo" } withPaginationInfo:nil
+     maximumNumberOfConcurrentSearches:NBAccountsManagerSearchDefaultMaximumNumberOfConcurrentSearches
+     mergeComparator:nil resultsHandler:nil
+     completionHandler:^(NSArray *mergedItems, NSError *error) {
+         // Then:
+         XCTAssertNil(error);
+         XCTAssertEqualObjects([mergedItems valueForKey:NBAccountsManagerSearchNationSlugKey], @[ @"nation-a" ],
+                               @"Inactive accounts should be searched once given their credential.");
+         OCMVerify([restoredAccountMock prepareClientWithSavedCredential]);
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+- (void)testSearchingAllAccountsWithFailure
+{
+    [self setUpAsync];
+    // Given:
+    NSError *accountError = [NSError errorWithDomain:NBErrorDomain code:NBClientErrorCodeService userInfo:nil];
+    NBAccountsManager *accountsManager = self.accountsManager;
+    [accountsManager.mutableAccounts addObjectsFromArray:
+     @[ [self createSearchableAccountMockWithNationSlug:@"nation-a" items:@[ @{ @"id": @1 } ] error:nil delay:0.1f],
+        [self createSearchableAccountMockWithNationSlug:@"nation-b" items:nil error:accountError delay:0.1f] ]];
+    // When:
+    [accountsManager
+     searchPeopleInAllAccountsByParameters:@{ @"first_name": @"Foo" } withPaginationInfo:nil
+     maximumNumberOfConcurrentSearches:NBAccountsManagerSearchDefaultMaximumNumberOfConcurrentSearches
+     mergeComparator:nil resultsHandler:nil
+     completionHandler:^(NSArray *mergedItems, NSError *error) {
+         // Then: other nations' results should still arrive.
+         XCTAssertEqual(error.code, NBClientErrorCodePartialResults);
+         XCTAssertEqualObjects(error.userInfo[NBClientErrorPartErrorsKey], @{ @"nation-b": accountError });
+         XCTAssertEqualObjects(mergedItems, (@[ @{ @"id": @1, NBAccountsManagerSearchNationSlugKey: @"nation-a" } ]));
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
 @end
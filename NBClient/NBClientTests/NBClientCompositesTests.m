@@ -0,0 +1,194 @@
+//
+//  NBClientCompositesTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+Composites.h"
+#import "NBClientCompositePipeline.h"
+#import "NBClientTaskGroup.h"
+#import "NBPaginationInfo.h"
+
+@interface NBClientCompositesTests : NBTestCase
+
+@end
+
+@implementation NBClientCompositesTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+}
+
+#pragma mark - Tests
+
+- (void)testFetchPersonProfile
+{
+    [self setUpAsync];
+    if (self.shouldUseHTTPStubbing) {
+        NSDictionary *pathVariables = @{ @"id": @(self.supporterIdentifier) };
+        for (NSString *pathFormat in @[ @"people/:id", @"people/:id/taggings", @"people/:id/capitals", @"people/:id/contacts" ]) {
+            [self stubRequestUsingFileDataWithMethod:@"GET" pathFormat:pathFormat pathVariables:pathVariables queryParameters:nil];
+        }
+    }
+    NSMutableSet *finishedPartKeys = [NSMutableSet set];
+    [self.client
+     fetchPersonProfileByIdentifier:self.supporterIdentifier
+     partTimeout:NBClientCompositeDefaultPartTimeout
+     partHandler:^(NSString *partKey, id result, NSError *error) {
+         [finishedPartKeys addObject:partKey];
+     }
+     completionHandler:^(NSDictionary *results, NSError *error) {
+         [self assertServiceError:error];
+         NSArray *partKeys = @[ NBClientPersonProfilePersonKey, NBClientPersonProfileTaggingsKey,
+                                NBClientPersonProfileCapitalsKey, NBClientPersonProfileContactsKey ];
+         XCTAssertEqualObjects(finishedPartKeys, [NSSet setWithArray:partKeys],
+                               @"Each part should be delivered progressively.");
+         for (NSString *partKey in partKeys) {
+             XCTAssertNotNil(results[partKey],
+                             @"Profile should include %@.", partKey);
+         }
+         NSTimeInterval latency = [results[NBClientCompositeLatencyKey] doubleValue];
+         for (NSNumber *partLatency in [results[NBClientCompositePartLatenciesKey] allValues]) {
+             XCTAssertLessThanOrEqual(partLatency.doubleValue, latency,
+                                      @"Latency should be that of the slowest part.");
+         }
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+- (void)testFetchPersonProfilePartTimeout
+{
+    [self setUpAsync];
+    // Given: a part timeout too short for any response.
+    [self.client
+     fetchPersonProfileByIdentifier:self.supporterIdentifier
+     partTimeout:0.0001f
+     partHandler:nil
+     completionHandler:^(NSDictionary *results, NSError *error) {
+         // Then: all parts should fail as timed out, with metrics still reported.
+         XCTAssertEqual(error.code, NBClientErrorCodePartialResults,
+                        @"Composite should report partial results.");
+         for (NSError *partError in [error.userInfo[NBClientErrorPartErrorsKey] allValues]) {
+             XCTAssertEqual(partError.code, NSURLErrorTimedOut,
+                            @"Part should have timed out.");
+         }
+         XCTAssertNotNil(results[NBClientCompositeLatencyKey],
+                         @"Composite should report latency.");
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+- (void)testPersonWriteCompositePipeline
+{
+    if (!self.shouldUseHTTPStubbing) { return NBLog(@"SKIPPING"); }
+    [self setUpAsync];
+    NSUInteger identifier = 715; // From fixture.
+    [self stubRequestUsingFileDataWithMethod:@"POST" path:@"people" queryParameters:nil];
+    [self stubRequestUsingFileDataWithMethod:@"POST" pathFormat:@"people/:id/notes" pathVariables:@{ @"id": @(identifier) } queryParameters:nil];
+    // Given: a pipeline running one composite at a time.
+    NBClientCompositePipeline *pipeline = [[NBClientCompositePipeline alloc] initWithClient:self.client];
+    pipeline.maximumNumberOfRunningComposites = 1;
+    NSDictionary *compositeInfo = @{ NBClientPersonCompositePersonKey: @{ @"first_name": @"Foo", @"last_name": @"Bar" },
+                                     NBClientPersonCompositeNoteInfoKey: @{ NBClientNoteUserContentKey: @"Walk-in." } };
+    // When: adding two person composites.
+    for (NSUInteger i = 0; i < 2; i++) {
+        [pipeline addPersonWithCompositeInfo:compositeInfo completionHandler:^(NSDictionary *results, NSError *error) {
+            [self assertServiceError:error];
+            XCTAssertNotNil(results[NBClientPersonCompositePersonKey],
+                            @"Results should include created person.");
+            XCTAssertNotNil(results[@"note"],
+                            @"Results should include decorations.");
+        }];
+    }
+    XCTAssertEqual(pipeline.numberOfRunningComposites, 1,
+                   @"Pipeline should bound running composites.");
+    XCTAssertEqual(pipeline.numberOfPendingComposites, 1,
+                   @"Pipeline should queue remaining composites.");
+    // Then: both should finish, with throughput reported.
+    pipeline.progressHandler = ^(NBClientCompositePipeline *pipeline) {
+        if (pipeline.numberOfSucceededComposites < 2) {
+            return;
+        }
+        XCTAssertGreaterThan(pipeline.throughput, 0.0f,
+                             @"Pipeline should report throughput.");
+        [self completeAsync];
+    };
+    [self tearDownAsync];
+}
+
+- (void)testPersonWriteCompositePipelineWithoutClient
+{
+    [self setUpAsync];
+    // Given: a pipeline whose client has gone away.
+    NBClientCompositePipeline *pipeline;
+    @autoreleasepool {
+        NBClient *client = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                               customURLSession:nil customURLSessionConfiguration:nil];
+        pipeline = [[NBClientCompositePipeline alloc] initWithClient:client];
+    }
+    // When:
+    NSDictionary *compositeInfo = @{ NBClientPersonCompositePersonKey: @{ @"first_name": @"Foo", @"last_name": @"Bar" } };
+    [pipeline addPersonWithCompositeInfo:compositeInfo completionHandler:^(NSDictionary *results, NSError *error) {
+        // Then:
+        XCTAssertEqual(error.code, NBErrorCodeInvalidArgument,
+                       @"Composite should fail without a client.");
+        XCTAssertEqual(pipeline.numberOfFailedComposites, 1);
+        XCTAssertEqual(pipeline.numberOfRunningComposites, 0);
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testFetchAllLegacyPagesConcurrently
+{
+    [self setUpAsync];
+    // Given: five legacy pages, where later pages respond sooner.
+    NSUInteger numberOfTotalPages = 5;
+    NSUInteger maximumNumberOfConcurrentPages = 2;
+    __block NSUInteger numberOfRunningPages = 0;
+    __block NSUInteger maximumNumberOfRunningPages = 0;
+    NBClientPageFetcher pageFetcher = ^NSURLSessionDataTask *(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler completionHandler) {
+        NSUInteger pageNumber = paginationInfo.currentPageNumber;
+        numberOfRunningPages += 1;
+        maximumNumberOfRunningPages = MAX(maximumNumberOfRunningPages, numberOfRunningPages);
+        NSTimeInterval delay = 0.01f * (numberOfTotalPages - pageNumber + 1);
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            numberOfRunningPages -= 1;
+            NBPaginationInfo *resultInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+            resultInfo.currentPageNumber = pageNumber;
+            resultInfo.numberOfTotalPages = numberOfTotalPages;
+            resultInfo.numberOfItemsPerPage = 1;
+            completionHandler(@[ @(pageNumber) ], resultInfo, nil);
+        });
+        return nil;
+    };
+    // When: fetching all pages.
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    paginationInfo.numberOfItemsPerPage = 1;
+    [self.client
+     fetchAllPagesWithPaginationInfo:paginationInfo
+     maximumNumberOfConcurrentPages:maximumNumberOfConcurrentPages
+     pageFetcher:pageFetcher
+     completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+         // Then: pages should be fetched together, within the limit, and reassembled in order.
+         XCTAssertNil(error);
+         XCTAssertEqualObjects(items, (@[ @1, @2, @3, @4, @5 ]),
+                               @"Items should be in page order.");
+         XCTAssertEqual(maximumNumberOfRunningPages, maximumNumberOfConcurrentPages,
+                        @"Remaining pages should be fetched concurrently, within the limit.");
+         XCTAssertEqual(paginationInfo.currentPageNumber, numberOfTotalPages,
+                        @"Pagination info should be the last page's.");
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+@end
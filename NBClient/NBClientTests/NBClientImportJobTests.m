@@ -0,0 +1,202 @@
+//
+//  NBClientImportJobTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+Composites.h"
+#import "NBClient+People.h"
+#import "NBClientImportJob.h"
+
+@interface NBClientImportJobTests : NBTestCase
+
+@property (nonatomic) id clientMock;
+@property (nonatomic) NSURL *checkpointDirectoryURL;
+@property (nonatomic) NSMutableArray *createdPeople;
+@property (nonatomic) NSMutableArray *savedPeople;
+@property (nonatomic) NSError *createError; // For the next create.
+@property (nonatomic) NBClientImportJob *resumedImportJob;
+
+- (NBClientImportJob *)importJobWithRows:(NSArray *)rows;
+
+@end
+
+@implementation NBClientImportJobTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.checkpointDirectoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+    self.createdPeople = [NSMutableArray array];
+    self.savedPeople = [NSMutableArray array];
+    // Fake the server, which knows one person.
+    self.clientMock = OCMPartialMock(self.client);
+    [OCMStub([self.clientMock performRequestsInTaskGroup:OCMOCK_ANY usingBlock:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained dispatch_block_t block;
+        [invocation getArgument:&block atIndex:3];
+        block();
+    }];
+    [OCMStub([self.clientMock fetchPersonByParameters:OCMOCK_ANY withCompletionHandler:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained NSDictionary *parameters;
+        __unsafe_unretained NBClientResourceItemCompletionHandler completionHandler;
+        [invocation getArgument:&parameters atIndex:2];
+        [invocation getArgument:&completionHandler atIndex:3];
+        [invocation retainArguments];
+        BOOL isKnown = [parameters[@"email"] isEqualToString:@"known@example.com"];
+        NSError *error = [NSError errorWithDomain:NBErrorDomain code:NBClientErrorCodeService
+                                         userInfo:@{ NBClientErrorCodeKey: @"no_matches" }];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(isKnown ? @{ @"id": @1 } : nil, isKnown ? nil : error);
+        });
+    }];
+    [OCMStub([self.clientMock createPersonWithParameters:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained NSDictionary *parameters;
+        __unsafe_unretained NBClientResourceItemCompletionHandler completionHandler;
+        [invocation getArgument:&parameters atIndex:2];
+        [invocation getArgument:&completionHandler atIndex:3];
+        [invocation retainArguments];
+        NSError *error = self.createError;
+        self.createError = nil;
+        if (!error) {
+            [self.createdPeople addObject:parameters];
+        }
+        NSDictionary *person = @{ @"id": @(100 + self.createdPeople.count) };
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(error ? nil : person, error);
+        });
+    }];
+    [OCMStub([self.clientMock savePersonByIdentifier:1 withParameters:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained NSDictionary *parameters;
+        __unsafe_unretained NBClientResourceItemCompletionHandler completionHandler;
+        [invocation getArgument:&parameters atIndex:3];
+        [invocation getArgument:&completionHandler atIndex:4];
+        [invocation retainArguments];
+        [self.savedPeople addObject:parameters];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(@{ @"id": @1 }, nil);
+        });
+    }];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [self.clientMock stopMocking];
+    [[NSFileManager defaultManager] removeItemAtURL:self.checkpointDirectoryURL error:nil];
+}
+
+#pragma mark - Helpers
+
+- (NBClientImportJob *)importJobWithRows:(NSArray *)rows
+{
+    NBClientImportJob *importJob = [[NBClientImportJob alloc] initWithClient:self.clientMock identifier:@"sign-up-sheet" rows:rows];
+    importJob.checkpointDirectoryURL = self.checkpointDirectoryURL;
+    return importJob;
+}
+
+#pragma mark - Tests
+
+- (void)testNormalizingAndMergingDuplicates
+{
+    XCTAssertEqualObjects([NBClientImportJob normalizedEmail:@" Foo@Example.COM\n"], @"foo@example.com");
+    XCTAssertEqualObjects([NBClientImportJob normalizedPhoneNumber:@"+1 (555) 010-0000"], @"5550100000");
+    XCTAssertNil([NBClientImportJob normalizedPhoneNumber:@"n/a"]);
+    // Given:
+    NSArray *rows = @[ @{ @"email": @" Foo@Example.com ", @"first_name": @"Foo" },
+                       @{ @"phone": @"+1 (555) 010-0000" },
+                       @{ @"email": @"foo@example.com", @"last_name": @"Bar" },
+                       @{ @"first_name": @"Nobody" },
+                       @{ @"mobile": @"555.010.0000", @"email": @"baz@example.com" },
+                       @{ @"email": @"baz@example.com" } ];
+    // When:
+    NBClientImportJob *importJob = [self importJobWithRows:rows];
+    // Then:
+    XCTAssertEqualObjects(importJob.rows[0][@"email"], @"foo@example.com");
+    XCTAssertEqualObjects(importJob.duplicateRowIndexGroups, (@[ @[ @0, @2 ], @[ @1, @4, @5 ] ]),
+                          @"Rows sharing an email, or a phone number with at most one email, should be merged.");
+}
+
+- (void)testNotMergingDifferentEmailsOnOnePhone
+{
+    // Given: a household sharing a phone.
+    NSArray *rows = @[ @{ @"email": @"foo@example.com", @"phone": @"555-010-0000", @"first_name": @"Foo" },
+                       @{ @"phone": @"(555) 010-0000" },
+                       @{ @"email": @"bar@example.com", @"phone": @"5550100000", @"first_name": @"Bar" },
+                       @{ @"email": @"Foo@example.com", @"mobile": @"555 010 0000" } ];
+    // When:
+    NBClientImportJob *importJob = [self importJobWithRows:rows];
+    // Then:
+    XCTAssertEqualObjects(importJob.duplicateRowIndexGroups, (@[ @[ @0, @1, @3 ] ]),
+                          @"Rows with different emails should never be merged, even by phone.");
+}
+
+- (void)testImportingRows
+{
+    [self setUpAsync];
+    // Given:
+    NSArray *rows = @[ @{ @"email": @"new@example.com", @"first_name": @"New" },
+                       @{ @"email": @"Known@example.com", @"first_name": @"Known" },
+                       @{ @"email": @"NEW@example.com", @"last_name": @"Person" },
+                       @{ @"first_name": @"Walk-in" } ];
+    NBClientImportJob *importJob = [self importJobWithRows:rows];
+    NSMutableArray *finishedRowIndexes = [NSMutableArray array];
+    importJob.rowHandler = ^(NSDictionary *rowResult) {
+        [finishedRowIndexes addObject:rowResult[NBClientImportRowIndexKey]];
+    };
+    // When:
+    [importJob startWithCompletionHandler:^(NSArray *rowResults, NSError *error) {
+        // Then:
+        XCTAssertNil(error);
+        XCTAssertEqual(finishedRowIndexes.count, rows.count);
+        NSArray *outcomes = [rowResults valueForKey:NBClientImportOutcomeKey];
+        XCTAssertEqualObjects(outcomes, (@[ @(NBClientImportOutcomeCreated), @(NBClientImportOutcomeUpdated),
+                                            @(NBClientImportOutcomeMerged), @(NBClientImportOutcomeCreated) ]));
+        XCTAssertEqualObjects(rowResults[2][NBClientImportPrimaryRowIndexKey], @0);
+        XCTAssertEqualObjects(rowResults[2][NBClientImportPersonIdentifierKey], rowResults[0][NBClientImportPersonIdentifierKey]);
+        XCTAssertEqual(self.createdPeople.count, 2, @"Duplicates should be created once.");
+        XCTAssertTrue([self.createdPeople containsObject:@{ @"email": @"new@example.com", @"first_name": @"New", @"last_name": @"Person" }],
+                      @"Duplicates should fill in the first row.");
+        XCTAssertEqualObjects(self.savedPeople, (@[ @{ @"email": @"known@example.com", @"first_name": @"Known" } ]));
+        XCTAssertEqual(importJob.numberOfImportedRows, rows.count);
+        XCTAssertGreaterThan(importJob.throughput, 0.0f);
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testResumingFromCheckpoint
+{
+    [self setUpAsync];
+    // Given: a run where the first row fails.
+    NSArray *rows = @[ @{ @"email": @"first@example.com" }, @{ @"email": @"second@example.com" } ];
+    NBClientImportJob *importJob = [self importJobWithRows:rows];
+    importJob.maximumNumberOfConcurrentRows = 1;
+    self.createError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    [importJob startWithCompletionHandler:^(NSArray *rowResults, NSError *error) {
+        XCTAssertEqual(error.code, NBClientErrorCodePartialResults);
+        XCTAssertNotNil(error.userInfo[NBClientErrorPartErrorsKey][@"0"]);
+        XCTAssertEqualObjects(rowResults[0][NBClientImportOutcomeKey], @(NBClientImportOutcomeFailed));
+        XCTAssertEqual(self.createdPeople.count, 1);
+        // Wait for the checkpoint.
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.2f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            // When: a new job for the same rows starts.
+            self.resumedImportJob = [self importJobWithRows:rows];
+            XCTAssertEqual(self.resumedImportJob.numberOfImportedRows, 1);
+            [self.resumedImportJob startWithCompletionHandler:^(NSArray *rowResults, NSError *error) {
+                // Then:
+                XCTAssertNil(error);
+                XCTAssertEqual(self.createdPeople.count, 2, @"Only the failed row should be imported again.");
+                XCTAssertEqualObjects(self.createdPeople.lastObject[@"email"], @"first@example.com");
+                [self completeAsync];
+            }];
+        });
+    }];
+    [self tearDownAsync];
+}
+
+@end
@@ -0,0 +1,197 @@
+//
+//  NBClientMembershipSetTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+Lists.h"
+#import "NBClient+People.h"
+#import "NBClient+Tags.h"
+#import "NBClientMembershipSet.h"
+#import "NBPaginationInfo.h"
+
+@interface NBClientMembershipSetTests : NBTestCase
+
+@property (nonatomic) id clientMock;
+
+// Pages the given identifiers as people, by twos.
+- (void)stubPageFetchForSelector:(SEL)selector argument:(id)argument identifiers:(NSArray *)identifiers;
+- (NSArray *)identifiersInIndexSet:(NSIndexSet *)indexSet;
+
+@end
+
+@implementation NBClientMembershipSetTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [self.clientMock stopMocking];
+}
+
+#pragma mark - Helpers
+
+- (void)stubPageFetchForSelector:(SEL)selector argument:(id)argument identifiers:(NSArray *)identifiers
+{
+    void (^pageHandler)(NSInvocation *) = ^(NSInvocation *invocation) {
+        __unsafe_unretained NBPaginationInfo *paginationInfo;
+        __unsafe_unretained NBClientResourceListCompletionHandler completionHandler;
+        [invocation getArgument:&paginationInfo atIndex:3];
+        [invocation getArgument:&completionHandler atIndex:4];
+        [invocation retainArguments];
+        NSUInteger offset = paginationInfo.nextPageURLString ? paginationInfo.nextPageURLString.lastPathComponent.integerValue : 0;
+        NSRange range = NSMakeRange(offset, MIN((NSUInteger)2, identifiers.count - offset));
+        NBPaginationInfo *nextPaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+        if (NSMaxRange(range) < identifiers.count) {
+            nextPaginationInfo.nextPageURLString = [NSString stringWithFormat:@"/api/v1/people/%lu", (unsigned long)NSMaxRange(range)];
+        }
+        NSMutableArray *items = [NSMutableArray array];
+        for (NSNumber *identifier in [identifiers subarrayWithRange:range]) {
+            [items addObject:@{ @"id": identifier, @"full_name": @"Foo Bar" }];
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(items, nextPaginationInfo, nil);
+        });
+    };
+    if (selector == @selector(fetchListPeopleByIdentifier:withPaginationInfo:completionHandler:)) {
+        [OCMStub([self.clientMock fetchListPeopleByIdentifier:[argument unsignedIntegerValue] withPaginationInfo:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:pageHandler];
+    } else {
+        [OCMStub([self.clientMock fetchTagPeopleByName:argument withPaginationInfo:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:pageHandler];
+    }
+}
+
+- (NSArray *)identifiersInIndexSet:(NSIndexSet *)indexSet
+{
+    NSMutableArray *identifiers = [NSMutableArray array];
+    [indexSet enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        [identifiers addObject:@(index)];
+    }];
+    return identifiers;
+}
+
+#pragma mark - Tests
+
+- (void)testSetAlgebra
+{
+    // Given: a dense range, which needs a bitmap, and sparse identifiers across containers.
+    NSMutableIndexSet *indexSet = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(1, 10000)];
+    [indexSet addIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(70000, 10)]];
+    [indexSet addIndex:4000000000];
+    NSMutableIndexSet *otherIndexSet = [NSMutableIndexSet indexSet];
+    for (NSUInteger index = 0; index < 200000; index += 7) {
+        [otherIndexSet addIndex:index];
+    }
+    NBClientMembershipSet *set = [[NBClientMembershipSet alloc] initWithIdentifiers:[self identifiersInIndexSet:indexSet]];
+    NBClientMembershipSet *otherSet = [[NBClientMembershipSet alloc] initWithIdentifiers:[self identifiersInIndexSet:otherIndexSet]];
+    XCTAssertEqual(set.count, indexSet.count);
+    XCTAssertTrue([set containsIdentifier:4000000000]);
+    XCTAssertFalse([set containsIdentifier:0]);
+    // When:
+    NBClientMembershipSet *intersection = [set setByIntersectingSet:otherSet];
+    NBClientMembershipSet *union_ = [set setByUnitingSet:otherSet];
+    NBClientMembershipSet *difference = [set setBySubtractingSet:otherSet];
+    // Then:
+    NSMutableIndexSet *expectedIntersection = [NSMutableIndexSet indexSet];
+    [indexSet enumerateIndexesUsingBlock:^(NSUInteger index, BOOL *stop) {
+        if ([otherIndexSet containsIndex:index]) {
+            [expectedIntersection addIndex:index];
+        }
+    }];
+    NSMutableIndexSet *expectedUnion = [indexSet mutableCopy];
+    [expectedUnion addIndexes:otherIndexSet];
+    NSMutableIndexSet *expectedDifference = [indexSet mutableCopy];
+    [expectedDifference removeIndexes:otherIndexSet];
+    XCTAssertEqualObjects([intersection identifiersInRange:NSMakeRange(0, NSUIntegerMax)], [self identifiersInIndexSet:expectedIntersection]);
+    XCTAssertEqualObjects([union_ identifiersInRange:NSMakeRange(0, NSUIntegerMax)], [self identifiersInIndexSet:expectedUnion]);
+    XCTAssertEqualObjects([difference identifiersInRange:NSMakeRange(0, NSUIntegerMax)], [self identifiersInIndexSet:expectedDifference]);
+    XCTAssertEqual(difference.count, expectedDifference.count);
+    XCTAssertEqualObjects([union_ identifiersInRange:NSMakeRange(9998, 4)], (@[ @9998, @9999, @10000, @10003 ]));
+    XCTAssertEqualObjects([set identifiersInRange:NSMakeRange(set.count - 1, 10)], @[ @4000000000 ]);
+    XCTAssertEqualObjects([set identifiersInRange:NSMakeRange(set.count, 10)], @[]);
+    XCTAssertEqualObjects([set copy], set);
+    XCTAssertEqualObjects([[set setBySubtractingSet:difference] setByUnitingSet:difference], set);
+    XCTAssertEqual([set setBySubtractingSet:set].count, 0);
+    XCTAssertLessThan(set.numberOfBytes, indexSet.count * sizeof(uint16_t) + 1024);
+}
+
+- (void)testSetAlgebraPerformance
+{
+    // Given: two overlapping lists of 100k people.
+    NSMutableArray *identifiers = [NSMutableArray array];
+    NSMutableArray *otherIdentifiers = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 100000; index++) {
+        [identifiers addObject:@(index * 3)];
+        [otherIdentifiers addObject:@(index * 2)];
+    }
+    NBClientMembershipSet *set = [[NBClientMembershipSet alloc] initWithIdentifiers:identifiers];
+    NBClientMembershipSet *otherSet = [[NBClientMembershipSet alloc] initWithIdentifiers:otherIdentifiers];
+    NSSet *hashSet = [NSSet setWithArray:identifiers];
+    NSSet *otherHashSet = [NSSet setWithArray:otherIdentifiers];
+    // The expected count, from hash sets.
+    NSMutableSet *intersection = [hashSet mutableCopy];
+    [intersection intersectSet:otherHashSet];
+    NSUInteger hashCount = intersection.count;
+    [intersection minusSet:otherHashSet];
+    hashCount += intersection.count;
+    // When: timed with Xcode's performance baselines, not the wall clock.
+    __block NSUInteger count;
+    [self measureBlock:^{
+        count = [[set setByIntersectingSet:otherSet] setBySubtractingSet:otherSet].count;
+        count += [set setByIntersectingSet:otherSet].count;
+    }];
+    // Then:
+    XCTAssertEqual(count, hashCount);
+    XCTAssertLessThan(set.numberOfBytes, (NSUInteger)(100000 * sizeof(uint32_t)));
+}
+
+- (void)testFetchingListAndTagMembership
+{
+    [self setUpAsync];
+    // Given: people 1-6 on the list, and 2 and 4 tagged; person 5 was deleted since.
+    self.clientMock = OCMPartialMock(self.client);
+    [self stubPageFetchForSelector:@selector(fetchListPeopleByIdentifier:withPaginationInfo:completionHandler:)
+                          argument:@1 identifiers:@[ @1, @2, @3, @4, @5, @6 ]];
+    [self stubPageFetchForSelector:@selector(fetchTagPeopleByName:withPaginationInfo:completionHandler:)
+                          argument:@"volunteer" identifiers:@[ @4, @2 ]];
+    [OCMStub([self.clientMock fetchPersonByIdentifier:0 withCompletionHandler:OCMOCK_ANY]).ignoringNonObjectArgs andDo:^(NSInvocation *invocation) {
+        NSUInteger identifier;
+        __unsafe_unretained NBClientResourceItemCompletionHandler completionHandler;
+        [invocation getArgument:&identifier atIndex:2];
+        [invocation getArgument:&completionHandler atIndex:3];
+        [invocation retainArguments];
+        NSError *error = (identifier != 5 ? nil
+                          : [NSError errorWithDomain:NBErrorDomain code:NBClientErrorCodeService
+                                            userInfo:@{ NBClientErrorHTTPStatusCodeKey: @404 }]);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(error ? nil : @{ @"id": @(identifier) }, error);
+        });
+    }];
+    // When:
+    [self.clientMock fetchListMembershipSetByIdentifier:1 completionHandler:^(NBClientMembershipSet *listSet, NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqual(listSet.count, 6);
+        [self.clientMock fetchTagMembershipSetByName:@"volunteer" completionHandler:^(NBClientMembershipSet *tagSet, NSError *error) {
+            XCTAssertNil(error);
+            NBClientMembershipSet *untaggedSet = [listSet setBySubtractingSet:tagSet];
+            // Then:
+            XCTAssertEqualObjects([untaggedSet identifiersInRange:NSMakeRange(0, 10)], (@[ @1, @3, @5, @6 ]));
+            [self.clientMock fetchPeopleInMembershipSet:untaggedSet range:NSMakeRange(1, 3) completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqualObjects([items valueForKey:@"id"], (@[ @3, @6 ]), @"Deleted people should be skipped.");
+                [self completeAsync];
+            }];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+@end
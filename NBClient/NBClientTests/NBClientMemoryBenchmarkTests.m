@@ -0,0 +1,250 @@
+//
+//  NBClientMemoryBenchmarkTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+#import "NBTestTransport.h"
+
+#import <malloc/malloc.h>
+#import <stdatomic.h>
+
+#import "NBClient_Internal.h"
+#import "NBClientStringInternPool.h"
+
+// The benchmarks take minutes and gigabytes, so they only run when asked to,
+// ie. `NB_RUN_MEMORY_BENCHMARKS=1`.
+static NSString *RunBenchmarksEnvironmentKey = @"NB_RUN_MEMORY_BENCHMARKS";
+// Comma-separated. Defaults to 1000, 10000 and 100000.
+static NSString *RecordCountsEnvironmentKey = @"NB_MEMORY_BENCHMARK_RECORD_COUNTS";
+// Defaults to a file in the temporary directory.
+static NSString *ResultsPathEnvironmentKey = @"NB_MEMORY_BENCHMARK_RESULTS_PATH";
+
+// Baselines per resource and mode, and the margin over them a metric can
+// reach before failing. Modeled baselines only get reported against, until
+// measured ones replace them.
+static NSString *ThresholdsFileName = @"NBClientMemoryBenchmarkThresholds";
+static NSString *BaselinesKey = @"baselines";
+static NSString *MarginKey = @"margin";
+static NSString *MeasuredKey = @"measured";
+// Parse modes. Add new model or streaming modes here, with thresholds.
+static NSString *DictionaryModeName = @"dictionary";
+static NSString *InternedModeName = @"interned";
+
+static atomic_bool IsSampling;
+static atomic_size_t PeakHeapSize;
+
+static size_t HeapSizeInUse(size_t *numberOfBlocksInUse)
+{
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    if (numberOfBlocksInUse) {
+        *numberOfBlocksInUse = statistics.blocks_in_use;
+    }
+    return statistics.size_in_use;
+}
+
+@interface NBClientMemoryBenchmarkTests : NBTestCase
+
+@property (nonatomic) NSDictionary *thresholds;
+@property (nonatomic) NSMutableArray *results;
+
+- (NSArray *)recordCounts;
+- (NSData *)responseDataWithFixtureNamed:(NSString *)fixtureName numberOfRecords:(NSUInteger)numberOfRecords;
+- (NSDictionary *)measureParsingData:(NSData *)data mode:(NSString *)mode numberOfRecords:(NSUInteger)numberOfRecords;
+- (void)benchmarkResource:(NSString *)resource fixtureNamed:(NSString *)fixtureName;
+- (void)startSamplingPeakHeapSize;
+- (size_t)stopSamplingPeakHeapSize;
+
+@end
+
+@implementation NBClientMemoryBenchmarkTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    NSString *path = [[NSBundle bundleForClass:self.class] pathForResource:ThresholdsFileName ofType:@"json"];
+    self.thresholds = [NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path] options:0 error:nil];
+    self.results = [NSMutableArray array];
+}
+
+- (void)tearDown
+{
+    if (self.results.count) {
+        NSString *path = ([NSProcessInfo processInfo].environment[ResultsPathEnvironmentKey] ?:
+                          [NSTemporaryDirectory() stringByAppendingPathComponent:@"memory_benchmark.json"]);
+        // Append to the results of other resources in the same run.
+        NSMutableDictionary *report = [[NSJSONSerialization JSONObjectWithData:[NSData dataWithContentsOfFile:path]
+                                                                       options:NSJSONReadingMutableContainers error:nil] mutableCopy];
+        if (![report[@"results"] isKindOfClass:[NSMutableArray class]]) {
+            report = [NSMutableDictionary dictionaryWithObject:[NSMutableArray array] forKey:@"results"];
+        }
+        [report[@"results"] addObjectsFromArray:self.results];
+        report[@"date"] = @([NSDate date].timeIntervalSince1970);
+        [[NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:nil] writeToFile:path atomically:YES];
+        NBLog(@"Memory benchmark results: %@", path);
+    }
+    [super tearDown];
+}
+
+#pragma mark - Helpers
+
+- (NSArray *)recordCounts
+{
+    NSString *recordCounts = [NSProcessInfo processInfo].environment[RecordCountsEnvironmentKey];
+    if (!recordCounts.length) {
+        return @[ @1000, @10000, @100000 ];
+    }
+    return [[recordCounts componentsSeparatedByString:@","] valueForKey:@"integerValue"];
+}
+
+- (NSData *)responseDataWithFixtureNamed:(NSString *)fixtureName numberOfRecords:(NSUInteger)numberOfRecords
+{
+    // Real record shapes, with unique identifiers and text like real data.
+    NSData *fixtureData = [NBTestTransportResponse responseWithFixtureNamed:fixtureName].data;
+    NSArray *templates = [NSJSONSerialization JSONObjectWithData:fixtureData options:0 error:nil][@"results"];
+    NSMutableArray *records = [NSMutableArray arrayWithCapacity:numberOfRecords];
+    for (NSUInteger index = 0; index < numberOfRecords; index++) {
+        NSMutableDictionary *record = [templates[index % templates.count] mutableCopy];
+        record[@"id"] = @(index + 1);
+        for (NSString *key in record.allKeys) {
+            id value = record[key];
+            if ([value isKindOfClass:[NSString class]] && ([key hasSuffix:@"name"] || [key hasSuffix:@"email"])) {
+                record[key] = [NSString stringWithFormat:@"%@ %lu", value, (unsigned long)index];
+            }
+        }
+        [records addObject:record];
+    }
+    return [NSJSONSerialization dataWithJSONObject:@{ @"results": records, @"next": [NSNull null], @"prev": [NSNull null] }
+                                           options:0 error:nil];
+}
+
+- (NSDictionary *)measureParsingData:(NSData *)data mode:(NSString *)mode numberOfRecords:(NSUInteger)numberOfRecords
+{
+    NSURL *url = [self.client urlComponentsForSubPath:@"/people"].URL;
+    NSURLRequest *request = [NSURLRequest requestWithURL:url];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:200 HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:@{ @"Content-Type": @"application/json" }];
+    self.client.shouldInternStrings = [mode isEqualToString:InternedModeName];
+    self.client.stringInternPool = nil; // A fresh pool counts against retained bytes.
+    __block id results;
+    size_t numberOfBlocksBefore, numberOfBlocksAfter;
+    size_t heapSizeBefore = HeapSizeInUse(&numberOfBlocksBefore);
+    [self startSamplingPeakHeapSize];
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    @autoreleasepool {
+        // The real response path, minus the network.
+        void (^handler)(NSData *, NSURLResponse *, NSError *) =
+        [self.client dataTaskCompletionHandlerForResultsKey:@"results" originalRequest:request
+                                          completionHandler:^(id items, NSDictionary *jsonObject, NSError *error) {
+                                              XCTAssertNil(error);
+                                              results = items;
+                                          }];
+        handler(data, response, nil);
+    }
+    NSTimeInterval duration = CFAbsoluteTimeGetCurrent() - startTime;
+    size_t peakHeapSize = MAX([self stopSamplingPeakHeapSize], HeapSizeInUse(NULL));
+    size_t heapSizeAfter = HeapSizeInUse(&numberOfBlocksAfter);
+    XCTAssertEqual([results count], numberOfRecords);
+    results = nil;
+    NSUInteger savedBytes = self.client.shouldInternStrings ? self.client.stringInternPool.numberOfSavedBytes : 0;
+    double retainedBytes = (double)heapSizeAfter - heapSizeBefore;
+    double peakBytes = (double)peakHeapSize - heapSizeBefore;
+    double numberOfAllocations = (double)numberOfBlocksAfter - numberOfBlocksBefore;
+    return @{ @"mode": mode,
+              @"records": @(numberOfRecords),
+              @"response_bytes": @(data.length),
+              @"duration": @(duration),
+              @"retained_bytes": @(retainedBytes),
+              @"peak_bytes": @(peakBytes),
+              @"live_allocations": @(numberOfAllocations),
+              @"interned_bytes": @(savedBytes),
+              @"bytes_per_record": @(retainedBytes / numberOfRecords),
+              @"peak_bytes_per_record": @(peakBytes / numberOfRecords),
+              @"allocations_per_record": @(numberOfAllocations / numberOfRecords) };
+}
+
+- (void)benchmarkResource:(NSString *)resource fixtureNamed:(NSString *)fixtureName
+{
+    if (![[NSProcessInfo processInfo].environment[RunBenchmarksEnvironmentKey] boolValue]) {
+        return NBLog(@"SKIPPING");
+    }
+    for (NSNumber *recordCount in self.recordCounts) {
+        NSUInteger numberOfRecords = recordCount.unsignedIntegerValue;
+        NSData *data = [self responseDataWithFixtureNamed:fixtureName numberOfRecords:numberOfRecords];
+        for (NSString *mode in @[ DictionaryModeName, InternedModeName ]) {
+            NSMutableDictionary *result = [[self measureParsingData:data mode:mode numberOfRecords:numberOfRecords] mutableCopy];
+            result[@"resource"] = resource;
+            NSDictionary *baselines = self.thresholds[BaselinesKey][resource][mode];
+            XCTAssertNotNil(baselines, @"Every resource and mode should have baselines.");
+            double margin = [self.thresholds[MarginKey] doubleValue];
+            NSMutableDictionary *thresholds = [NSMutableDictionary dictionaryWithCapacity:baselines.count];
+            for (NSString *metric in baselines) {
+                thresholds[metric] = @(ceil([baselines[metric] doubleValue] * (1 + margin)));
+            }
+            BOOL isMeasured = [self.thresholds[MeasuredKey] boolValue];
+            BOOL didPass = YES;
+            for (NSString *metric in thresholds) {
+                if ([result[metric] doubleValue] <= [thresholds[metric] doubleValue]) {
+                    continue;
+                }
+                didPass = NO;
+                NSString *message = [NSString stringWithFormat:@"%@ (%@, %lu records) regressed: %@ is %.0f, over %@",
+                                     resource, mode, (unsigned long)numberOfRecords, metric, [result[metric] doubleValue], thresholds[metric]];
+                if (isMeasured) {
+                    XCTFail(@"%@", message);
+                } else {
+                    NBLog(@"%@ (baselines not measured yet)", message);
+                }
+            }
+            result[@"baselines"] = baselines ?: @{};
+            result[@"measured"] = @(isMeasured);
+            result[@"thresholds"] = thresholds;
+            result[@"passed"] = @(didPass);
+            [self.results addObject:result];
+        }
+    }
+}
+
+- (void)startSamplingPeakHeapSize
+{
+    atomic_store(&PeakHeapSize, HeapSizeInUse(NULL));
+    atomic_store(&IsSampling, true);
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0), ^{
+        while (atomic_load(&IsSampling)) {
+            size_t heapSize = HeapSizeInUse(NULL);
+            if (heapSize > atomic_load(&PeakHeapSize)) {
+                atomic_store(&PeakHeapSize, heapSize);
+            }
+            usleep(500);
+        }
+    });
+}
+
+- (size_t)stopSamplingPeakHeapSize
+{
+    atomic_store(&IsSampling, false);
+    return atomic_load(&PeakHeapSize);
+}
+
+#pragma mark - Tests
+
+- (void)testPeopleMemoryFootprint
+{
+    [self benchmarkResource:@"people" fixtureNamed:@"people_get"];
+}
+
+- (void)testDonationsMemoryFootprint
+{
+    [self benchmarkResource:@"donations" fixtureNamed:@"donations_get"];
+}
+
+- (void)testListPeopleMemoryFootprint
+{
+    [self benchmarkResource:@"list_people" fixtureNamed:@"lists_id_people_get"];
+}
+
+@end
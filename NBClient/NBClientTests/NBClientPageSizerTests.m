@@ -0,0 +1,147 @@
+//
+//  NBClientPageSizerTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClientPageSizer.h"
+#import "NBPaginationInfo.h"
+
+static NSString *Path = @"/api/v1/people";
+static NSUInteger NumberOfBytesPerItem = 600;
+
+@interface NBClientPageSizerTests : NBTestCase
+
+@property (nonatomic) NBClientPageSizer *pageSizer;
+
+// Returns the time to the first item and the total time of syncing a list
+// over a link with the given round trip time and transfer rate.
+- (NSDictionary *)simulateSyncOfNumberOfItems:(NSUInteger)numberOfItems
+                                roundTripTime:(NSTimeInterval)roundTripTime
+                               bytesPerSecond:(double)bytesPerSecond
+                         numberOfItemsPerPage:(NSUInteger)numberOfItemsPerPage;
+
+@end
+
+@implementation NBClientPageSizerTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.pageSizer = [[NBClientPageSizer alloc] init];
+}
+
+#pragma mark - Helpers
+
+- (NSDictionary *)simulateSyncOfNumberOfItems:(NSUInteger)numberOfItems
+                                roundTripTime:(NSTimeInterval)roundTripTime
+                               bytesPerSecond:(double)bytesPerSecond
+                         numberOfItemsPerPage:(NSUInteger)numberOfItemsPerPage
+{
+    // Adaptive if the number of items per page is 0.
+    BOOL isAdaptive = !numberOfItemsPerPage;
+    NSUInteger pageSize = isAdaptive ? [self.pageSizer numberOfItemsForFirstPageForPath:Path] : numberOfItemsPerPage;
+    NSUInteger remainingNumberOfItems = numberOfItems;
+    NSTimeInterval firstItemDuration = 0;
+    NSTimeInterval totalDuration = 0;
+    NSUInteger numberOfPages = 0;
+    while (remainingNumberOfItems) {
+        NSUInteger pageNumberOfItems = MIN(pageSize, remainingNumberOfItems);
+        NSUInteger numberOfBytes = pageNumberOfItems * NumberOfBytesPerItem;
+        NSTimeInterval duration = roundTripTime + numberOfBytes / bytesPerSecond;
+        totalDuration += duration;
+        if (!numberOfPages) {
+            firstItemDuration = duration;
+        }
+        numberOfPages += 1;
+        remainingNumberOfItems -= pageNumberOfItems;
+        if (isAdaptive) {
+            [self.pageSizer recordPageForPath:Path numberOfItems:pageNumberOfItems numberOfBytes:numberOfBytes duration:duration];
+            pageSize = [self.pageSizer numberOfItemsForPageForPath:Path afterPageWithNumberOfItems:pageSize];
+        }
+    }
+    return @{ @"time_to_first_item": @(firstItemDuration), @"total_time": @(totalDuration), @"pages": @(numberOfPages) };
+}
+
+#pragma mark - Tests
+
+- (void)testEstimatingLinkFromPages
+{
+    // Given: a 0.3s round trip at 50 KB/s.
+    for (NSNumber *numberOfItems in @[ @10, @20, @40 ]) {
+        NSUInteger numberOfBytes = numberOfItems.unsignedIntegerValue * NumberOfBytesPerItem;
+        [self.pageSizer recordPageForPath:Path numberOfItems:numberOfItems.unsignedIntegerValue
+                            numberOfBytes:numberOfBytes duration:0.3 + numberOfBytes / 50000.0];
+    }
+    // When:
+    NSDictionary *estimates = [self.pageSizer estimatesForPath:Path];
+    // Then:
+    XCTAssertEqualWithAccuracy([estimates[NBClientPageSizerRoundTripTimeKey] doubleValue], 0.3, 0.001);
+    XCTAssertEqualWithAccuracy([estimates[NBClientPageSizerBytesPerSecondKey] doubleValue], 50000.0, 1.0);
+    XCTAssertEqualWithAccuracy([estimates[NBClientPageSizerBytesPerItemKey] doubleValue], NumberOfBytesPerItem, 0.001);
+    XCTAssertNil([self.pageSizer estimatesForPath:@"/api/v1/lists"], @"Endpoints should be estimated separately.");
+    // First page: (0.5s - 0.3s) * 50 KB/s / 600 B.
+    XCTAssertEqual([self.pageSizer numberOfItemsForFirstPageForPath:Path], 16);
+    XCTAssertEqual([self.pageSizer numberOfItemsForPageForPath:Path afterPageWithNumberOfItems:16], 32);
+    XCTAssertEqual([self.pageSizer numberOfItemsForPageForPath:Path afterPageWithNumberOfItems:64], 100,
+                   @"Later pages should grow up to the maximum.");
+}
+
+- (void)testResizingTokenPages
+{
+    // Given:
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+    [self.pageSizer updatePaginationInfo:paginationInfo forPath:Path];
+    XCTAssertEqual(paginationInfo.numberOfItemsPerPage, 10, @"First pages without estimates should start small.");
+    paginationInfo.nextPageURLString = @"/api/v1/people?__nonce=nonce&__token=token&limit=10";
+    // When:
+    [self.pageSizer updatePaginationInfo:paginationInfo forPath:Path];
+    // Then:
+    XCTAssertEqual(paginationInfo.numberOfItemsPerPage, 20);
+    XCTAssertEqualObjects(paginationInfo.queryParameters[NBClientPaginationLimitKey], @20,
+                          @"Next links should be requested with the new size.");
+    // Given: legacy pages, which can't change size.
+    NBPaginationInfo *legacyPaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    legacyPaginationInfo.currentPageNumber = 2;
+    legacyPaginationInfo.numberOfItemsPerPage = 25;
+    // When:
+    [self.pageSizer updatePaginationInfo:legacyPaginationInfo forPath:Path];
+    // Then:
+    XCTAssertEqual(legacyPaginationInfo.numberOfItemsPerPage, 25);
+}
+
+- (void)testComparingPolicies
+{
+    NSUInteger numberOfItems = 500;
+    NSDictionary *links = @{ @"high_latency": @[ @0.6, @200000.0 ],
+                             @"low_bandwidth": @[ @0.1, @20000.0 ],
+                             @"fast": @[ @0.05, @2000000.0 ] };
+    NSMutableDictionary *report = [NSMutableDictionary dictionary];
+    for (NSString *linkName in links) {
+        NSTimeInterval roundTripTime = [links[linkName][0] doubleValue];
+        double bytesPerSecond = [links[linkName][1] doubleValue];
+        [self.pageSizer removeAllSamples];
+        NSDictionary *results =
+        @{ @"fixed_10": [self simulateSyncOfNumberOfItems:numberOfItems roundTripTime:roundTripTime bytesPerSecond:bytesPerSecond numberOfItemsPerPage:10],
+           @"fixed_100": [self simulateSyncOfNumberOfItems:numberOfItems roundTripTime:roundTripTime bytesPerSecond:bytesPerSecond numberOfItemsPerPage:100],
+           @"adaptive_cold": [self simulateSyncOfNumberOfItems:numberOfItems roundTripTime:roundTripTime bytesPerSecond:bytesPerSecond numberOfItemsPerPage:0],
+           @"adaptive_warm": [self simulateSyncOfNumberOfItems:numberOfItems roundTripTime:roundTripTime bytesPerSecond:bytesPerSecond numberOfItemsPerPage:0] };
+        report[linkName] = results;
+        // Then: about as fast as the largest pages overall,
+        XCTAssertLessThan([results[@"adaptive_warm"][@"total_time"] doubleValue],
+                          [results[@"fixed_100"][@"total_time"] doubleValue] * 1.5, @"%@", linkName);
+        // and about as fast as the smallest pages to the first item.
+        XCTAssertLessThanOrEqual([results[@"adaptive_warm"][@"time_to_first_item"] doubleValue],
+                                 MAX([results[@"fixed_10"][@"time_to_first_item"] doubleValue],
+                                     self.pageSizer.firstPageTargetDuration) + 0.001, @"%@", linkName);
+    }
+    XCTAssertLessThan([report[@"high_latency"][@"adaptive_cold"][@"total_time"] doubleValue],
+                      [report[@"high_latency"][@"fixed_10"][@"total_time"] doubleValue] / 4);
+    XCTAssertLessThan([report[@"low_bandwidth"][@"adaptive_warm"][@"time_to_first_item"] doubleValue],
+                      [report[@"low_bandwidth"][@"fixed_100"][@"time_to_first_item"] doubleValue] / 4);
+}
+
+@end
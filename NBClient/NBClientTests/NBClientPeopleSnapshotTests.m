@@ -0,0 +1,137 @@
+//
+//  NBClientPeopleSnapshotTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+#import "NBTestTransport.h"
+
+#import "NBClientPeopleSnapshot.h"
+
+@interface NBClientPeopleSnapshotTests : NBTestCase
+
+@property (nonatomic) NSURL *fileURL;
+
+// A people list response of the given size, with unique identifiers and names.
+- (NSData *)responseDataWithNumberOfPeople:(NSUInteger)numberOfPeople;
+
+@end
+
+@implementation NBClientPeopleSnapshotTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:
+                                           [[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"snapshot"]]];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+}
+
+#pragma mark - Helpers
+
+- (NSData *)responseDataWithNumberOfPeople:(NSUInteger)numberOfPeople
+{
+    NSData *fixtureData = [NBTestTransportResponse responseWithFixtureNamed:@"people_get"].data;
+    NSDictionary *response = [NSJSONSerialization JSONObjectWithData:fixtureData options:0 error:nil];
+    NSArray *templates = response[@"results"];
+    NSMutableArray *people = [NSMutableArray arrayWithCapacity:numberOfPeople];
+    for (NSUInteger index = 0; index < numberOfPeople; index++) {
+        NSMutableDictionary *person = [templates[index % templates.count] mutableCopy];
+        person[@"id"] = @(index + 1);
+        person[@"first_name"] = [NSString stringWithFormat:@"%@ %lu", person[@"first_name"], (unsigned long)index];
+        [people addObject:person];
+    }
+    return [NSJSONSerialization dataWithJSONObject:@{ @"results": people, @"next": response[@"next"] } options:0 error:nil];
+}
+
+#pragma mark - Tests
+
+- (void)testWritingAndReadingPeople
+{
+    // Given:
+    NSArray *people = [NSJSONSerialization JSONObjectWithData:[self responseDataWithNumberOfPeople:5] options:0 error:nil][@"results"];
+    NSDictionary *cursor = @{ NBClientPeopleSnapshotPaginationInfoKey: @{ @"limit": @5, @"next": @"/api/v1/people?__token=token" },
+                              NBClientPeopleSnapshotLegacyKey: @NO };
+    NSArray *keys = [NBClientPeopleSnapshot defaultKeys];
+    NSError *error;
+    // When:
+    XCTAssertTrue([NBClientPeopleSnapshot writeItems:people keys:keys cursor:cursor toURL:self.fileURL error:&error]);
+    NBClientPeopleSnapshot *snapshot = [[NBClientPeopleSnapshot alloc] initWithContentsOfURL:self.fileURL error:&error];
+    // Then:
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(snapshot.keys, keys);
+    XCTAssertEqualObjects(snapshot.cursor, cursor);
+    XCTAssertEqual(snapshot.numberOfItems, people.count);
+    [snapshot.items enumerateObjectsUsingBlock:^(NSDictionary *item, NSUInteger index, BOOL *stop) {
+        NSDictionary *person = people[index];
+        XCTAssertEqualObjects(item[@"id"], person[@"id"]);
+        for (NSString *key in keys) {
+            id value = [person[key] isKindOfClass:[NSNull class]] ? nil : person[key];
+            XCTAssertEqualObjects(item[key], value, @"%@", key);
+        }
+    }];
+    XCTAssertEqualObjects([snapshot itemAtIndex:3][@"tags"], people[3][@"tags"], @"Lists of strings should be kept.");
+}
+
+- (void)testRejectingInvalidSnapshots
+{
+    // Given:
+    NSData *data = [NBClientPeopleSnapshot dataWithItems:@[ @{ @"id": @1, @"first_name": @"Foo" } ]
+                                                    keys:[NBClientPeopleSnapshot defaultKeys] cursor:nil error:nil];
+    NSMutableData *otherVersionData = data.mutableCopy;
+    uint32_t otherVersion = CFSwapInt32HostToLittle((uint32_t)NBClientPeopleSnapshotVersion + 1);
+    [otherVersionData replaceBytesInRange:NSMakeRange(sizeof(uint32_t), sizeof(uint32_t)) withBytes:&otherVersion];
+    NSArray *invalidData = @[ [data subdataWithRange:NSMakeRange(0, data.length - 8)], otherVersionData, [NSData data] ];
+    for (NSData *data in invalidData) {
+        NSError *error;
+        // When:
+        NBClientPeopleSnapshot *snapshot = [[NBClientPeopleSnapshot alloc] initWithData:data error:&error];
+        // Then:
+        XCTAssertNil(snapshot);
+        XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+    }
+    XCTAssertEqualObjects([[[NBClientPeopleSnapshot alloc] initWithData:data error:nil] itemAtIndex:0][@"first_name"], @"Foo");
+}
+
+- (void)testTimeToFirstFrameFromResponse
+{
+    // Given: two screens of people, as a response.
+    NSUInteger numberOfPeople = 60;
+    NSURL *responseURL = [self.fileURL URLByAppendingPathExtension:@"json"];
+    XCTAssertTrue([[self responseDataWithNumberOfPeople:numberOfPeople] writeToURL:responseURL atomically:YES]);
+    // When: read from disk and decoded into items to render, timed with
+    // Xcode's performance baselines to compare with the snapshot's.
+    __block NSUInteger count;
+    [self measureBlock:^{
+        NSData *data = [NSData dataWithContentsOfURL:responseURL options:0 error:nil];
+        count = [[NSJSONSerialization JSONObjectWithData:data options:0 error:nil][@"results"] count];
+    }];
+    // Then:
+    XCTAssertEqual(count, numberOfPeople);
+    [[NSFileManager defaultManager] removeItemAtURL:responseURL error:nil];
+}
+
+- (void)testTimeToFirstFrameFromSnapshot
+{
+    // Given: the same people, as a snapshot.
+    NSUInteger numberOfPeople = 60;
+    NSData *responseData = [self responseDataWithNumberOfPeople:numberOfPeople];
+    NSArray *people = [NSJSONSerialization JSONObjectWithData:responseData options:0 error:nil][@"results"];
+    XCTAssertTrue([NBClientPeopleSnapshot writeItems:people keys:[NBClientPeopleSnapshot defaultKeys] cursor:nil toURL:self.fileURL error:nil]);
+    // When: read from disk and decoded into items to render.
+    __block NSUInteger count;
+    [self measureBlock:^{
+        count = [[NBClientPeopleSnapshot alloc] initWithContentsOfURL:self.fileURL error:nil].items.count;
+    }];
+    // Then:
+    XCTAssertEqual(count, numberOfPeople);
+}
+
+@end
@@ -0,0 +1,98 @@
+//
+//  NBClientPersonSaveCoalescerTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClientPersonSaveCoalescer.h"
+
+@interface NBClientPersonSaveCoalescerTests : NBTestCase
+
+@property (nonatomic) NBClientPersonSaveCoalescer *coalescer;
+
+@end
+
+@implementation NBClientPersonSaveCoalescerTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.coalescer = [[NBClientPersonSaveCoalescer alloc] initWithClient:self.client];
+    self.coalescer.coalescingInterval = 0.1f;
+}
+
+#pragma mark - Tests
+
+- (void)testCoalescingSaves
+{
+    if (!self.shouldUseHTTPStubbing) { return NBLog(@"SKIPPING"); }
+    [self setUpAsync];
+    [self stubRequestUsingFileDataWithMethod:@"PUT" pathFormat:@"people/:id" pathVariables:@{ @"id": @(self.userIdentifier) } queryParameters:nil];
+    // Given: quick successive saves of the same person.
+    NSDictionary *person = @{ @"id": @(self.userIdentifier), @"first_name": @"Foo", @"demo": @"W" };
+    __block NSUInteger numberOfCompletedSaves = 0;
+    NBClientResourceItemCompletionHandler completionHandler = ^(NSDictionary *item, NSError *error) {
+        [self assertServiceError:error];
+        XCTAssertNotNil(item,
+                        @"Every caller should get the saved person.");
+        numberOfCompletedSaves += 1;
+        if (numberOfCompletedSaves < 3) {
+            return;
+        }
+        // Then: only one request should be sent.
+        XCTAssertEqual(self.coalescer.numberOfRequestedSaves, 3);
+        XCTAssertEqual(self.coalescer.numberOfSentSaves, 1,
+                       @"Saves within the interval should be coalesced.");
+        [self completeAsync];
+    };
+    // When: saving within the coalescing interval.
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"demo": @"B" }
+                            originalPerson:person completionHandler:completionHandler];
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"first_name": @"Bar" }
+                            originalPerson:person completionHandler:completionHandler];
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"first_name": @"Foo" }
+                            originalPerson:person completionHandler:completionHandler];
+    [self tearDownAsync];
+}
+
+- (void)testSkippingUnchangedSaves
+{
+    [self setUpAsync];
+    // Given: changes that were reverted within the interval.
+    NSDictionary *person = @{ @"id": @(self.userIdentifier), @"demo": @"W" };
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"demo": @"B" }
+                            originalPerson:person completionHandler:nil];
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"demo": @"W" }
+                            originalPerson:person completionHandler:^(NSDictionary *item, NSError *error) {
+        // Then: nothing should be sent.
+        XCTAssertNil(item);
+        XCTAssertNil(error);
+        XCTAssertEqual(self.coalescer.numberOfSentSaves, 0,
+                       @"Saves without real changes should not be sent.");
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testSendingSavesAfterRelease
+{
+    [self setUpAsync];
+    // Given: a pending save.
+    NSDictionary *person = @{ @"id": @(self.userIdentifier), @"demo": @"W" };
+    [self.coalescer savePersonByIdentifier:self.userIdentifier withChanges:@{ @"demo": @"W" }
+                            originalPerson:person completionHandler:^(NSDictionary *item, NSError *error) {
+        // Then:
+        XCTAssertNil(error);
+        [self completeAsync];
+    }];
+    // When: its owner goes away within the interval.
+    self.coalescer = nil;
+    [self tearDownAsync];
+}
+
+@end
@@ -0,0 +1,98 @@
+//
+//  NBClientReferenceDataTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClientReferenceData.h"
+
+@interface NBClientReferenceDataTests : NBTestCase
+
+@property (nonatomic) NBClientReferenceData *referenceData;
+@property (nonatomic) NSArray *contactTypes;
+
+@end
+
+@implementation NBClientReferenceDataTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.referenceData = [[NBClientReferenceData alloc] initWithClient:self.client identifier:[NSUUID UUID].UUIDString];
+    self.referenceData.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:self.referenceData.identifier]];
+    // Fake the server.
+    self.contactTypes = @[ @{ @"id": @1, @"name": @"Canvass" } ];
+    __weak __typeof(self)weakSelf = self;
+    self.referenceData.fetchersByKey = @{ NBClientReferenceDataContactTypesKey: ^(NBClient *client, NBClientResourceCompletionHandler completionHandler) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(weakSelf.contactTypes, nil);
+        });
+    } };
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [[NSFileManager defaultManager] removeItemAtURL:self.referenceData.fileURL error:nil];
+}
+
+#pragma mark - Tests
+
+- (void)testNotifyingOnlyOfChanges
+{
+    [self setUpAsync];
+    __block NSUInteger numberOfNotifications = 0;
+    id observer = [[NSNotificationCenter defaultCenter]
+                   addObserverForName:NBClientReferenceDataDidChangeNotification object:self.referenceData queue:nil
+                   usingBlock:^(NSNotification *note) {
+                       numberOfNotifications += 1;
+                       XCTAssertEqualObjects(note.userInfo[NBClientReferenceDataChangedKeysKey], @[ NBClientReferenceDataContactTypesKey ]);
+                   }];
+    // When: refreshing twice with the same data, then with different data.
+    [self.referenceData refreshWithCompletionHandler:^(NSError *error) {
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(self.referenceData.contactTypes, self.contactTypes);
+        [self.referenceData refreshWithCompletionHandler:^(NSError *error) {
+            XCTAssertEqual(numberOfNotifications, 1,
+                           @"Unchanged data should not be notified.");
+            self.contactTypes = @[ @{ @"id": @1, @"name": @"Door knock" } ];
+            [self.referenceData refreshWithCompletionHandler:^(NSError *error) {
+                // Then:
+                XCTAssertEqual(numberOfNotifications, 2,
+                               @"Changed data should be notified.");
+                XCTAssertEqualObjects(self.referenceData.contactTypes, self.contactTypes);
+                [[NSNotificationCenter defaultCenter] removeObserver:observer];
+                [self completeAsync];
+            }];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testLoadingSnapshot
+{
+    [self setUpAsync];
+    // Given: a refreshed snapshot.
+    [self.referenceData refreshWithCompletionHandler:^(NSError *error) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            // When: creating reference data for the same account, ie. at launch.
+            NBClientReferenceData *referenceData = [[NBClientReferenceData alloc] initWithClient:self.client
+                                                                                     identifier:self.referenceData.identifier];
+            referenceData.fileURL = self.referenceData.fileURL;
+            // Then:
+            XCTAssertEqualObjects(referenceData.contactTypes, self.contactTypes,
+                                  @"The snapshot should be available right away.");
+            XCTAssertNotNil(referenceData.snapshotDate);
+            XCTAssertFalse(referenceData.needsRefresh);
+            [self completeAsync];
+        });
+    }];
+    [self tearDownAsync];
+}
+
+@end
@@ -0,0 +1,136 @@
+//
+//  NBClientRefreshSchedulerTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClientRefreshScheduler.h"
+
+@interface NBClientRefreshSchedulerTests : NBTestCase
+
+@property (nonatomic) NBClientRefreshScheduler *scheduler;
+@property (nonatomic) NSMutableArray *refreshedKeys;
+
+- (void)setFakeRefresherForCollectionKey:(NSString *)collectionKey
+                           numberOfBytes:(NSUInteger)numberOfBytes
+                                   error:(NSError *)error;
+
+@end
+
+@implementation NBClientRefreshSchedulerTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.scheduler = [[NBClientRefreshScheduler alloc] initWithClient:self.client identifier:[NSUUID UUID].UUIDString];
+    self.scheduler.directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:self.scheduler.identifier]];
+    self.refreshedKeys = [NSMutableArray array];
+    // Fake the server.
+    [self setFakeRefresherForCollectionKey:NBClientRefreshPeopleKey numberOfBytes:100 error:nil];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [self.scheduler removeAllData];
+}
+
+#pragma mark - Helpers
+
+- (void)setFakeRefresherForCollectionKey:(NSString *)collectionKey
+                           numberOfBytes:(NSUInteger)numberOfBytes
+                                   error:(NSError *)error
+{
+    __weak __typeof(self)weakSelf = self;
+    [self.scheduler setRefresher:^(NBClientRefreshCompletionHandler completionHandler) {
+        [weakSelf.refreshedKeys addObject:collectionKey];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(numberOfBytes, error);
+        });
+    } forCollectionKey:collectionKey];
+}
+
+#pragma mark - Tests
+
+- (void)testRefreshingMostRecentlyUsedFirst
+{
+    [self setUpAsync];
+    // Given:
+    [self setFakeRefresherForCollectionKey:@"events" numberOfBytes:100 error:nil];
+    [self setFakeRefresherForCollectionKey:@"donations" numberOfBytes:100 error:nil];
+    XCTAssertEqualObjects(self.scheduler.collectionKeys, (@[ NBClientRefreshPeopleKey, @"events", @"donations" ]),
+                          @"Overriding a built-in refresher should not duplicate its key.");
+    [self.scheduler collectionWasUsed:@"donations"];
+    // When:
+    [self.scheduler performRefreshWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        // Then:
+        XCTAssertEqual(result, UIBackgroundFetchResultNewData);
+        XCTAssertEqualObjects(self.refreshedKeys, (@[ @"donations", NBClientRefreshPeopleKey, @"events" ]));
+        XCTAssertEqual(self.scheduler.records.count, 3);
+        XCTAssertNotNil([self.scheduler lastRefreshDateForCollectionKey:@"events"]);
+        // When: refreshing again within the minimum refresh interval.
+        [self.refreshedKeys removeAllObjects];
+        [self.scheduler performRefreshWithCompletionHandler:^(UIBackgroundFetchResult result) {
+            // Then:
+            XCTAssertEqual(result, UIBackgroundFetchResultNoData);
+            XCTAssertEqual(self.refreshedKeys.count, 0, @"Fresh collections should be skipped.");
+            [self completeAsync];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testStayingWithinByteBudget
+{
+    [self setUpAsync];
+    // Given: a previous refresh that found each collection to be 600 bytes.
+    [self setFakeRefresherForCollectionKey:@"events" numberOfBytes:600 error:nil];
+    [self setFakeRefresherForCollectionKey:NBClientRefreshPeopleKey numberOfBytes:600 error:nil];
+    [self.scheduler performRefreshWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        self.scheduler.minimumRefreshInterval = 0;
+        self.scheduler.budget.byteLimit = 1000;
+        [self.refreshedKeys removeAllObjects];
+        // When:
+        [self.scheduler performRefreshWithCompletionHandler:^(UIBackgroundFetchResult result) {
+            // Then:
+            XCTAssertEqual(result, UIBackgroundFetchResultNewData);
+            XCTAssertEqualObjects(self.refreshedKeys, @[ NBClientRefreshPeopleKey ],
+                                  @"Collections expected to go over the budget should be skipped.");
+            [self completeAsync];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testRecordingFailuresAndPersisting
+{
+    [self setUpAsync];
+    // Given:
+    NSError *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    [self setFakeRefresherForCollectionKey:NBClientRefreshPeopleKey numberOfBytes:0 error:error];
+    [self.scheduler collectionWasUsed:NBClientRefreshPeopleKey];
+    // When:
+    [self.scheduler performRefreshWithCompletionHandler:^(UIBackgroundFetchResult result) {
+        // Then:
+        XCTAssertEqual(result, UIBackgroundFetchResultFailed);
+        NSDictionary *record = self.scheduler.records.lastObject;
+        XCTAssertEqualObjects(record[NBClientRefreshRecordCollectionKey], NBClientRefreshPeopleKey);
+        XCTAssertNotNil(record[NBClientRefreshRecordErrorKey]);
+        XCTAssertNil([self.scheduler lastRefreshDateForCollectionKey:NBClientRefreshPeopleKey],
+                     @"Failed refreshes should not count as refreshed.");
+        // Then: records should be persisted before the completion handler.
+        NBClientRefreshScheduler *scheduler = [[NBClientRefreshScheduler alloc] initWithClient:self.client
+                                                                                   identifier:self.scheduler.identifier];
+        scheduler.directoryURL = self.scheduler.directoryURL;
+        XCTAssertEqualObjects(scheduler.records, self.scheduler.records);
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+@end
@@ -0,0 +1,104 @@
+//
+//  NBClientStringInternPoolTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+#import "NBTestTransport.h"
+
+#import "NBClient_Internal.h"
+#import "NBClientStringInternPool.h"
+
+@interface NBClientStringInternPoolTests : NBTestCase
+
+@property (nonatomic) NBClientStringInternPool *pool;
+
+- (id)parsedObject:(id)object;
+
+@end
+
+@implementation NBClientStringInternPoolTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.pool = [[NBClientStringInternPool alloc] init];
+}
+
+#pragma mark - Helpers
+
+- (id)parsedObject:(id)object
+{
+    // Each occurrence of a string gets its own instance, like any response.
+    NSData *data = [NSJSONSerialization dataWithJSONObject:object options:0 error:nil];
+    return [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+}
+
+#pragma mark - Tests
+
+- (void)testInterningRepeatedStrings
+{
+    // Given: Values too long to be tagged pointers.
+    NSDictionary *record = @{ @"support_level_name": @"Strong support for the candidate",
+                              @"tags": @[ @"volunteer-for-the-campaign" ] };
+    NSArray *records = [self parsedObject:@[ record, record, record ]];
+    XCTAssertNotEqual(records[0][@"support_level_name"], records[1][@"support_level_name"]);
+    // When:
+    NSUInteger savedBytes;
+    NSArray *internedRecords = [self.pool internObject:records savedBytes:&savedBytes];
+    // Then:
+    XCTAssertEqualObjects(internedRecords, records, @"Interning should not change the object.");
+    for (NSDictionary *internedRecord in internedRecords) {
+        XCTAssertEqual(internedRecord[@"support_level_name"], internedRecords[0][@"support_level_name"]);
+        XCTAssertEqual([internedRecord[@"tags"] firstObject], [internedRecords[0][@"tags"] firstObject]);
+    }
+    XCTAssertEqual(self.pool.numberOfStrings, 4, @"Both keys and both values should be pooled.");
+    XCTAssertGreaterThanOrEqual(self.pool.numberOfDeduplicatedStrings, 6);
+    XCTAssertGreaterThan(savedBytes, 0);
+    XCTAssertEqual(self.pool.numberOfSavedBytes, savedBytes);
+}
+
+- (void)testNotInterningValuesOfHighCardinalityKeys
+{
+    // Given:
+    self.pool.maximumNumberOfValuesPerKey = 2;
+    NSMutableArray *records = [NSMutableArray array];
+    for (NSUInteger index = 0; index < 4; index++) {
+        [records addObject:@{ @"email": [NSString stringWithFormat:@"supporter-%lu@example.com", (unsigned long)index],
+                              @"party": @"Independent party" }];
+    }
+    // When:
+    NSArray *internedRecords = [self.pool internObject:[self parsedObject:records] savedBytes:nil];
+    // Then:
+    XCTAssertEqualObjects(internedRecords, records);
+    XCTAssertEqual(self.pool.numberOfStrings, 3, @"Emails should stop being pooled.");
+    XCTAssertEqual(internedRecords[0][@"party"], internedRecords[3][@"party"]);
+    [self.pool removeAllStrings];
+    XCTAssertEqual(self.pool.numberOfStrings, 0);
+    XCTAssertEqual(self.pool.numberOfSavedBytes, 0);
+}
+
+- (void)testClientInterningListResponses
+{
+    // Given:
+    self.client.shouldInternStrings = YES;
+    NSData *data = [NBTestTransportResponse responseWithFixtureNamed:@"people_get"].data;
+    NSURL *url = [self.client urlComponentsForSubPath:@"/people"].URL;
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:url statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    __block NSArray *results;
+    // When:
+    [self.client dataTaskCompletionHandlerForResultsKey:@"results" originalRequest:[NSURLRequest requestWithURL:url]
+                                      completionHandler:^(id items, NSDictionary *jsonObject, NSError *error) {
+                                          XCTAssertNil(error);
+                                          results = items;
+                                      }](data, response, nil);
+    // Then:
+    NSDictionary *jsonObject = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    XCTAssertEqualObjects(results, jsonObject[@"results"]);
+    XCTAssertGreaterThan(self.client.stringInternPool.numberOfStrings, 0);
+}
+
+@end
@@ -0,0 +1,177 @@
+//
+//  NBClientSurveyTallyTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+Surveys.h"
+#import "NBClientSurveyTally.h"
+#import "NBPaginationInfo.h"
+
+@interface NBClientSurveyTallyTests : NBTestCase
+
+@property (nonatomic) id clientMock;
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) NSMutableArray *serverResponses;
+@property (nonatomic) NSMutableArray *requestedParameters;
+
+- (NSDictionary *)responseWithIdentifier:(NSUInteger)identifier answer:(NSUInteger)answer;
+- (NBClientSurveyTally *)tally;
+
+@end
+
+@implementation NBClientSurveyTallyTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:
+                                           [[NSUUID UUID].UUIDString stringByAppendingPathExtension:@"json"]]];
+    self.serverResponses = [NSMutableArray array];
+    self.requestedParameters = [NSMutableArray array];
+    // Fake the server, which pages by twos and filters by creation time.
+    self.clientMock = OCMPartialMock(self.client);
+    [OCMStub([self.clientMock fetchSurveyResponseByIdentifier:1 parameters:OCMOCK_ANY withPaginationInfo:OCMOCK_ANY completionHandler:OCMOCK_ANY]) andDo:^(NSInvocation *invocation) {
+        __unsafe_unretained NSDictionary *parameters;
+        __unsafe_unretained NBPaginationInfo *paginationInfo;
+        __unsafe_unretained NBClientResourceListCompletionHandler completionHandler;
+        [invocation getArgument:&parameters atIndex:3];
+        [invocation getArgument:&paginationInfo atIndex:4];
+        [invocation getArgument:&completionHandler atIndex:5];
+        [invocation retainArguments];
+        [self.requestedParameters addObject:parameters ?: @{}];
+        NSString *startTime = parameters[@"start_time"];
+        NSArray *responses = [self.serverResponses filteredArrayUsingPredicate:
+                              [NSPredicate predicateWithBlock:^BOOL(NSDictionary *response, NSDictionary *bindings) {
+            return !startTime || [response[@"created_at"] compare:startTime] != NSOrderedAscending;
+        }]];
+        NSUInteger offset = paginationInfo.nextPageURLString ? paginationInfo.nextPageURLString.lastPathComponent.integerValue : 0;
+        NSRange range = NSMakeRange(offset, MIN((NSUInteger)2, responses.count - offset));
+        NBPaginationInfo *nextPaginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+        if (NSMaxRange(range) < responses.count) {
+            nextPaginationInfo.nextPageURLString = [NSString stringWithFormat:@"/api/v1/survey_responses/%lu", (unsigned long)NSMaxRange(range)];
+        }
+        NSArray *items = [responses subarrayWithRange:range];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(items, nextPaginationInfo, nil);
+        });
+    }];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [self.clientMock stopMocking];
+    [[NSFileManager defaultManager] removeItemAtURL:self.fileURL error:nil];
+}
+
+#pragma mark - Helpers
+
+- (NSDictionary *)responseWithIdentifier:(NSUInteger)identifier answer:(NSUInteger)answer
+{
+    return @{ @"id": @(identifier), @"survey_id": @1, @"person_id": @(700 + identifier),
+              @"created_at": [NSString stringWithFormat:@"2016-03-10T21:%02lu:00-08:00", (unsigned long)identifier],
+              NBClientSurveyResponsesKey: @[ @{ NBClientSurveyQuestionIdentifierKey: @1, NBClientSurveyQuestionResponseIdentifierKey: @(answer) },
+                                             @{ NBClientSurveyQuestionIdentifierKey: @2, NBClientSurveyQuestionResponseIdentifierKey: @"Yes" } ] };
+}
+
+- (NBClientSurveyTally *)tally
+{
+    NBClientSurveyTally *tally = [[NBClientSurveyTally alloc] initWithClient:self.clientMock identifier:@"test" surveyIdentifier:1];
+    tally.fileURL = self.fileURL;
+    return tally;
+}
+
+#pragma mark - Tests
+
+- (void)testCountingResponsesIncrementally
+{
+    [self setUpAsync];
+    // Given:
+    for (NSUInteger identifier = 1; identifier <= 5; identifier++) {
+        [self.serverResponses addObject:[self responseWithIdentifier:identifier answer:(identifier % 2 ? 1 : 2)]];
+    }
+    NBClientSurveyTally *tally = [self tally];
+    NSMutableArray *updates = [NSMutableArray array];
+    tally.updateHandler = ^(NSArray *responses) {
+        [updates addObject:@(responses.count)];
+    };
+    // When:
+    [tally refreshWithCompletionHandler:^(NSError *error) {
+        // Then:
+        XCTAssertNil(error);
+        XCTAssertEqualObjects(updates, (@[ @2, @2, @1 ]), @"Counts should update as each page arrives.");
+        XCTAssertEqualObjects([tally countsForQuestionIdentifier:1], (@{ @"1": @3, @"2": @2 }));
+        XCTAssertEqualObjects([tally countsForQuestionIdentifier:2], (@{ @"Yes": @5 }));
+        XCTAssertEqual(tally.lastResponseIdentifier, 5);
+        XCTAssertEqualObjects(tally.startTime, @"2016-03-10T21:05:00-08:00");
+        // When: a response comes in, and the refresh overlaps the last one.
+        [self.serverResponses addObject:[self responseWithIdentifier:6 answer:2]];
+        [self.requestedParameters removeAllObjects];
+        [tally refreshWithCompletionHandler:^(NSError *error) {
+            // Then:
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(self.requestedParameters, (@[ @{ @"start_time": @"2016-03-10T21:05:00-08:00" } ]),
+                                  @"Only responses since the last refresh should be fetched.");
+            XCTAssertEqual(tally.numberOfResponses, 6);
+            XCTAssertEqualObjects([tally countsForQuestionIdentifier:1], (@{ @"1": @3, @"2": @3 }),
+                                  @"Responses should only be counted once.");
+            XCTAssertEqualObjects(tally.startTime, @"2016-03-10T21:06:00-08:00");
+            [self completeAsync];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testPersistingTally
+{
+    [self setUpAsync];
+    // Given:
+    NBClientSurveyTally *tally = [self tally];
+    NSArray *responses = @[ [self responseWithIdentifier:1 answer:1], [self responseWithIdentifier:3 answer:2] ];
+    XCTAssertEqual([tally addResponses:responses].count, 2);
+    XCTAssertEqual([tally addResponses:@[ responses[1], [self responseWithIdentifier:2 answer:1] ]].count, 1);
+    // When:
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.2f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        NBClientSurveyTally *loadedTally = [self tally];
+        // Then:
+        XCTAssertEqual(loadedTally.numberOfResponses, 3);
+        XCTAssertEqualObjects(loadedTally.counts, tally.counts);
+        XCTAssertEqual(loadedTally.lastResponseIdentifier, 3);
+        XCTAssertEqual([loadedTally addResponses:responses].count, 0, @"Counted responses should be remembered.");
+        [loadedTally reset];
+        XCTAssertEqual(loadedTally.numberOfResponses, 0);
+        XCTAssertNil([loadedTally countsForQuestionIdentifier:1]);
+        [self completeAsync];
+    });
+    [self tearDownAsync];
+}
+
+- (void)testFailingWithoutClient
+{
+    [self setUpAsync];
+    // Given: a client that has gone away.
+    NBClientSurveyTally *tally;
+    @autoreleasepool {
+        NBClient *client = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                               customURLSession:nil customURLSessionConfiguration:nil];
+        tally = [[NBClientSurveyTally alloc] initWithClient:client identifier:@"test" surveyIdentifier:1];
+    }
+    tally.fileURL = self.fileURL;
+    // When:
+    [tally refreshWithCompletionHandler:^(NSError *error) {
+        // Then:
+        XCTAssertEqual(error.code, NBErrorCodeInvalidArgument,
+                       @"Refresh should fail fast without a client.");
+        XCTAssertFalse(tally.isRefreshing);
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+@end
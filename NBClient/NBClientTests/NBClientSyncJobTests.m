@@ -0,0 +1,169 @@
+//
+//  NBClientSyncJobTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClientSyncJob.h"
+#import "NBPaginationInfo.h"
+
+@interface NBClientSyncJobTests : NBTestCase
+
+@property (nonatomic) NSURL *checkpointDirectoryURL;
+@property (nonatomic) NSMutableArray *records;
+
+- (NBClientSyncJob *)createJob;
+
+@end
+
+@implementation NBClientSyncJobTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.checkpointDirectoryURL = [[NSURL fileURLWithPath:NSTemporaryDirectory() isDirectory:YES]
+                                   URLByAppendingPathComponent:[NSUUID UUID].UUIDString isDirectory:YES];
+    self.records = [NSMutableArray array];
+    for (NSUInteger identifier = 1; identifier <= 8; identifier++) {
+        [self.records addObject:@{ @"id": @(identifier) }];
+    }
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [[NSFileManager defaultManager] removeItemAtURL:self.checkpointDirectoryURL error:nil];
+}
+
+- (NBClientSyncJob *)createJob
+{
+    // Serves the current records, two per legacy page.
+    NBClientPageFetcher pageFetcher = ^NSURLSessionDataTask *(NBPaginationInfo *paginationInfo, NBClientResourceListCompletionHandler completionHandler) {
+        NSUInteger numberOfItemsPerPage = 2;
+        NSUInteger pageNumber = paginationInfo.currentPageNumber;
+        NSUInteger location = (pageNumber - 1) * numberOfItemsPerPage;
+        NSArray *items = [self.records subarrayWithRange:
+                          NSMakeRange(location, MIN(numberOfItemsPerPage, self.records.count - location))];
+        NBPaginationInfo *resultInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+        resultInfo.currentPageNumber = pageNumber;
+        resultInfo.numberOfItemsPerPage = numberOfItemsPerPage;
+        resultInfo.numberOfTotalItems = self.records.count;
+        resultInfo.numberOfTotalPages = (self.records.count + numberOfItemsPerPage - 1) / numberOfItemsPerPage;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completionHandler(items, resultInfo, nil);
+        });
+        return nil;
+    };
+    NBClientSyncJob *job = [[NBClientSyncJob alloc] initWithIdentifier:@"people" pageFetcher:pageFetcher];
+    job.checkpointDirectoryURL = self.checkpointDirectoryURL;
+    return job;
+}
+
+#pragma mark - Tests
+
+- (void)testResumingFromCheckpoint
+{
+    [self setUpAsync];
+    NSMutableArray *syncedIdentifiers = [NSMutableArray array];
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    // Given: a job interrupted after two pages.
+    NBClientSyncJob *job = [self createJob];
+    __weak NBClientSyncJob *weakJob = job;
+    job.pageHandler = ^(NSArray *items, NSUInteger pageNumber) {
+        [syncedIdentifiers addObjectsFromArray:[items valueForKey:@"id"]];
+        if (pageNumber == 2) {
+            [weakJob cancel];
+        }
+    };
+    [job startWithPaginationInfo:paginationInfo completionHandler:^(NSUInteger numberOfItemsSeen, NSError *error) {
+        XCTAssertEqual(error.code, NSURLErrorCancelled);
+        XCTAssertEqual([weakJob.checkpoint[NBClientSyncCheckpointPageNumberKey] unsignedIntegerValue], 2,
+                       @"Checkpoint should be saved after each page.");
+        // When: a record is added before the checkpoint, then a new job resumes.
+        [self.records insertObject:@{ @"id": @0 } atIndex:0];
+        NBClientSyncJob *resumedJob = [self createJob];
+        XCTAssertEqual(resumedJob.numberOfItemsSeen, 4,
+                       @"Job should load its checkpoint.");
+        resumedJob.pageHandler = ^(NSArray *items, NSUInteger pageNumber) {
+            XCTAssertGreaterThan(pageNumber, 2,
+                                 @"Synced pages should not be fetched again.");
+            [syncedIdentifiers addObjectsFromArray:[items valueForKey:@"id"]];
+        };
+        [resumedJob startWithPaginationInfo:paginationInfo completionHandler:^(NSUInteger numberOfItemsSeen, NSError *error) {
+            // Then: the stream should continue without gaps or duplicates.
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(syncedIdentifiers, (@[ @1, @2, @3, @4, @5, @6, @7, @8 ]),
+                                  @"Resumed sync should skip already seen items.");
+            XCTAssertEqual(numberOfItemsSeen, 8);
+            XCTAssertNil(resumedJob.checkpoint,
+                         @"Checkpoint should be removed when finished.");
+            XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:resumedJob.checkpointURL.path]);
+            [self completeAsync];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testSkippingItemsSeenOnLastSyncedPage
+{
+    [self setUpAsync];
+    NSMutableArray *syncedIdentifiers = [NSMutableArray array];
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    // Given: a job interrupted after two pages.
+    NBClientSyncJob *job = [self createJob];
+    __weak NBClientSyncJob *weakJob = job;
+    job.pageHandler = ^(NSArray *items, NSUInteger pageNumber) {
+        [syncedIdentifiers addObjectsFromArray:[items valueForKey:@"id"]];
+        if (pageNumber == 2) {
+            [weakJob cancel];
+        }
+    };
+    [job startWithPaginationInfo:paginationInfo completionHandler:^(NSUInteger numberOfItemsSeen, NSError *error) {
+        NSSet *checkpointIdentifiers = [NSSet setWithArray:weakJob.checkpoint[NBClientSyncCheckpointItemIdentifiersKey]];
+        XCTAssertEqualObjects(checkpointIdentifiers, ([NSSet setWithArray:@[ @3, @4 ]]),
+                              @"Checkpoint should only keep the last synced page's identifiers.");
+        // When: more records than a page are added before the checkpoint.
+        [self.records insertObjects:@[ @{ @"id": @10 }, @{ @"id": @11 }, @{ @"id": @12 } ]
+                          atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 3)]];
+        NBClientSyncJob *resumedJob = [self createJob];
+        resumedJob.pageHandler = ^(NSArray *items, NSUInteger pageNumber) {
+            [syncedIdentifiers addObjectsFromArray:[items valueForKey:@"id"]];
+        };
+        [resumedJob startWithPaginationInfo:paginationInfo completionHandler:^(NSUInteger numberOfItemsSeen, NSError *error) {
+            // Then: items from the last synced page should be skipped, and earlier ones handled again.
+            XCTAssertNil(error);
+            XCTAssertEqualObjects(syncedIdentifiers, (@[ @1, @2, @3, @4, @2, @4, @5, @6, @7, @8 ]),
+                                  @"Resumed sync should only skip items seen on the last synced page.");
+            [self completeAsync];
+        }];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testFailingOnRemovedRecords
+{
+    [self setUpAsync];
+    // Given: a record removed before synced pages, mid-sync.
+    NBClientSyncJob *job = [self createJob];
+    job.pageHandler = ^(NSArray *items, NSUInteger pageNumber) {
+        if (pageNumber == 2) {
+            [self.records removeObjectAtIndex:0];
+        }
+    };
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    [job startWithPaginationInfo:paginationInfo completionHandler:^(NSUInteger numberOfItemsSeen, NSError *error) {
+        // Then: the job should fail instead of skipping an item.
+        XCTAssertEqual(error.code, NBClientErrorCodeSyncDiscontinuity);
+        XCTAssertEqual([job.checkpoint[NBClientSyncCheckpointPageNumberKey] unsignedIntegerValue], 2,
+                       @"Checkpoint should be kept for inspection.");
+        [job reset];
+        XCTAssertNil(job.checkpoint);
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+@end
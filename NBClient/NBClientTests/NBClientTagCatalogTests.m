@@ -0,0 +1,98 @@
+//
+//  NBClientTagCatalogTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+People.h"
+#import "NBClientTagCatalog.h"
+
+@interface NBClientTagCatalogTests : NBTestCase
+
+@property (nonatomic) NBClientTagCatalog *catalog;
+
+@end
+
+@implementation NBClientTagCatalogTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.catalog = [[NBClientTagCatalog alloc] initWithClient:self.client];
+    self.catalog.fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString]];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [[NSFileManager defaultManager] removeItemAtURL:self.catalog.fileURL error:nil];
+}
+
+#pragma mark - Tests
+
+- (void)testRankingPrefixMatches
+{
+    // Given: a catalog with some tags, one used more than once.
+    [self.catalog addTagNames:@[ @"Volunteer", @"volunteer-lead", @"Vol", @"Voter", @"Donor" ]];
+    [self.catalog addTagNames:@[ @"volunteer-lead" ]];
+    // When:
+    NSArray *tagNames = [self.catalog tagNamesWithPrefix:@"VÖL" limit:3];
+    // Then:
+    XCTAssertEqual(self.catalog.numberOfTags, 5,
+                   @"Names should only be added once.");
+    XCTAssertEqualObjects(tagNames, (@[ @"Vol", @"volunteer-lead", @"Volunteer" ]),
+                          @"Matches should ignore case and diacritics, and be ranked.");
+    XCTAssertEqualObjects([self.catalog tagNamesWithPrefix:@"x" limit:3], @[]);
+}
+
+- (void)testRankingOnlyFirstUnusedMatches
+{
+    // Given: synced tags, saved without use counts, and one used tag.
+    NSDictionary *catalogInfo = @{ @"names": @[ @"vote-a", @"vote-b", @"vote-c", @"vote-d" ],
+                                   @"keys": @[ @"vote-a", @"vote-b", @"vote-c", @"vote-d" ] };
+    [[NSPropertyListSerialization dataWithPropertyList:catalogInfo format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil]
+     writeToURL:self.catalog.fileURL atomically:YES];
+    NBClientTagCatalog *catalog = [[NBClientTagCatalog alloc] initWithClient:self.client];
+    catalog.fileURL = self.catalog.fileURL;
+    [catalog addTagNames:@[ @"vote-d" ]];
+    // When:
+    NSArray *tagNames = [catalog tagNamesWithPrefix:@"vote" limit:2];
+    // Then:
+    XCTAssertEqualObjects(tagNames, (@[ @"vote-d", @"vote-a" ]),
+                          @"Used tags should rank first, then the first unused matches.");
+}
+
+- (void)testAddingCreatedTaggings
+{
+    // When: the client creates taggings.
+    [[NSNotificationCenter defaultCenter] postNotificationName:NBClientDidCreateTaggingsNotification object:self.client
+                                                      userInfo:@{ NBClientTagNamesKey: @[ @"canvassed" ] }];
+    // Then:
+    XCTAssertEqualObjects([self.catalog tagNamesWithPrefix:@"can" limit:10], @[ @"canvassed" ],
+                          @"Tags applied through the client should be added.");
+}
+
+- (void)testLoadingPersistedTags
+{
+    [self setUpAsync];
+    // Given: added tags.
+    [self.catalog addTagNames:@[ @"builder", @"expert" ]];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.5f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        // When: creating another catalog with the same file.
+        NBClientTagCatalog *catalog = [[NBClientTagCatalog alloc] initWithClient:self.client];
+        catalog.fileURL = self.catalog.fileURL;
+        // Then:
+        XCTAssertEqual(catalog.numberOfTags, 2,
+                       @"Tags should be loaded from the file.");
+        XCTAssertEqualObjects([catalog tagNamesWithPrefix:@"ex" limit:10], @[ @"expert" ]);
+        [self completeAsync];
+    });
+    [self tearDownAsync];
+}
+
+@end
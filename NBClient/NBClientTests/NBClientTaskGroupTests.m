@@ -0,0 +1,75 @@
+//
+//  NBClientTaskGroupTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClient.h"
+#import "NBClient+People.h"
+#import "NBClientTaskGroup.h"
+
+@interface NBClientTaskGroupTests : NBTestCase
+
+@property (nonatomic) NBClientTaskGroup *taskGroup;
+
+@end
+
+@implementation NBClientTaskGroupTests
+
+- (void)setUp
+{
+    [super setUp];
+    [self setUpSharedClient];
+    self.taskGroup = [[NBClientTaskGroup alloc] init];
+}
+
+#pragma mark - Tests
+
+- (void)testJoiningAndCancellingGroup
+{
+    [self setUpAsync];
+    // Given: requests made in a group, and one made outside of it.
+    id delegateMock = OCMProtocolMock(@protocol(NBClientDelegate));
+    [OCMStub([delegateMock client:OCMOCK_ANY shouldAutomaticallyStartDataTask:OCMOCK_ANY]) andReturnValue:@NO];
+    self.client.delegate = delegateMock;
+    [self.client performRequestsInTaskGroup:self.taskGroup usingBlock:^{
+        [self.client fetchPersonForClientUserWithCompletionHandler:nil];
+        [self.client fetchPersonForClientUserWithCompletionHandler:nil];
+    }];
+    NSURLSessionDataTask *otherTask = [self.client fetchPersonForClientUserWithCompletionHandler:nil];
+    XCTAssertEqual(self.taskGroup.tasks.count, 2,
+                   @"Only requests made in the block should join the group.");
+    // When: reprioritizing the group.
+    self.taskGroup.priority = NSURLSessionTaskPriorityHigh;
+    // Then: all its tasks should be updated.
+    for (NSURLSessionTask *task in self.taskGroup.tasks) {
+        XCTAssertEqual(task.priority, NSURLSessionTaskPriorityHigh,
+                       @"Group should reprioritize its tasks.");
+    }
+    // When: cancelling the group.
+    [self.taskGroup notifyOnQueue:nil completionHandler:^{
+        // Then: the group should finish without its tasks.
+        XCTAssertEqual(self.taskGroup.tasks.count, 0,
+                       @"Cancelled tasks should leave the group.");
+        XCTAssertEqual(otherTask.state, NSURLSessionTaskStateSuspended,
+                       @"Tasks outside the group should be unaffected.");
+        [otherTask cancel];
+        [self completeAsync];
+    }];
+    [self.taskGroup cancel];
+    [self tearDownAsync];
+}
+
+- (void)testNotifyingEmptyGroup
+{
+    [self setUpAsync];
+    [self.taskGroup notifyOnQueue:nil completionHandler:^{
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+@end
@@ -7,11 +7,15 @@
 
 #import "NBTestCase.h"
 
+#import <zlib.h>
+
 #import "FoundationAdditions.h"
 
 #import "NBAuthenticator.h"
 #import "NBClient_Internal.h"
 #import "NBClient+People.h"
+#import "NBClientSessionProvider.h"
+#import "NBClientStreamedBody.h"
 #import "NBPaginationInfo.h"
 
 @interface NBClientTests : NBTestCase
@@ -93,10 +97,79 @@
     // When: assigning delegate immediately after initialization.
     initClient();
     client.delegate = OCMProtocolMock(@protocol(NBClientDelegate));
-    XCTAssertEqual(client.urlSession.delegate, client.delegate,
+    XCTAssertEqual(client.urlSession.delegate, client,
+                   @"Client should stay the default session's delegate, to resend streamed bodies.");
+    SEL selector = @selector(URLSession:didReceiveChallenge:completionHandler:);
+    XCTAssertTrue([client respondsToSelector:selector]);
+    XCTAssertEqual([client forwardingTargetForSelector:selector], client.delegate,
                    @"Client should delegate default session to delegate.");
 }
 
+- (void)testSharingSessionProvider
+{
+    // Given: two clients sharing a provider that runs one task at a time.
+    NBClientSessionProvider *provider = [[NBClientSessionProvider alloc] initWithSessionConfiguration:nil];
+    provider.maximumNumberOfRunningTasks = 1;
+    id delegateMock = OCMProtocolMock(@protocol(NBClientDelegate));
+    [OCMStub([delegateMock client:OCMOCK_ANY shouldAutomaticallyStartDataTask:OCMOCK_ANY]) andReturnValue:@NO];
+    NSMutableArray *clients = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 2; i++) {
+        NBClient *client = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                               customURLSession:nil customURLSessionConfiguration:nil];
+        client.delegate = delegateMock;
+        client.sessionProvider = provider;
+        [clients addObject:client];
+    }
+    XCTAssertEqual([clients.firstObject urlSession], [clients.lastObject urlSession],
+                   @"Clients should share the provider's session.");
+    XCTAssertEqual([clients.firstObject urlSession].delegate, provider,
+                   @"Provider should be the shared session's delegate.");
+    // When: both clients start a task.
+    NSMutableArray *tasks = [NSMutableArray array];
+    for (NBClient *client in clients) {
+        NSURLSessionDataTask *task = [client fetchPersonForClientUserWithCompletionHandler:nil];
+        [client startDataTask:task];
+        [tasks addObject:task];
+    }
+    // Then: the second task should wait for the first.
+    XCTAssertEqual(provider.numberOfRunningTasks, 1,
+                   @"Provider should limit running tasks across clients.");
+    XCTAssertEqual(provider.numberOfPendingTasks, 1,
+                   @"Provider should defer tasks over its limit.");
+    XCTAssertEqual([tasks.lastObject state], NSURLSessionTaskStateSuspended,
+                   @"Deferred task should not have been resumed.");
+    XCTAssertGreaterThan([NBClient resumeTimeForTask:tasks.firstObject], 0,
+                         @"Running task should be timed from when it was resumed.");
+    XCTAssertEqual([NBClient resumeTimeForTask:tasks.lastObject], 0,
+                   @"Deferred task should not be timed while queued.");
+    // When: cancelling the second client's tasks.
+    [provider cancelTasksForClient:clients.lastObject];
+    // Then: its deferred task should no longer be pending.
+    XCTAssertEqual(provider.numberOfPendingTasks, 0,
+                   @"Provider should cancel deferred tasks for client.");
+    [tasks.firstObject cancel];
+}
+
+- (void)testStartingNonAPITasksThroughSessionProvider
+{
+    // Given: a client with a provider that runs one task at a time, and a running API task.
+    NBClientSessionProvider *provider = [[NBClientSessionProvider alloc] initWithSessionConfiguration:nil];
+    provider.maximumNumberOfRunningTasks = 1;
+    NBClient *client = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                           customURLSession:nil customURLSessionConfiguration:nil];
+    client.sessionProvider = provider;
+    NSURLSessionDataTask *apiTask = [client fetchPersonForClientUserWithCompletionHandler:nil];
+    // When: loading an image.
+    NSURLSessionDataTask *task = [client startDataTaskWithURL:[NSURL URLWithString:@"https://example.com/avatar.png"]
+                                            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {}];
+    // Then:
+    XCTAssertEqual(provider.numberOfPendingTasks, 1,
+                   @"Non-API tasks should be subject to the provider's limit.");
+    XCTAssertEqual(task.state, NSURLSessionTaskStateSuspended);
+    [provider cancelTasksForClient:client];
+    [apiTask cancel];
+}
+
 - (void)testTogglingIncludingKeyAsHeader
 {
     if (self.shouldUseHTTPStubbing) { return NBLog(@"SKIPPING"); }
@@ -156,6 +229,32 @@
 
 #pragma mark Helpers
 
+- (NSData *)readBodyStream:(NSInputStream *)inputStream decompress:(BOOL)decompress
+{
+    NSMutableData *data = [NSMutableData data];
+    uint8_t buffer[4096];
+    [inputStream open];
+    NSInteger length;
+    while ((length = [inputStream read:buffer maxLength:sizeof(buffer)]) > 0) {
+        [data appendBytes:buffer length:(NSUInteger)length];
+    }
+    [inputStream close];
+    if (!decompress) {
+        return data;
+    }
+    NSMutableData *decompressedData = [NSMutableData dataWithLength:data.length * 10];
+    z_stream zStream = {0};
+    inflateInit2(&zStream, MAX_WBITS + 16);
+    zStream.next_in = (Bytef *)data.bytes;
+    zStream.avail_in = (uInt)data.length;
+    zStream.next_out = decompressedData.mutableBytes;
+    zStream.avail_out = (uInt)decompressedData.length;
+    inflate(&zStream, Z_FINISH);
+    decompressedData.length = zStream.total_out;
+    inflateEnd(&zStream);
+    return decompressedData;
+}
+
 - (NSURL *)getSomeRequestURLForClient:(NBClient *)client {
     if (self.shouldUseHTTPStubbing) {
         // NOTE: There won't be a file, but request will be cancelled.
@@ -226,6 +325,94 @@
     [self tearDownAsync];
 }
 
+- (void)testStreamingLargeRequestBodies
+{
+    NBClient *client = self.baseClientWithTestToken;
+    client.bodyStreamingThreshold = 3;
+    NSURL *url = [NSURL URLWithString:@"https://example.com"];
+    // Given: a small and a large list.
+    NSMutableArray *identifiers = [NSMutableArray array];
+    for (NSUInteger identifier = 1; identifier <= 10000; identifier++) {
+        [identifiers addObject:@(identifier)];
+    }
+    NSDictionary *smallParameters = @{ @"people_ids": @[ @1, @2 ] };
+    NSDictionary *largeParameters = @{ @"people_ids": identifiers };
+    // When: creating requests for a bulk endpoint.
+    __block NSMutableURLRequest *smallRequest, *largeRequest;
+    [client performBulkRequestsUsingBlock:^{
+        smallRequest = [client baseRequestWithURL:url parameters:smallParameters error:nil];
+        largeRequest = [client baseRequestWithURL:url parameters:largeParameters error:nil];
+    }];
+    // Then: other endpoints should never stream.
+    XCTAssertNotNil([client baseRequestWithURL:url parameters:largeParameters error:nil].HTTPBody,
+                    @"Only bulk endpoints should stream bodies.");
+    // Then: only the large body should be streamed, and decode as usual.
+    XCTAssertNotNil(smallRequest.HTTPBody);
+    XCTAssertNil(largeRequest.HTTPBody,
+                 @"Large bodies should not be encoded up front.");
+    NSData *data = [self readBodyStream:largeRequest.HTTPBodyStream decompress:NO];
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], largeParameters,
+                          @"Streamed body should be the same JSON.");
+    // When: compressing.
+    NBClientStreamedBody *body = [[NBClientStreamedBody alloc] initWithKey:@"people_ids" items:identifiers shouldCompress:YES];
+    NSData *compressedData = [self readBodyStream:[body inputStreamWithError:nil] decompress:NO];
+    data = [self readBodyStream:[body inputStreamWithError:nil] decompress:YES];
+    // Then: it should be smaller, and decode the same.
+    XCTAssertLessThan(compressedData.length, data.length);
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], largeParameters,
+                          @"Compressed body should be the same JSON.");
+}
+
+- (void)testResendingStreamedRequestBodies
+{
+    NBClient *client = self.baseClientWithTestToken;
+    client.bodyStreamingThreshold = 3;
+    NSURL *url = [NSURL URLWithString:@"https://example.com"];
+    NSDictionary *parameters = @{ @"people_ids": @[ @1, @2, @3, @4 ] };
+    __block NSMutableURLRequest *request, *smallRequest;
+    [client performBulkRequestsUsingBlock:^{
+        request = [client baseRequestWithURL:url parameters:parameters error:nil];
+        smallRequest = [client baseRequestWithURL:url parameters:@{ @"people_ids": @[ @1 ] } error:nil];
+    }];
+    // Given: a streamed body that was already read.
+    [self readBodyStream:request.HTTPBodyStream decompress:NO];
+    // When: the session asks for a new body stream.
+    NSInputStream *inputStream = [NBClientStreamedBody inputStreamForResendingRequest:request];
+    // Then: it should be a fresh one that decodes the same.
+    XCTAssertNotNil(inputStream);
+    XCTAssertNotEqual(inputStream, request.HTTPBodyStream);
+    NSData *data = [self readBodyStream:inputStream decompress:NO];
+    XCTAssertEqualObjects([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], parameters,
+                          @"Resent body should be the same JSON.");
+    // Then: bodies that aren't streamed should have none.
+    XCTAssertNil([NBClientStreamedBody inputStreamForResendingRequest:smallRequest]);
+}
+
+- (void)testFailingStreamedRequestBodiesWithInvalidItems
+{
+    NBClient *client = self.baseClientWithTestToken;
+    client.bodyStreamingThreshold = 3;
+    NSURL *url = [NSURL URLWithString:@"https://example.com"];
+    // Given: a large list with an item that isn't JSON.
+    NSArray *items = @[ @1, @2, [NSDate date], @4 ];
+    // When: creating a request.
+    __block NSError *error;
+    [client performBulkRequestsUsingBlock:^{
+        NSError *requestError;
+        [client baseRequestWithURL:url parameters:@{ @"people_ids": items } error:&requestError];
+        error = requestError;
+    }];
+    // Then: it should error instead of sending null.
+    XCTAssertEqualObjects(error.domain, NBErrorDomain);
+    XCTAssertEqual(error.code, NBErrorCodeInvalidArgument);
+    // When: creating a body stream with the item anyway.
+    NBClientStreamedBody *body = [[NBClientStreamedBody alloc] initWithKey:@"people_ids" items:items shouldCompress:NO];
+    NSError *streamError;
+    // Then: there should be no stream to send a truncated body.
+    XCTAssertNil([body inputStreamWithError:&streamError]);
+    XCTAssertEqual(streamError.code, NBErrorCodeInvalidArgument);
+}
+
 #pragma mark - Delegation
 
 #pragma mark Helpers
@@ -0,0 +1,138 @@
+//
+//  NBClientTracerTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+#import "NBTestTransport.h"
+
+#import "NBClient.h"
+#import "NBClient+Contacts.h"
+#import "NBClientTracer.h"
+
+@interface NBClientTracerTests : NBTestCase
+
+@property (nonatomic) NBClient *transportClient;
+@property (nonatomic) NBClientTracer *tracer;
+
+@end
+
+@implementation NBClientTracerTests
+
+- (void)setUp
+{
+    [super setUp];
+    if (self.shouldUseHTTPStubbing) {
+        [[LSNocilla sharedInstance] stop];
+    }
+    [NBTestTransport reset];
+    [NBTestTransport setConditions:[NBTestTransportConditions conditionsWithLatency:0.1f bandwidth:0]];
+    [NBTestTransport addFixtureResponderForMethod:@"GET" path:@"settings/contact_methods"];
+    NSURLSession *urlSession = [NSURLSession sessionWithConfiguration:[NBTestTransport sessionConfiguration]
+                                                             delegate:nil delegateQueue:[NSOperationQueue mainQueue]];
+    self.transportClient = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                               customURLSession:urlSession customURLSessionConfiguration:nil];
+    self.tracer = [NBClientTracer sharedTracer];
+    [self.tracer removeAllSpans];
+    self.tracer.enabled = YES;
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    self.tracer.enabled = NO;
+    [self.tracer removeAllSpans];
+    [NBTestTransport reset];
+    if (self.shouldUseHTTPStubbing) {
+        [[LSNocilla sharedInstance] start];
+    }
+}
+
+#pragma mark - Tests
+
+- (void)testTracingRequestStages
+{
+    [self setUpAsync];
+    // When:
+    [self.transportClient fetchContactMethodsWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+        XCTAssertNil(error);
+        // The request ends once the completion handler returns.
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // Then:
+            NSArray *spans = self.tracer.spans;
+            NBClientTraceSpan *requestSpan = spans.lastObject;
+            XCTAssertEqualObjects(requestSpan.name, NBClientTraceRequestSpanName);
+            XCTAssertEqualObjects(requestSpan.arguments[@"status_code"], @200);
+            NSArray *stageNames = @[ NBClientTraceURLStageName, NBClientTraceBodyStageName, NBClientTraceQueueStageName,
+                                     NBClientTraceNetworkStageName, NBClientTraceParseStageName,
+                                     NBClientTracePaginationStageName, NBClientTraceCompletionStageName ];
+            XCTAssertEqualObjects([[spans subarrayWithRange:NSMakeRange(0, spans.count - 1)] valueForKey:@"name"], stageNames,
+                                  @"Each stage should be traced, in order.");
+            for (NBClientTraceSpan *span in spans) {
+                XCTAssertEqual(span.requestIdentifier, requestSpan.requestIdentifier);
+                XCTAssertTrue(span.startTime >= requestSpan.startTime && span.endTime <= requestSpan.endTime,
+                              @"Stages should nest in their request.");
+                if ([span.name isEqualToString:NBClientTraceNetworkStageName]) {
+                    XCTAssertGreaterThanOrEqual(span.duration, 0.1f);
+                }
+            }
+            NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[self.tracer chromeTraceData] options:0 error:nil];
+            XCTAssertEqual([trace[@"traceEvents"] count], spans.count * 2,
+                           @"Each span should be exported as a begin and end event.");
+            [self completeAsync];
+        });
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testTrackingOpenMainThreadSpans
+{
+    // Given:
+    NBClientTraceSpan *span = [self.tracer beginRequestSpanWithArguments:nil];
+    // When:
+    [span beginStageWithName:NBClientTraceParseStageName];
+    // Then:
+    NSArray *openSpans = self.tracer.openMainThreadSpans;
+    XCTAssertEqualObjects([openSpans valueForKey:@"name"], (@[ NBClientTraceRequestSpanName, NBClientTraceParseStageName ]),
+                          @"Open spans should be in order of beginning.");
+    // When:
+    [span end];
+    // Then:
+    XCTAssertEqual(self.tracer.openMainThreadSpans.count, 0);
+}
+
+- (void)testEndingSpansOfAbandonedTasks
+{
+    // Given: a request span for a task that never runs.
+    NBClientTraceSpan *span = [self.tracer beginRequestSpanWithArguments:nil];
+    @autoreleasepool {
+        NSURLSessionTask *task = (id)[[NSObject alloc] init];
+        [self.tracer setSpan:span forTask:task];
+    }
+    // Then: it should end once the task is gone.
+    XCTAssertTrue(span.isEnded,
+                  @"Span should end when its task is deallocated.");
+    XCTAssertEqualObjects(span.arguments[@"abandoned"], @YES);
+    XCTAssertEqual(self.tracer.openMainThreadSpans.count, 0,
+                   @"Span should no longer be open.");
+}
+
+- (void)testNotTracingWhenDisabled
+{
+    [self setUpAsync];
+    // Given:
+    self.tracer.enabled = NO;
+    // When:
+    [self.transportClient fetchContactMethodsWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // Then:
+            XCTAssertEqual(self.tracer.spans.count, 0);
+            [self completeAsync];
+        });
+    }];
+    [self tearDownAsync];
+}
+
+@end
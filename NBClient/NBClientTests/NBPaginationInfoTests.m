@@ -177,4 +177,19 @@
                   @"Should properly generate query parameters.");
 }
 
+- (void)testKeepingLinkLimits
+{
+    // Given: a next link with another limit than the page size.
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+    paginationInfo.numberOfItemsPerPage = 10;
+    paginationInfo.nextPageURLString = @"/api/v1/people?__nonce=nonce&__token=token&limit=100";
+    // Then: the link's limit should be kept.
+    XCTAssertEqualObjects([paginationInfo queryParameters][NBClientPaginationLimitKey], @100,
+                          @"Only a page sizer should change a link's limit.");
+    // When: sized by a page sizer.
+    paginationInfo.overridesLinkLimit = YES;
+    // Then:
+    XCTAssertEqualObjects([paginationInfo queryParameters][NBClientPaginationLimitKey], @10);
+}
+
 @end
@@ -0,0 +1,120 @@
+//
+//  NBPerformanceMonitorTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+
+#import "NBClientTracer.h"
+#import "NBPerformanceMonitor.h"
+
+@interface NBPerformanceMonitorTests : NBTestCase
+
+@property (nonatomic) NBPerformanceMonitor *monitor;
+
+// Stalls for the given attribution.
+- (NSArray *)stallsAttributedTo:(NSString *)attribution;
+
+@end
+
+@implementation NBPerformanceMonitorTests
+
+- (void)setUp
+{
+    [super setUp];
+    self.monitor = [NBPerformanceMonitor sharedMonitor];
+    [self.monitor reset];
+    self.monitor.stallThreshold = 0.05f;
+    self.monitor.enabled = YES;
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    self.monitor.enabled = NO;
+    [self.monitor reset];
+    [NBClientTracer sharedTracer].enabled = NO;
+    [[NBClientTracer sharedTracer] removeAllSpans];
+}
+
+#pragma mark - Helpers
+
+- (NSArray *)stallsAttributedTo:(NSString *)attribution
+{
+    return [self.monitor.stalls filteredArrayUsingPredicate:
+            [NSPredicate predicateWithFormat:@"%K == %@", NBPerformanceMonitorStallAttributionKey, attribution]];
+}
+
+#pragma mark - Tests
+
+- (void)testAttributingStallsToOperations
+{
+    [self setUpAsync];
+    // Given:
+    [self.monitor beginInteractionWithName:@"test.scroll"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        // When:
+        [self.monitor performOperationWithName:@"test.outer" usingBlock:^{
+            [self.monitor performOperationWithName:@"test.inner" usingBlock:^{
+                [NSThread sleepForTimeInterval:0.3f];
+            }];
+        }];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            [self.monitor endInteraction];
+            // Then:
+            NSDictionary *stall = [self stallsAttributedTo:@"test.inner"].firstObject;
+            XCTAssertNotNil(stall, @"The stall should be attributed to the innermost operation.");
+            XCTAssertEqualObjects(stall[NBPerformanceMonitorStallOperationsKey], (@[ @"test.outer", @"test.inner" ]));
+            XCTAssertEqualObjects(stall[NBPerformanceMonitorStallInteractionKey], @"test.scroll");
+            XCTAssertGreaterThanOrEqual([stall[NBPerformanceMonitorStallDurationKey] doubleValue], 200.0f);
+            NSDictionary *report = [self.monitor report];
+            XCTAssertEqualObjects(report[NBPerformanceMonitorStallsByAttributionKey][@"test.inner"][@"count"], @1);
+            XCTAssertNotNil(report[NBPerformanceMonitorBuildKey]);
+            XCTAssertTrue([NSJSONSerialization isValidJSONObject:report]);
+            [self completeAsync];
+        });
+    });
+    [self tearDownAsync];
+}
+
+- (void)testAttributingStallsToClientStages
+{
+    [self setUpAsync];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        // Given: a traced request, as the client would begin it.
+        NBClientTraceSpan *span = [[NBClientTracer sharedTracer] beginRequestSpanWithArguments:@{ @"path": @"/api/v1/people" }];
+        XCTAssertNotNil(span, @"The monitor should enable tracing.");
+        // When:
+        [span beginStageWithName:NBClientTraceParseStageName];
+        [NSThread sleepForTimeInterval:0.3f];
+        [span end];
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.1f * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+            // Then:
+            NSDictionary *stall = [self stallsAttributedTo:@"nbclient.parse"].firstObject;
+            XCTAssertNotNil(stall);
+            XCTAssertEqualObjects(stall[NBPerformanceMonitorStallClientPathKey], @"/api/v1/people");
+            XCTAssertEqual([stall[NBPerformanceMonitorStallOperationsKey] count], 0);
+            [self completeAsync];
+        });
+    });
+    [self tearDownAsync];
+}
+
+- (void)testRestoringStateWhenDisabled
+{
+    // Given: enabled, with the tracer off beforehand.
+    XCTAssertTrue([NBClientTracer sharedTracer].isEnabled);
+    // When:
+    self.monitor.enabled = NO;
+    // Then:
+    XCTAssertFalse([NBClientTracer sharedTracer].isEnabled,
+                   @"Disabling should restore the tracer.");
+    NSUInteger operation = [self.monitor beginOperationWithName:@"test.ignored"];
+    XCTAssertEqual(operation, 0,
+                   @"Operations begun while disabled should be ignored.");
+    [self.monitor endOperation:operation];
+}
+
+@end
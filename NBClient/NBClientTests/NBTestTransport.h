@@ -0,0 +1,70 @@
+//
+//  NBTestTransport.h
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <Foundation/Foundation.h>
+
+@interface NBTestTransportResponse : NSObject
+
+@property (nonatomic) NSInteger statusCode;
+@property (nonatomic, copy) NSDictionary *headers;
+@property (nonatomic, copy) NSData *data;
+
+// From a raw HTTP response in the Fixtures folder, ie. 'tags_get'.
++ (instancetype)responseWithFixtureNamed:(NSString *)name;
++ (instancetype)responseWithJSONObject:(id)object statusCode:(NSInteger)statusCode;
+// Generated results, for large datasets, ie. a page of people.
++ (instancetype)responseWithNumberOfResults:(NSUInteger)numberOfResults
+                            resultGenerator:(NSDictionary * (^)(NSUInteger index))resultGenerator;
+
+@end
+
+typedef NBTestTransportResponse * (^NBTestTransportResponder)(NSURLRequest *request);
+
+// Network conditions. Delays are real, but jitter and errors come from a
+// seeded generator, so a run is repeatable.
+@interface NBTestTransportConditions : NSObject <NSCopying>
+
+@property (nonatomic) NSTimeInterval latency; // Before the first byte.
+@property (nonatomic) NSTimeInterval jitter; // Up to this much more latency.
+@property (nonatomic) NSUInteger bandwidth; // Bytes per second, shared by all responses. 0 is unlimited.
+@property (nonatomic) double errorRate; // Fraction of requests that fail with a lost connection.
+// Requests beyond this many per window get a 429 with a Retry-After header. 0 is unlimited.
+@property (nonatomic) NSUInteger rateLimit;
+@property (nonatomic) NSTimeInterval rateLimitWindow; // Defaults to 1 second.
+@property (nonatomic) unsigned int seed;
+
+// Ie. 300 ms at 1 Mbps.
++ (instancetype)conditionsWithLatency:(NSTimeInterval)latency bandwidth:(NSUInteger)bandwidth;
+
+@end
+
+// The test transport is a stand-in for the network that serves responses in
+// process under configurable conditions, so throughput and latency of the
+// client can be tested offline. Give the client a session with its
+// configuration. Unlike Nocilla stubs, responses take time, arrive in chunks
+// at the given bandwidth, which concurrent responses share, and can fail or
+// be rate limited. Requests are matched by method and path, relative to the
+// API version, ie. 'GET tags'; unmatched requests get a 404.
+@interface NBTestTransport : NSURLProtocol
+
++ (NSURLSessionConfiguration *)sessionConfiguration;
+
++ (NBTestTransportConditions *)conditions;
++ (void)setConditions:(NBTestTransportConditions *)conditions;
+
++ (void)addResponderForMethod:(NSString *)method path:(NSString *)path responder:(NBTestTransportResponder)responder;
+// Serves the fixture conventionally named after the path and method.
++ (void)addFixtureResponderForMethod:(NSString *)method path:(NSString *)path;
+// Clears responders, conditions and statistics.
++ (void)reset;
+
+// Statistics.
++ (NSUInteger)numberOfRequests;
++ (NSUInteger)numberOfRateLimitedRequests;
++ (NSUInteger)maximumNumberOfConcurrentRequests;
+
+@end
@@ -0,0 +1,423 @@
+//
+//  NBTestTransport.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestTransport.h"
+
+static NSUInteger ChunkSize = 16 * 1024;
+
+@implementation NBTestTransportResponse
+
++ (instancetype)responseWithFixtureNamed:(NSString *)name
+{
+    NSString *path = [[NSBundle bundleForClass:self] pathForResource:name ofType:@"txt"];
+    NSData *fileData = [NSData dataWithContentsOfFile:path];
+    NSAssert(fileData, @"Missing fixture %@", name);
+    // Raw HTTP: status line, headers, blank line, body.
+    NSRange separatorRange = [fileData rangeOfData:[@"\n\n" dataUsingEncoding:NSUTF8StringEncoding] options:0
+                                             range:NSMakeRange(0, fileData.length)];
+    NSUInteger separatorLength = 2;
+    NSRange crlfSeparatorRange = [fileData rangeOfData:[@"\r\n\r\n" dataUsingEncoding:NSUTF8StringEncoding] options:0
+                                                 range:NSMakeRange(0, fileData.length)];
+    if (crlfSeparatorRange.location != NSNotFound && crlfSeparatorRange.location < separatorRange.location) {
+        separatorRange = crlfSeparatorRange;
+        separatorLength = 4;
+    }
+    NSAssert(separatorRange.location != NSNotFound, @"Invalid fixture %@", name);
+    NSString *head = [[NSString alloc] initWithData:[fileData subdataWithRange:NSMakeRange(0, separatorRange.location)]
+                                           encoding:NSUTF8StringEncoding];
+    NSArray *lines = [head componentsSeparatedByCharactersInSet:[NSCharacterSet newlineCharacterSet]];
+    NBTestTransportResponse *response = [[self alloc] init];
+    response.statusCode = [[lines.firstObject componentsSeparatedByString:@" "][1] integerValue];
+    NSMutableDictionary *headers = [NSMutableDictionary dictionary];
+    for (NSString *line in [lines subarrayWithRange:NSMakeRange(1, lines.count - 1)]) {
+        NSRange colonRange = [line rangeOfString:@":"];
+        if (colonRange.location == NSNotFound) {
+            continue;
+        }
+        NSString *field = [line substringToIndex:colonRange.location];
+        // The body is sent as is.
+        if ([field caseInsensitiveCompare:@"Transfer-Encoding"] == NSOrderedSame ||
+            [field caseInsensitiveCompare:@"Content-Length"] == NSOrderedSame)
+        {
+            continue;
+        }
+        headers[field] = [[line substringFromIndex:colonRange.location + 1]
+                          stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    }
+    response.headers = headers;
+    NSUInteger bodyLocation = separatorRange.location + separatorLength;
+    response.data = [fileData subdataWithRange:NSMakeRange(bodyLocation, fileData.length - bodyLocation)];
+    return response;
+}
+
++ (instancetype)responseWithJSONObject:(id)object statusCode:(NSInteger)statusCode
+{
+    NBTestTransportResponse *response = [[self alloc] init];
+    response.statusCode = statusCode;
+    response.headers = @{ @"Content-Type": @"application/json" };
+    response.data = [NSJSONSerialization dataWithJSONObject:object options:0 error:nil];
+    return response;
+}
+
++ (instancetype)responseWithNumberOfResults:(NSUInteger)numberOfResults
+                            resultGenerator:(NSDictionary * (^)(NSUInteger))resultGenerator
+{
+    NSMutableArray *results = [NSMutableArray arrayWithCapacity:numberOfResults];
+    for (NSUInteger index = 0; index < numberOfResults; index++) {
+        [results addObject:resultGenerator(index)];
+    }
+    return [self responseWithJSONObject:@{ @"results": results } statusCode:200];
+}
+
+@end
+
+@implementation NBTestTransportConditions
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.rateLimitWindow = 1.0f;
+        self.seed = 1;
+    }
+    return self;
+}
+
++ (instancetype)conditionsWithLatency:(NSTimeInterval)latency bandwidth:(NSUInteger)bandwidth
+{
+    NBTestTransportConditions *conditions = [[self alloc] init];
+    conditions.latency = latency;
+    conditions.bandwidth = bandwidth;
+    return conditions;
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+    NBTestTransportConditions *conditions = [[self.class allocWithZone:zone] init];
+    conditions.latency = self.latency;
+    conditions.jitter = self.jitter;
+    conditions.bandwidth = self.bandwidth;
+    conditions.errorRate = self.errorRate;
+    conditions.rateLimit = self.rateLimit;
+    conditions.rateLimitWindow = self.rateLimitWindow;
+    conditions.seed = self.seed;
+    return conditions;
+}
+
+@end
+
+// Shared by all instances, which the URL loading system creates. Guarded by
+// synchronizing on the class.
+static NBTestTransportConditions *Conditions;
+static NSMutableArray *Responders;
+static unsigned int RandomState;
+static NSDate *RateLimitWindowStartDate;
+static NSUInteger NumberOfRequestsInWindow;
+static NSUInteger NumberOfRequests;
+static NSUInteger NumberOfRateLimitedRequests;
+static NSUInteger NumberOfConcurrentRequests;
+static NSUInteger MaximumNumberOfConcurrentRequests;
+static CFAbsoluteTime LinkIdleTime; // Once every chunk sent so far has arrived.
+
+@interface NBTestTransport ()
+
+@property (nonatomic) NSThread *clientThread;
+@property (nonatomic, copy) NSArray *clientRunLoopModes;
+@property (nonatomic) dispatch_queue_t queue;
+@property (atomic, getter = isStopped) BOOL stopped;
+
++ (double)nextRandomValue;
++ (NSString *)relativePathForURL:(NSURL *)url;
++ (BOOL)path:(NSString *)path matchesPattern:(NSString *)pattern;
+
+- (void)performOnClientThread:(dispatch_block_t)block;
+- (void)runBlock:(dispatch_block_t)block;
+- (void)sendResponse:(NBTestTransportResponse *)response
+     afterTimeInterval:(NSTimeInterval)delay
+           conditions:(NBTestTransportConditions *)conditions;
+- (void)sendData:(NSData *)data fromOffset:(NSUInteger)offset bandwidth:(NSUInteger)bandwidth;
+- (void)finishLoading;
+
+@end
+
+@implementation NBTestTransport
+
++ (void)initialize
+{
+    if (self == [NBTestTransport class]) {
+        [self reset];
+    }
+}
+
++ (NSURLSessionConfiguration *)sessionConfiguration
+{
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+    configuration.protocolClasses = @[ self ];
+    return configuration;
+}
+
++ (NBTestTransportConditions *)conditions
+{
+    @synchronized(self) {
+        return [Conditions copy];
+    }
+}
+
++ (void)setConditions:(NBTestTransportConditions *)conditions
+{
+    @synchronized(self) {
+        Conditions = [conditions copy] ?: [[NBTestTransportConditions alloc] init];
+        RandomState = Conditions.seed;
+        RateLimitWindowStartDate = nil;
+        NumberOfRequestsInWindow = 0;
+        LinkIdleTime = 0.0f;
+    }
+}
+
++ (void)addResponderForMethod:(NSString *)method path:(NSString *)path responder:(NBTestTransportResponder)responder
+{
+    @synchronized(self) {
+        [Responders addObject:@[ method.uppercaseString, path, [responder copy] ]];
+    }
+}
+
++ (void)addFixtureResponderForMethod:(NSString *)method path:(NSString *)path
+{
+    // ie. 'people/:id/contacts' => 'people_id_contacts_get'
+    NSString *fixtureName = [NSString stringWithFormat:@"%@_%@",
+                             [[path stringByReplacingOccurrencesOfString:@"/" withString:@"_"]
+                              stringByReplacingOccurrencesOfString:@":" withString:@""],
+                             method.lowercaseString];
+    NBTestTransportResponse *response = [NBTestTransportResponse responseWithFixtureNamed:fixtureName];
+    [self addResponderForMethod:method path:path responder:^(NSURLRequest *request) {
+        return response;
+    }];
+}
+
++ (void)reset
+{
+    @synchronized(self) {
+        Responders = [NSMutableArray array];
+        NumberOfRequests = 0;
+        NumberOfRateLimitedRequests = 0;
+        MaximumNumberOfConcurrentRequests = 0;
+    }
+    [self setConditions:nil];
+}
+
++ (NSUInteger)numberOfRequests
+{
+    @synchronized(self) {
+        return NumberOfRequests;
+    }
+}
+
++ (NSUInteger)numberOfRateLimitedRequests
+{
+    @synchronized(self) {
+        return NumberOfRateLimitedRequests;
+    }
+}
+
++ (NSUInteger)maximumNumberOfConcurrentRequests
+{
+    @synchronized(self) {
+        return MaximumNumberOfConcurrentRequests;
+    }
+}
+
+#pragma mark - NSURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request
+{
+    return [@[ @"http", @"https" ] containsObject:request.URL.scheme.lowercaseString];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request
+{
+    return request;
+}
+
+- (void)startLoading
+{
+    self.clientThread = [NSThread currentThread];
+    self.clientRunLoopModes = @[ [NSRunLoop currentRunLoop].currentMode ?: NSDefaultRunLoopMode ];
+    self.queue = dispatch_queue_create("com.nationbuilder.test-transport", DISPATCH_QUEUE_SERIAL);
+    NBTestTransportConditions *conditions;
+    NBTestTransportResponse *response;
+    NSTimeInterval delay;
+    BOOL shouldFail = NO;
+    Class transportClass = self.class;
+    @synchronized(transportClass) {
+        conditions = [Conditions copy];
+        NumberOfRequests += 1;
+        NumberOfConcurrentRequests += 1;
+        MaximumNumberOfConcurrentRequests = MAX(MaximumNumberOfConcurrentRequests, NumberOfConcurrentRequests);
+        delay = conditions.latency + conditions.jitter * [transportClass nextRandomValue];
+        shouldFail = conditions.errorRate > 0.0f && [transportClass nextRandomValue] < conditions.errorRate;
+        // Fixed windows, like the API's.
+        NSDate *now = [NSDate date];
+        if (!RateLimitWindowStartDate || [now timeIntervalSinceDate:RateLimitWindowStartDate] >= conditions.rateLimitWindow) {
+            RateLimitWindowStartDate = now;
+            NumberOfRequestsInWindow = 0;
+        }
+        NumberOfRequestsInWindow += 1;
+        if (conditions.rateLimit && NumberOfRequestsInWindow > conditions.rateLimit) {
+            NumberOfRateLimitedRequests += 1;
+            NSTimeInterval retryAfter = conditions.rateLimitWindow - [now timeIntervalSinceDate:RateLimitWindowStartDate];
+            response = [NBTestTransportResponse responseWithJSONObject:@{ @"code": @"rate_limit_exceeded",
+                                                                          @"message": @"You have exceeded your rate limit." }
+                                                            statusCode:429];
+            NSMutableDictionary *headers = response.headers.mutableCopy;
+            headers[@"Retry-After"] = [NSString stringWithFormat:@"%.0f", ceil(retryAfter)];
+            response.headers = headers;
+        }
+        NSString *path = [transportClass relativePathForURL:self.request.URL];
+        for (NSArray *responder in Responders) {
+            if (response) {
+                break;
+            }
+            if ([responder[0] isEqualToString:self.request.HTTPMethod.uppercaseString] &&
+                [transportClass path:path matchesPattern:responder[1]])
+            {
+                response = ((NBTestTransportResponder)responder[2])(self.request);
+            }
+        }
+    }
+    response = response ?: [NBTestTransportResponse responseWithJSONObject:@{ @"code": @"not_found", @"message": @"Record not found" }
+                                                               statusCode:404];
+    if (shouldFail) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, ^{
+            if (self.isStopped) {
+                return;
+            }
+            [self performOnClientThread:^{
+                [self.client URLProtocol:self didFailWithError:[NSError errorWithDomain:NSURLErrorDomain
+                                                                                   code:NSURLErrorNetworkConnectionLost userInfo:nil]];
+            }];
+            [self finishLoading];
+        });
+        return;
+    }
+    [self sendResponse:response afterTimeInterval:delay conditions:conditions];
+}
+
+- (void)stopLoading
+{
+    [self finishLoading];
+}
+
+#pragma mark - Private
+
++ (double)nextRandomValue
+{
+    return (double)rand_r(&RandomState) / ((double)RAND_MAX + 1.0f);
+}
+
++ (NSString *)relativePathForURL:(NSURL *)url
+{
+    // ie. '/api/v1/tags' => 'tags'
+    NSArray *pathComponents = url.pathComponents;
+    if (pathComponents.count > 3 && [pathComponents[1] isEqualToString:@"api"]) {
+        pathComponents = [pathComponents subarrayWithRange:NSMakeRange(3, pathComponents.count - 3)];
+    }
+    return [pathComponents componentsJoinedByString:@"/"];
+}
+
++ (BOOL)path:(NSString *)path matchesPattern:(NSString *)pattern
+{
+    NSArray *components = [path componentsSeparatedByString:@"/"];
+    NSArray *patternComponents = [pattern componentsSeparatedByString:@"/"];
+    if (components.count != patternComponents.count) {
+        return NO;
+    }
+    for (NSUInteger index = 0; index < components.count; index++) {
+        NSString *patternComponent = patternComponents[index];
+        if (![patternComponent hasPrefix:@":"] && ![patternComponent isEqualToString:components[index]]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+- (void)performOnClientThread:(dispatch_block_t)block
+{
+    [self performSelector:@selector(runBlock:) onThread:self.clientThread withObject:[block copy]
+            waitUntilDone:NO modes:self.clientRunLoopModes];
+}
+
+- (void)runBlock:(dispatch_block_t)block
+{
+    block();
+}
+
+- (void)sendResponse:(NBTestTransportResponse *)response
+   afterTimeInterval:(NSTimeInterval)delay
+          conditions:(NBTestTransportConditions *)conditions
+{
+    NSMutableDictionary *headers = response.headers.mutableCopy;
+    headers[@"Content-Length"] = [NSString stringWithFormat:@"%lu", (unsigned long)response.data.length];
+    NSHTTPURLResponse *urlResponse = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:response.statusCode
+                                                                HTTPVersion:@"HTTP/1.1" headerFields:headers];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, ^{
+        if (self.isStopped) {
+            return;
+        }
+        [self performOnClientThread:^{
+            [self.client URLProtocol:self didReceiveResponse:urlResponse cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+        }];
+        [self sendData:response.data fromOffset:0 bandwidth:conditions.bandwidth];
+    });
+}
+
+- (void)sendData:(NSData *)data fromOffset:(NSUInteger)offset bandwidth:(NSUInteger)bandwidth
+{
+    if (self.isStopped) {
+        return;
+    }
+    if (offset >= data.length) {
+        [self performOnClientThread:^{
+            [self.client URLProtocolDidFinishLoading:self];
+        }];
+        [self finishLoading];
+        return;
+    }
+    NSData *chunk = [data subdataWithRange:NSMakeRange(offset, MIN(ChunkSize, data.length - offset))];
+    // Responses in flight share the link: each chunk waits its turn, so
+    // together they never go faster than the bandwidth.
+    NSTimeInterval transferDelay = 0.0f;
+    if (bandwidth) {
+        @synchronized(self.class) {
+            CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+            LinkIdleTime = MAX(LinkIdleTime, now) + (double)chunk.length / bandwidth;
+            transferDelay = LinkIdleTime - now;
+        }
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(transferDelay * NSEC_PER_SEC)), self.queue, ^{
+        if (self.isStopped) {
+            return;
+        }
+        [self performOnClientThread:^{
+            [self.client URLProtocol:self didLoadData:chunk];
+        }];
+        [self sendData:data fromOffset:offset + chunk.length bandwidth:bandwidth];
+    });
+}
+
+- (void)finishLoading
+{
+    // Once, whether finished or stopped.
+    @synchronized(self.class) {
+        if (self.isStopped) {
+            return;
+        }
+        self.stopped = YES;
+        NumberOfConcurrentRequests -= 1;
+    }
+}
+
+@end
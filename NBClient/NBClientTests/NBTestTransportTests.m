@@ -0,0 +1,183 @@
+//
+//  NBTestTransportTests.m
+//  NBClient
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBTestCase.h"
+#import "NBTestTransport.h"
+
+#import "NBClient.h"
+#import "NBClient+Composites.h"
+#import "NBClient+Contacts.h"
+#import "NBClient+People.h"
+#import "NBPaginationInfo.h"
+
+@interface NBTestTransportTests : NBTestCase
+
+@property (nonatomic) NBClient *transportClient;
+
+@end
+
+@implementation NBTestTransportTests
+
+- (void)setUp
+{
+    [super setUp];
+    // Nocilla hooks every session, so it has to step aside.
+    if (self.shouldUseHTTPStubbing) {
+        [[LSNocilla sharedInstance] stop];
+    }
+    [NBTestTransport reset];
+    NSURLSession *urlSession = [NSURLSession sessionWithConfiguration:[NBTestTransport sessionConfiguration]];
+    self.transportClient = [[NBClient alloc] initWithNationSlug:self.nationSlug apiKey:self.testToken customBaseURL:self.baseURL
+                                      customURLSession:urlSession customURLSessionConfiguration:nil];
+}
+
+- (void)tearDown
+{
+    [super tearDown];
+    [NBTestTransport reset];
+    if (self.shouldUseHTTPStubbing) {
+        [[LSNocilla sharedInstance] start];
+    }
+}
+
+#pragma mark - Helpers
+
+- (void)addPeopleResponderWithNumberOfPages:(NSUInteger)numberOfPages numberOfPeoplePerPage:(NSUInteger)numberOfPeoplePerPage
+{
+    [NBTestTransport addResponderForMethod:@"GET" path:@"people" responder:^(NSURLRequest *request) {
+        NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO];
+        NSUInteger pageNumber = 1;
+        for (NSURLQueryItem *item in components.queryItems) {
+            if ([item.name isEqualToString:NBClientCurrentPageNumberKey]) {
+                pageNumber = (NSUInteger)item.value.integerValue;
+            }
+        }
+        NSMutableArray *results = [NSMutableArray array];
+        for (NSUInteger index = 0; index < numberOfPeoplePerPage; index++) {
+            NSUInteger identifier = (pageNumber - 1) * numberOfPeoplePerPage + index + 1;
+            [results addObject:@{ @"id": @(identifier), @"first_name": @"Foo", @"last_name": [NSString stringWithFormat:@"Bar %lu", (unsigned long)identifier],
+                                  @"email": [NSString stringWithFormat:@"foo%lu@example.com", (unsigned long)identifier], @"support_level": @1 }];
+        }
+        return [NBTestTransportResponse responseWithJSONObject:@{ @"results": results,
+                                                                  NBClientCurrentPageNumberKey: @(pageNumber),
+                                                                  NBClientNumberOfTotalPagesKey: @(numberOfPages),
+                                                                  NBClientNumberOfItemsPerPageKey: @(numberOfPeoplePerPage),
+                                                                  NBClientNumberOfTotalItemsKey: @(numberOfPages * numberOfPeoplePerPage) }
+                                                    statusCode:200];
+    }];
+}
+
+#pragma mark - Tests
+
+- (void)testLatencyAndBandwidth
+{
+    [self setUpAsync];
+    // Given: a 300 ms, 1 Mbps link.
+    [NBTestTransport setConditions:[NBTestTransportConditions conditionsWithLatency:0.3f bandwidth:125000]];
+    [NBTestTransport addFixtureResponderForMethod:@"GET" path:@"settings/contact_methods"];
+    NSUInteger numberOfBytes = [NBTestTransportResponse responseWithFixtureNamed:@"settings_contact_methods_get"].data.length;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    // When:
+    [self.transportClient fetchContactMethodsWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+        // Then:
+        XCTAssertNil(error);
+        XCTAssertTrue(items.count > 0,
+                      @"Fixtures should be served.");
+        XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - startTime, 0.3f + numberOfBytes / 125000.0f,
+                                    @"Responses should take the latency plus the transfer time.");
+        [self completeAsync];
+    }];
+    [self tearDownAsync];
+}
+
+- (void)testSharingBandwidth
+{
+    [self setUpAsync];
+    // Given: a slow link.
+    [NBTestTransport setConditions:[NBTestTransportConditions conditionsWithLatency:0.1f bandwidth:20000]];
+    [NBTestTransport addFixtureResponderForMethod:@"GET" path:@"settings/contact_methods"];
+    NSUInteger numberOfBytes = [NBTestTransportResponse responseWithFixtureNamed:@"settings_contact_methods_get"].data.length;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    __block NSUInteger numberOfResponses = 0;
+    // When: making 3 requests at once.
+    for (NSUInteger index = 0; index < 3; index++) {
+        [self.transportClient fetchContactMethodsWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+            XCTAssertNil(error);
+            numberOfResponses += 1;
+            if (numberOfResponses < 3) {
+                return;
+            }
+            // Then:
+            XCTAssertGreaterThanOrEqual(CFAbsoluteTimeGetCurrent() - startTime, 0.1f + 3 * numberOfBytes / 20000.0f,
+                                        @"Concurrent responses should share the bandwidth.");
+            [self completeAsync];
+        }];
+    }
+    [self tearDownAsync];
+}
+
+- (void)testFetchingLegacyPagesConcurrentlyOverSlowLink
+{
+    [self setUpAsync];
+    // Given: a slow link, and many pages.
+    [NBTestTransport setConditions:[NBTestTransportConditions conditionsWithLatency:0.3f bandwidth:125000]];
+    [self addPeopleResponderWithNumberOfPages:8 numberOfPeoplePerPage:100];
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
+    paginationInfo.numberOfItemsPerPage = 100;
+    self.transportClient.shouldUseLegacyPagination = YES;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    // When:
+    [self.transportClient
+     fetchAllPagesWithPaginationInfo:paginationInfo maximumNumberOfConcurrentPages:4
+     pageFetcher:^NSURLSessionDataTask *(NBPaginationInfo *pageInfo, NBClientResourceListCompletionHandler pageHandler) {
+         return [self.transportClient fetchPeopleWithPaginationInfo:pageInfo completionHandler:pageHandler];
+     }
+     completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+         // Then:
+         XCTAssertNil(error);
+         XCTAssertEqual(items.count, 800);
+         XCTAssertEqual([NBTestTransport maximumNumberOfConcurrentRequests], 4,
+                        @"Pages should be fetched up to the limit at once.");
+         XCTAssertLessThan(CFAbsoluteTimeGetCurrent() - startTime, 8 * 0.3f,
+                           @"Concurrent pages should take less than their total latency.");
+         [self completeAsync];
+     }];
+    [self tearDownAsync];
+}
+
+- (void)testRateLimiting
+{
+    [self setUpAsync];
+    // Given: a limit of 2 requests per window.
+    NBTestTransportConditions *conditions = [NBTestTransportConditions conditionsWithLatency:0.05f bandwidth:0];
+    conditions.rateLimit = 2;
+    conditions.rateLimitWindow = 10.0f;
+    [NBTestTransport setConditions:conditions];
+    [NBTestTransport addFixtureResponderForMethod:@"GET" path:@"settings/contact_statuses"];
+    __block NSUInteger numberOfResponses = 0;
+    __block NSUInteger numberOfRateLimitedResponses = 0;
+    // When: making 3 requests.
+    for (NSUInteger index = 0; index < 3; index++) {
+        [self.transportClient fetchContactStatusesWithCompletionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+            numberOfResponses += 1;
+            if ([error.userInfo[NBClientErrorHTTPStatusCodeKey] integerValue] == 429) {
+                numberOfRateLimitedResponses += 1;
+            }
+            if (numberOfResponses < 3) {
+                return;
+            }
+            // Then:
+            XCTAssertEqual(numberOfRateLimitedResponses, 1,
+                           @"Requests beyond the limit should get a 429.");
+            XCTAssertEqual([NBTestTransport numberOfRateLimitedRequests], 1);
+            [self completeAsync];
+        }];
+    }
+    [self tearDownAsync];
+}
+
+@end
@@ -48,6 +48,11 @@
     [NBClient updateLoggingToLevel:NBLogLevelWarning];
     // You can also implement NBLogging in your own classes and use the NBLog macros.
     [NBPeopleViewFlowLayout updateLoggingToLevel:NBLogLevelInfo];
+#if DEBUG
+    // Record frame times while scrolling people and main-thread stalls, to
+    // compare builds. The report is saved to Documents on backgrounding.
+    [NBPerformanceMonitor sharedMonitor].enabled = YES;
+#endif
 #if defined(DEBUG) && TARGET_IPHONE_SIMULATOR
     // NOTE: This configuration file is meant for internal use only, unless
     // you have a development-specific set of NationBuilder configuration.
@@ -63,6 +68,9 @@
     // Pass our account button to the view controller that will show it for
     // further configuration. Please refer to the method for configuration options.
     [self.peopleViewController showAccountButton:self.accountButton];
+    // Keep the selected account's people warm for the next launch. The
+    // refresh scheduler has its own minimum interval and budget.
+    [application setMinimumBackgroundFetchInterval:UIApplicationBackgroundFetchIntervalMinimum];
     // Boilerplate.
     self.window = [[UIWindow alloc] initWithFrame:[[UIScreen mainScreen] bounds]];
     self.window.rootViewController = [[UINavigationController alloc] initWithRootViewController:self.peopleViewController];
@@ -71,6 +79,20 @@
     return YES;
 }
 
+- (void)applicationDidEnterBackground:(UIApplication *)application
+{
+    NBPerformanceMonitor *monitor = [NBPerformanceMonitor sharedMonitor];
+    if (!monitor.isEnabled) {
+        return;
+    }
+    NSURL *documentsURL = [[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask].firstObject;
+    NSString *fileName = [NSString stringWithFormat:@"performance-report-%@.json", monitor.buildIdentifier];
+    NSError *error;
+    if (![monitor writeReportToURL:[documentsURL URLByAppendingPathComponent:fileName] error:&error]) {
+        NBLog(@"WARNING: Failed to save performance report: %@", error);
+    }
+}
+
 - (BOOL)application:(UIApplication *)application openURL:(NSURL *)url sourceApplication:(NSString *)sourceApplication annotation:(id)annotation
 {
     NBLog(@"INFO: Finishing authenticating with URL: %@", url);
@@ -83,6 +105,16 @@
     return NO;
 }
 
+- (void)application:(UIApplication *)application performFetchWithCompletionHandler:(void (^)(UIBackgroundFetchResult))completionHandler
+{
+    NBClientRefreshScheduler *refreshScheduler = self.account.refreshScheduler;
+    if (!refreshScheduler) {
+        completionHandler(UIBackgroundFetchResultNoData);
+        return;
+    }
+    [refreshScheduler performRefreshWithCompletionHandler:completionHandler];
+}
+
 #pragma mark - NBAuthenticatorPresentationDelegate
 
 - (void)presentWebBrowserForAuthenticationWithRedirectPath:(SFSafariViewController *)webBrowser
@@ -121,7 +153,19 @@
     // If we have a new / different account.
     if (account) {
         // Clear out our data.
-        self.peopleViewController.dataSource = [[NBPeopleViewDataSource alloc] initWithClient:account.client];
+        NBPeopleViewDataSource *dataSource = [[NBPeopleViewDataSource alloc] initWithClient:account.client];
+        // Store pages the size the view shows.
+        account.refreshScheduler.numberOfItemsPerPage = dataSource.paginationInfo.numberOfItemsPerPage;
+        dataSource.refreshScheduler = account.refreshScheduler;
+        // Show the last launch's first pages right away.
+        if (account.identifier != NSNotFound) {
+            NSURL *cachesURL = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+            NSString *fileName = [NSString stringWithFormat:@"%@-%lu.snapshot",
+                                  account.clientInfo[NBInfoNationSlugKey], (unsigned long)account.identifier];
+            dataSource.snapshotURL = [[cachesURL URLByAppendingPathComponent:@"com.nationbuilder.people-snapshots" isDirectory:YES]
+                                      URLByAppendingPathComponent:fileName];
+        }
+        self.peopleViewController.dataSource = dataSource;
         // If the accounts view was shown to sign in initially, the user probably just wants to start using the app.
         if (!self.peopleViewController.ready) {
             // Dismiss the accounts view if needed.
@@ -10,6 +10,7 @@
 #import <NBClient/NBPaginationInfo.h>
 
 #import <NBClient/UI/NBAccountButton.h>
+#import <NBClient/UI/NBPerformanceMonitor.h>
 #import <NBClient/UI/UIKitAdditions.h>
 
 #import "NBPeopleViewDataSource.h"
@@ -27,6 +28,8 @@ static NSUInteger SectionHeaderPaginationItemLabelTag = 2;
 
 static NSString *ShowPersonSegueIdentifier = @"ShowPersonSegue";
 
+static NSString *ScrollInteractionName = @"people.scroll";
+
 static NSDictionary *DefaultNibNames;
 
 static NSString *PeopleKeyPath;
@@ -54,6 +57,10 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 @property (nonatomic) NBScrollViewPullActionState refreshState;
 @property (nonatomic) NBScrollViewPullActionState loadMoreState;
 
+// Shared by cells, and rebuilt when the item width changes, ie. on rotation.
+@property (nonatomic) NBPersonCellViewLayout *cellLayout;
+@property (nonatomic) CGFloat cellLayoutItemWidth;
+
 - (void)fetchIfNeeded;
 - (IBAction)presentPersonView:(id)sender;
 
@@ -161,6 +168,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     dispatch_once(&onceToken, ^{
         [self completePaginationSetup];
     });
+    CGFloat itemWidth = ((NBPeopleViewFlowLayout *)self.collectionViewLayout).itemSize.width;
+    if (itemWidth != self.cellLayoutItemWidth) {
+        self.cellLayoutItemWidth = itemWidth;
+        self.cellLayout = nil;
+    }
 }
 
 - (void)didRotateFromInterfaceOrientation:(UIInterfaceOrientation)fromInterfaceOrientation
@@ -259,7 +271,9 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
                 self.refreshState = NBScrollViewPullActionStateStopped;
             }
         }
-        [self.collectionView reloadData];
+        [[NBPerformanceMonitor sharedMonitor] performOperationWithName:@"people.reload" usingBlock:^{
+            [self.collectionView reloadData];
+        }];
     } else if ([keyPath isEqualToString:NBViewDataSourceErrorKeyPath] && self.dataSource.error) {
         if (self.isBusy) { // If we were busy refreshing data, now we're not.
             self.busy = NO;
@@ -289,11 +303,20 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 - (UICollectionViewCell *)collectionView:(UICollectionView *)collectionView cellForItemAtIndexPath:(NSIndexPath *)indexPath
 {
+    NBPerformanceMonitor *monitor = [NBPerformanceMonitor sharedMonitor];
+    NSUInteger operation = [monitor beginOperationWithName:@"people.cell"];
     NBPersonCellView *cell = (id)[collectionView dequeueReusableCellWithReuseIdentifier:CellReuseIdentifier forIndexPath:indexPath];
     NBPeopleViewDataSource *dataSource = (id)self.dataSource;
+    if (!self.cellLayout) {
+        self.cellLayout = cell.viewModelLayout;
+        // Rebuilds view models for the new cell size.
+        dataSource.cellLayout = self.cellLayout;
+    }
+    cell.sharedViewModelLayout = self.cellLayout;
     NSUInteger index = [dataSource.paginationInfo indexOfFirstItemAtPage:(indexPath.section + 1)] + indexPath.item;
-    cell.dataSource = [(id)self.dataSource dataSourceForItemAtIndex:index];
+    cell.dataSource = [dataSource dataSourceForItemAtIndex:index];
     cell.delegate = self;
+    [monitor endOperation:operation];
     return cell;
 }
 
@@ -342,14 +365,46 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 #pragma mark - UICollectionViewDelegate
 
+- (void)collectionView:(UICollectionView *)collectionView willDisplayCell:(UICollectionViewCell *)cell forItemAtIndexPath:(NSIndexPath *)indexPath
+{
+    NBPeopleViewDataSource *dataSource = (id)self.dataSource;
+    // Evicts pages far from what's visible and refetches evicted ones coming into view.
+    [dataSource didShowItemAtIndex:[dataSource.paginationInfo indexOfFirstItemAtPage:(indexPath.section + 1)] + indexPath.item];
+}
+
 - (void)collectionView:(UICollectionView *)collectionView didSelectItemAtIndexPath:(NSIndexPath *)indexPath
 {
+    NBPeopleViewDataSource *dataSource = (id)self.dataSource;
+    NSUInteger index = [dataSource.paginationInfo indexOfFirstItemAtPage:(indexPath.section + 1)] + indexPath.item;
+    if (![dataSource isItemResidentAtIndex:index]) {
+        // Still refetching, so there's no person to present yet.
+        [collectionView deselectItemAtIndexPath:indexPath animated:YES];
+        [dataSource didShowItemAtIndex:index];
+        return;
+    }
     self.selectedIndexPath = indexPath;
     [self performSegueWithIdentifier:ShowPersonSegueIdentifier sender:self];
 }
 
 #pragma mark - UIScrollViewDelegate
 
+- (void)scrollViewWillBeginDragging:(UIScrollView *)scrollView
+{
+    [[NBPerformanceMonitor sharedMonitor] beginInteractionWithName:ScrollInteractionName];
+}
+
+- (void)scrollViewDidEndDragging:(UIScrollView *)scrollView willDecelerate:(BOOL)decelerate
+{
+    if (!decelerate) {
+        [[NBPerformanceMonitor sharedMonitor] endInteraction];
+    }
+}
+
+- (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView
+{
+    [[NBPerformanceMonitor sharedMonitor] endInteraction];
+}
+
 - (void)scrollViewDidScroll:(UIScrollView *)scrollView
 {
     if (!self.isReady) { return; }
@@ -531,6 +586,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         NBPaginationInfo *paginationInfo = ((NBPeopleViewDataSource *)self.dataSource).paginationInfo;
         NSUInteger startItemIndex = [paginationInfo indexOfFirstItemAtPage:(self.selectedIndexPath.section + 1)];
         viewController.dataSource = [(id)self.dataSource dataSourceForItemAtIndex:startItemIndex + self.selectedIndexPath.item];
+        if (!viewController.dataSource) {
+            NBLogWarning(@"Not presenting person at %@, which was evicted", self.selectedIndexPath);
+            self.selectedIndexPath = nil;
+            return;
+        }
     }
     self.navigationController.delegate = self;
     if (shouldPresentAsModal) {
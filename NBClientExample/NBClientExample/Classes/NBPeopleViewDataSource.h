@@ -9,11 +9,38 @@
 
 #import "NBUIDefines.h"
 
+@class NBClientRefreshScheduler;
+@class NBPersonCellViewLayout;
+
 @interface NBPeopleViewDataSource : NSObject <NBCollectionViewDataSource>
 
+// Only people that are resident, so use `paginationInfo` for counts and
+// indexes.
 @property (nonatomic, copy, readonly) NSArray *people;
 @property (nonatomic, copy, readonly) NSDictionary *personDataSources;
 
+// Pages beyond this window around the last shown page are evicted, along
+// with their person data sources, and refetched when shown again. Defaults to
+// 5.
+@property (nonatomic) NSUInteger maximumNumberOfResidentPages;
+// If set, the first page it refreshed in the background is shown while
+// fetching it again.
+@property (nonatomic, weak) NBClientRefreshScheduler *refreshScheduler;
+// If set, the first pages are saved to it as a people snapshot whenever they
+// change, and the first fetch shows them right away, then refetches them.
+@property (nonatomic, copy) NSURL *snapshotURL;
+// Defaults to 2.
+@property (nonatomic) NSUInteger maximumNumberOfSnapshotPages;
+// If set, cell view models for people are built on a background queue as pages
+// arrive, and rebuilt when a person or the layout changes.
+@property (nonatomic) NBPersonCellViewLayout *cellLayout;
+
 - (void)fetchAll;
 
+// If not, `-dataSourceForItemAtIndex:` returns nil.
+- (BOOL)isItemResidentAtIndex:(NSUInteger)index;
+// Call as items come into view. Evicts pages outside the window around the
+// item's page and refetches it if evicted.
+- (void)didShowItemAtIndex:(NSUInteger)index;
+
 @end
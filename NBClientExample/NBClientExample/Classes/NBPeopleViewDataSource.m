@@ -7,11 +7,20 @@
 
 #import "NBPeopleViewDataSource.h"
 
+#import <NBClient/FoundationAdditions.h>
 #import <NBClient/NBClient+People.h>
+#import <NBClient/NBClientPeopleSnapshot.h>
+#import <NBClient/NBClientRefreshScheduler.h>
+#import <NBClient/NBClientTaskGroup.h>
 #import <NBClient/NBPaginationInfo.h>
+#import <NBClient/UI/NBPerformanceMonitor.h>
 
+#import "NBPersonCellViewModel.h"
 #import "NBPersonViewDataSource.h"
 
+static NSUInteger DefaultMaximumNumberOfResidentPages = 5;
+static NSUInteger DefaultMaximumNumberOfSnapshotPages = 2;
+
 #if DEBUG
 static NBLogLevel LogLevel = NBLogLevelDebug;
 #else
@@ -22,8 +31,39 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 @property (nonatomic, weak, readwrite) NBClient *client;
 
-@property (nonatomic, copy, readwrite) NSArray *people;
+// People by index, with `NSNull` for evicted ones so indexes stay stable.
+@property (nonatomic, copy) NSArray *slots;
 @property (nonatomic) NSMutableDictionary *mutablePersonDataSources;
+// Page fetches in flight, cancelled on clean-up.
+@property (nonatomic) NBClientTaskGroup *taskGroup;
+
+// Windowing: pages far from the focus page are evicted.
+@property (nonatomic) NSUInteger focusPageNumber;
+@property (nonatomic) NSMutableDictionary *pageCursors; // Page numbers to pagination info dictionaries.
+@property (nonatomic) NSMutableSet *fetchingPageNumbers;
+@property (nonatomic) NSMutableSet *evictedPersonIdentifiers;
+
+// Snapshot: only shown on the first fetch, ie. at launch.
+@property (nonatomic) BOOL didShowSnapshot;
+// Partial people from the snapshot, read-only until refetched.
+@property (nonatomic) NSMutableSet *snapshotPersonIdentifiers;
+@property (nonatomic) dispatch_queue_t snapshotQueue;
+
+// Cell view models: built off the main queue, by person identifier.
+@property (nonatomic) NSMutableDictionary *cellViewModels;
+@property (nonatomic) NSMutableDictionary *pendingCellViewModelPeople;
+@property (nonatomic) NSUInteger cellViewModelGeneration; // Results of older generations are dropped.
+@property (nonatomic) dispatch_queue_t cellViewModelQueue;
+
++ (NSArray *)residentPeopleInSlots:(NSArray *)slots;
+- (BOOL)showSnapshot;
+- (void)saveSnapshot;
+- (void)replaceSnapshotPeopleWithPeople:(NSArray *)people;
+- (BOOL)isPageResident:(NSUInteger)pageNumber;
+- (void)fetchPage:(NSUInteger)pageNumber;
+- (void)evictPagesOutsideWindow;
+- (void)prepareCellViewModels;
+- (void)resetCellViewModels;
 
 @end
 
@@ -40,6 +80,18 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     self = [super init];
     if (self) {
         self.client = client;
+        self.taskGroup = [[NBClientTaskGroup alloc] init];
+        self.maximumNumberOfResidentPages = DefaultMaximumNumberOfResidentPages;
+        self.maximumNumberOfSnapshotPages = DefaultMaximumNumberOfSnapshotPages;
+        self.snapshotQueue = dispatch_queue_create("com.nationbuilder.people-snapshot", DISPATCH_QUEUE_SERIAL);
+        self.snapshotPersonIdentifiers = [NSMutableSet set];
+        self.cellViewModels = [NSMutableDictionary dictionary];
+        self.pendingCellViewModelPeople = [NSMutableDictionary dictionary];
+        self.cellViewModelQueue = dispatch_queue_create("com.nationbuilder.person-cell-view-models", DISPATCH_QUEUE_SERIAL);
+        self.focusPageNumber = 1;
+        self.pageCursors = [NSMutableDictionary dictionary];
+        self.fetchingPageNumbers = [NSMutableSet set];
+        self.evictedPersonIdentifiers = [NSMutableSet set];
         self.paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:YES];
     }
     return self;
@@ -47,13 +99,14 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 #pragma mark - Public
 
++ (NSSet *)keyPathsForValuesAffectingPeople
+{
+    return [NSSet setWithObject:NSStringFromSelector(@selector(slots))];
+}
+
 - (NSArray *)people
 {
-    if (_people) {
-        return _people;
-    }
-    self.people = @[];
-    return _people;
+    return _people ?: @[];
 }
 
 - (NSDictionary *)personDataSources
@@ -61,20 +114,61 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     return [NSDictionary dictionaryWithDictionary:self.mutablePersonDataSources];
 }
 
+- (void)setCellLayout:(NBPersonCellViewLayout *)cellLayout
+{
+    // Guard.
+    if (cellLayout == _cellLayout || [cellLayout isEqual:_cellLayout]) { return; }
+    // Set.
+    _cellLayout = cellLayout;
+    // Did.
+    [self resetCellViewModels];
+    [self prepareCellViewModels];
+}
+
 - (void)fetchAll
 {
-    [self.client fetchPeopleWithPaginationInfo:self.paginationInfo completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
-        if (error) {
-            self.error = [self.class parseClientError:error];
-            return;
-        }
-        self.paginationInfo = paginationInfo;
-        NSArray *people = [self.class parseClientResults:items];
-        if (self.paginationInfo.currentPageNumber > 1) {
-            self.people = [self.people arrayByAddingObjectsFromArray:people];
-        } else {
-            self.people = people;
+    [self.refreshScheduler collectionWasUsed:NBClientRefreshPeopleKey];
+    if (!self.slots.count && !self.didShowSnapshot && [self showSnapshot]) {
+        // Refetch the shown pages in the background. Loading more continues
+        // from the snapshot's cursor.
+        for (NSUInteger pageNumber = 1; pageNumber <= self.paginationInfo.currentPageNumber; pageNumber++) {
+            [self fetchPage:pageNumber];
         }
+        return;
+    }
+    self.didShowSnapshot = YES;
+    NSArray *cachedItems = [self.refreshScheduler cachedItemsForCollectionKey:NBClientRefreshPeopleKey];
+    if (!self.slots.count && cachedItems.count && cachedItems.count <= self.paginationInfo.numberOfItemsPerPage) {
+        NBLogInfo(@"Showing %lu cached people while fetching", (unsigned long)cachedItems.count);
+        self.slots = [self.class parseClientResults:cachedItems];
+    }
+    [self.client performRequestsInTaskGroup:self.taskGroup usingBlock:^{
+        [self.client fetchPeopleWithPaginationInfo:self.paginationInfo completionHandler:^(NSArray *items, NBPaginationInfo *paginationInfo, NSError *error) {
+            if (error) {
+                if (!error.nb_isCancellation) {
+                    self.error = [self.class parseClientError:error];
+                }
+                return;
+            }
+            NSUInteger operation = [[NBPerformanceMonitor sharedMonitor] beginOperationWithName:@"people.fetch"];
+            self.paginationInfo = paginationInfo;
+            NSArray *people = [self.class parseClientResults:items];
+            [self replaceSnapshotPeopleWithPeople:people];
+            if (self.paginationInfo.currentPageNumber > 1) {
+                self.slots = [self.slots arrayByAddingObjectsFromArray:people];
+            } else {
+                self.slots = people;
+            }
+            if (!paginationInfo.isLegacy) {
+                self.pageCursors[@(paginationInfo.currentPageNumber)] = paginationInfo.dictionary;
+            }
+            self.focusPageNumber = paginationInfo.currentPageNumber;
+            [self evictPagesOutsideWindow];
+            if (paginationInfo.currentPageNumber <= self.maximumNumberOfSnapshotPages) {
+                [self saveSnapshot];
+            }
+            [[NBPerformanceMonitor sharedMonitor] endOperation:operation];
+        }];
     }];
 }
 
@@ -85,47 +179,72 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 {
     NBPersonViewDataSource *dataSource = [[NBPersonViewDataSource alloc] initWithClient:self.client];
     dataSource.delegate = self;
+    dataSource.readOnly = item[@"id"] && [self.snapshotPersonIdentifiers containsObject:item[@"id"]];
     dataSource.person = item;
     if (item && item[@"id"]) {
         self.mutablePersonDataSources[item[@"id"]] = dataSource;
+        dataSource.cellViewModel = self.cellViewModels[item[@"id"]];
     }
     return dataSource;
 }
 - (id<NBViewDataSource>)dataSourceForItemAtIndex:(NSUInteger)index
 {
-    NBPersonViewDataSource *dataSource;
-    if (index >= self.people.count) {
+    NSDictionary *person = index < self.slots.count ? self.slots[index] : nil;
+    if (![person isKindOfClass:[NSDictionary class]]) {
         return nil;
     }
-    NSDictionary *person = self.people[index];
-    dataSource = self.mutablePersonDataSources[person[@"id"]];
+    NBPersonViewDataSource *dataSource = self.mutablePersonDataSources[person[@"id"]];
     if (!dataSource) {
         dataSource = [self dataSourceForItem:person];
     }
     return dataSource;
 }
 
+- (BOOL)isItemResidentAtIndex:(NSUInteger)index
+{
+    return index < self.slots.count && [self.slots[index] isKindOfClass:[NSDictionary class]];
+}
+
+- (void)didShowItemAtIndex:(NSUInteger)index
+{
+    if (index >= self.slots.count) {
+        return;
+    }
+    NSUInteger pageNumber = index / MAX(self.paginationInfo.numberOfItemsPerPage, (NSUInteger)1) + 1;
+    if (pageNumber != self.focusPageNumber) {
+        self.focusPageNumber = pageNumber;
+        [self evictPagesOutsideWindow];
+    }
+    if (![self isItemResidentAtIndex:index]) {
+        // Evicted, so refetch; cells update when `people` changes.
+        [self fetchPage:pageNumber];
+    }
+}
+
 #pragma mark - NBViewDataSourceDelegate
 
 - (void)dataSource:(id<NBViewDataSource>)dataSource didChangeValueForKeyPath:(NSString *)keyPath
 {
     if ([dataSource isKindOfClass:[NBPersonViewDataSource class]] && [keyPath isEqualToString:NSStringFromSelector(@selector(person))]) {
         NBPersonViewDataSource *personDataSource = dataSource;
-        NSMutableArray *people = self.people.mutableCopy;
+        NSMutableArray *people = self.slots.mutableCopy;
         NSDictionary *person = personDataSource.person;
         if (person) {
             // Keep `people` synced with `mutablePersonDataSources`.
-            NSUInteger index = [self.people indexOfObjectPassingTest:^BOOL(NSDictionary *aPerson, NSUInteger idx, BOOL *stop) {
-                return [aPerson[@"id"] isEqual:person[@"id"]];
+            NSUInteger index = [self.slots indexOfObjectPassingTest:^BOOL(NSDictionary *aPerson, NSUInteger idx, BOOL *stop) {
+                return [aPerson isKindOfClass:[NSDictionary class]] && [aPerson[@"id"] isEqual:person[@"id"]];
             }];
-            if (index == NSNotFound) {
+            if (index == NSNotFound && [self.evictedPersonIdentifiers containsObject:person[@"id"]]) {
+                // Handle updates to evicted people, which get refetched anyway.
+                return;
+            } else if (index == NSNotFound) {
                 // Handle creates.
                 [people insertObject:person atIndex:0];
                 self.mutablePersonDataSources[person[@"id"]] = [self dataSourceForItem:person];
             } else {
                 people[index] = person;
             }
-            self.people = [NSArray arrayWithArray:people];
+            self.slots = [NSArray arrayWithArray:people];
         } else {
             // Handle deletes.
             NSString *identifier = [self.personDataSources keysOfEntriesPassingTest:^BOOL(NSString *identifier, NBPersonViewDataSource *aDataSource, BOOL *stop) {
@@ -133,12 +252,12 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
             }].allObjects.firstObject;
             // Remove data source and item.
             [self.mutablePersonDataSources removeObjectForKey:identifier];
-            for (NSDictionary *person in self.people) {
-                if ([person[@"id"] isEqual:identifier]) {
+            for (NSDictionary *person in self.slots) {
+                if ([person isKindOfClass:[NSDictionary class]] && [person[@"id"] isEqual:identifier]) {
                     [people removeObject:person];
                 }
             }
-            self.people = [NSArray arrayWithArray:people];
+            self.slots = [NSArray arrayWithArray:people];
         }
     }
 }
@@ -152,9 +271,19 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 - (void)cleanUp:(NSError *__autoreleasing *)error
 {
+    [self.taskGroup cancel];
+    for (NBPersonViewDataSource *dataSource in self.mutablePersonDataSources.allValues) {
+        [dataSource cleanUp:NULL];
+    }
     self.paginationInfo = nil;
-    self.people = nil;
+    self.slots = nil;
     self.mutablePersonDataSources = nil;
+    [self.pageCursors removeAllObjects];
+    [self.fetchingPageNumbers removeAllObjects];
+    [self.evictedPersonIdentifiers removeAllObjects];
+    [self.snapshotPersonIdentifiers removeAllObjects];
+    [self resetCellViewModels];
+    self.focusPageNumber = 1;
 }
 
 + (NSError *)parseClientError:(NSError *)error
@@ -174,17 +303,284 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 #pragma mark - Private
 
-- (void)setPeople:(NSArray *)people
+- (void)setSlots:(NSArray *)slots
 {
     // Guard.
-    NSAssert(!people.count || self.paginationInfo, @"Pagination info should be set before adding people.");
+    NSAssert(!slots.count || self.paginationInfo, @"Pagination info should be set before adding people.");
     // Will.
     if (self.paginationInfo) {
-        self.paginationInfo.currentPageNumber = !people ? 1 : ceil((double)people.count / self.paginationInfo.numberOfItemsPerPage);
-        self.paginationInfo.numberOfTotalAvailableItems = people.count;
+        self.paginationInfo.currentPageNumber = !slots ? 1 : ceil((double)slots.count / self.paginationInfo.numberOfItemsPerPage);
+        self.paginationInfo.numberOfTotalAvailableItems = slots.count;
     }
     // Set.
-    _people = people;
+    _slots = slots;
+    _people = [self.class residentPeopleInSlots:slots];
+    // Did.
+    [self prepareCellViewModels];
+}
+
++ (NSArray *)residentPeopleInSlots:(NSArray *)slots
+{
+    return [slots filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"SELF != %@", [NSNull null]]];
+}
+
+- (BOOL)showSnapshot
+{
+    self.didShowSnapshot = YES;
+    if (!self.snapshotURL) {
+        return NO;
+    }
+    // The first page the refresh scheduler cached is shown instead if it's newer.
+    NSDate *snapshotDate;
+    [self.snapshotURL getResourceValue:&snapshotDate forKey:NSURLContentModificationDateKey error:nil];
+    NSDate *refreshDate = [self.refreshScheduler lastRefreshDateForCollectionKey:NBClientRefreshPeopleKey];
+    if (snapshotDate && refreshDate && [refreshDate compare:snapshotDate] == NSOrderedDescending &&
+        [self.refreshScheduler cachedItemsForCollectionKey:NBClientRefreshPeopleKey].count)
+    {
+        NBLogInfo(@"Skipping people snapshot from %@, older than the cached page", snapshotDate);
+        return NO;
+    }
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    NBClientPeopleSnapshot *snapshot = [[NBClientPeopleSnapshot alloc] initWithContentsOfURL:self.snapshotURL error:nil];
+    NSDictionary *cursor = snapshot.cursor;
+    NBPaginationInfo *paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:cursor[NBClientPeopleSnapshotPaginationInfoKey]
+                                                                             legacy:[cursor[NBClientPeopleSnapshotLegacyKey] boolValue]];
+    if (!snapshot.numberOfItems || paginationInfo.numberOfItemsPerPage != self.paginationInfo.numberOfItemsPerPage) {
+        // Pages of another size wouldn't line up with the ones fetched next.
+        return NO;
+    }
+    self.paginationInfo = paginationInfo;
+    [cursor[NBClientPeopleSnapshotPageCursorsKey] enumerateKeysAndObjectsUsingBlock:^(NSString *pageNumber, NSDictionary *pageCursor, BOOL *stop) {
+        self.pageCursors[@(pageNumber.integerValue)] = pageCursor;
+    }];
+    self.slots = [self.class parseClientResults:snapshot.items];
+    [self.snapshotPersonIdentifiers addObjectsFromArray:[self.slots valueForKey:@"id"]];
+    NBLogInfo(@"Showed %lu people from snapshot in %.1fms",
+              (unsigned long)self.slots.count, (CFAbsoluteTimeGetCurrent() - startTime) * 1000);
+    return YES;
+}
+
+- (void)saveSnapshot
+{
+    if (!self.snapshotURL || !self.paginationInfo.numberOfItemsPerPage) {
+        return;
+    }
+    // Only whole, resident pages from the first.
+    NSUInteger numberOfPages = MIN(self.paginationInfo.currentPageNumber, self.maximumNumberOfSnapshotPages);
+    NSUInteger numberOfItems = MIN([self.paginationInfo indexOfFirstItemAtPage:(numberOfPages + 1)], self.slots.count);
+    NSArray *people = [self.slots subarrayWithRange:NSMakeRange(0, numberOfItems)];
+    if (!people.count || [people containsObject:[NSNull null]]) {
+        return;
+    }
+    NSDictionary *paginationInfo;
+    NSMutableDictionary *pageCursors = [NSMutableDictionary dictionary];
+    if (self.paginationInfo.isLegacy) {
+        paginationInfo = self.paginationInfo.dictionary;
+    } else {
+        paginationInfo = self.pageCursors[@(numberOfPages)];
+        for (NSUInteger pageNumber = 1; pageNumber <= numberOfPages; pageNumber++) {
+            pageCursors[@(pageNumber).stringValue] = self.pageCursors[@(pageNumber)];
+        }
+    }
+    if (!paginationInfo) {
+        return;
+    }
+    NSDictionary *cursor = @{ NBClientPeopleSnapshotPaginationInfoKey: paginationInfo,
+                              NBClientPeopleSnapshotLegacyKey: @(self.paginationInfo.isLegacy),
+                              NBClientPeopleSnapshotPageCursorsKey: [NSDictionary dictionaryWithDictionary:pageCursors] };
+    NSURL *snapshotURL = self.snapshotURL;
+    dispatch_async(self.snapshotQueue, ^{
+        NSError *error;
+        if (![NBClientPeopleSnapshot writeItems:people keys:[NBClientPeopleSnapshot defaultKeys] cursor:cursor
+                                          toURL:snapshotURL error:&error])
+        {
+            NBLogWarning(@"Failed to save people snapshot: %@", error);
+        }
+    });
+}
+
+- (void)replaceSnapshotPeopleWithPeople:(NSArray *)people
+{
+    if (!self.snapshotPersonIdentifiers.count) {
+        return;
+    }
+    for (NSDictionary *person in people) {
+        id identifier = person[@"id"];
+        if (!identifier || ![self.snapshotPersonIdentifiers containsObject:identifier]) {
+            continue;
+        }
+        [self.snapshotPersonIdentifiers removeObject:identifier];
+        // Before the person, so observers of it see both.
+        NBPersonViewDataSource *dataSource = self.mutablePersonDataSources[identifier];
+        dataSource.readOnly = NO;
+        dataSource.person = person;
+    }
+}
+
+- (BOOL)isPageResident:(NSUInteger)pageNumber
+{
+    NSUInteger index = [self.paginationInfo indexOfFirstItemAtPage:pageNumber];
+    return index < self.slots.count && [self.slots[index] isKindOfClass:[NSDictionary class]];
+}
+
+- (void)fetchPage:(NSUInteger)pageNumber
+{
+    // Guard.
+    if ([self.fetchingPageNumbers containsObject:@(pageNumber)]) {
+        return;
+    }
+    NBPaginationInfo *paginationInfo;
+    if (self.paginationInfo.isLegacy) {
+        paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:self.paginationInfo.dictionary legacy:YES];
+        paginationInfo.currentPageNumber = pageNumber;
+    } else if (self.pageCursors[@(pageNumber + 1)]) {
+        // Scrolling back up.
+        paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:self.pageCursors[@(pageNumber + 1)] legacy:NO];
+        paginationInfo.currentDirection = NBPaginationDirectionPrevious;
+    } else if (self.pageCursors[@(pageNumber - 1)]) {
+        paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:self.pageCursors[@(pageNumber - 1)] legacy:NO];
+        paginationInfo.currentDirection = NBPaginationDirectionNext;
+    } else if (pageNumber == 1) {
+        paginationInfo = [[NBPaginationInfo alloc] initWithDictionary:nil legacy:NO];
+        paginationInfo.numberOfItemsPerPage = self.paginationInfo.numberOfItemsPerPage;
+    } else {
+        NBLogWarning(@"No cursor to refetch page %lu", (unsigned long)pageNumber);
+        return;
+    }
+    // Fetch.
+    NBLogInfo(@"Refetching evicted page %lu", (unsigned long)pageNumber);
+    [self.fetchingPageNumbers addObject:@(pageNumber)];
+    [self.client performRequestsInTaskGroup:self.taskGroup usingBlock:^{
+        [self.client fetchPeopleWithPaginationInfo:paginationInfo completionHandler:^(NSArray *items, NBPaginationInfo *responsePaginationInfo, NSError *error) {
+            [self.fetchingPageNumbers removeObject:@(pageNumber)];
+            if (error) {
+                if (!error.nb_isCancellation) {
+                    self.error = [self.class parseClientError:error];
+                }
+                return;
+            }
+            NSUInteger operation = [[NBPerformanceMonitor sharedMonitor] beginOperationWithName:@"people.refetch_page"];
+            if (!responsePaginationInfo.isLegacy) {
+                self.pageCursors[@(pageNumber)] = responsePaginationInfo.dictionary;
+                if (pageNumber == self.paginationInfo.currentPageNumber) {
+                    // Keep loading more from the latest cursor.
+                    self.paginationInfo.nextPageURLString = responsePaginationInfo.nextPageURLString;
+                }
+            }
+            // Fill the page's slots back in.
+            NSArray *people = [self.class parseClientResults:items];
+            [self replaceSnapshotPeopleWithPeople:people];
+            NSUInteger startIndex = [self.paginationInfo indexOfFirstItemAtPage:pageNumber];
+            NSUInteger endIndex = MIN(startIndex + self.paginationInfo.numberOfItemsPerPage, self.slots.count);
+            for (NSUInteger index = startIndex; index < endIndex; index++) {
+                // A shorter page leaves snapshot people it didn't return, who'd stay read-only.
+                id identifier = [self.slots[index] isKindOfClass:[NSDictionary class]] ? self.slots[index][@"id"] : nil;
+                if (identifier && [self.snapshotPersonIdentifiers containsObject:identifier]) {
+                    [self.snapshotPersonIdentifiers removeObject:identifier];
+                    ((NBPersonViewDataSource *)self.mutablePersonDataSources[identifier]).readOnly = NO;
+                }
+            }
+            NSMutableArray *mutablePeople = self.slots.mutableCopy;
+            for (NSUInteger offset = 0; offset < people.count && startIndex + offset < mutablePeople.count; offset++) {
+                NSDictionary *person = people[offset];
+                mutablePeople[startIndex + offset] = person;
+                [self.evictedPersonIdentifiers removeObject:person[@"id"]];
+            }
+            self.slots = [NSArray arrayWithArray:mutablePeople];
+            [self evictPagesOutsideWindow];
+            if (pageNumber <= self.maximumNumberOfSnapshotPages) {
+                [self saveSnapshot];
+            }
+            [[NBPerformanceMonitor sharedMonitor] endOperation:operation];
+        }];
+    }];
+}
+
+- (void)evictPagesOutsideWindow
+{
+    NSUInteger radius = self.maximumNumberOfResidentPages / 2;
+    NSUInteger numberOfPages = self.paginationInfo.currentPageNumber;
+    NSMutableArray *people;
+    for (NSUInteger pageNumber = 1; pageNumber <= numberOfPages; pageNumber++) {
+        NSUInteger distance = (pageNumber > self.focusPageNumber
+                               ? pageNumber - self.focusPageNumber : self.focusPageNumber - pageNumber);
+        if (distance <= radius || ![self isPageResident:pageNumber]) {
+            continue;
+        }
+        people = people ?: self.slots.mutableCopy;
+        NSUInteger startIndex = [self.paginationInfo indexOfFirstItemAtPage:pageNumber];
+        NSUInteger endIndex = MIN(startIndex + self.paginationInfo.numberOfItemsPerPage, people.count);
+        for (NSUInteger index = startIndex; index < endIndex; index++) {
+            id identifier = [people[index] isKindOfClass:[NSDictionary class]] ? people[index][@"id"] : nil;
+            if (identifier) {
+                // Not cleaned up, in case it's still being presented.
+                [self.mutablePersonDataSources removeObjectForKey:identifier];
+                [self.cellViewModels removeObjectForKey:identifier];
+                [self.evictedPersonIdentifiers addObject:identifier];
+            }
+            people[index] = [NSNull null];
+        }
+        NBLogInfo(@"Evicted page %lu", (unsigned long)pageNumber);
+    }
+    if (people) {
+        // Set directly, since evicting doesn't change what's visible.
+        _slots = [NSArray arrayWithArray:people];
+        _people = [self.class residentPeopleInSlots:_slots];
+    }
+}
+
+- (void)prepareCellViewModels
+{
+    NBPersonCellViewLayout *layout = self.cellLayout;
+    if (!layout) {
+        return;
+    }
+    // Only people who are new or changed, by identity, and not already pending.
+    NSMutableArray *people = [NSMutableArray array];
+    for (NSDictionary *person in self.slots) {
+        id identifier = [person isKindOfClass:[NSDictionary class]] ? person[@"id"] : nil;
+        if (!identifier || self.pendingCellViewModelPeople[identifier] == person ||
+            [self.cellViewModels[identifier] isForPerson:person layout:layout])
+        {
+            continue;
+        }
+        self.pendingCellViewModelPeople[identifier] = person;
+        [people addObject:person];
+    }
+    if (!people.count) {
+        return;
+    }
+    NSUInteger generation = self.cellViewModelGeneration;
+    dispatch_async(self.cellViewModelQueue, ^{
+        NSMutableArray *viewModels = [NSMutableArray arrayWithCapacity:people.count];
+        for (NSDictionary *person in people) {
+            [viewModels addObject:[[NBPersonCellViewModel alloc] initWithPerson:person layout:layout]];
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (generation != self.cellViewModelGeneration) {
+                return;
+            }
+            for (NBPersonCellViewModel *viewModel in viewModels) {
+                id identifier = viewModel.person[@"id"];
+                if (self.pendingCellViewModelPeople[identifier] == viewModel.person) {
+                    [self.pendingCellViewModelPeople removeObjectForKey:identifier];
+                }
+                if ([self.evictedPersonIdentifiers containsObject:identifier]) {
+                    continue;
+                }
+                self.cellViewModels[identifier] = viewModel;
+                [self.mutablePersonDataSources[identifier] setCellViewModel:viewModel];
+            }
+            NBLogDebug(@"Prepared %lu person cell view model(s)", (unsigned long)viewModels.count);
+        });
+    });
+}
+
+- (void)resetCellViewModels
+{
+    self.cellViewModelGeneration += 1;
+    [self.cellViewModels removeAllObjects];
+    [self.pendingCellViewModelPeople removeAllObjects];
 }
 
 - (NSMutableDictionary *)mutablePersonDataSources
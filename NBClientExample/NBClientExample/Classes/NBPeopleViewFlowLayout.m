@@ -7,6 +7,8 @@
 
 #import "NBPeopleViewFlowLayout.h"
 
+#import <NBClient/UI/NBPerformanceMonitor.h>
+
 #if DEBUG
 static NBLogLevel LogLevel = NBLogLevelDebug;
 #else
@@ -26,6 +28,7 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 - (void)prepareLayout
 {
+    NSUInteger operation = [[NBPerformanceMonitor sharedMonitor] beginOperationWithName:@"people.layout"];
     [super prepareLayout];
     
     static dispatch_once_t onceToken;
@@ -55,6 +58,7 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         [decorationViewAttributes addObject:attributes];
     }
     self.decorationViewAttributes = decorationViewAttributes;
+    [[NBPerformanceMonitor sharedMonitor] endOperation:operation];
 }
 
 - (BOOL)shouldInvalidateLayoutForBoundsChange:(CGRect)newBounds
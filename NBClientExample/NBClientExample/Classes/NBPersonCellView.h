@@ -9,6 +9,8 @@
 
 #import "NBUIDefines.h"
 
+@class NBPersonCellViewLayout;
+
 @interface NBPersonCellView : UICollectionViewCell <NBViewCell>
 
 @property (nonatomic, weak, readonly) UIView *bottomBorderView;
@@ -26,5 +28,10 @@
 
 @property (nonatomic, weak) id<NBCollectionViewCellDelegate> delegate;
 
+// For preparing view models at the cell's current size.
+- (NBPersonCellViewLayout *)viewModelLayout;
+// If set, used instead of building a layout on every refresh.
+@property (nonatomic) NBPersonCellViewLayout *sharedViewModelLayout;
+
 @end
 
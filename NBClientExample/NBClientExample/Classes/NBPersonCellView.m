@@ -7,6 +7,9 @@
 
 #import "NBPersonCellView.h"
 
+#import <NBClient/UI/NBPerformanceMonitor.h>
+
+#import "NBPersonCellViewModel.h"
 #import "NBPersonViewDataSource.h"
 
 static NSString *LabelViewKey = @"view";
@@ -25,6 +28,7 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 @property (nonatomic, weak) IBOutlet UILabel *tagsLabel;
 @property (nonatomic, copy) NSArray *borderViews;
 @property (nonatomic, copy) NSArray *labeledViews;
+@property (nonatomic) CGFloat textMarginWidth;
 
 @end
 
@@ -40,6 +44,7 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         self.selectedBackgroundColor = self.tintColor;
     }
     self.selectedBackgroundView = [[UIView alloc] init];
+    self.textMarginWidth = self.bounds.size.width - self.tagsLabel.bounds.size.width;
 }
 
 - (void)dealloc
@@ -91,14 +96,21 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 - (void)refreshWithData:(NSDictionary *)data
 {
+    NSUInteger operation = [[NBPerformanceMonitor sharedMonitor] beginOperationWithName:@"people.cell.refresh"];
     if (data) {
-        self.nameLabel.text = data[@"full_name"];
-        self.tagsLabel.text = [data[@"tags"] componentsJoinedByString:
-                               [NSString stringWithFormat:@" %@ ", self.tagDelimiterString]];
+        NBPersonCellViewLayout *layout = self.sharedViewModelLayout ?: self.viewModelLayout;
+        NBPersonCellViewModel *viewModel = ((NBPersonViewDataSource *)self.dataSource).cellViewModel;
+        if (![viewModel isForPerson:data layout:layout]) {
+            // Not prepared yet, or stale.
+            viewModel = [[NBPersonCellViewModel alloc] initWithPerson:data layout:layout];
+        }
+        self.nameLabel.text = viewModel.nameText;
+        self.tagsLabel.text = viewModel.subtitleText;
     } else {
         self.nameLabel.text =
         self.tagsLabel.text = nil;
     }
+    [[NBPerformanceMonitor sharedMonitor] endOperation:operation];
 }
 
 - (void)setDataSource:(id<NBViewDataSource>)dataSource
@@ -116,6 +128,14 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 #pragma mark - Public
 
+- (NBPersonCellViewLayout *)viewModelLayout
+{
+    return [[NBPersonCellViewLayout alloc] initWithNameFont:self.nameLabel.font
+                                               subtitleFont:self.tagsLabel.font
+                                         tagDelimiterString:self.tagDelimiterString
+                                           maximumTextWidth:(self.bounds.size.width - self.textMarginWidth)];
+}
+
 - (void)setBorderColor:(UIColor *)borderColor
 {
     _borderColor = borderColor;
@@ -0,0 +1,47 @@
+//
+//  NBPersonCellViewModel.h
+//  NBClientExample
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import <UIKit/UIKit.h>
+
+// What a person cell's content depends on besides the person, from the cell.
+@interface NBPersonCellViewLayout : NSObject
+
+@property (nonatomic, readonly) UIFont *nameFont;
+@property (nonatomic, readonly) UIFont *subtitleFont;
+@property (nonatomic, copy, readonly) NSString *tagDelimiterString;
+@property (nonatomic, readonly) CGFloat maximumTextWidth;
+
+- (instancetype)initWithNameFont:(UIFont *)nameFont
+                    subtitleFont:(UIFont *)subtitleFont
+              tagDelimiterString:(NSString *)tagDelimiterString
+                maximumTextWidth:(CGFloat)maximumTextWidth;
+
+@end
+
+// Display-ready content for a person cell, so configuring one during scrolling
+// only assigns values. Building it formats the name, summarizes the tags to
+// fit on a line, and measures both, which is safe to do off the main queue.
+// Immutable; it's rebuilt when the person or the layout changes.
+@interface NBPersonCellViewModel : NSObject
+
+@property (nonatomic, copy, readonly) NSDictionary *person;
+@property (nonatomic, readonly) NBPersonCellViewLayout *layout;
+
+@property (nonatomic, copy, readonly) NSString *nameText;
+// The tags that fit, then how many more there are.
+@property (nonatomic, copy, readonly) NSString *subtitleText;
+@property (nonatomic, readonly) CGSize nameSize;
+@property (nonatomic, readonly) CGSize subtitleSize;
+// For cells showing avatars, to look up or fetch the image by.
+@property (nonatomic, copy, readonly) NSURL *thumbnailURL;
+
+- (instancetype)initWithPerson:(NSDictionary *)person layout:(NBPersonCellViewLayout *)layout;
+
+// By identity, since people are replaced rather than mutated.
+- (BOOL)isForPerson:(NSDictionary *)person layout:(NBPersonCellViewLayout *)layout;
+
+@end
@@ -0,0 +1,127 @@
+//
+//  NBPersonCellViewModel.m
+//  NBClientExample
+//
+//  Copyright (MIT) 2014-present NationBuilder
+//
+
+#import "NBPersonCellViewModel.h"
+
+@interface NBPersonCellViewLayout ()
+
+@property (nonatomic, readwrite) UIFont *nameFont;
+@property (nonatomic, readwrite) UIFont *subtitleFont;
+@property (nonatomic, copy, readwrite) NSString *tagDelimiterString;
+@property (nonatomic, readwrite) CGFloat maximumTextWidth;
+
+@end
+
+@implementation NBPersonCellViewLayout
+
+- (instancetype)initWithNameFont:(UIFont *)nameFont
+                    subtitleFont:(UIFont *)subtitleFont
+              tagDelimiterString:(NSString *)tagDelimiterString
+                maximumTextWidth:(CGFloat)maximumTextWidth
+{
+    self = [super init];
+    if (self) {
+        self.nameFont = nameFont;
+        self.subtitleFont = subtitleFont;
+        self.tagDelimiterString = tagDelimiterString ?: @"";
+        self.maximumTextWidth = maximumTextWidth;
+    }
+    return self;
+}
+
+- (BOOL)isEqual:(id)object
+{
+    if (object == self) {
+        return YES;
+    }
+    if (![object isKindOfClass:[NBPersonCellViewLayout class]]) {
+        return NO;
+    }
+    NBPersonCellViewLayout *layout = object;
+    return ([layout.nameFont isEqual:self.nameFont] && [layout.subtitleFont isEqual:self.subtitleFont] &&
+            [layout.tagDelimiterString isEqualToString:self.tagDelimiterString] &&
+            layout.maximumTextWidth == self.maximumTextWidth);
+}
+
+- (NSUInteger)hash
+{
+    return self.nameFont.hash ^ self.subtitleFont.hash ^ self.tagDelimiterString.hash ^ (NSUInteger)self.maximumTextWidth;
+}
+
+@end
+
+@interface NBPersonCellViewModel ()
+
+@property (nonatomic, copy, readwrite) NSDictionary *person;
+@property (nonatomic, readwrite) NBPersonCellViewLayout *layout;
+
+@property (nonatomic, copy, readwrite) NSString *nameText;
+@property (nonatomic, copy, readwrite) NSString *subtitleText;
+@property (nonatomic, readwrite) CGSize nameSize;
+@property (nonatomic, readwrite) CGSize subtitleSize;
+@property (nonatomic, copy, readwrite) NSURL *thumbnailURL;
+
++ (CGSize)sizeOfText:(NSString *)text withFont:(UIFont *)font;
+
+@end
+
+@implementation NBPersonCellViewModel
+
+- (instancetype)initWithPerson:(NSDictionary *)person layout:(NBPersonCellViewLayout *)layout
+{
+    self = [super init];
+    if (self) {
+        self.person = person;
+        self.layout = layout;
+        // Name.
+        self.nameText = person[@"full_name"];
+        self.nameSize = [self.class sizeOfText:self.nameText withFont:layout.nameFont];
+        // Tags, as many as fit.
+        NSArray *tags = [person[@"tags"] isKindOfClass:[NSArray class]] ? person[@"tags"] : @[];
+        NSString *separator = [NSString stringWithFormat:@" %@ ", layout.tagDelimiterString];
+        NSString *subtitleText = [tags componentsJoinedByString:separator];
+        CGSize subtitleSize = [self.class sizeOfText:subtitleText withFont:layout.subtitleFont];
+        NSUInteger count = tags.count;
+        while (count > 1 && subtitleSize.width > layout.maximumTextWidth) {
+            count -= 1;
+            NSString *visibleText = [[tags subarrayWithRange:NSMakeRange(0, count)] componentsJoinedByString:separator];
+            subtitleText = [NSString localizedStringWithFormat:NSLocalizedString(@"person.tags-summary.format", nil),
+                            visibleText, (unsigned long)(tags.count - count)];
+            subtitleSize = [self.class sizeOfText:subtitleText withFont:layout.subtitleFont];
+        }
+        self.subtitleText = subtitleText;
+        self.subtitleSize = subtitleSize;
+        // Avatar.
+        NSString *urlString = person[@"profile_image_url_ssl"];
+        if ([urlString isKindOfClass:[NSString class]] && urlString.length) {
+            self.thumbnailURL = [NSURL URLWithString:urlString];
+        }
+    }
+    return self;
+}
+
+#pragma mark - Public
+
+- (BOOL)isForPerson:(NSDictionary *)person layout:(NBPersonCellViewLayout *)layout
+{
+    return person == self.person && [layout isEqual:self.layout];
+}
+
+#pragma mark - Private
+
++ (CGSize)sizeOfText:(NSString *)text withFont:(UIFont *)font
+{
+    if (!text.length || !font) {
+        return CGSizeZero;
+    }
+    CGRect rect = [text boundingRectWithSize:CGSizeMake(CGFLOAT_MAX, CGFLOAT_MAX)
+                                     options:NSStringDrawingUsesLineFragmentOrigin
+                                  attributes:@{ NSFontAttributeName: font } context:nil];
+    return CGSizeMake(ceil(rect.size.width), ceil(rect.size.height));
+}
+
+@end
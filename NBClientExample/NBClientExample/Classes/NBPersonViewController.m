@@ -366,18 +366,13 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     if (!dataSource.profileImage && urlString.length) {
         UIImageView *imageView = self.profileImageView;
         imageView.alpha = 0.0f;
-        dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-            NSData *imageData = [NSData dataWithContentsOfURL:[NSURL URLWithString:urlString]];
-            if (!imageData) {
-                NBLogWarning(@"Invalid profile image URL %@", urlString);
+        [dataSource fetchProfileImageWithCompletionHandler:^(UIImage *profileImage) {
+            if (!profileImage) {
                 return;
             }
-            dispatch_async(dispatch_get_main_queue(), ^{
-                dataSource.profileImage = [UIImage imageWithData:imageData];
-                imageView.image = dataSource.profileImage;
-                [UIView animateWithDuration:0.2f animations:^{ imageView.alpha = 1.0f; }];
-            });
-        });
+            imageView.image = profileImage;
+            [UIView animateWithDuration:0.2f animations:^{ imageView.alpha = 1.0f; }];
+        }];
     } else {
         self.profileImageView.image = dataSource.profileImage;
     }
@@ -385,6 +380,9 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     [DataToFieldKeyPathsMap enumerateKeysAndObjectsUsingBlock:^(NSString *dataKeyPath, NSString *fieldKeyPath, BOOL *stop) {
         [self setValue:[data valueForKeyPath:dataKeyPath] forKeyPath:fieldKeyPath];
     }];
+    // Partial people can't be changed until refetched.
+    self.editButtonItem.enabled = !dataSource.isReadOnly;
+    self.deleteButtonItem.enabled = !dataSource.isReadOnly;
     // Invalidate any views.
     self.deleteConfirmationAlert = nil;
 }
@@ -9,11 +9,19 @@
 
 #import "NBUIDefines.h"
 
+@class NBPersonCellViewModel;
+
 @interface NBPersonViewDataSource : NSObject <NBViewDataSource>
 
 @property (nonatomic, copy) NSDictionary *person;
+// Partial people, ie. from a snapshot, can't be saved or deleted until the
+// full person is set.
+@property (nonatomic, getter = isReadOnly) BOOL readOnly;
 
 @property (nonatomic) UIImage *profileImage;
+// Prepared by the people data source for list cells. Nil or stale while it's
+// being rebuilt for a changed person.
+@property (nonatomic) NBPersonCellViewModel *cellViewModel;
 
 - (BOOL)save;
 - (void)cancelSave;
@@ -21,4 +29,7 @@
 - (BOOL)nb_delete;
 - (void)cancelDelete;
 
+// Downloads at most once, and is cancelled along with everything else on clean-up.
+- (void)fetchProfileImageWithCompletionHandler:(void (^)(UIImage *profileImage))completionHandler;
+
 @end
@@ -9,6 +9,8 @@
 
 #import <NBClient/FoundationAdditions.h>
 #import <NBClient/NBClient+People.h>
+#import <NBClient/NBClientPersonSaveCoalescer.h>
+#import <NBClient/NBClientTaskGroup.h>
 
 static NSString *PersonKeyPath;
 static NSString *TagDelimiter = @", ";
@@ -25,8 +27,14 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 @property (nonatomic) NSURLSessionDataTask *saveTask;
 @property (nonatomic) NSURLSessionDataTask *deleteTask;
+// Everything in flight, cancelled on clean-up.
+@property (nonatomic) NBClientTaskGroup *taskGroup;
+// Merges quick successive saves, ie. autosaves, into one request.
+@property (nonatomic) NBClientPersonSaveCoalescer *saveCoalescer;
 
 @property (nonatomic, copy) NSDictionary *realChanges;
+// Saves still land after clean-up, but their results are ignored.
+@property (nonatomic, getter = isCleanedUp) BOOL cleanedUp;
 
 @end
 
@@ -48,6 +56,9 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     self = [super init];
     if (self) {
         self.client = client;
+        self.taskGroup = [[NBClientTaskGroup alloc] init];
+        self.saveCoalescer = [[NBClientPersonSaveCoalescer alloc] initWithClient:client];
+        self.saveCoalescer.taskGroup = self.taskGroup;
         self.person = @{};
     }
     return self;
@@ -59,6 +70,10 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 {
     BOOL willSave = NO;
     // Guard.
+    if (self.isReadOnly) {
+        NBLogWarning(@"Person is read-only until refetched. Aborting save.");
+        return willSave;
+    }
     NSDictionary *realChanges = [self realChanges];
     if (!realChanges.count) {
         NBLogInfo(@"No changes detected. Aborting save.");
@@ -68,11 +83,17 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     willSave = YES;
     NSMutableDictionary *parsedChanges = [self.class parseChanges:realChanges];
     void (^completion)(NSDictionary *, NSError *) = ^(NSDictionary *item, NSError *error) {
+        if (self.isCleanedUp) {
+            return;
+        }
         // Handle client error.
         if (error) {
             self.error = [self.class parseClientError:error];
             return;
         }
+        if (!item) {
+            return; // Coalesced into no changes.
+        }
         // Update and notify.
         self.person = [self.class parseClientResults:item];
         if (self.delegate && [self.delegate respondsToSelector:@selector(dataSource:didChangeValueForKeyPath:)]) {
@@ -82,19 +103,25 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
         self.saveTask = nil;
     };
     if (self.person[@"id"]) {
-        // Update existing.
-        self.saveTask = [self.client savePersonByIdentifier:[self.person[@"id"] unsignedIntegerValue]
-                                             withParameters:parsedChanges
-                                          completionHandler:completion];
-    } else {
+        // Update existing, sending only what changed.
+        [self.saveCoalescer savePersonByIdentifier:[self.person[@"id"] unsignedIntegerValue]
+                                       withChanges:parsedChanges
+                                    originalPerson:self.person
+                                 completionHandler:completion];
+        return willSave;
+    }
+    [self.client performRequestsInTaskGroup:self.taskGroup usingBlock:^{
         // Create new.
         self.saveTask = [self.client createPersonWithParameters:parsedChanges
                                               completionHandler:completion];
-    }
+    }];
     return willSave;
 }
 - (void)cancelSave
 {
+    if (self.person[@"id"]) {
+        [self.saveCoalescer cancelSavesForPersonByIdentifier:[self.person[@"id"] unsignedIntegerValue]];
+    }
     if (!self.saveTask) { return; }
     [self.saveTask cancel];
 }
@@ -102,27 +129,34 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 - (BOOL)nb_delete
 {
     BOOL willDelete = YES;
-    self.deleteTask =
-    [self.client
-     deletePersonByIdentifier:[self.person[@"id"] unsignedIntegerValue]
-     withCompletionHandler:^(NSDictionary *item, NSError *error) {
-         // Handle client error.
-         if (error) {
-             self.error = [self.class parseClientError:error];
-             return;
-         }
-         // Update and notify.
-         [self cleanUp:&error];
-         if (error) {
-             self.error = error;
-             return;
-         }
-         if (self.delegate && [self.delegate respondsToSelector:@selector(dataSource:didChangeValueForKeyPath:)]) {
-             [self.delegate dataSource:self didChangeValueForKeyPath:NSStringFromSelector(@selector(person))];
-         }
-         // Teardown canceling.
-         self.deleteTask = nil;
-     }];
+    // Guard.
+    if (self.isReadOnly) {
+        NBLogWarning(@"Person is read-only until refetched. Aborting delete.");
+        return NO;
+    }
+    [self.client performRequestsInTaskGroup:self.taskGroup usingBlock:^{
+        self.deleteTask =
+        [self.client
+         deletePersonByIdentifier:[self.person[@"id"] unsignedIntegerValue]
+         withCompletionHandler:^(NSDictionary *item, NSError *error) {
+             // Handle client error.
+             if (error) {
+                 self.error = [self.class parseClientError:error];
+                 return;
+             }
+             // Update and notify.
+             [self cleanUp:&error];
+             if (error) {
+                 self.error = error;
+                 return;
+             }
+             if (self.delegate && [self.delegate respondsToSelector:@selector(dataSource:didChangeValueForKeyPath:)]) {
+                 [self.delegate dataSource:self didChangeValueForKeyPath:NSStringFromSelector(@selector(person))];
+             }
+             // Teardown canceling.
+             self.deleteTask = nil;
+         }];
+    }];
     return willDelete;
 }
 - (void)cancelDelete
@@ -131,6 +165,33 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
     [self.deleteTask cancel];
 }
 
+- (void)fetchProfileImageWithCompletionHandler:(void (^)(UIImage *))completionHandler
+{
+    NSString *urlString = self.person[@"profile_image_url_ssl"];
+    if (self.profileImage || !urlString.length) {
+        completionHandler(self.profileImage);
+        return;
+    }
+    NSURLSessionDataTask *task =
+    [self.client
+     startDataTaskWithURL:[NSURL URLWithString:urlString]
+     completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+         UIImage *image = data ? [UIImage imageWithData:data] : nil;
+         dispatch_async(dispatch_get_main_queue(), ^{
+             if (!image) {
+                 if (!error.nb_isCancellation) {
+                     NBLogWarning(@"Invalid profile image URL %@", urlString);
+                 }
+                 completionHandler(nil);
+                 return;
+             }
+             self.profileImage = image;
+             completionHandler(image);
+         });
+     }];
+    [self.taskGroup addTask:task];
+}
+
 #pragma mark - Private
 
 - (NSDictionary *)realChanges
@@ -154,6 +215,11 @@ static NBLogLevel LogLevel = NBLogLevelWarning;
 
 - (void)cleanUp:(NSError *__autoreleasing *)error
 {
+    self.cleanedUp = YES;
+    // Send pending edits outside the group, so cancelling it doesn't drop them.
+    self.saveCoalescer.taskGroup = nil;
+    [self.saveCoalescer flush];
+    [self.taskGroup cancel];
     self.person = nil;
     self.profileImage = nil;
 }